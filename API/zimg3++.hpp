@@ -1,6 +1,7 @@
 #ifndef ZIMG3PLUSPLUS_HPP_
 #define ZIMG3PLUSPLUS_HPP_
 
+#include <vector>
 #include "zimg3.h"
 
 namespace zimgxx {;
@@ -80,6 +81,17 @@ public:
 		return ret;
 	}
 
+	size_t get_cache_size(size_t *unshared = 0) const
+	{
+		size_t ret;
+		size_t ret_unshared;
+		check(zimg2_filter_graph_get_cache_size(m_graph, &ret, &ret_unshared));
+
+		if (unshared)
+			*unshared = ret_unshared;
+		return ret;
+	}
+
 	unsigned get_input_buffering() const
 	{
 		unsigned ret;
@@ -94,6 +106,13 @@ public:
 		return ret;
 	}
 
+	unsigned get_push_buffering(unsigned slice_height) const
+	{
+		unsigned ret;
+		check(zimg2_filter_graph_get_push_buffering(m_graph, slice_height, &ret));
+		return ret;
+	}
+
 	void process(const zimg_image_buffer_const *src, const zimg_image_buffer *dst, void *tmp,
 	             zimg_filter_graph_callback unpack_cb = 0, void *unpack_user = 0,
 	             zimg_filter_graph_callback pack_cb = 0, void *pack_user = 0) const
@@ -101,6 +120,53 @@ public:
 		check(zimg2_filter_graph_process(m_graph, src, dst, tmp, unpack_cb, unpack_user, pack_cb, pack_user));
 	}
 
+	void process_region(const zimg_image_buffer_const *src, const zimg_image_buffer *dst, void *tmp,
+	                    unsigned left, unsigned top, unsigned right, unsigned bottom,
+	                    zimg_filter_graph_callback unpack_cb = 0, void *unpack_user = 0,
+	                    zimg_filter_graph_callback pack_cb = 0, void *pack_user = 0) const
+	{
+		check(zimg2_filter_graph_process_region(m_graph, src, dst, tmp, left, top, right, bottom, unpack_cb, unpack_user, pack_cb, pack_user));
+	}
+
+	std::vector<zimg_filter_graph_stats> get_stats() const
+	{
+		std::vector<zimg_filter_graph_stats> ret;
+		unsigned count = 0;
+
+		check(zimg2_filter_graph_get_stats(m_graph, 0, &count));
+		ret.resize(count);
+
+		if (count) {
+			check(zimg2_filter_graph_get_stats(m_graph, &ret[0], &count));
+			ret.resize(count);
+		}
+		return ret;
+	}
+
+	size_t get_tmp_size_mt(unsigned threads) const
+	{
+		size_t ret;
+		check(zimg2_filter_graph_get_tmp_size_mt(m_graph, threads, &ret));
+		return ret;
+	}
+
+	void process_mt(const zimg_image_buffer_const *src, const zimg_image_buffer *dst, void *tmp, unsigned threads,
+	                zimg_filter_graph_callback unpack_cb = 0, void *unpack_user = 0,
+	                zimg_filter_graph_callback pack_cb = 0, void *pack_user = 0) const
+	{
+		check(zimg2_filter_graph_process_mt(m_graph, src, dst, tmp, unpack_cb, unpack_user, pack_cb, pack_user, threads));
+	}
+
+	zimg_filter_graph_context *create_context() const
+	{
+		zimg_filter_graph_context *ctx;
+
+		if (!(ctx = zimg2_filter_graph_context_create(m_graph)))
+			throw zerror();
+
+		return ctx;
+	}
+
 	static zimg_filter_graph *build(const zimg_image_format *src_format, const zimg_image_format *dst_format, const zimg_filter_graph_params *params = 0)
 	{
 		zimg_filter_graph *graph;
@@ -112,6 +178,45 @@ public:
 	}
 };
 
+class FilterGraphContext {
+private:
+	zimg_filter_graph_context *m_ctx;
+
+	FilterGraphContext(const FilterGraphContext &);
+
+	FilterGraphContext &operator=(const FilterGraphContext &);
+
+	void check(int x) const
+	{
+		if (x)
+			throw zerror();
+	}
+public:
+	explicit FilterGraphContext(zimg_filter_graph_context *ctx) : m_ctx(ctx)
+	{
+	}
+
+	~FilterGraphContext()
+	{
+		zimg2_filter_graph_context_free(m_ctx);
+	}
+
+	void process(const zimg_image_buffer_const *src, const zimg_image_buffer *dst,
+	             zimg_filter_graph_callback unpack_cb = 0, void *unpack_user = 0,
+	             zimg_filter_graph_callback pack_cb = 0, void *pack_user = 0)
+	{
+		check(zimg2_filter_graph_context_process(m_ctx, src, dst, unpack_cb, unpack_user, pack_cb, pack_user));
+	}
+
+	unsigned push_rows(const zimg_image_buffer_const *src, const zimg_image_buffer *dst, unsigned first_row, unsigned count,
+	                   zimg_filter_graph_callback pack_cb = 0, void *pack_user = 0)
+	{
+		unsigned ret;
+		check(zimg2_filter_graph_push_rows(m_ctx, src, dst, first_row, count, pack_cb, pack_user, &ret));
+		return ret;
+	}
+};
+
 } // namespace zimgxx
 
 #endif // ZIMG3PLUSPLUS_HPP_
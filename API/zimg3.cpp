@@ -5,6 +5,7 @@
 #include <tuple>
 #include <type_traits>
 #include <utility>
+#include <vector>
 #include "Common/cpuinfo.h"
 #include "Common/except.h"
 #include "Common/filtergraph.h"
@@ -19,6 +20,7 @@
 #include "Depth/depth2.h"
 #include "Resize/filter.h"
 #include "Resize/resize2.h"
+#include "Unresize/unresize2.h"
 #include "zimg3.h"
 
 #define API_VERSION_ASSERT(x) _zassert_d((x) >= 2 && (x) <= ZIMG_API_VERSION, "API version invalid")
@@ -141,7 +143,7 @@ typename Map::mapped_type search_itu_enum_map(const Map &map, const Key &key, co
 
 zimg::CPUClass translate_cpu(zimg_cpu_type_e cpu)
 {
-	static const zimg::static_enum_map<zimg_cpu_type_e, zimg::CPUClass, 12> map{
+	static const zimg::static_enum_map<zimg_cpu_type_e, zimg::CPUClass, 13> map{
 		{ ZIMG_CPU_NONE,      zimg::CPUClass::CPU_NONE },
 		{ ZIMG_CPU_AUTO,      zimg::CPUClass::CPU_AUTO },
 #ifdef ZIMG_X86
@@ -155,6 +157,7 @@ zimg::CPUClass translate_cpu(zimg_cpu_type_e cpu)
 		{ ZIMG_CPU_X86_AVX,   zimg::CPUClass::CPU_X86_SSE2 },
 		{ ZIMG_CPU_X86_F16C,  zimg::CPUClass::CPU_X86_SSE2 },
 		{ ZIMG_CPU_X86_AVX2,  zimg::CPUClass::CPU_X86_AVX2 },
+		{ ZIMG_CPU_X86_AVX512, zimg::CPUClass::CPU_X86_AVX512 },
 #endif
 	};
 	return search_enum_map(map, cpu, "unrecognized cpu type");
@@ -376,6 +379,38 @@ double luma_shift_factor(FieldParity parity, unsigned src_height, unsigned dst_h
 	return shift * (double)src_height / dst_height - shift;
 }
 
+// Descale the dimensions that shrink and resample the ones that grow, such as chroma converted to 4:4:4.
+std::pair<zimg::IZimgFilter *, zimg::IZimgFilter *> create_descale(
+	const zimg::resize::Filter &filter, zimg::PixelType type, unsigned depth, unsigned src_width, unsigned src_height, unsigned dst_width, unsigned dst_height,
+	double shift_w, double shift_h, double shift_up_w, double shift_up_h, zimg::CPUClass cpu)
+{
+	bool descale_w = dst_width <= src_width;
+	bool descale_h = dst_height <= src_height;
+
+	if (descale_w && descale_h)
+		return zimg::unresize::create_unresize2(filter, type, src_width, src_height, dst_width, dst_height, shift_up_w, shift_up_h, cpu);
+	if (!descale_w && !descale_h)
+		return zimg::resize::create_resize2(filter, type, depth, src_width, src_height, dst_width, dst_height, shift_w, shift_h, src_width, src_height, cpu);
+
+	unsigned mid_width = descale_w ? dst_width : src_width;
+	unsigned mid_height = descale_h ? dst_height : src_height;
+	double mid_shift_w = descale_w ? shift_up_w : 0.0;
+	double mid_shift_h = descale_h ? shift_up_h : 0.0;
+	std::unique_ptr<zimg::IZimgFilter> stage1;
+	std::unique_ptr<zimg::IZimgFilter> stage2;
+
+	if (mid_width != src_width || mid_height != src_height || mid_shift_w || mid_shift_h)
+		stage1.reset(zimg::unresize::create_unresize2(filter, type, src_width, src_height, mid_width, mid_height, mid_shift_w, mid_shift_h, cpu).first);
+
+	stage2.reset(zimg::resize::create_resize2(filter, type, depth, mid_width, mid_height, dst_width, dst_height,
+	                                          descale_w ? 0.0 : shift_w, descale_h ? 0.0 : shift_h, mid_width, mid_height, cpu).first);
+
+	if (!stage1)
+		return{ stage2.release(), nullptr };
+	else
+		return{ stage1.release(), stage2.release() };
+}
+
 class GraphBuilder {
 public:
 	struct params {
@@ -383,6 +418,9 @@ public:
 		std::unique_ptr<zimg::resize::Filter> filter_uv;
 		zimg::depth::DitherType dither_type;
 		zimg::CPUClass cpu;
+		unsigned tile_width;
+		bool enable_stats;
+		bool descale;
 	};
 
 	struct state {
@@ -461,15 +499,19 @@ private:
 	state m_state;
 	bool m_dirty;
 
-	zimg::PixelType select_working_type(const state &target) const
+	zimg::PixelType select_working_type(const state &target, const params *params) const
 	{
 		if (needs_colorspace(target)) {
 			return zimg::PixelType::FLOAT;
+		} else if (needs_resize(target) && params && params->descale) {
+			// Unresize operates on floating point data only.
+			return m_state.type == zimg::PixelType::HALF && target.type == zimg::PixelType::HALF ? zimg::PixelType::HALF : zimg::PixelType::FLOAT;
 		} else if (needs_resize(target)) {
+			// Bytes and halves are resized natively unless the output needs the extra precision.
 			if (m_state.type == zimg::PixelType::BYTE)
-				return zimg::PixelType::WORD;
+				return target.type == zimg::PixelType::BYTE ? zimg::PixelType::BYTE : zimg::PixelType::WORD;
 			else if (m_state.type == zimg::PixelType::HALF)
-				return zimg::PixelType::FLOAT;
+				return target.type == zimg::PixelType::HALF ? zimg::PixelType::HALF : zimg::PixelType::FLOAT;
 			else
 				return m_state.type;
 		} else {
@@ -538,12 +580,16 @@ private:
 		std::unique_ptr<zimg::IZimgFilter> filter_uv;
 		zimg::CPUClass cpu = params ? params->cpu : zimg::CPUClass::CPU_AUTO;
 
-		if (src_format == format)
-			return;
-
 		src_format.depth = m_state.depth;
 		src_format.fullrange = m_state.fullrange;
 
+		// Floating point formats compare equal regardless of depth and range, which must still be recorded.
+		if (src_format == format) {
+			m_state.depth = format.depth;
+			m_state.fullrange = format.fullrange;
+			return;
+		}
+
 		filter.reset(zimg::depth::create_depth2(dither_type, m_state.width, m_state.height, src_format, format, cpu));
 
 		if (m_state.is_yuv()) {
@@ -599,6 +645,7 @@ private:
 		const zimg::resize::Filter *resample_filter = params ? params->filter.get() : &bicubic_filter;
 		const zimg::resize::Filter *resample_filter_uv = params ? params->filter_uv.get() : &bilinear_filter;
 		zimg::CPUClass cpu = params ? params->cpu : zimg::CPUClass::CPU_AUTO;
+		bool descale = params && params->descale;
 
 		bool do_resize_luma = m_state.width != width || m_state.height != height;
 		bool do_resize_chroma = (m_state.width >> m_state.subsample_w != width >> subsample_w) ||
@@ -613,8 +660,18 @@ private:
 
 		if (do_resize_luma) {
 			double shift_h = luma_shift_factor(m_state.parity, m_state.height, height);
-			auto filter_pair = zimg::resize::create_resize2(*resample_filter, m_state.type, m_state.depth, m_state.width, m_state.height, width, height,
-			                                                0.0, shift_h, m_state.width, m_state.height, cpu);
+			std::pair<zimg::IZimgFilter *, zimg::IZimgFilter *> filter_pair;
+
+			if (descale) {
+				// Invert the upsampling from the output format, expressing its shift on the upsampled grid.
+				double shift_up_h = luma_shift_factor(m_state.parity, height, m_state.height) * m_state.height / height;
+
+				filter_pair = create_descale(*resample_filter, m_state.type, m_state.depth, m_state.width, m_state.height, width, height,
+				                             0.0, shift_h, 0.0, shift_up_h, cpu);
+			} else {
+				filter_pair = zimg::resize::create_resize2(*resample_filter, m_state.type, m_state.depth, m_state.width, m_state.height, width, height,
+				                                           0.0, shift_h, m_state.width, m_state.height, cpu);
+			}
 			filter1.reset(filter_pair.first);
 			filter2.reset(filter_pair.second);
 
@@ -641,8 +698,22 @@ private:
 			unsigned chroma_width_out = width >> subsample_w;
 			unsigned chroma_height_out = height >> subsample_h;
 
-			auto filter_pair = zimg::resize::create_resize2(*resample_filter_uv, m_state.type, m_state.depth, chroma_width_in, chroma_height_in, chroma_width_out, chroma_height_out,
-			                                                shift_w, shift_h, chroma_width_in, chroma_height_in, cpu);
+			std::pair<zimg::IZimgFilter *, zimg::IZimgFilter *> filter_pair;
+
+			if (descale) {
+				// As for luma, invert the upsampling from the output format.
+				double shift_up_w = chroma_shift_factor(chroma_location_w, m_state.chroma_location_w, subsample_w, m_state.subsample_w, m_state.parity, width, m_state.width);
+				double shift_up_h = chroma_shift_factor(chroma_location_h, m_state.chroma_location_h, subsample_h, m_state.subsample_h, m_state.parity, height, m_state.height);
+
+				shift_up_w = shift_up_w * chroma_width_in / chroma_width_out;
+				shift_up_h = shift_up_h * chroma_height_in / chroma_height_out;
+
+				filter_pair = create_descale(*resample_filter_uv, m_state.type, m_state.depth, chroma_width_in, chroma_height_in, chroma_width_out, chroma_height_out,
+				                             shift_w, shift_h, shift_up_w, shift_up_h, cpu);
+			} else {
+				filter_pair = zimg::resize::create_resize2(*resample_filter_uv, m_state.type, m_state.depth, chroma_width_in, chroma_height_in, chroma_width_out, chroma_height_out,
+				                                           shift_w, shift_h, chroma_width_in, chroma_height_in, cpu);
+			}
 			filter1_uv.reset(filter_pair.first);
 			filter2_uv.reset(filter_pair.second);
 		}
@@ -689,7 +760,11 @@ public:
 			throw zimg::error::NoColorspaceConversion{ "conversion between greyscale and color image not supported" };
 
 		target.validate();
-		convert_depth(zimg::default_pixel_format(select_working_type(target)), params);
+
+		zimg::PixelType working_type = select_working_type(target, params);
+
+		if (working_type != m_state.type)
+			convert_depth(zimg::default_pixel_format(working_type), params);
 
 		while (true) {
 			if (needs_colorspace(target)) {
@@ -711,6 +786,11 @@ public:
 			}
 		}
 
+		if (params) {
+			m_graph->set_tile_width(params->tile_width);
+			m_graph->set_stats_enabled(params->enable_stats);
+		}
+
 		m_graph->complete();
 		return m_graph.release();
 	}
@@ -790,6 +870,11 @@ GraphBuilder::params import_graph_params(const zimg_filter_graph_params &src)
 
 		params.cpu = translate_cpu(src.cpu_type);
 	}
+	if (src.version >= 3) {
+		params.tile_width = src.tile_width;
+		params.enable_stats = !!src.enable_stats;
+		params.descale = !!src.descale;
+	}
 
 	return params;
 }
@@ -858,6 +943,20 @@ zimg_error_code_e zimg2_filter_graph_get_tmp_size(const zimg_filter_graph *ptr,
 	EX_END
 }
 
+zimg_error_code_e zimg2_filter_graph_get_cache_size(const zimg_filter_graph *ptr, size_t *out, size_t *out_unshared)
+{
+	_zassert_d(ptr, "null pointer");
+	_zassert_d(out, "null pointer");
+	_zassert_d(out_unshared, "null pointer");
+
+	EX_BEGIN
+	const zimg::FilterGraph *graph = assert_dynamic_cast<const zimg::FilterGraph>(ptr);
+
+	*out = graph->get_cache_size();
+	*out_unshared = graph->get_cache_size_unshared();
+	EX_END
+}
+
 zimg_error_code_e zimg2_filter_graph_get_input_buffering(const zimg_filter_graph *ptr, unsigned *out)
 {
 	_zassert_d(ptr, "null pointer");
@@ -878,6 +977,16 @@ zimg_error_code_e zimg2_filter_graph_get_output_buffering(const zimg_filter_grap
 	EX_END
 }
 
+zimg_error_code_e zimg2_filter_graph_get_push_buffering(const zimg_filter_graph *ptr, unsigned slice_height, unsigned *out)
+{
+	_zassert_d(ptr, "null pointer");
+	_zassert_d(out, "null pointer");
+
+	EX_BEGIN
+	*out = assert_dynamic_cast<const zimg::FilterGraph>(ptr)->get_push_buffering(slice_height);
+	EX_END
+}
+
 zimg_error_code_e zimg2_filter_graph_process(const zimg_filter_graph *ptr, const zimg_image_buffer_const *src, const zimg_image_buffer *dst, void *tmp,
                                              zimg_filter_graph_callback unpack_cb, void *unpack_user,
                                              zimg_filter_graph_callback pack_cb, void *pack_user)
@@ -913,6 +1022,201 @@ zimg_error_code_e zimg2_filter_graph_process(const zimg_filter_graph *ptr, const
 	EX_END
 }
 
+zimg_error_code_e zimg2_filter_graph_process_region(const zimg_filter_graph *ptr, const zimg_image_buffer_const *src, const zimg_image_buffer *dst, void *tmp,
+                                                    unsigned left, unsigned top, unsigned right, unsigned bottom,
+                                                    zimg_filter_graph_callback unpack_cb, void *unpack_user,
+                                                    zimg_filter_graph_callback pack_cb, void *pack_user)
+{
+	_zassert_d(ptr, "null pointer");
+	_zassert_d(src, "null pointer");
+	_zassert_d(dst, "null pointer");
+
+	POINTER_ALIGNMENT_ASSERT(src->data[0]);
+	POINTER_ALIGNMENT_ASSERT(src->data[1]);
+	POINTER_ALIGNMENT_ASSERT(src->data[2]);
+
+	STRIDE_ALIGNMENT_ASSERT(src->stride[0]);
+	STRIDE_ALIGNMENT_ASSERT(src->stride[1]);
+	STRIDE_ALIGNMENT_ASSERT(src->stride[2]);
+
+	POINTER_ALIGNMENT_ASSERT(dst->m.data[0]);
+	POINTER_ALIGNMENT_ASSERT(dst->m.data[1]);
+	POINTER_ALIGNMENT_ASSERT(dst->m.data[2]);
+
+	STRIDE_ALIGNMENT_ASSERT(dst->m.stride[0]);
+	STRIDE_ALIGNMENT_ASSERT(dst->m.stride[1]);
+	STRIDE_ALIGNMENT_ASSERT(dst->m.stride[2]);
+
+	POINTER_ALIGNMENT_ASSERT(tmp);
+
+	EX_BEGIN
+	const zimg::FilterGraph *graph = assert_dynamic_cast<const zimg::FilterGraph>(ptr);
+	zimg::ZimgImageBufferConst src_buf = import_image_buffer(*src);
+	zimg::ZimgImageBuffer dst_buf = import_image_buffer(*dst);
+
+	graph->process_region(src_buf, dst_buf, tmp, left, top, right, bottom, { unpack_cb, unpack_user }, { pack_cb, pack_user });
+	EX_END
+}
+
+zimg_error_code_e zimg2_filter_graph_get_tmp_size_mt(const zimg_filter_graph *ptr, unsigned threads, size_t *out)
+{
+	_zassert_d(ptr, "null pointer");
+	_zassert_d(out, "null pointer");
+
+	EX_BEGIN
+	*out = assert_dynamic_cast<const zimg::FilterGraph>(ptr)->get_tmp_size_mt(threads);
+	EX_END
+}
+
+zimg_error_code_e zimg2_filter_graph_process_mt(const zimg_filter_graph *ptr, const zimg_image_buffer_const *src, const zimg_image_buffer *dst, void *tmp,
+                                                zimg_filter_graph_callback unpack_cb, void *unpack_user,
+                                                zimg_filter_graph_callback pack_cb, void *pack_user, unsigned threads)
+{
+	_zassert_d(ptr, "null pointer");
+	_zassert_d(src, "null pointer");
+	_zassert_d(dst, "null pointer");
+
+	POINTER_ALIGNMENT_ASSERT(src->data[0]);
+	POINTER_ALIGNMENT_ASSERT(src->data[1]);
+	POINTER_ALIGNMENT_ASSERT(src->data[2]);
+
+	STRIDE_ALIGNMENT_ASSERT(src->stride[0]);
+	STRIDE_ALIGNMENT_ASSERT(src->stride[1]);
+	STRIDE_ALIGNMENT_ASSERT(src->stride[2]);
+
+	POINTER_ALIGNMENT_ASSERT(dst->m.data[0]);
+	POINTER_ALIGNMENT_ASSERT(dst->m.data[1]);
+	POINTER_ALIGNMENT_ASSERT(dst->m.data[2]);
+
+	STRIDE_ALIGNMENT_ASSERT(dst->m.stride[0]);
+	STRIDE_ALIGNMENT_ASSERT(dst->m.stride[1]);
+	STRIDE_ALIGNMENT_ASSERT(dst->m.stride[2]);
+
+	POINTER_ALIGNMENT_ASSERT(tmp);
+
+	EX_BEGIN
+	const zimg::FilterGraph *graph = assert_dynamic_cast<const zimg::FilterGraph>(ptr);
+	zimg::ZimgImageBufferConst src_buf = import_image_buffer(*src);
+	zimg::ZimgImageBuffer dst_buf = import_image_buffer(*dst);
+
+	graph->process_mt(src_buf, dst_buf, tmp, { unpack_cb, unpack_user }, { pack_cb, pack_user }, threads);
+	EX_END
+}
+
+zimg_filter_graph_context *zimg2_filter_graph_context_create(const zimg_filter_graph *ptr)
+{
+	_zassert_d(ptr, "null pointer");
+
+	try {
+		return new zimg::FilterGraphContext{ *assert_dynamic_cast<const zimg::FilterGraph>(ptr) };
+	} catch (const zimg::error::Exception &) {
+		handle_exception(std::current_exception());
+		return nullptr;
+	} catch (const std::bad_alloc &e) {
+		handle_exception(e);
+		return nullptr;
+	}
+}
+
+void zimg2_filter_graph_context_free(zimg_filter_graph_context *ctx)
+{
+	delete ctx;
+}
+
+zimg_error_code_e zimg2_filter_graph_context_process(zimg_filter_graph_context *ctx, const zimg_image_buffer_const *src, const zimg_image_buffer *dst,
+                                                     zimg_filter_graph_callback unpack_cb, void *unpack_user,
+                                                     zimg_filter_graph_callback pack_cb, void *pack_user)
+{
+	_zassert_d(ctx, "null pointer");
+	_zassert_d(src, "null pointer");
+	_zassert_d(dst, "null pointer");
+
+	POINTER_ALIGNMENT_ASSERT(src->data[0]);
+	POINTER_ALIGNMENT_ASSERT(src->data[1]);
+	POINTER_ALIGNMENT_ASSERT(src->data[2]);
+
+	STRIDE_ALIGNMENT_ASSERT(src->stride[0]);
+	STRIDE_ALIGNMENT_ASSERT(src->stride[1]);
+	STRIDE_ALIGNMENT_ASSERT(src->stride[2]);
+
+	POINTER_ALIGNMENT_ASSERT(dst->m.data[0]);
+	POINTER_ALIGNMENT_ASSERT(dst->m.data[1]);
+	POINTER_ALIGNMENT_ASSERT(dst->m.data[2]);
+
+	STRIDE_ALIGNMENT_ASSERT(dst->m.stride[0]);
+	STRIDE_ALIGNMENT_ASSERT(dst->m.stride[1]);
+	STRIDE_ALIGNMENT_ASSERT(dst->m.stride[2]);
+
+	EX_BEGIN
+	zimg::FilterGraphContext *context = assert_dynamic_cast<zimg::FilterGraphContext>(ctx);
+	zimg::ZimgImageBufferConst src_buf = import_image_buffer(*src);
+	zimg::ZimgImageBuffer dst_buf = import_image_buffer(*dst);
+
+	context->process(src_buf, dst_buf, { unpack_cb, unpack_user }, { pack_cb, pack_user });
+	EX_END
+}
+
+zimg_error_code_e zimg2_filter_graph_push_rows(zimg_filter_graph_context *ctx, const zimg_image_buffer_const *src, const zimg_image_buffer *dst,
+                                               unsigned first_row, unsigned count,
+                                               zimg_filter_graph_callback pack_cb, void *pack_user, unsigned *out_rows)
+{
+	_zassert_d(ctx, "null pointer");
+	_zassert_d(src, "null pointer");
+	_zassert_d(dst, "null pointer");
+
+	POINTER_ALIGNMENT_ASSERT(src->data[0]);
+	POINTER_ALIGNMENT_ASSERT(src->data[1]);
+	POINTER_ALIGNMENT_ASSERT(src->data[2]);
+
+	STRIDE_ALIGNMENT_ASSERT(src->stride[0]);
+	STRIDE_ALIGNMENT_ASSERT(src->stride[1]);
+	STRIDE_ALIGNMENT_ASSERT(src->stride[2]);
+
+	POINTER_ALIGNMENT_ASSERT(dst->m.data[0]);
+	POINTER_ALIGNMENT_ASSERT(dst->m.data[1]);
+	POINTER_ALIGNMENT_ASSERT(dst->m.data[2]);
+
+	STRIDE_ALIGNMENT_ASSERT(dst->m.stride[0]);
+	STRIDE_ALIGNMENT_ASSERT(dst->m.stride[1]);
+	STRIDE_ALIGNMENT_ASSERT(dst->m.stride[2]);
+
+	EX_BEGIN
+	zimg::FilterGraphContext *context = assert_dynamic_cast<zimg::FilterGraphContext>(ctx);
+	zimg::ZimgImageBufferConst src_buf = import_image_buffer(*src);
+	zimg::ZimgImageBuffer dst_buf = import_image_buffer(*dst);
+	unsigned rows = context->push_rows(src_buf, dst_buf, first_row, count, { pack_cb, pack_user });
+
+	if (out_rows)
+		*out_rows = rows;
+	EX_END
+}
+
+zimg_error_code_e zimg2_filter_graph_get_stats(const zimg_filter_graph *ptr, zimg_filter_graph_stats *stats, unsigned *count)
+{
+	_zassert_d(ptr, "null pointer");
+	_zassert_d(count, "null pointer");
+
+	EX_BEGIN
+	std::vector<zimg::FilterGraph::node_stats> node_stats = assert_dynamic_cast<const zimg::FilterGraph>(ptr)->get_stats();
+
+	if (stats) {
+		*count = std::min(*count, (unsigned)node_stats.size());
+
+		for (unsigned n = 0; n < *count; ++n) {
+			stats[n].name = node_stats[n].name;
+			stats[n].calls = node_stats[n].calls;
+			stats[n].lines = node_stats[n].lines;
+			stats[n].bytes_read = node_stats[n].bytes_read;
+			stats[n].bytes_written = node_stats[n].bytes_written;
+			stats[n].cycles = node_stats[n].cycles;
+			stats[n].seconds = node_stats[n].seconds;
+		}
+	} else {
+		*count = (unsigned)node_stats.size();
+	}
+	EX_END
+}
+
 #undef EX_BEGIN
 #undef EX_END
 
@@ -964,6 +1268,11 @@ void zimg2_filter_graph_params_default(zimg_filter_graph_params *ptr, unsigned v
 
 		ptr->cpu_type = ZIMG_CPU_AUTO;
 	}
+	if (version >= 3) {
+		ptr->tile_width = 0;
+		ptr->enable_stats = 0;
+		ptr->descale = 0;
+	}
 }
 
 zimg_filter_graph *zimg2_filter_graph_build(const zimg_image_format *src_format, const zimg_image_format *dst_format, const zimg_filter_graph_params *params)
@@ -24,7 +24,7 @@ extern "C" {;
  * to the API version corresponding to its layout to ensure that the library
  * does not access memory beyond the end of the structure.
  */
-#define ZIMG_API_VERSION 2
+#define ZIMG_API_VERSION 3
 
 /**
  * Get the version number of the library.
@@ -150,6 +150,7 @@ typedef enum zimg_cpu_type_e {
 	ZIMG_CPU_X86_AVX   = 1007,
 	ZIMG_CPU_X86_F16C  = 1008, /**< AVX with F16C extension (e.g. Ivy Bridge) */
 	ZIMG_CPU_X86_AVX2  = 1009,
+	ZIMG_CPU_X86_AVX512 = 1010, /**< AVX-512 with F, BW and VL extensions (e.g. Skylake-SP) */
 #endif
 } zimg_cpu_type_e;
 
@@ -405,6 +406,21 @@ void zimg2_filter_graph_free(zimg_filter_graph *ptr);
  */
 zimg_error_code_e zimg2_filter_graph_get_tmp_size(const zimg_filter_graph *ptr, size_t *out);
 
+/**
+ * Query the portion of the temporary buffer used to hold intermediate lines.
+ *
+ * Intermediate line caches whose lifetimes do not overlap during processing
+ * share the same memory. The size that would be required without sharing
+ * is also reported.
+ *
+ * @pre out != 0 && out_unshared != 0
+ * @param ptr graph handle
+ * @param[out] out set to the size of the line caches in bytes
+ * @param[out] out_unshared set to the size of the line caches without sharing
+ * @return error code
+ */
+zimg_error_code_e zimg2_filter_graph_get_cache_size(const zimg_filter_graph *ptr, size_t *out, size_t *out_unshared);
+
 /**
  * Query the maximum number of lines required in the input buffer.
  *
@@ -430,6 +446,22 @@ zimg_error_code_e zimg2_filter_graph_get_input_buffering(const zimg_filter_graph
  */
 zimg_error_code_e zimg2_filter_graph_get_output_buffering(const zimg_filter_graph *ptr, unsigned *out);
 
+/**
+ * Query the minimum number of lines in an input ring buffer used with
+ * {@link zimg2_filter_graph_push_rows}.
+ *
+ * The result accounts for the lines still referenced by the graph in
+ * addition to a newly written slice. A value of UINT_MAX indicates that the
+ * entire image must be buffered.
+ *
+ * @pre out != 0
+ * @param ptr graph handle
+ * @param slice_height maximum number of lines pushed in a single call
+ * @param[out] out set to the number of scanlines
+ * @return error code
+ */
+zimg_error_code_e zimg2_filter_graph_get_push_buffering(const zimg_filter_graph *ptr, unsigned slice_height, unsigned *out);
+
 /**
  * Process an image with the filter graph.
  *
@@ -447,6 +479,196 @@ zimg_error_code_e zimg2_filter_graph_process(const zimg_filter_graph *ptr, const
                                              zimg_filter_graph_callback unpack_cb, void *unpack_user,
                                              zimg_filter_graph_callback pack_cb, void *pack_user);
 
+/**
+ * Process a rectangular region of the output image with the filter graph.
+ *
+ * Only the input required by the output region is read, and the work done
+ * is proportional to the size of the region. The region is expanded to
+ * whole chroma samples. If the graph contains filters which operate on
+ * entire rows, the full image width is processed, and if it contains
+ * filters carrying state between rows, processing begins at the top of the
+ * image. Output lines outside of the region may be modified.
+ *
+ * @see zimg2_filter_graph_process
+ *
+ * @param ptr graph handle
+ * @param[in] src input image buffer
+ * @param[out] dst output image buffer
+ * @param tmp temporary buffer (@see zimg2_filter_graph_get_tmp_size)
+ * @param left first column of the region
+ * @param top first row of the region
+ * @param right one past the last column of the region
+ * @param bottom one past the last row of the region
+ * @param unpack_cb user-defined input callback, may be NULL
+ * @param unpack_user private data for callback
+ * @param pack_cb user-defined output callback, may be NULL
+ * @param pack_user private data for callback
+ * @return error code
+ */
+zimg_error_code_e zimg2_filter_graph_process_region(const zimg_filter_graph *ptr, const zimg_image_buffer_const *src, const zimg_image_buffer *dst, void *tmp,
+                                                    unsigned left, unsigned top, unsigned right, unsigned bottom,
+                                                    zimg_filter_graph_callback unpack_cb, void *unpack_user,
+                                                    zimg_filter_graph_callback pack_cb, void *pack_user);
+
+/**
+ * Query the size of the temporary buffer required to execute the graph
+ * with {@link zimg2_filter_graph_process_mt}.
+ *
+ * @pre out != 0
+ * @param ptr graph handle
+ * @param threads number of worker threads, or 0 for hardware concurrency
+ * @param[out] out set to the size of the buffer in bytes
+ * @return error code
+ */
+zimg_error_code_e zimg2_filter_graph_get_tmp_size_mt(const zimg_filter_graph *ptr, unsigned threads, size_t *out);
+
+/**
+ * Process an image with the filter graph using multiple threads.
+ *
+ * The image is divided into column tiles which are distributed among the
+ * worker threads, each of which uses its own portion of the temporary
+ * buffer. The calling thread participates as one of the workers. If there
+ * are fewer tiles than threads, no filter in the graph carries state
+ * between rows, and no unpack callback is given, the tiles are further
+ * divided into horizontal bands, at the cost of recomputing the rows shared
+ * by adjacent bands. When no callback
+ * is given and the luma and chroma planes are processed by independent
+ * filter chains, the two chains run as separate work items.
+ *
+ * The user callbacks may be invoked concurrently from different threads
+ * for disjoint column ranges and must be reentrant. If either image buffer
+ * is not a full image plane (mask of UINT_MAX), the graph is executed on
+ * the calling thread as in {@link zimg2_filter_graph_process}.
+ *
+ * @see zimg2_filter_graph_process
+ *
+ * @param ptr graph handle
+ * @param[in] src input image buffer
+ * @param[out] dst output image buffer
+ * @param tmp temporary buffer (@see zimg2_filter_graph_get_tmp_size_mt)
+ * @param unpack_cb user-defined input callback, may be NULL
+ * @param unpack_user private data for callback
+ * @param pack_cb user-defined output callback, may be NULL
+ * @param pack_user private data for callback
+ * @param threads number of worker threads, or 0 for hardware concurrency
+ * @return error code
+ */
+zimg_error_code_e zimg2_filter_graph_process_mt(const zimg_filter_graph *ptr, const zimg_image_buffer_const *src, const zimg_image_buffer *dst, void *tmp,
+                                                zimg_filter_graph_callback unpack_cb, void *unpack_user,
+                                                zimg_filter_graph_callback pack_cb, void *pack_user, unsigned threads);
+
+/**
+ * Handle to a persistent execution context for a filter graph.
+ *
+ * The context owns the temporary buffer required by the graph, and retains
+ * the state derived from the graph between calls. This reduces the setup
+ * cost of each call when the same graph is used to process many images.
+ *
+ * A context may only be used by one thread at a time.
+ */
+typedef struct zimg_filter_graph_context zimg_filter_graph_context;
+
+/**
+ * Create an execution context for a filter graph.
+ *
+ * Upon failure, a NULL pointer is returned. The graph must not be deleted
+ * before the context.
+ *
+ * @param ptr graph handle
+ * @return context handle, or NULL on failure
+ */
+zimg_filter_graph_context *zimg2_filter_graph_context_create(const zimg_filter_graph *ptr);
+
+/**
+ * Delete the execution context.
+ *
+ * @param ctx context handle, may be NULL
+ */
+void zimg2_filter_graph_context_free(zimg_filter_graph_context *ctx);
+
+/**
+ * Process an image with the filter graph using an execution context.
+ *
+ * @see zimg2_filter_graph_process
+ *
+ * @param ctx context handle
+ * @param[in] src input image buffer
+ * @param[out] dst output image buffer
+ * @param unpack_cb user-defined input callback, may be NULL
+ * @param unpack_user private data for callback
+ * @param pack_cb user-defined output callback, may be NULL
+ * @param pack_user private data for callback
+ * @return error code
+ */
+zimg_error_code_e zimg2_filter_graph_context_process(zimg_filter_graph_context *ctx, const zimg_image_buffer_const *src, const zimg_image_buffer *dst,
+                                                     zimg_filter_graph_callback unpack_cb, void *unpack_user,
+                                                     zimg_filter_graph_callback pack_cb, void *pack_user);
+
+/**
+ * Supply a slice of input lines to the filter graph.
+ *
+ * Instead of reading the input through a callback, the caller pushes the
+ * lines of the image in order as they become available, and the graph
+ * produces every output line that depends only on the lines pushed so far.
+ * Pushing the first line of the image starts a new frame. The slice
+ * boundaries must be aligned to the vertical subsampling of the input,
+ * except at the bottom of the image.
+ *
+ * The input buffer may be a ring buffer of at least the size returned by
+ * {@link zimg2_filter_graph_get_push_buffering}, with lines stored at their
+ * row index modulo the buffer mask. Completed output lines are signalled
+ * through the pack callback, which is invoked for the entire image width.
+ *
+ * @param ctx context handle
+ * @param[in] src input image buffer containing the pushed lines
+ * @param[out] dst output image buffer
+ * @param first_row index of the first pushed line
+ * @param count number of lines pushed
+ * @param pack_cb user-defined output callback, may be NULL
+ * @param pack_user private data for callback
+ * @param[out] out_rows set to the number of completed output lines, may be NULL
+ * @return error code
+ */
+zimg_error_code_e zimg2_filter_graph_push_rows(zimg_filter_graph_context *ctx, const zimg_image_buffer_const *src, const zimg_image_buffer *dst,
+                                               unsigned first_row, unsigned count,
+                                               zimg_filter_graph_callback pack_cb, void *pack_user, unsigned *out_rows);
+
+/**
+ * Execution statistics for a filter in the graph.
+ *
+ * The counters are accumulated over all calls to the processing functions
+ * since the graph was created. A line is counted once for each column tile
+ * in which it is produced.
+ */
+typedef struct zimg_filter_graph_stats {
+	const char *name;                 /**< Filter type name and configuration (e.g. resize order), valid for the lifetime of the graph. */
+	unsigned long long calls;         /**< Number of invocations of the filter. */
+	unsigned long long lines;         /**< Number of lines produced. */
+	unsigned long long bytes_read;    /**< Bytes of input image data read. */
+	unsigned long long bytes_written; /**< Bytes of output image data written. */
+	unsigned long long cycles;        /**< Elapsed processor time-stamp counter ticks, or 0 if unavailable. */
+	double seconds;                   /**< Elapsed wall-clock time in seconds. */
+} zimg_filter_graph_stats;
+
+/**
+ * Retrieve per-filter execution statistics.
+ *
+ * Statistics are only collected if requested by the {@p enable_stats} field
+ * of {@link zimg_filter_graph_params}. Otherwise, the graph reports zero
+ * filters. The filters are listed in order of attachment to the graph.
+ *
+ * If {@p stats} is NULL, the number of filters is returned in {@p count}.
+ * Otherwise, up to {@p count} entries are written and {@p count} is set to
+ * the number of entries written.
+ *
+ * @pre count != 0
+ * @param ptr graph handle
+ * @param[out] stats array of statistics, may be NULL
+ * @param[in,out] count number of entries
+ * @return error code
+ */
+zimg_error_code_e zimg2_filter_graph_get_stats(const zimg_filter_graph *ptr, zimg_filter_graph_stats *stats, unsigned *count);
+
 
 /**
  * Image format descriptor.
@@ -504,6 +726,42 @@ typedef struct zimg_filter_graph_params {
 	zimg_dither_type_e dither_type;            /**< Dithering method (default ZIMG_DITHER_NONE). */
 
 	zimg_cpu_type_e cpu_type;                  /**< Target CPU architecture (default (ZIMG_CPU_AUTO). */
+
+	/**
+	 * Width of the column tiles processed by the graph, in output pixels.
+	 *
+	 * The value is rounded up to the CPU alignment. It has no effect on graphs
+	 * containing filters that operate on entire rows.
+	 *
+	 * The default value is 0, which selects a width such that the working set
+	 * of the graph fits in the L2 cache of the CPU.
+	 *
+	 * @since API version 3
+	 */
+	unsigned tile_width;
+
+	/**
+	 * Collect per-filter execution statistics (default 0).
+	 *
+	 * Filters that would otherwise be fused into a single pass are executed
+	 * separately, so that each can be measured.
+	 *
+	 * @see zimg2_filter_graph_get_stats
+	 * @since API version 3
+	 */
+	char enable_stats;
+
+	/**
+	 * Invert an upsampling instead of resampling (default 0).
+	 *
+	 * The image is resized by the least-squares solution to the upsampling,
+	 * which recovers an image that was previously enlarged with the same
+	 * resampling filters and parameters. Dimensions that grow, such as chroma
+	 * converted to 4:4:4, are resampled as usual.
+	 *
+	 * @since API version 3
+	 */
+	char descale;
 } zimg_filter_graph_params;
 
 /**
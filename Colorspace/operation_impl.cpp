@@ -193,7 +193,7 @@ Operation *create_matrix_operation(const Matrix3x3 &m, CPUClass cpu)
 {
 	Operation *ret = nullptr;
 #ifdef ZIMG_X86
-//	ret = create_matrix_operation_x86(m, cpu);
+	ret = create_matrix_operation_x86(m, cpu);
 #endif
 	if (!ret)
 		ret = new MatrixOperationC{ m };
@@ -108,9 +108,9 @@ public:
 		__m256 c22 = _mm256_set1_ps(m_matrix[2][2]);
 
 		for (int i = 0; i < mod(width, 8); i += 8) {
-			__m256 a = _mm256_load_ps(&ptr[0][i]);
-			__m256 b = _mm256_load_ps(&ptr[1][i]);
-			__m256 c = _mm256_load_ps(&ptr[2][i]);
+			__m256 a = _mm256_loadu_ps(&ptr[0][i]);
+			__m256 b = _mm256_loadu_ps(&ptr[1][i]);
+			__m256 c = _mm256_loadu_ps(&ptr[2][i]);
 
 			__m256 x = _mm256_mul_ps(c00, a);
 			__m256 y = _mm256_mul_ps(c10, a);
@@ -125,9 +125,9 @@ public:
 			z = _mm256_fmadd_ps(c21, b, z);
 			z = _mm256_fmadd_ps(c22, c, z);
 
-			_mm256_store_ps(&ptr[0][i], x);
-			_mm256_store_ps(&ptr[1][i], y);
-			_mm256_store_ps(&ptr[2][i], z);
+			_mm256_storeu_ps(&ptr[0][i], x);
+			_mm256_storeu_ps(&ptr[1][i], y);
+			_mm256_storeu_ps(&ptr[2][i], z);
 		}
 		for (int i = mod(width, 8); i < width; ++i) {
 			float a, b, c;
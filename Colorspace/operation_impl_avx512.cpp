@@ -0,0 +1,75 @@
+#ifdef ZIMG_X86
+
+#include <immintrin.h>
+#include "Common/osdep.h"
+#include "matrix3.h"
+#include "operation.h"
+#include "operation_impl.h"
+#include "operation_impl_x86.h"
+
+namespace zimg {;
+namespace colorspace {;
+
+namespace {;
+
+inline FORCE_INLINE __mmask16 tail_mask16(int n)
+{
+	return n >= 16 ? 0xFFFFU : (__mmask16)((1U << n) - 1);
+}
+
+class MatrixOperationAVX512 : public MatrixOperationImpl {
+public:
+	explicit MatrixOperationAVX512(const Matrix3x3 &m) : MatrixOperationImpl(m)
+	{}
+
+	void process(float * const *ptr, int width) const override
+	{
+		__m512 c00 = _mm512_set1_ps(m_matrix[0][0]);
+		__m512 c01 = _mm512_set1_ps(m_matrix[0][1]);
+		__m512 c02 = _mm512_set1_ps(m_matrix[0][2]);
+		__m512 c10 = _mm512_set1_ps(m_matrix[1][0]);
+		__m512 c11 = _mm512_set1_ps(m_matrix[1][1]);
+		__m512 c12 = _mm512_set1_ps(m_matrix[1][2]);
+		__m512 c20 = _mm512_set1_ps(m_matrix[2][0]);
+		__m512 c21 = _mm512_set1_ps(m_matrix[2][1]);
+		__m512 c22 = _mm512_set1_ps(m_matrix[2][2]);
+
+		for (int i = 0; i < width; i += 16) {
+			__mmask16 mask = tail_mask16(width - i);
+
+			__m512 a = _mm512_maskz_loadu_ps(mask, &ptr[0][i]);
+			__m512 b = _mm512_maskz_loadu_ps(mask, &ptr[1][i]);
+			__m512 c = _mm512_maskz_loadu_ps(mask, &ptr[2][i]);
+
+			__m512 x = _mm512_mul_ps(c00, a);
+			__m512 y = _mm512_mul_ps(c10, a);
+			__m512 z = _mm512_mul_ps(c20, a);
+
+			x = _mm512_fmadd_ps(c01, b, x);
+			x = _mm512_fmadd_ps(c02, c, x);
+
+			y = _mm512_fmadd_ps(c11, b, y);
+			y = _mm512_fmadd_ps(c12, c, y);
+
+			z = _mm512_fmadd_ps(c21, b, z);
+			z = _mm512_fmadd_ps(c22, c, z);
+
+			_mm512_mask_storeu_ps(&ptr[0][i], mask, x);
+			_mm512_mask_storeu_ps(&ptr[1][i], mask, y);
+			_mm512_mask_storeu_ps(&ptr[2][i], mask, z);
+		}
+	}
+};
+
+} // namespace
+
+
+Operation *create_matrix_operation_avx512(const Matrix3x3 &m)
+{
+	return new MatrixOperationAVX512{ m };
+}
+
+} // namespace colorspace
+} // namespace zimg
+
+#endif // ZIMG_X86
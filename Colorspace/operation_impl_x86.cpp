@@ -31,12 +31,16 @@ Operation *create_matrix_operation_x86(const Matrix3x3 &m, CPUClass cpu)
 	Operation *ret;
 
 	if (cpu == CPUClass::CPU_AUTO) {
-		if (caps.avx2)
+		if (caps.avx512f && caps.avx512bw && caps.avx512vl)
+			ret = create_matrix_operation_avx512(m);
+		else if (caps.avx2 && caps.fma)
 			ret = create_matrix_operation_avx2(m);
 		else if (caps.sse2)
 			ret = create_matrix_operation_sse2(m);
 		else
 			ret = nullptr;
+	} else if (cpu >= CPUClass::CPU_X86_AVX512) {
+		ret = create_matrix_operation_avx512(m);
 	} else if (cpu >= CPUClass::CPU_X86_AVX2) {
 		ret = create_matrix_operation_avx2(m);
 	} else if (cpu >= CPUClass::CPU_X86_SSE2) {
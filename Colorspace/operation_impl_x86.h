@@ -20,6 +20,7 @@ PixelAdapter *create_pixel_adapter_avx2();
 
 Operation *create_matrix_operation_sse2(const Matrix3x3 &m);
 Operation *create_matrix_operation_avx2(const Matrix3x3 &m);
+Operation *create_matrix_operation_avx512(const Matrix3x3 &m);
 
 Operation *create_rec709_gamma_operation_avx2();
 Operation *create_rec709_inverse_gamma_operation_avx2();
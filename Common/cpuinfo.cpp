@@ -0,0 +1,125 @@
+#include <cstdio>
+#include "cpuinfo.h"
+
+namespace zimg {;
+
+namespace {;
+
+const unsigned long DEFAULT_L2_CACHE_SIZE = 256 * 1024UL;
+
+#ifdef ZIMG_X86
+unsigned long query_l2_cache_size_x86()
+{
+	int regs[4] = { 0 };
+	unsigned max_leaf;
+	unsigned max_ext_leaf;
+
+	do_cpuid(regs, 0, 0);
+	max_leaf = regs[0];
+
+	// Deterministic cache parameters (Intel).
+	if (max_leaf >= 4) {
+		for (int i = 0; i < 16; ++i) {
+			do_cpuid(regs, 4, i);
+
+			unsigned type = regs[0] & 0x1F;
+			unsigned level = (regs[0] >> 5) & 0x07;
+
+			if (type == 0)
+				break;
+			if (level != 2 || type == 2)
+				continue;
+
+			unsigned long ways = ((unsigned)regs[1] >> 22) + 1;
+			unsigned long partitions = (((unsigned)regs[1] >> 12) & 0x3FF) + 1;
+			unsigned long line_size = ((unsigned)regs[1] & 0xFFF) + 1;
+			unsigned long sets = (unsigned)regs[2] + 1UL;
+
+			return ways * partitions * line_size * sets;
+		}
+	}
+
+	// Extended L2 cache features (AMD).
+	do_cpuid(regs, 0x80000000U, 0);
+	max_ext_leaf = regs[0];
+
+	if (max_ext_leaf >= 0x80000006U) {
+		do_cpuid(regs, 0x80000006U, 0);
+
+		if ((unsigned)regs[2] >> 16)
+			return ((unsigned long)regs[2] >> 16) * 1024UL;
+	}
+
+	return 0;
+}
+#endif // ZIMG_X86
+
+#ifdef __linux__
+unsigned long query_l2_cache_size_sysfs()
+{
+	unsigned long size = 0;
+
+	for (int i = 0; i < 8 && !size; ++i) {
+		char path[128];
+		char buf[32] = { 0 };
+		unsigned level = 0;
+		unsigned long value = 0;
+		char suffix = 0;
+		FILE *f;
+
+		sprintf(path, "/sys/devices/system/cpu/cpu0/cache/index%d/level", i);
+		if (!(f = fopen(path, "r")))
+			break;
+		if (fscanf(f, "%u", &level) != 1)
+			level = 0;
+		fclose(f);
+
+		if (level != 2)
+			continue;
+
+		sprintf(path, "/sys/devices/system/cpu/cpu0/cache/index%d/type", i);
+		if ((f = fopen(path, "r"))) {
+			if (fscanf(f, "%31s", buf) != 1)
+				buf[0] = '\0';
+			fclose(f);
+		}
+		if (buf[0] == 'I')
+			continue;
+
+		sprintf(path, "/sys/devices/system/cpu/cpu0/cache/index%d/size", i);
+		if (!(f = fopen(path, "r")))
+			continue;
+		if (fscanf(f, "%lu%c", &value, &suffix) >= 1)
+			size = value * (suffix == 'K' ? 1024UL : suffix == 'M' ? 1024UL * 1024UL : 1UL);
+		fclose(f);
+	}
+
+	return size;
+}
+#endif // __linux__
+
+unsigned long detect_l2_cache_size()
+{
+	unsigned long size = 0;
+
+#ifdef ZIMG_X86
+	size = query_l2_cache_size_x86();
+#endif
+#ifdef __linux__
+	if (!size)
+		size = query_l2_cache_size_sysfs();
+#endif
+
+	return size ? size : DEFAULT_L2_CACHE_SIZE;
+}
+
+} // namespace
+
+
+unsigned long query_l2_cache_size()
+{
+	static const unsigned long l2_cache_size = detect_l2_cache_size();
+	return l2_cache_size;
+}
+
+} // namespace zimg
@@ -21,10 +21,20 @@ enum class CPUClass {
 	CPU_AUTO,
 #ifdef ZIMG_X86
 	CPU_X86_SSE2,
-	CPU_X86_AVX2
+	CPU_X86_AVX2,
+	CPU_X86_AVX512
 #endif // ZIMG_X86
 };
 
+/**
+ * Get the size of the level 2 data cache on the current CPU.
+ *
+ * If the size can not be determined, a conservative default is returned.
+ *
+ * @return cache size in bytes
+ */
+unsigned long query_l2_cache_size();
+
 
 #ifdef ZIMG_X86
 
@@ -42,6 +52,10 @@ struct X86Capabilities {
 	unsigned avx   : 1;
 	unsigned f16c  : 1;
 	unsigned avx2  : 1;
+	unsigned avx512f  : 1;
+	unsigned avx512dq : 1;
+	unsigned avx512bw : 1;
+	unsigned avx512vl : 1;
 };
 
 /**
@@ -65,6 +79,25 @@ inline void do_cpuid(int regs[4], int eax, int ecx)
 #endif
 }
 
+/**
+ * Read an extended control register.
+ *
+ * @param ecx register index
+ * @return register contents, or 0 if not supported by the compiler
+ */
+inline unsigned long long do_xgetbv(unsigned ecx)
+{
+#if defined(_MSC_VER)
+	return _xgetbv(ecx);
+#elif defined(__GNUC__)
+	unsigned eax, edx;
+	__asm__ volatile("xgetbv" : "=a"(eax), "=d"(edx) : "c"(ecx));
+	return ((unsigned long long)edx << 32) | eax;
+#else
+	return 0;
+#endif
+}
+
 /**
  * Get the x86 feature flags on the current CPU.
  *
@@ -86,12 +119,35 @@ inline X86Capabilities query_x86_capabilities()
 	caps.avx   = !!(regs[2] & (1 << 28));
 	caps.f16c  = !!(regs[2] & (1 << 29));
 
+	// The OS must save the opmask and ZMM registers for AVX-512.
+	bool zmm_state = (regs[2] & (1 << 27)) && (do_xgetbv(0) & 0xE6) == 0xE6;
+
 	do_cpuid(regs, 7, 0);
-	caps.avx2 = !!(regs[1] & (1 << 5));
+	caps.avx2     = !!(regs[1] & (1 << 5));
+	caps.avx512f  = zmm_state && (regs[1] & (1 << 16));
+	caps.avx512dq = zmm_state && (regs[1] & (1 << 17));
+	caps.avx512bw = zmm_state && (regs[1] & (1 << 30));
+	caps.avx512vl = zmm_state && (regs[1] & (1U << 31));
 
 	return caps;
 }
 
+/**
+ * Read the processor time-stamp counter.
+ *
+ * @return counter value, or 0 if not supported by the compiler
+ */
+inline unsigned long long read_tsc()
+{
+#if defined(_MSC_VER)
+	return __rdtsc();
+#elif defined(__GNUC__)
+	return __builtin_ia32_rdtsc();
+#else
+	return 0;
+#endif
+}
+
 #endif // ZIMG_X86
 
 } // namespace zimg
@@ -1,11 +1,28 @@
 #include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
 #include <cstdint>
+#include <cstdlib>
+#include <exception>
+#include <mutex>
+#include <string>
+#include <system_error>
+#include <thread>
+#include <typeinfo>
+#include <utility>
 #include <vector>
+
+#ifdef __GNUC__
+  #include <cxxabi.h>
+#endif
 #include "align.h"
 #include "alloc.h"
 #include "copy_filter.h"
+#include "cpuinfo.h"
 #include "except.h"
 #include "filtergraph.h"
+#include "fused_filter.h"
 #include "linebuffer.h"
 #include "pixel.h"
 #include "zassert.h"
@@ -14,10 +31,100 @@
 namespace zimg {;
 namespace {;
 
+unsigned get_thread_count(unsigned threads)
+{
+	if (!threads)
+		threads = std::thread::hardware_concurrency();
+
+	return std::max(threads, 1U);
+}
+
+std::string demangle(const char *name)
+{
+#ifdef __GNUC__
+	int status;
+	char *demangled = abi::__cxa_demangle(name, nullptr, nullptr, &status);
+
+	if (demangled) {
+		std::string ret = demangled;
+		free(demangled);
+		return ret;
+	}
+#endif
+	return name;
+}
+
+
+struct StatsCounter {
+	unsigned long long calls;
+	unsigned long long lines;
+	unsigned long long bytes_read;
+	unsigned long long bytes_written;
+	unsigned long long cycles;
+	unsigned long long nanoseconds;
+};
+
+class StatsTimer {
+	StatsCounter *m_stats;
+	std::chrono::steady_clock::time_point m_time;
+	unsigned long long m_cycles;
+
+	static unsigned long long get_cycles()
+	{
+#ifdef ZIMG_X86
+		return read_tsc();
+#else
+		return 0;
+#endif
+	}
+public:
+	explicit StatsTimer(StatsCounter *stats) :
+		m_stats{ stats },
+		m_time{},
+		m_cycles{}
+	{
+		if (m_stats) {
+			m_time = std::chrono::steady_clock::now();
+			m_cycles = get_cycles();
+		}
+	}
+
+	~StatsTimer()
+	{
+		if (m_stats) {
+			m_stats->cycles += get_cycles() - m_cycles;
+			m_stats->nanoseconds += std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - m_time).count();
+		}
+	}
+};
+
+
+class GraphNode;
+
+struct ScheduleStep {
+	GraphNode *node;
+	unsigned row;
+};
+
+struct PushState {
+	size_t pos;
+	unsigned input_row;
+	unsigned output_row;
+};
+
 class SimulationState {
+	struct line_lifetimes {
+		unsigned base;
+		std::vector<std::pair<unsigned, unsigned>> lines;
+	};
+
 	std::vector<unsigned> m_cache_pos;
+	std::vector<line_lifetimes> m_lifetimes;
+	std::vector<ScheduleStep> m_schedule;
 public:
-	explicit SimulationState(unsigned size) : m_cache_pos(size)
+	explicit SimulationState(unsigned size) :
+		m_cache_pos(size),
+		m_lifetimes(size)
 	{
 	}
 
@@ -25,6 +132,75 @@ public:
 	{
 		return m_cache_pos[id];
 	}
+
+	const std::vector<unsigned> &positions() const
+	{
+		return m_cache_pos;
+	}
+
+	void clear_positions()
+	{
+		std::fill(m_cache_pos.begin(), m_cache_pos.end(), (unsigned)-1);
+	}
+
+	unsigned tick(GraphNode *node, unsigned row)
+	{
+		m_schedule.push_back({ node, row });
+		return (unsigned)(m_schedule.size() - 1);
+	}
+
+	unsigned time() const
+	{
+		return (unsigned)m_schedule.size();
+	}
+
+	void write(unsigned id, unsigned first, unsigned last, unsigned time)
+	{
+		line_lifetimes &lifetimes = m_lifetimes[id];
+
+		if (lifetimes.lines.empty())
+			lifetimes.base = first;
+		if (lifetimes.lines.size() < last - lifetimes.base)
+			lifetimes.lines.resize(last - lifetimes.base, { -1, 0 });
+
+		for (unsigned i = first; i < last; ++i) {
+			lifetimes.lines[i - lifetimes.base] = { time, time };
+		}
+	}
+
+	void read(unsigned id, unsigned first, unsigned last, unsigned time)
+	{
+		line_lifetimes &lifetimes = m_lifetimes[id];
+
+		// Lines produced before the simulation began are not tracked.
+		for (unsigned i = std::max(first, lifetimes.base); i < last && i - lifetimes.base < lifetimes.lines.size(); ++i) {
+			auto &line = lifetimes.lines[i - lifetimes.base];
+			line.second = std::max(line.second, time);
+		}
+	}
+
+	// Disjoint intervals of the schedule during which any line of the cache is live.
+	std::vector<std::pair<unsigned, unsigned>> live_intervals(unsigned id) const
+	{
+		std::vector<std::pair<unsigned, unsigned>> intervals;
+
+		for (const auto &line : m_lifetimes[id].lines) {
+			if (line.first == (unsigned)-1)
+				continue;
+
+			if (!intervals.empty() && line.first <= intervals.back().second)
+				intervals.back().second = std::max(intervals.back().second, line.second);
+			else
+				intervals.push_back(line);
+		}
+
+		return intervals;
+	}
+
+	std::vector<ScheduleStep> &schedule()
+	{
+		return m_schedule;
+	}
 };
 
 class ExecutionState {
@@ -34,17 +210,30 @@ class ExecutionState {
 	FilterGraph::callback m_unpack_cb;
 	FilterGraph::callback m_pack_cb;
 	void **m_context_table;
+	char *m_cache_base;
+	StatsCounter *m_stats;
 	void *m_base;
 public:
-	ExecutionState(unsigned id_counter, const ZimgImageBufferConst &src_buf, const ZimgImageBuffer &dst_buf, void *pool,
-	               FilterGraph::callback unpack_cb, FilterGraph::callback pack_cb) :
+	explicit ExecutionState(void *pool) :
 		m_alloc{ pool },
-		m_src_buf{ &src_buf },
-		m_dst_buf{ &dst_buf },
-		m_unpack_cb{ unpack_cb },
-		m_pack_cb{ pack_cb },
+		m_src_buf{},
+		m_dst_buf{},
 		m_context_table{},
+		m_cache_base{},
+		m_stats{},
 		m_base{ pool }
+	{
+	}
+
+	void set_buffers(const ZimgImageBufferConst &src_buf, const ZimgImageBuffer &dst_buf, FilterGraph::callback unpack_cb, FilterGraph::callback pack_cb)
+	{
+		m_src_buf = &src_buf;
+		m_dst_buf = &dst_buf;
+		m_unpack_cb = unpack_cb;
+		m_pack_cb = pack_cb;
+	}
+
+	void alloc_context_table(unsigned id_counter)
 	{
 		m_context_table = m_alloc.allocate_n<void *>(id_counter);
 		std::fill_n(m_context_table, id_counter, nullptr);
@@ -63,6 +252,27 @@ public:
 		return m_context_table[id];
 	}
 
+	void alloc_cache(size_t size)
+	{
+		m_cache_base = m_alloc.allocate<char>(size);
+	}
+
+	void *get_cache(size_t offset) const
+	{
+		return m_cache_base + offset;
+	}
+
+	void alloc_stats(unsigned id_counter)
+	{
+		m_stats = m_alloc.allocate_n<StatsCounter>(id_counter);
+		std::fill_n(m_stats, id_counter, StatsCounter{});
+	}
+
+	StatsCounter *get_stats(unsigned id) const
+	{
+		return m_stats ? m_stats + id : nullptr;
+	}
+
 	const ZimgImageBufferConst &get_input_buffer() const
 	{
 		return *m_src_buf;
@@ -145,10 +355,12 @@ public:
 	static const filter_uv_tag FILTER_UV;
 private:
 	std::unique_ptr<IZimgFilter> m_filter;
+	size_t m_cache_offset;
 	unsigned m_cache_lines;
 	unsigned m_ref_count;
 	unsigned m_id;
 	bool m_is_source;
+	bool m_is_output;
 
 	unsigned get_num_planes() const
 	{
@@ -187,8 +399,9 @@ private:
 		first <<= uv ? m_data.source_info.subsample_h : 0;
 		last <<= uv ? m_data.source_info.subsample_h : 0;
 
-		if (pos < last)
-			pos = mod(last - 1, step) + step;
+		for (; pos < last; pos += step) {
+			sim->tick(this, pos);
+		}
 
 		sim->pos(m_id) = pos;
 		set_cache_lines(pos - first);
@@ -196,12 +409,17 @@ private:
 
 	void simulate_node_uv(SimulationState *sim, unsigned first, unsigned last)
 	{
+		unsigned height = m_filter->get_image_attributes().height;
 		unsigned pos = sim->pos(m_id);
 
 		for (; pos < last; pos += m_data.node_info.step) {
 			auto range = m_filter->get_required_row_range(pos);
 
 			m_data.node_info.parent->simulate(sim, range.first, range.second, true);
+
+			unsigned time = sim->tick(this, pos);
+			sim->write(m_id, pos, std::min(pos + m_data.node_info.step, height), time);
+			sim->read(m_data.node_info.parent->m_id, range.first, range.second, time);
 		}
 
 		sim->pos(m_id) = pos;
@@ -210,6 +428,7 @@ private:
 
 	void simulate_node(SimulationState *sim, unsigned first, unsigned last)
 	{
+		unsigned height = m_filter->get_image_attributes().height;
 		unsigned pos = sim->pos(m_id);
 
 		for (; pos < last; pos += m_data.node_info.step) {
@@ -219,40 +438,59 @@ private:
 
 			if (m_data.node_info.parent_uv)
 				m_data.node_info.parent_uv->simulate(sim, range.first, range.second, true);
+
+			unsigned time = sim->tick(this, pos);
+			sim->write(m_id, pos, std::min(pos + m_data.node_info.step, height), time);
+			sim->read(m_data.node_info.parent->m_id, range.first, range.second, time);
+
+			if (m_data.node_info.parent_uv)
+				sim->read(m_data.node_info.parent_uv->m_id, range.first, range.second, time);
 		}
 
 		sim->pos(m_id) = pos;
 		set_cache_lines(pos - first);
 	}
 
-	void init_context_node_uv(LinearAllocator &alloc, node_context *context) const
+	void init_cache(ExecutionState *state, node_context *context) const
 	{
-		size_t filter_context_size = m_filter->get_context_size();
-		ptrdiff_t stride = get_cache_stride();
-		unsigned cache_lines = get_real_cache_lines();
+		if (m_is_output)
+			return;
 
-		context->filter_ctx = alloc.allocate(filter_context_size);
-		context->filter_ctx2 = alloc.allocate(filter_context_size);
+		char *cache = static_cast<char *>(state->get_cache(m_cache_offset));
+		ptrdiff_t stride = get_cache_stride();
+		size_t plane_size = (size_t)get_real_cache_lines() * stride;
 
-		for (unsigned p = 1; p < 3; ++p) {
-			context->cache_buf.data[p] = alloc.allocate((size_t)cache_lines * stride);
+		for (unsigned p = m_data.node_info.is_uv ? 1 : 0; p < (m_data.node_info.is_uv ? 3 : get_num_planes()); ++p) {
+			context->cache_buf.data[p] = cache;
 			context->cache_buf.stride[p] = stride;
 			context->cache_buf.mask[p] = select_zimg_buffer_mask(m_cache_lines);
+			cache += plane_size;
 		}
 	}
 
-	void init_context_node(LinearAllocator &alloc, node_context *context) const
+	void init_context_node_uv(ExecutionState *state, LinearAllocator &alloc, node_context *context) const
 	{
-		ptrdiff_t stride = get_cache_stride();
-		unsigned cache_lines = get_real_cache_lines();
+		size_t filter_context_size = m_filter->get_context_size();
+
+		context->filter_ctx = alloc.allocate(filter_context_size);
+		context->filter_ctx2 = alloc.allocate(filter_context_size);
 
+		init_cache(state, context);
+	}
+
+	void init_context_node(ExecutionState *state, LinearAllocator &alloc, node_context *context) const
+	{
 		context->filter_ctx = alloc.allocate(m_filter->get_context_size());
 
-		for (unsigned p = 0; p < get_num_planes(); ++p) {
-			context->cache_buf.data[p] = alloc.allocate((size_t)cache_lines * stride);
-			context->cache_buf.stride[p] = stride;
-			context->cache_buf.mask[p] = select_zimg_buffer_mask(m_cache_lines);
-		}
+		init_cache(state, context);
+	}
+
+	void init_filter_context(node_context *context) const
+	{
+		m_filter->init_context(context->filter_ctx);
+
+		if (m_data.node_info.is_uv)
+			m_filter->init_context(context->filter_ctx2);
 	}
 
 	void set_tile_region_source(ExecutionState *state, unsigned left, unsigned right, bool uv) const
@@ -297,6 +535,36 @@ private:
 		context->source_right = std::max(context->source_right, right);
 	}
 
+	void set_row_origin_source(ExecutionState *state, unsigned i, bool uv) const
+	{
+		node_context *context = reinterpret_cast<node_context *>(state->get_context(m_id));
+		context->assert_guard_pattern();
+
+		unsigned step = 1 << m_data.source_info.subsample_h;
+		unsigned line = uv ? i * step : i;
+
+		context->cache_pos = std::min(context->cache_pos, mod(line, step));
+	}
+
+	void set_row_origin_node(ExecutionState *state, unsigned i) const
+	{
+		node_context *context = reinterpret_cast<node_context *>(state->get_context(m_id));
+		context->assert_guard_pattern();
+
+		unsigned pos = mod(i, m_data.node_info.step);
+
+		if (pos >= context->cache_pos)
+			return;
+
+		context->cache_pos = pos;
+
+		auto range = m_filter->get_required_row_range(pos);
+
+		m_data.node_info.parent->set_row_origin(state, range.first, m_data.node_info.is_uv);
+		if (m_data.node_info.parent_uv)
+			m_data.node_info.parent_uv->set_row_origin(state, range.first, true);
+	}
+
 	const ZimgImageBufferConst *generate_line_source(ExecutionState *state, unsigned i, bool uv)
 	{
 		node_context *context = reinterpret_cast<node_context *>(state->get_context(m_id));
@@ -321,6 +589,74 @@ private:
 		return &state->get_input_buffer();
 	}
 
+	void update_stats(StatsCounter *stats, const node_context *context, unsigned pos) const
+	{
+		auto attr = m_filter->get_image_attributes();
+		auto parent_attr = m_data.node_info.parent->get_image_attributes(m_data.node_info.is_uv);
+		auto row_range = m_filter->get_required_row_range(pos);
+		auto col_range = m_filter->get_required_col_range(context->source_left, context->source_right);
+		unsigned lines = std::min(pos + m_data.node_info.step, attr.height) - pos;
+		unsigned num_planes = get_num_planes();
+
+		stats->calls += 1;
+		stats->lines += lines;
+		stats->bytes_read += (unsigned long long)num_planes * (row_range.second - row_range.first) * (col_range.second - col_range.first) * pixel_size(parent_attr.type);
+		stats->bytes_written += (unsigned long long)num_planes * lines * (context->source_right - context->source_left) * pixel_size(attr.type);
+	}
+
+	void process_node_uv(ExecutionState *state, const node_context *context, const ZimgImageBufferConst &input_buffer, const ZimgImageBuffer &output_buffer, unsigned pos) const
+	{
+		StatsCounter *stats = state->get_stats(m_id);
+		StatsTimer timer{ stats };
+		ZimgImageBufferConst input_buffer_one;
+		ZimgImageBuffer output_buffer_one;
+
+		if (stats)
+			update_stats(stats, context, pos);
+
+		for (unsigned p = 1; p < 3; ++p) {
+			void *filter_ctx = p == 1 ? context->filter_ctx : context->filter_ctx2;
+
+			input_buffer_one.data[0] = input_buffer.data[p];
+			input_buffer_one.stride[0] = input_buffer.stride[p];
+			input_buffer_one.mask[0] = input_buffer.mask[p];
+
+			output_buffer_one.data[0] = output_buffer.data[p];
+			output_buffer_one.stride[0] = output_buffer.stride[p];
+			output_buffer_one.mask[0] = output_buffer.mask[p];
+
+			m_filter->process(filter_ctx, input_buffer_one, output_buffer_one, state->get_tmp(), pos, context->source_left, context->source_right);
+		}
+	}
+
+	void process_node(ExecutionState *state, const node_context *context, const ZimgImageBufferConst &input_buffer, const ZimgImageBufferConst *input_buffer_uv,
+	                  const ZimgImageBuffer &output_buffer, unsigned pos) const
+	{
+		StatsCounter *stats = state->get_stats(m_id);
+		StatsTimer timer{ stats };
+
+		if (stats)
+			update_stats(stats, context, pos);
+
+		if (input_buffer_uv) {
+			ZimgImageBufferConst input_buffer_yuv;
+
+			input_buffer_yuv.data[0] = input_buffer.data[0];
+			input_buffer_yuv.stride[0] = input_buffer.stride[0];
+			input_buffer_yuv.mask[0] = input_buffer.mask[0];
+
+			for (unsigned p = 1; p < 3; ++p) {
+				input_buffer_yuv.data[p] = input_buffer_uv->data[p];
+				input_buffer_yuv.stride[p] = input_buffer_uv->stride[p];
+				input_buffer_yuv.mask[p] = input_buffer_uv->mask[p];
+			}
+
+			m_filter->process(context->filter_ctx, input_buffer_yuv, output_buffer, state->get_tmp(), pos, context->source_left, context->source_right);
+		} else {
+			m_filter->process(context->filter_ctx, input_buffer, output_buffer, state->get_tmp(), pos, context->source_left, context->source_right);
+		}
+	}
+
 	const ZimgImageBufferConst *generate_line_node_uv(ExecutionState *state, const ZimgImageBuffer *external, unsigned i)
 	{
 		node_context *context = reinterpret_cast<node_context *>(state->get_context(m_id));
@@ -331,8 +667,6 @@ private:
 
 		for (; pos <= i; pos += m_data.node_info.step) {
 			const ZimgImageBufferConst *input_buffer = nullptr;
-			ZimgImageBufferConst input_buffer_one;
-			ZimgImageBuffer output_buffer_one;
 
 			auto range = m_filter->get_required_row_range(pos);
 
@@ -340,19 +674,7 @@ private:
 				input_buffer = m_data.node_info.parent->generate_line(state, nullptr, ii, true);
 			}
 
-			for (unsigned p = 1; p < 3; ++p) {
-				void *filter_ctx = p == 1 ? context->filter_ctx : context->filter_ctx2;
-
-				input_buffer_one.data[0] = input_buffer->data[p];
-				input_buffer_one.stride[0] = input_buffer->stride[p];
-				input_buffer_one.mask[0] = input_buffer->mask[p];
-
-				output_buffer_one.data[0] = output_buffer->data[p];
-				output_buffer_one.stride[0] = output_buffer->stride[p];
-				output_buffer_one.mask[0] = output_buffer->mask[p];
-
-				m_filter->process(filter_ctx, input_buffer_one, output_buffer_one, state->get_tmp(), pos, context->source_left, context->source_right);
-			}
+			process_node_uv(state, context, *input_buffer, *output_buffer, pos);
 		}
 		context->cache_pos = pos;
 
@@ -380,35 +702,31 @@ private:
 					input_buffer_uv = m_data.node_info.parent_uv->generate_line(state, nullptr, ii, true);
 			}
 
-			if (m_data.node_info.parent_uv) {
-				ZimgImageBufferConst input_buffer_yuv;
-
-				input_buffer_yuv.data[0] = input_buffer->data[0];
-				input_buffer_yuv.stride[0] = input_buffer->stride[0];
-				input_buffer_yuv.mask[0] = input_buffer->mask[0];
-
-				for (unsigned p = 1; p < 3; ++p) {
-					input_buffer_yuv.data[p] = input_buffer_uv->data[p];
-					input_buffer_yuv.stride[p] = input_buffer_uv->stride[p];
-					input_buffer_yuv.mask[p] = input_buffer_uv->mask[p];
-				}
-
-				m_filter->process(context->filter_ctx, input_buffer_yuv, *output_buffer, state->get_tmp(), pos, context->source_left, context->source_right);
-			} else {
-				m_filter->process(context->filter_ctx, *input_buffer, *output_buffer, state->get_tmp(), pos, context->source_left, context->source_right);
-			}
+			process_node(state, context, *input_buffer, input_buffer_uv, *output_buffer, pos);
 		}
 		context->cache_pos = pos;
 
 		return &static_cast<const ZimgImageBufferConst &>(*output_buffer);
 	}
+
+	const ZimgImageBufferConst *get_output_buffer(const ExecutionState *state) const
+	{
+		if (m_is_source)
+			return &state->get_input_buffer();
+		else if (m_is_output)
+			return &static_cast<const ZimgImageBufferConst &>(state->get_output_buffer());
+		else
+			return &static_cast<const ZimgImageBufferConst &>(reinterpret_cast<const node_context *>(state->get_context(m_id))->cache_buf);
+	}
 public:
 	GraphNode(source_tag tag, unsigned id, unsigned width, unsigned height, PixelType type, unsigned subsample_w, unsigned subsample_h, bool color) :
 		m_data{ tag },
+		m_cache_offset{},
 		m_cache_lines{ 1U << subsample_h },
 		m_ref_count{},
 		m_id{ id },
-		m_is_source{ true }
+		m_is_source{ true },
+		m_is_output{}
 	{
 		m_data.source_info.width = width;
 		m_data.source_info.height = height;
@@ -420,10 +738,12 @@ public:
 
 	GraphNode(filter_tag tag, unsigned id, GraphNode *parent, GraphNode *parent_uv, IZimgFilter *filter) :
 		m_data{ tag },
+		m_cache_offset{},
 		m_cache_lines{},
 		m_ref_count{},
 		m_id{ id },
-		m_is_source{ false }
+		m_is_source{ false },
+		m_is_output{}
 	{
 		m_data.node_info.parent = parent;
 		m_data.node_info.parent_uv = parent_uv;
@@ -436,10 +756,12 @@ public:
 
 	GraphNode(filter_uv_tag tag, unsigned id, GraphNode *parent, IZimgFilter *filter) :
 		m_data{ tag },
+		m_cache_offset{},
 		m_cache_lines{},
 		m_ref_count{},
 		m_id{ id },
-		m_is_source{ false }
+		m_is_source{ false },
+		m_is_output{}
 	{
 		m_data.node_info.parent = parent;
 		m_data.node_info.parent_uv = nullptr;
@@ -450,11 +772,82 @@ public:
 		m_filter.reset(filter);
 	}
 
+	GraphNode *get_parent() const
+	{
+		return m_is_source ? nullptr : m_data.node_info.parent;
+	}
+
+	bool can_fuse_parent() const
+	{
+		if (m_is_source)
+			return false;
+
+		const GraphNode *parent = m_data.node_info.parent;
+		const GraphNode *parent_uv = m_data.node_info.parent_uv;
+
+		if (parent->m_is_source || parent->m_data.node_info.is_uv != m_data.node_info.is_uv)
+			return false;
+		if (!!parent->m_data.node_info.flags.color != !!m_data.node_info.flags.color)
+			return false;
+		if (parent_uv && parent_uv != parent)
+			return false;
+		if (parent->m_ref_count != (parent_uv ? 2U : 1U))
+			return false;
+
+		return FusedFilter::is_fusable(*m_filter) && FusedFilter::is_fusable(*parent->m_filter);
+	}
+
+	void fuse_parents(const std::vector<GraphNode *> &parents)
+	{
+		std::vector<std::unique_ptr<IZimgFilter>> filters;
+		GraphNode *first = parents.back();
+
+		for (auto it = parents.rbegin(); it != parents.rend(); ++it) {
+			filters.emplace_back(std::move((*it)->m_filter));
+		}
+		filters.emplace_back(std::move(m_filter));
+
+		m_filter.reset(new FusedFilter{ std::move(filters) });
+
+		m_data.node_info.parent = first->m_data.node_info.parent;
+		m_data.node_info.parent_uv = first->m_data.node_info.parent_uv;
+		m_data.node_info.flags = m_filter->get_flags();
+		m_data.node_info.step = m_filter->get_simultaneous_lines();
+	}
+
 	unsigned add_ref()
 	{
 		return ++m_ref_count;
 	}
 
+	unsigned release_ref()
+	{
+		return --m_ref_count;
+	}
+
+	bool is_copy() const
+	{
+		if (m_is_source || !dynamic_cast<const CopyFilter *>(m_filter.get()))
+			return false;
+
+		return m_filter->get_image_attributes() == m_data.node_info.parent->get_image_attributes(m_data.node_info.is_uv);
+	}
+
+	void replace_parent(GraphNode *node, GraphNode *replacement)
+	{
+		if (m_is_source)
+			return;
+
+		if (m_data.node_info.parent == node) {
+			m_data.node_info.parent = replacement;
+			replacement->add_ref();
+		}
+		if (m_data.node_info.parent_uv == node) {
+			m_data.node_info.parent_uv = replacement;
+			replacement->add_ref();
+		}
+	}
+
 	unsigned get_ref() const
 	{
 		return m_ref_count;
@@ -470,6 +863,42 @@ public:
 			simulate_node(sim, first, last);
 	}
 
+	void simulate_row_origin(SimulationState *sim, unsigned i, bool uv)
+	{
+		if (m_is_source) {
+			unsigned step = 1 << m_data.source_info.subsample_h;
+			unsigned line = uv ? i * step : i;
+
+			sim->pos(m_id) = std::min(sim->pos(m_id), mod(line, step));
+			return;
+		}
+
+		unsigned pos = mod(i, m_data.node_info.step);
+
+		if (pos >= sim->pos(m_id))
+			return;
+
+		sim->pos(m_id) = pos;
+
+		auto range = m_filter->get_required_row_range(pos);
+
+		m_data.node_info.parent->simulate_row_origin(sim, range.first, m_data.node_info.is_uv);
+		if (m_data.node_info.parent_uv)
+			m_data.node_info.parent_uv->simulate_row_origin(sim, range.first, true);
+	}
+
+	// Treat the lines still held in the cache as live until the given time.
+	void simulate_hold(SimulationState *sim, unsigned time) const
+	{
+		unsigned pos = sim->pos(m_id);
+		unsigned lines = get_real_cache_lines();
+
+		if (m_is_source || pos == (unsigned)-1)
+			return;
+
+		sim->read(m_id, pos > lines ? pos - lines : 0, pos, time);
+	}
+
 	bool entire_row() const
 	{
 		bool entire_row = false;
@@ -485,6 +914,16 @@ public:
 		return entire_row;
 	}
 
+	bool row_dependent() const
+	{
+		return !m_is_source && (m_data.node_info.flags.has_state || m_data.node_info.flags.entire_plane);
+	}
+
+	unsigned get_step() const
+	{
+		return m_is_source ? 1U << m_data.source_info.subsample_h : m_data.node_info.step;
+	}
+
 	IZimgFilter::image_attributes get_image_attributes(bool uv = false) const
 	{
 		if (m_is_source) {
@@ -503,11 +942,6 @@ public:
 		alloc.allocate_n<node_context>(1);
 
 		if (!m_is_source) {
-			unsigned num_planes = get_num_planes();
-			unsigned cache_lines = get_real_cache_lines();
-			ptrdiff_t stride = get_cache_stride();
-
-			alloc.allocate((size_t)num_planes * cache_lines * stride);
 			alloc.allocate(m_filter->get_context_size());
 
 			if (m_data.node_info.is_uv)
@@ -517,6 +951,42 @@ public:
 		return alloc.count();
 	}
 
+	size_t get_cache_size() const
+	{
+		if (m_is_source)
+			return 0;
+
+		return (size_t)get_num_planes() * get_real_cache_lines() * get_cache_stride();
+	}
+
+	size_t get_cache_offset() const
+	{
+		return m_cache_offset;
+	}
+
+	void set_cache_offset(size_t offset)
+	{
+		m_cache_offset = offset;
+	}
+
+	bool is_output() const
+	{
+		return m_is_output;
+	}
+
+	void set_output()
+	{
+		m_is_output = true;
+	}
+
+	size_t get_cache_footprint() const
+	{
+		if (m_is_source || m_is_output || m_cache_lines == (unsigned)-1)
+			return 0;
+
+		return (size_t)get_num_planes() * m_cache_lines * pixel_size(get_image_attributes().type);
+	}
+
 	size_t get_tmp_size(unsigned left, unsigned right) const
 	{
 		size_t tmp_size = 0;
@@ -539,18 +1009,51 @@ public:
 		return m_cache_lines;
 	}
 
-	void init_context(ExecutionState *state)
+	unsigned get_id() const
 	{
-		size_t context_size = get_context_size();
-		LinearAllocator alloc{ state->alloc_context(m_id, context_size) };
+		return m_id;
+	}
 
-		node_context *context = new (alloc.allocate_n<node_context>(1)) node_context{};
+	void get_subgraph(std::vector<const GraphNode *> *nodes) const
+	{
+		if (m_is_source || std::find(nodes->begin(), nodes->end(), this) != nodes->end())
+			return;
+
+		nodes->push_back(this);
+		m_data.node_info.parent->get_subgraph(nodes);
+
+		if (m_data.node_info.parent_uv)
+			m_data.node_info.parent_uv->get_subgraph(nodes);
+	}
+
+	std::string get_name() const
+	{
+		if (m_is_source)
+			return "source";
+
+		std::string name = demangle(typeid(*m_filter).name());
+
+		if (const char *annotation = m_filter->get_stats_annotation())
+			name = name + " (" + annotation + ")";
+
+		return name;
+	}
+
+	void init_context(ExecutionState *state)
+	{
+		size_t context_size = get_context_size();
+		LinearAllocator alloc{ state->alloc_context(m_id, context_size) };
+
+		node_context *context = new (alloc.allocate_n<node_context>(1)) node_context{};
 		context->cache_pos = 0;
 
 		if (!m_is_source && m_data.node_info.is_uv)
-			init_context_node_uv(alloc, context);
+			init_context_node_uv(state, alloc, context);
 		else if (!m_is_source)
-			init_context_node(alloc, context);
+			init_context_node(state, alloc, context);
+
+		if (!m_is_source)
+			init_filter_context(context);
 
 		_zassert(alloc.count() <= context_size, "buffer overflow detected");
 		_zassert_d(alloc.count() == context_size, "allocation mismatch");
@@ -566,12 +1069,24 @@ public:
 		context->source_left = attr.width;
 		context->source_right = 0;
 
-		if (!m_is_source && m_data.node_info.is_uv) {
-			m_filter->init_context(context->filter_ctx);
-			m_filter->init_context(context->filter_ctx2);
-		} else if (!m_is_source) {
-			m_filter->init_context(context->filter_ctx);
-		}
+		// Stateless filters keep the context from init_context().
+		if (!m_is_source && m_data.node_info.flags.has_state)
+			init_filter_context(context);
+	}
+
+	void clear_row_origin(ExecutionState *state) const
+	{
+		node_context *context = reinterpret_cast<node_context *>(state->get_context(m_id));
+		context->assert_guard_pattern();
+		context->cache_pos = -1;
+	}
+
+	void set_row_origin(ExecutionState *state, unsigned i, bool uv)
+	{
+		if (m_is_source)
+			set_row_origin_source(state, i, uv);
+		else
+			set_row_origin_node(state, i);
 	}
 
 	void set_tile_region(ExecutionState *state, unsigned left, unsigned right, bool uv)
@@ -584,6 +1099,27 @@ public:
 			set_tile_region_node(state, left, right);
 	}
 
+	void execute(ExecutionState *state, unsigned pos) const
+	{
+		const node_context *context = reinterpret_cast<const node_context *>(state->get_context(m_id));
+
+		if (m_is_source) {
+			if (state->get_unpack_cb())
+				state->get_unpack_cb()(pos, context->source_left, context->source_right);
+			return;
+		}
+
+		const ZimgImageBuffer &output_buffer = m_is_output ? state->get_output_buffer() : context->cache_buf;
+		const ZimgImageBufferConst *input_buffer = m_data.node_info.parent->get_output_buffer(state);
+
+		if (m_data.node_info.is_uv) {
+			process_node_uv(state, context, *input_buffer, output_buffer, pos);
+		} else {
+			const ZimgImageBufferConst *input_buffer_uv = m_data.node_info.parent_uv ? m_data.node_info.parent_uv->get_output_buffer(state) : nullptr;
+			process_node(state, context, *input_buffer, input_buffer_uv, output_buffer, pos);
+		}
+	}
+
 	const ZimgImageBufferConst *generate_line(ExecutionState *state, const ZimgImageBuffer *external, unsigned i, bool uv)
 	{
 		if (m_is_source)
@@ -603,32 +1139,466 @@ const GraphNode::filter_uv_tag GraphNode::FILTER_UV{};
 
 
 class FilterGraph::impl {
-	static const unsigned HORIZONTAL_STEP = 512;
 	static const unsigned TILE_MIN = 64;
+	static const unsigned BAND_MIN = 64;
+
+	static const unsigned PLANE_Y = 1;
+	static const unsigned PLANE_UV = 2;
+	static const unsigned PLANE_ALL = PLANE_Y | PLANE_UV;
 
 	std::vector<std::unique_ptr<GraphNode>> m_node_set;
+	std::vector<ScheduleStep> m_schedule;
+	std::vector<ScheduleStep> m_schedule_y;
+	std::vector<ScheduleStep> m_schedule_uv;
 	GraphNode *m_head;
 	GraphNode *m_node;
 	GraphNode *m_node_uv;
+	size_t m_cache_size;
+	size_t m_cache_size_unshared;
 	unsigned m_id_counter;
 	unsigned m_subsample_w;
 	unsigned m_subsample_h;
+	unsigned m_tile_width;
+	std::vector<std::string> m_stats_name;
+	mutable std::vector<StatsCounter> m_stats;
+	mutable std::mutex m_stats_mutex;
+	bool m_stats_enabled;
+	bool m_split_planes;
+	bool m_is_identity;
 	bool m_is_color;
 	bool m_is_complete;
 
+	bool entire_row() const
+	{
+		return m_node->entire_row() || (m_node_uv && m_node_uv->entire_row());
+	}
+
 	unsigned get_horizontal_step() const
 	{
-		auto head_attr = m_head->get_image_attributes();
 		auto tail_attr = m_node->get_image_attributes();
 
-		bool entire_row = m_node->entire_row() || (m_node_uv && m_node_uv->entire_row());
+		if (!entire_row())
+			return std::min(m_tile_width, tail_attr.width);
+		else
+			return tail_attr.width;
+	}
 
-		if (!entire_row) {
-			double scale = std::max((double)tail_attr.width / head_attr.width, 1.0);
-			unsigned step = mod((unsigned)std::round(HORIZONTAL_STEP * scale), ALIGNMENT);
-			return std::min(step, tail_attr.width);
-		} else {
+	unsigned select_tile_width() const
+	{
+		auto tail_attr = m_node->get_image_attributes();
+		double footprint = 0.0;
+
+		// Bytes of cached image data touched per column of output.
+		for (const auto &node : m_node_set) {
+			auto attr = node->get_image_attributes();
+			footprint += (double)node->get_cache_footprint() * attr.width / tail_attr.width;
+		}
+
+		if (footprint == 0.0)
+			return tail_attr.width;
+
+		// Leave half of the cache for filter coefficients, temporaries, and the user buffers.
+		double tile_width = query_l2_cache_size() / 2 / footprint;
+
+		if (tile_width >= tail_attr.width)
 			return tail_attr.width;
+
+		return std::max(mod((unsigned)tile_width, ALIGNMENT), TILE_MIN);
+	}
+
+	unsigned get_num_tiles() const
+	{
+		auto attr = m_node->get_image_attributes();
+		unsigned h_step = get_horizontal_step();
+		unsigned num_tiles = 0;
+
+		for (unsigned j = 0; j < attr.width; j += h_step) {
+			++num_tiles;
+
+			if (attr.width - std::min(j + h_step, attr.width) < TILE_MIN)
+				break;
+		}
+
+		return num_tiles;
+	}
+
+	std::pair<unsigned, unsigned> get_tile_bounds(unsigned n) const
+	{
+		auto attr = m_node->get_image_attributes();
+		unsigned h_step = get_horizontal_step();
+		unsigned j = n * h_step;
+		unsigned j_end = std::min(j + h_step, attr.width);
+
+		if (attr.width - j_end < TILE_MIN)
+			j_end = attr.width;
+
+		return{ j, j_end };
+	}
+
+	bool can_split_rows() const
+	{
+		for (const auto &node : m_node_set) {
+			if (node->row_dependent())
+				return false;
+		}
+		return true;
+	}
+
+	unsigned get_num_bands(unsigned threads, unsigned num_tiles, bool has_unpack_cb) const
+	{
+		auto attr = m_node->get_image_attributes();
+
+		// Adjacent bands fetch the rows they share, which would unpack them more than once.
+		if (num_tiles >= threads || has_unpack_cb || !can_split_rows())
+			return 1;
+
+		unsigned num_bands = (threads + num_tiles - 1) / num_tiles;
+		return std::max(std::min(num_bands, attr.height / BAND_MIN), 1U);
+	}
+
+	std::pair<unsigned, unsigned> get_band_bounds(unsigned n, unsigned num_bands) const
+	{
+		auto attr = m_node->get_image_attributes();
+		unsigned row_align = (1 << m_subsample_h) * m_node->get_step() * (m_node_uv ? m_node_uv->get_step() : 1);
+
+		unsigned i = mod((unsigned)((uint64_t)attr.height * n / num_bands), row_align);
+		unsigned i_end = n == num_bands - 1 ? attr.height : mod((unsigned)((uint64_t)attr.height * (n + 1) / num_bands), row_align);
+
+		return{ i, i_end };
+	}
+
+	bool is_full_plane(const ZimgImageBufferConst &buf) const
+	{
+		for (unsigned p = 0; p < (m_node_uv ? 3U : 1U); ++p) {
+			if (buf.mask[p] != (unsigned)-1)
+				return false;
+		}
+		return true;
+	}
+
+	void merge_stats(ExecutionState &state) const
+	{
+		if (!m_stats_enabled)
+			return;
+
+		std::lock_guard<std::mutex> lock{ m_stats_mutex };
+
+		for (unsigned id = 0; id < m_id_counter; ++id) {
+			StatsCounter *stats = state.get_stats(id);
+
+			m_stats[id].calls += stats->calls;
+			m_stats[id].lines += stats->lines;
+			m_stats[id].bytes_read += stats->bytes_read;
+			m_stats[id].bytes_written += stats->bytes_written;
+			m_stats[id].cycles += stats->cycles;
+			m_stats[id].nanoseconds += stats->nanoseconds;
+
+			*stats = StatsCounter{};
+		}
+	}
+
+	void split_schedule()
+	{
+		std::vector<const GraphNode *> subgraph_y;
+		std::vector<const GraphNode *> subgraph_uv;
+
+		m_split_planes = false;
+
+		if (!m_node_uv || m_node_uv == m_node)
+			return;
+
+		m_node->get_subgraph(&subgraph_y);
+		m_node_uv->get_subgraph(&subgraph_uv);
+
+		// The luma and chroma paths may only share the source node.
+		for (const GraphNode *node : subgraph_y) {
+			if (std::find(subgraph_uv.begin(), subgraph_uv.end(), node) != subgraph_uv.end())
+				return;
+		}
+
+		for (const auto &step : m_schedule) {
+			if (!step.node)
+				continue;
+
+			bool is_y = std::find(subgraph_y.begin(), subgraph_y.end(), step.node) != subgraph_y.end();
+			bool is_uv = std::find(subgraph_uv.begin(), subgraph_uv.end(), step.node) != subgraph_uv.end();
+
+			if (is_y || step.node == m_head)
+				m_schedule_y.push_back(step);
+			if (is_uv || step.node == m_head)
+				m_schedule_uv.push_back(step);
+		}
+
+		m_split_planes = true;
+	}
+
+	void process_tile(ExecutionState *state, unsigned j, unsigned j_end, unsigned i_begin, unsigned i_end, unsigned planes = PLANE_ALL) const
+	{
+		unsigned v_step = 1 << m_subsample_h;
+		bool do_y = !!(planes & PLANE_Y);
+		bool do_uv = m_node_uv && (planes & PLANE_UV);
+
+		for (const auto &node : m_node_set) {
+			node->reset_context(state);
+		}
+
+		if (do_y)
+			m_node->set_tile_region(state, j, j_end, false);
+		if (do_uv)
+			m_node_uv->set_tile_region(state, j >> m_subsample_w, j_end >> m_subsample_w, true);
+
+		// The precompiled schedule starts at the top of the plane and stops
+		// once the last row of the range is packed. Bands starting further
+		// down pull their rows on demand, starting from the row origin.
+		if (!i_begin && (i_end == m_node->get_image_attributes().height || planes == PLANE_ALL)) {
+			const std::vector<ScheduleStep> &schedule = planes == PLANE_ALL ? m_schedule : planes == PLANE_Y ? m_schedule_y : m_schedule_uv;
+
+			for (const auto &step : schedule) {
+				if (step.node) {
+					step.node->execute(state, step.row);
+					continue;
+				}
+
+				if (state->get_pack_cb())
+					state->get_pack_cb()(step.row, j, j_end);
+				if (step.row + v_step >= i_end)
+					break;
+			}
+			return;
+		}
+
+		if (i_begin) {
+			for (const auto &node : m_node_set) {
+				node->clear_row_origin(state);
+			}
+
+			if (do_y)
+				m_node->set_row_origin(state, i_begin, false);
+			if (do_uv)
+				m_node_uv->set_row_origin(state, i_begin >> m_subsample_h, true);
+		}
+
+		for (unsigned i = i_begin; i < i_end; i += v_step) {
+			for (unsigned ii = i; do_y && ii < i + v_step; ++ii) {
+				m_node->generate_line(state, &state->get_output_buffer(), ii, false);
+			}
+
+			if (do_uv)
+				m_node_uv->generate_line(state, &state->get_output_buffer(), i / v_step, true);
+
+			if (state->get_pack_cb())
+				state->get_pack_cb()(i, j, j_end);
+		}
+	}
+
+	void eliminate_copies()
+	{
+		for (auto &node_ptr : m_node_set) {
+			GraphNode *node = node_ptr.get();
+
+			if (!node->is_copy())
+				continue;
+
+			GraphNode *parent = node->get_parent();
+
+			for (const auto &other : m_node_set) {
+				if (other)
+					other->replace_parent(node, parent);
+			}
+			parent->release_ref();
+
+			if (m_node == node)
+				m_node = parent;
+			if (m_node_uv == node)
+				m_node_uv = parent;
+
+			node_ptr.reset();
+		}
+
+		m_node_set.erase(std::remove(m_node_set.begin(), m_node_set.end(), nullptr), m_node_set.end());
+		m_is_identity = m_node == m_head && (!m_node_uv || m_node_uv == m_head);
+	}
+
+	void copy_planes(const ZimgImageBufferConst &src, const ZimgImageBuffer &dst) const
+	{
+		for (unsigned p = 0; p < (m_node_uv ? 3U : 1U); ++p) {
+			auto attr = m_head->get_image_attributes(p != 0);
+			const char *src_p = static_cast<const char *>(src.data[p]);
+			char *dst_p = static_cast<char *>(dst.data[p]);
+			size_t row_size = (size_t)attr.width * pixel_size(attr.type);
+
+			// Nothing to do when the image is processed in place.
+			if (src_p == dst_p && src.stride[p] == dst.stride[p])
+				continue;
+
+			if (src.stride[p] == (ptrdiff_t)row_size && dst.stride[p] == (ptrdiff_t)row_size) {
+				std::copy_n(src_p, row_size * attr.height, dst_p);
+				continue;
+			}
+
+			for (unsigned i = 0; i < attr.height; ++i) {
+				std::copy_n(src_p + i * src.stride[p], row_size, dst_p + i * dst.stride[p]);
+			}
+		}
+	}
+
+	bool can_copy_planes(const ZimgImageBufferConst &src, const ZimgImageBuffer &dst, callback unpack_cb, callback pack_cb) const
+	{
+		return m_is_identity && !unpack_cb && !pack_cb && is_full_plane(src) && is_full_plane(dst);
+	}
+
+	void fuse_filters()
+	{
+		for (size_t n = m_node_set.size(); n-- > 0;) {
+			GraphNode *node = m_node_set[n].get();
+			std::vector<GraphNode *> parents;
+
+			if (!node)
+				continue;
+
+			for (GraphNode *cur = node; cur->can_fuse_parent(); cur = cur->get_parent()) {
+				GraphNode *parent = cur->get_parent();
+
+				if (parent == m_node || parent == m_node_uv)
+					break;
+
+				parents.push_back(parent);
+			}
+
+			if (parents.empty())
+				continue;
+
+			node->fuse_parents(parents);
+
+			for (GraphNode *parent : parents) {
+				auto it = std::find_if(m_node_set.begin(), m_node_set.end(), [=](const std::unique_ptr<GraphNode> &x) { return x.get() == parent; });
+				it->reset();
+			}
+		}
+
+		m_node_set.erase(std::remove(m_node_set.begin(), m_node_set.end(), nullptr), m_node_set.end());
+	}
+
+	static bool intervals_overlap(const std::vector<std::pair<unsigned, unsigned>> &a, const std::vector<std::pair<unsigned, unsigned>> &b)
+	{
+		auto it_a = a.begin();
+		auto it_b = b.begin();
+
+		while (it_a != a.end() && it_b != b.end()) {
+			if (it_a->first <= it_b->second && it_b->first <= it_a->second)
+				return true;
+
+			if (it_a->second < it_b->second)
+				++it_a;
+			else
+				++it_b;
+		}
+		return false;
+	}
+
+	void plan_caches(const SimulationState &sim, const std::vector<std::vector<unsigned>> &frame_pos)
+	{
+		struct cache_block {
+			GraphNode *node;
+			size_t size;
+		};
+
+		std::vector<cache_block> blocks;
+		std::vector<unsigned char> conflicts(m_id_counter * m_id_counter);
+
+		// Two caches conflict if any of their lines are live at the same
+		// step of the schedule. Each tile runs the schedule from the top.
+		auto add_conflicts = [&](const SimulationState &s)
+		{
+			std::vector<std::vector<std::pair<unsigned, unsigned>>> intervals(m_id_counter);
+
+			for (const auto &node : m_node_set) {
+				intervals[node->get_id()] = s.live_intervals(node->get_id());
+			}
+
+			for (unsigned a = 0; a < m_id_counter; ++a) {
+				for (unsigned b = 0; b < a; ++b) {
+					if (intervals_overlap(intervals[a], intervals[b]))
+						conflicts[a * m_id_counter + b] = conflicts[b * m_id_counter + a] = 1;
+				}
+			}
+		};
+
+		add_conflicts(sim);
+
+		// Bands and regions pull their rows starting from an arbitrary row.
+		// Once every node has reached the same position as in the schedule,
+		// execution proceeds as in the schedule, so only the prefix until
+		// then needs to be simulated.
+		if (!frame_pos.empty()) {
+			auto attr = m_node->get_image_attributes();
+			unsigned v_step = 1 << m_subsample_h;
+
+			for (unsigned origin = v_step; origin < attr.height; origin += v_step) {
+				SimulationState band{ m_id_counter };
+
+				band.clear_positions();
+				m_node->simulate_row_origin(&band, origin, false);
+				if (m_node_uv)
+					m_node_uv->simulate_row_origin(&band, origin >> m_subsample_h, true);
+
+				for (unsigned i = origin; i < attr.height; i += v_step) {
+					m_node->simulate(&band, i, i + v_step);
+					if (m_node_uv)
+						m_node_uv->simulate(&band, i >> m_subsample_h, (i >> m_subsample_h) + 1, true);
+
+					band.tick(nullptr, i);
+
+					if (band.positions() == frame_pos[i / v_step])
+						break;
+				}
+
+				for (const auto &node : m_node_set) {
+					node->simulate_hold(&band, band.time());
+				}
+
+				add_conflicts(band);
+			}
+		}
+
+		m_cache_size = 0;
+		m_cache_size_unshared = 0;
+
+		for (const auto &node : m_node_set) {
+			m_cache_size_unshared += node->get_cache_size();
+
+			if (!node->is_output() && node->get_cache_size())
+				blocks.push_back({ node.get(), node->get_cache_size() });
+		}
+
+		std::stable_sort(blocks.begin(), blocks.end(), [](const cache_block &a, const cache_block &b) { return a.size > b.size; });
+
+		// Greedy first-fit: place each cache at the lowest offset not
+		// occupied by a conflicting cache.
+		for (size_t n = 0; n < blocks.size(); ++n) {
+			const cache_block &block = blocks[n];
+			std::vector<const cache_block *> placed;
+			size_t offset = 0;
+
+			for (size_t m = 0; m < n; ++m) {
+				if (conflicts[block.node->get_id() * m_id_counter + blocks[m].node->get_id()])
+					placed.push_back(&blocks[m]);
+			}
+
+			std::sort(placed.begin(), placed.end(), [](const cache_block *a, const cache_block *b)
+			{
+				return a->node->get_cache_offset() < b->node->get_cache_offset();
+			});
+
+			for (const cache_block *other : placed) {
+				if (offset + block.size <= other->node->get_cache_offset())
+					break;
+
+				offset = std::max(offset, other->node->get_cache_offset() + other->size);
+			}
+
+			block.node->set_cache_offset(offset);
+			m_cache_size = std::max(m_cache_size, offset + block.size);
 		}
 	}
 
@@ -648,9 +1618,15 @@ public:
 		m_head{},
 		m_node{},
 		m_node_uv{},
+		m_cache_size{},
+		m_cache_size_unshared{},
 		m_id_counter{},
 		m_subsample_w{},
 		m_subsample_h{},
+		m_tile_width{},
+		m_stats_enabled{},
+		m_split_planes{},
+		m_is_identity{},
 		m_is_complete{}
 	{
 		if (!color && (subsample_w || subsample_h))
@@ -712,6 +1688,18 @@ public:
 		parent->add_ref();
 	}
 
+	void set_tile_width(unsigned width)
+	{
+		check_incomplete();
+		m_tile_width = width ? std::max(align(width, ALIGNMENT), TILE_MIN) : 0;
+	}
+
+	void set_stats_enabled(bool enabled)
+	{
+		check_incomplete();
+		m_stats_enabled = enabled;
+	}
+
 	void complete()
 	{
 		check_incomplete();
@@ -735,43 +1723,98 @@ public:
 		if (node_attr.type != node_attr_uv.type)
 			throw zimg::error::InternalError{ "UV pixel type can not differ" };
 
+		eliminate_copies();
+
+		// Fusion would hide the individual filters from the statistics.
+		if (!m_stats_enabled)
+			fuse_filters();
+
 		if (m_node == m_head || m_node->get_ref())
 			attach_filter(new CopyFilter{ node_attr.width, node_attr.height, node_attr.type });
 		if (m_node_uv && (m_node_uv == m_head || m_node_uv->get_ref()))
 			attach_filter_uv(new CopyFilter{ node_attr_uv.width, node_attr_uv.height, node_attr_uv.type });
 
 		SimulationState sim{ m_id_counter };
+		std::vector<std::vector<unsigned>> frame_pos;
+		bool split_rows = can_split_rows();
 
 		for (unsigned i = 0; i < node_attr.height; i += (1 << subsample_h)) {
 			m_node->simulate(&sim, i, i + (1 << subsample_h));
 
 			if (m_node_uv)
 				m_node_uv->simulate(&sim, i >> subsample_h, (i >> subsample_h) + 1, true);
+
+			sim.tick(nullptr, i);
+
+			// Record the positions after each row for the simulation of bands.
+			if (split_rows)
+				frame_pos.push_back(sim.positions());
 		}
 
+		// The output nodes always write to the caller's buffer.
+		m_node->set_output();
+		if (m_node_uv)
+			m_node_uv->set_output();
+
 		m_subsample_w = subsample_w;
 		m_subsample_h = subsample_h;
+
+		plan_caches(sim, frame_pos);
+		m_schedule = std::move(sim.schedule());
+		split_schedule();
+
+		if (!m_tile_width)
+			m_tile_width = select_tile_width();
+
+		if (m_stats_enabled) {
+			m_stats_name.resize(m_id_counter);
+			m_stats.resize(m_id_counter);
+
+			for (const auto &node : m_node_set) {
+				m_stats_name[node->get_id()] = node->get_name();
+			}
+		}
+
 		m_is_complete = true;
 	}
 
-	size_t get_tmp_size() const
+	void init_state(ExecutionState *state) const
 	{
-		check_complete();
+		state->alloc_context_table(m_id_counter);
+
+		if (m_stats_enabled)
+			state->alloc_stats(m_id_counter);
+
+		state->alloc_cache(m_cache_size);
 
+		for (const auto &node : m_node_set) {
+			node->init_context(state);
+		}
+	}
+
+	// Size the temporary buffer for the actual tile bounds, or for the entire image width.
+	size_t calculate_tmp_size(bool tiled) const
+	{
 		auto attr = m_node->get_image_attributes();
-		unsigned step = get_horizontal_step();
+		unsigned num_tiles = tiled ? get_num_tiles() : 1;
 
 		FakeAllocator alloc;
 		size_t tmp_size = 0;
 
 		alloc.allocate(ExecutionState::context_table_size(m_id_counter));
 
+		if (m_stats_enabled)
+			alloc.allocate_n<StatsCounter>(m_id_counter);
+
 		for (const auto &node : m_node_set) {
 			alloc.allocate(node->get_context_size());
 		}
+		alloc.allocate(m_cache_size);
 
-		for (unsigned j = 0; j < attr.width; j += step) {
-			unsigned j_end = std::min(j + step, attr.width);
+		for (unsigned n = 0; n < num_tiles; ++n) {
+			auto bounds = tiled ? get_tile_bounds(n) : std::make_pair(0U, attr.width);
+			unsigned j = bounds.first;
+			unsigned j_end = bounds.second;
 
 			tmp_size = std::max(tmp_size, m_node->get_tmp_size(j, j_end));
 
@@ -783,6 +1826,32 @@ public:
 		return alloc.count();
 	}
 
+	size_t get_tmp_size() const
+	{
+		check_complete();
+		return calculate_tmp_size(true);
+	}
+
+	size_t get_tmp_size_push() const
+	{
+		check_complete();
+
+		// Pushed rows are processed across the entire image width.
+		return std::max(calculate_tmp_size(true), calculate_tmp_size(false));
+	}
+
+	size_t get_cache_size() const
+	{
+		check_complete();
+		return m_cache_size;
+	}
+
+	size_t get_cache_size_unshared() const
+	{
+		check_complete();
+		return m_cache_size_unshared;
+	}
+
 	unsigned get_input_buffering() const
 	{
 		check_complete();
@@ -804,48 +1873,282 @@ public:
 		return lines;
 	}
 
-	void process(const ZimgImageBufferConst &src, const ZimgImageBuffer &dst, void *tmp, callback unpack_cb, callback pack_cb) const
+	unsigned get_push_buffering(unsigned slice_height) const
 	{
 		check_complete();
 
-		ExecutionState state{ m_id_counter, src, dst, tmp, unpack_cb, pack_cb };
-		auto attr = m_node->get_image_attributes();
-		unsigned h_step = get_horizontal_step();
+		auto attr = m_head->get_image_attributes();
+		unsigned step = m_head->get_step();
+		unsigned lines = m_head->get_cache_lines();
+
+		if (lines == (unsigned)-1)
+			return lines;
+
+		// Rows still referenced by the graph must survive the next slice being written.
+		lines += (slice_height + step - 1) / step * step;
+		return lines >= attr.height ? -1 : select_zimg_buffer_mask(lines) + 1;
+	}
+
+	void push_rows(ExecutionState *state, PushState *push, const ZimgImageBufferConst &src, const ZimgImageBuffer &dst, unsigned first_row, unsigned count, callback pack_cb) const
+	{
+		auto attr = m_head->get_image_attributes();
+		auto out_attr = m_node->get_image_attributes();
+		unsigned step = m_head->get_step();
 		unsigned v_step = 1 << m_subsample_h;
+		unsigned last_row;
 
-		for (const auto &node : m_node_set) {
-			node->init_context(&state);
-		}
+		if (first_row > attr.height || count > attr.height - first_row)
+			throw zimg::error::IllegalArgument{ "row range out of bounds" };
 
-		for (unsigned j = 0; j < attr.width; j += h_step) {
-			unsigned j_end = std::min(j + h_step, attr.width);
+		last_row = first_row + count;
 
-			if (attr.width - j_end < TILE_MIN) {
-				j_end = attr.width;
-				h_step = attr.width - j;
-			}
+		if (first_row % step || (last_row % step && last_row != attr.height))
+			throw zimg::error::IllegalArgument{ "row range must be aligned to vertical subsampling" };
 
+		// Pushing the first row of the image begins a new frame.
+		if (!first_row) {
 			for (const auto &node : m_node_set) {
-				node->reset_context(&state);
+				node->reset_context(state);
 			}
 
-			m_node->set_tile_region(&state, j, j_end, false);
+			m_node->set_tile_region(state, 0, out_attr.width, false);
 			if (m_node_uv)
-				m_node_uv->set_tile_region(&state, j >> m_subsample_w, j_end >> m_subsample_w, true);
+				m_node_uv->set_tile_region(state, 0, out_attr.width >> m_subsample_w, true);
+
+			*push = PushState{};
+		} else if (first_row != push->input_row) {
+			throw zimg::error::IllegalArgument{ "rows must be pushed in order" };
+		}
+
+		push->input_row = last_row;
+		state->set_buffers(src, dst, nullptr, pack_cb);
+
+		// Run the schedule until it needs a row that has not been pushed.
+		for (; push->pos < m_schedule.size(); ++push->pos) {
+			const ScheduleStep &schedule_step = m_schedule[push->pos];
+
+			if (schedule_step.node == m_head && schedule_step.row >= last_row)
+				break;
+
+			if (schedule_step.node) {
+				schedule_step.node->execute(state, schedule_step.row);
+			} else {
+				if (pack_cb)
+					pack_cb(schedule_step.row, 0, out_attr.width);
+
+				push->output_row = std::min(schedule_step.row + v_step, out_attr.height);
+			}
+		}
+
+		merge_stats(*state);
+	}
+
+	void process(const ZimgImageBufferConst &src, const ZimgImageBuffer &dst, void *tmp, callback unpack_cb, callback pack_cb) const
+	{
+		check_complete();
+
+		ExecutionState state{ tmp };
+
+		init_state(&state);
+		process(&state, src, dst, unpack_cb, pack_cb);
+	}
+
+	void process(ExecutionState *state, const ZimgImageBufferConst &src, const ZimgImageBuffer &dst, callback unpack_cb, callback pack_cb) const
+	{
+		auto attr = m_node->get_image_attributes();
+		unsigned num_tiles = get_num_tiles();
+
+		if (can_copy_planes(src, dst, unpack_cb, pack_cb)) {
+			copy_planes(src, dst);
+			return;
+		}
+
+		state->set_buffers(src, dst, unpack_cb, pack_cb);
+
+		for (unsigned n = 0; n < num_tiles; ++n) {
+			auto bounds = get_tile_bounds(n);
+			process_tile(state, bounds.first, bounds.second, 0, attr.height);
+		}
+
+		merge_stats(*state);
+	}
 
-			for (unsigned i = 0; i < attr.height; i += v_step) {
-				for (unsigned ii = i; ii < i + v_step; ++ii) {
-					m_node->generate_line(&state, &dst, ii, false);
+	void process_region(const ZimgImageBufferConst &src, const ZimgImageBuffer &dst, void *tmp, unsigned left, unsigned top, unsigned right, unsigned bottom,
+	                    callback unpack_cb, callback pack_cb) const
+	{
+		check_complete();
+
+		auto attr = m_node->get_image_attributes();
+		unsigned num_tiles = get_num_tiles();
+
+		if (left >= right || right > attr.width || top >= bottom || bottom > attr.height)
+			throw zimg::error::IllegalArgument{ "region out of bounds" };
+
+		// Expand the region to whole chroma samples.
+		left = mod(left, 1U << m_subsample_w);
+		right = std::min(align(right, 1U << m_subsample_w), attr.width);
+		top = mod(top, 1U << m_subsample_h);
+		bottom = std::min(align(bottom, 1U << m_subsample_h), attr.height);
+
+		if (entire_row()) {
+			left = 0;
+			right = attr.width;
+		}
+
+		// Filters carrying state between rows must start from the top of the image.
+		if (!can_split_rows())
+			top = 0;
+
+		ExecutionState state{ tmp };
+
+		init_state(&state);
+		state.set_buffers(src, dst, unpack_cb, pack_cb);
+
+		// Clip the regular tiles to the region so that the temporary buffer suffices.
+		for (unsigned n = 0; n < num_tiles; ++n) {
+			auto bounds = get_tile_bounds(n);
+			unsigned j = std::max(bounds.first, left);
+			unsigned j_end = std::min(bounds.second, right);
+
+			if (j < j_end)
+				process_tile(&state, j, j_end, top, bottom);
+		}
+
+		merge_stats(state);
+	}
+
+	void process_mt(const ZimgImageBufferConst &src, const ZimgImageBuffer &dst, void *tmp, callback unpack_cb, callback pack_cb, unsigned threads) const
+	{
+		check_complete();
+
+		unsigned num_tiles = get_num_tiles();
+		// Both work items would run the source steps, unpacking every row twice.
+		unsigned num_planes = m_split_planes && !unpack_cb && !pack_cb ? 2 : 1;
+		unsigned num_bands;
+		unsigned num_items;
+
+		if (can_copy_planes(src, dst, unpack_cb, pack_cb)) {
+			copy_planes(src, dst);
+			return;
+		}
+
+		threads = get_thread_count(threads);
+		num_bands = get_num_bands(threads, num_tiles * num_planes, !!unpack_cb);
+		num_items = num_tiles * num_bands * num_planes;
+		threads = std::min(threads, num_items);
+
+		if (threads <= 1 || !is_full_plane(src) || !is_full_plane(dst)) {
+			process(src, dst, tmp, unpack_cb, pack_cb);
+			return;
+		}
+
+		size_t tmp_size = get_tmp_size();
+		std::atomic<unsigned> next_item{ 0 };
+		std::atomic<bool> failed{ false };
+		std::exception_ptr eptr;
+		std::mutex eptr_mutex;
+
+		auto worker = [&](unsigned t)
+		{
+			try {
+				ExecutionState state{ reinterpret_cast<char *>(tmp) + t * tmp_size };
+				unsigned n;
+
+				init_state(&state);
+				state.set_buffers(src, dst, unpack_cb, pack_cb);
+
+				while (!failed && (n = next_item++) < num_items) {
+					unsigned planes = num_planes == 1 ? PLANE_ALL : n % num_planes ? PLANE_UV : PLANE_Y;
+					auto col_bounds = get_tile_bounds(n / num_planes / num_bands);
+					auto row_bounds = get_band_bounds(n / num_planes % num_bands, num_bands);
+
+					process_tile(&state, col_bounds.first, col_bounds.second, row_bounds.first, row_bounds.second, planes);
 				}
 
-				if (m_node_uv)
-					m_node_uv->generate_line(&state, &state.get_output_buffer(), i / v_step, true);
+				merge_stats(state);
+			} catch (...) {
+				std::lock_guard<std::mutex> lock{ eptr_mutex };
 
-				if (state.get_pack_cb())
-					state.get_pack_cb()(i, j, j_end);
+				if (!eptr)
+					eptr = std::current_exception();
+				failed = true;
 			}
+		};
+
+		std::vector<std::thread> pool;
+
+		try {
+			pool.reserve(threads - 1);
+
+			for (unsigned t = 1; t < threads; ++t) {
+				pool.emplace_back(worker, t);
+			}
+		} catch (const std::system_error &) {
+			// Continue with the threads that were successfully started.
+		} catch (const std::bad_alloc &) {
+			// Continue with the threads that were successfully started.
+		}
+
+		worker(0);
+
+		for (auto &th : pool) {
+			th.join();
+		}
+
+		if (eptr)
+			std::rethrow_exception(eptr);
+	}
+
+	std::vector<node_stats> get_stats() const
+	{
+		check_complete();
+
+		std::vector<node_stats> ret;
+
+		if (!m_stats_enabled)
+			return ret;
+
+		std::lock_guard<std::mutex> lock{ m_stats_mutex };
+
+		for (const auto &node : m_node_set) {
+			unsigned id = node->get_id();
+
+			if (node.get() == m_head)
+				continue;
+
+			const StatsCounter &stats = m_stats[id];
+			ret.push_back({ m_stats_name[id].c_str(), stats.calls, stats.lines, stats.bytes_read, stats.bytes_written, stats.cycles, stats.nanoseconds / 1e9 });
 		}
 
+		return ret;
+	}
+};
+
+
+class FilterGraphContext::impl {
+	const FilterGraph::impl *m_graph;
+	AlignedVector<char> m_tmp;
+	ExecutionState m_state;
+	PushState m_push;
+public:
+	explicit impl(const FilterGraph::impl *graph) :
+		m_graph{ graph },
+		m_tmp(graph->get_tmp_size_push()),
+		m_state{ m_tmp.data() },
+		m_push{}
+	{
+		m_graph->init_state(&m_state);
+	}
+
+	void process(const ZimgImageBufferConst &src, const ZimgImageBuffer &dst, FilterGraph::callback unpack_cb, FilterGraph::callback pack_cb)
+	{
+		m_graph->process(&m_state, src, dst, unpack_cb, pack_cb);
+	}
+
+	unsigned push_rows(const ZimgImageBufferConst &src, const ZimgImageBuffer &dst, unsigned first_row, unsigned count, FilterGraph::callback pack_cb)
+	{
+		m_graph->push_rows(&m_state, &m_push, src, dst, first_row, count, pack_cb);
+		return m_push.output_row;
 	}
 };
 
@@ -893,6 +2196,16 @@ void FilterGraph::attach_filter_uv(IZimgFilter *filter)
 	m_impl->attach_filter_uv(filter);
 }
 
+void FilterGraph::set_tile_width(unsigned width)
+{
+	m_impl->set_tile_width(width);
+}
+
+void FilterGraph::set_stats_enabled(bool enabled)
+{
+	m_impl->set_stats_enabled(enabled);
+}
+
 void FilterGraph::complete()
 {
 	m_impl->complete();
@@ -903,6 +2216,16 @@ size_t FilterGraph::get_tmp_size() const
 	return m_impl->get_tmp_size();
 }
 
+size_t FilterGraph::get_cache_size() const
+{
+	return m_impl->get_cache_size();
+}
+
+size_t FilterGraph::get_cache_size_unshared() const
+{
+	return m_impl->get_cache_size_unshared();
+}
+
 unsigned FilterGraph::get_input_buffering() const
 {
 	return m_impl->get_input_buffering();
@@ -913,9 +2236,55 @@ unsigned FilterGraph::get_output_buffering() const
 	return m_impl->get_output_buffering();
 }
 
+unsigned FilterGraph::get_push_buffering(unsigned slice_height) const
+{
+	return m_impl->get_push_buffering(slice_height);
+}
+
 void FilterGraph::process(const ZimgImageBufferConst &src, const ZimgImageBuffer &dst, void *tmp, callback unpack_cb, callback pack_cb) const
 {
 	m_impl->process(src, dst, tmp, unpack_cb, pack_cb);
 }
 
+void FilterGraph::process_region(const ZimgImageBufferConst &src, const ZimgImageBuffer &dst, void *tmp, unsigned left, unsigned top, unsigned right, unsigned bottom,
+                                 callback unpack_cb, callback pack_cb) const
+{
+	m_impl->process_region(src, dst, tmp, left, top, right, bottom, unpack_cb, pack_cb);
+}
+
+size_t FilterGraph::get_tmp_size_mt(unsigned threads) const
+{
+	return m_impl->get_tmp_size() * get_thread_count(threads);
+}
+
+void FilterGraph::process_mt(const ZimgImageBufferConst &src, const ZimgImageBuffer &dst, void *tmp, callback unpack_cb, callback pack_cb, unsigned threads) const
+{
+	m_impl->process_mt(src, dst, tmp, unpack_cb, pack_cb, threads);
+}
+
+std::vector<FilterGraph::node_stats> FilterGraph::get_stats() const
+{
+	return m_impl->get_stats();
+}
+
+
+FilterGraphContext::FilterGraphContext(const FilterGraph &graph) :
+	m_impl{ new impl{ graph.m_impl.get() } }
+{
+}
+
+FilterGraphContext::~FilterGraphContext()
+{
+}
+
+void FilterGraphContext::process(const ZimgImageBufferConst &src, const ZimgImageBuffer &dst, FilterGraph::callback unpack_cb, FilterGraph::callback pack_cb)
+{
+	m_impl->process(src, dst, unpack_cb, pack_cb);
+}
+
+unsigned FilterGraphContext::push_rows(const ZimgImageBufferConst &src, const ZimgImageBuffer &dst, unsigned first_row, unsigned count, FilterGraph::callback pack_cb)
+{
+	return m_impl->push_rows(src, dst, first_row, count, pack_cb);
+}
+
 } // namespace zimg
@@ -4,6 +4,7 @@
 #define ZIMG_FILTERGRAPH_H
 
 #include <memory>
+#include <vector>
 #include "ztypes.h"
 
 struct zimg_filter_graph {
@@ -14,6 +15,14 @@ zimg_filter_graph::~zimg_filter_graph()
 {
 }
 
+struct zimg_filter_graph_context {
+	virtual inline ~zimg_filter_graph_context() = 0;
+};
+
+zimg_filter_graph_context::~zimg_filter_graph_context()
+{
+}
+
 
 namespace zimg {;
 
@@ -23,6 +32,8 @@ enum class PixelType;
 
 class FilterGraph : public zimg_filter_graph {
 	class impl;
+
+	friend class FilterGraphContext;
 public:
 	class callback {
 	public:
@@ -41,6 +52,16 @@ public:
 
 		friend class FilterGraph;
 	};
+
+	struct node_stats {
+		const char *name;
+		unsigned long long calls;
+		unsigned long long lines;
+		unsigned long long bytes_read;
+		unsigned long long bytes_written;
+		unsigned long long cycles;
+		double seconds;
+	};
 private:
 	std::unique_ptr<impl> m_impl;
 public:
@@ -52,15 +73,48 @@ public:
 
 	void attach_filter_uv(IZimgFilter *filter);
 
+	void set_tile_width(unsigned width);
+
+	void set_stats_enabled(bool enabled);
+
 	void complete();
 
 	size_t get_tmp_size() const;
 
+	size_t get_cache_size() const;
+
+	size_t get_cache_size_unshared() const;
+
 	unsigned get_input_buffering() const;
 
 	unsigned get_output_buffering() const;
 
+	unsigned get_push_buffering(unsigned slice_height) const;
+
 	void process(const ZimgImageBufferConst &src, const ZimgImageBuffer &dst, void *tmp, callback unpack_cb, callback pack_cb) const;
+
+	void process_region(const ZimgImageBufferConst &src, const ZimgImageBuffer &dst, void *tmp, unsigned left, unsigned top, unsigned right, unsigned bottom,
+	                    callback unpack_cb, callback pack_cb) const;
+
+	size_t get_tmp_size_mt(unsigned threads) const;
+
+	void process_mt(const ZimgImageBufferConst &src, const ZimgImageBuffer &dst, void *tmp, callback unpack_cb, callback pack_cb, unsigned threads) const;
+
+	std::vector<node_stats> get_stats() const;
+};
+
+class FilterGraphContext : public zimg_filter_graph_context {
+	class impl;
+
+	std::unique_ptr<impl> m_impl;
+public:
+	explicit FilterGraphContext(const FilterGraph &graph);
+
+	~FilterGraphContext();
+
+	void process(const ZimgImageBufferConst &src, const ZimgImageBuffer &dst, FilterGraph::callback unpack_cb, FilterGraph::callback pack_cb);
+
+	unsigned push_rows(const ZimgImageBufferConst &src, const ZimgImageBuffer &dst, unsigned first_row, unsigned count, FilterGraph::callback pack_cb);
 };
 
 } // namespace zimg
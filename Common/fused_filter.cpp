@@ -0,0 +1,233 @@
+#include <algorithm>
+#include "align.h"
+#include "alloc.h"
+#include "except.h"
+#include "fused_filter.h"
+#include "pixel.h"
+
+namespace zimg {;
+
+namespace {;
+
+const size_t STRIP_BUFFER_SIZE = 16384;
+const unsigned STRIP_MIN = 64;
+
+} // namespace
+
+
+struct FusedFilter::fused_context {
+	void **filter_ctx;
+	char *buffer[2];
+};
+
+bool FusedFilter::is_fusable(const IZimgFilter &filter)
+{
+	ZimgFilterFlags flags = filter.get_flags();
+	return flags.same_row && !flags.entire_plane && filter.get_simultaneous_lines() == 1;
+}
+
+FusedFilter::FusedFilter(std::vector<std::unique_ptr<IZimgFilter>> &&filters) :
+	m_flags{},
+	m_strip_width{}
+{
+	if (filters.size() < 2)
+		throw zimg::error::InternalError{ "fused filter requires at least two filters" };
+
+	bool pointwise = true;
+	size_t max_pixel_size = 0;
+
+	m_flags.same_row = true;
+	m_flags.color = filters.front()->get_flags().color;
+
+	for (const auto &filter : filters) {
+		ZimgFilterFlags flags = filter->get_flags();
+		image_attributes attr = filter->get_image_attributes();
+
+		if (!is_fusable(*filter))
+			throw zimg::error::InternalError{ "filter can not be fused" };
+		if (!!flags.color != !!m_flags.color)
+			throw zimg::error::InternalError{ "fused filters must be all color or all grey" };
+
+		m_flags.has_state = m_flags.has_state || flags.has_state;
+		m_flags.entire_row = m_flags.entire_row || flags.entire_row;
+
+		pointwise = pointwise && !flags.entire_row && attr.width == filters.front()->get_image_attributes().width;
+		max_pixel_size = std::max(max_pixel_size, (size_t)pixel_size(attr.type));
+
+		m_attr.push_back(attr);
+	}
+
+	for (unsigned j = 0; pointwise && j < m_attr.back().width; ++j) {
+		for (const auto &filter : filters) {
+			if (filter->get_required_col_range(j, j + 1) != std::make_pair(j, j + 1)) {
+				pointwise = false;
+				break;
+			}
+		}
+	}
+
+	if (pointwise) {
+		unsigned strip_width = (unsigned)(STRIP_BUFFER_SIZE / (2 * get_num_planes() * max_pixel_size));
+		m_strip_width = std::max(mod(strip_width, STRIP_MIN), STRIP_MIN);
+	}
+
+	m_filters = std::move(filters);
+}
+
+unsigned FusedFilter::get_num_planes() const
+{
+	return m_flags.color ? 3 : 1;
+}
+
+ptrdiff_t FusedFilter::get_buffer_stride() const
+{
+	size_t stride = 0;
+
+	for (auto it = m_attr.begin(); it != m_attr.end() - 1; ++it) {
+		unsigned width = m_strip_width ? m_strip_width : it->width;
+		stride = std::max(stride, align((size_t)width * pixel_size(it->type), ALIGNMENT));
+	}
+
+	return stride;
+}
+
+size_t FusedFilter::get_buffer_size() const
+{
+	return get_num_planes() * get_buffer_stride();
+}
+
+ZimgFilterFlags FusedFilter::get_flags() const
+{
+	return m_flags;
+}
+
+IZimgFilter::image_attributes FusedFilter::get_image_attributes() const
+{
+	return m_attr.back();
+}
+
+IZimgFilter::pair_unsigned FusedFilter::get_required_row_range(unsigned i) const
+{
+	return m_filters.front()->get_required_row_range(i);
+}
+
+IZimgFilter::pair_unsigned FusedFilter::get_required_col_range(unsigned left, unsigned right) const
+{
+	pair_unsigned range{ left, right };
+
+	for (auto it = m_filters.rbegin(); it != m_filters.rend(); ++it) {
+		range = (*it)->get_required_col_range(range.first, range.second);
+	}
+
+	return range;
+}
+
+unsigned FusedFilter::get_simultaneous_lines() const
+{
+	return 1;
+}
+
+unsigned FusedFilter::get_max_buffering() const
+{
+	return m_filters.front()->get_max_buffering();
+}
+
+size_t FusedFilter::get_context_size() const
+{
+	FakeAllocator alloc;
+
+	alloc.allocate_n<fused_context>(1);
+	alloc.allocate_n<void *>(m_filters.size());
+
+	for (const auto &filter : m_filters) {
+		alloc.allocate(filter->get_context_size());
+	}
+
+	alloc.allocate(get_buffer_size());
+	alloc.allocate(get_buffer_size());
+
+	return alloc.count();
+}
+
+size_t FusedFilter::get_tmp_size(unsigned left, unsigned right) const
+{
+	pair_unsigned range{ left, right };
+	size_t tmp_size = 0;
+
+	if (m_strip_width)
+		range.second = std::min(range.second, range.first + m_strip_width);
+
+	for (auto it = m_filters.rbegin(); it != m_filters.rend(); ++it) {
+		tmp_size = std::max(tmp_size, (*it)->get_tmp_size(range.first, range.second));
+		range = (*it)->get_required_col_range(range.first, range.second);
+	}
+
+	return tmp_size;
+}
+
+void FusedFilter::init_context(void *ctx) const
+{
+	LinearAllocator alloc{ ctx };
+
+	fused_context *context = new (alloc.allocate_n<fused_context>(1)) fused_context{};
+	context->filter_ctx = alloc.allocate_n<void *>(m_filters.size());
+
+	for (size_t n = 0; n < m_filters.size(); ++n) {
+		context->filter_ctx[n] = alloc.allocate(m_filters[n]->get_context_size());
+		m_filters[n]->init_context(context->filter_ctx[n]);
+	}
+
+	context->buffer[0] = alloc.allocate<char>(get_buffer_size());
+	context->buffer[1] = alloc.allocate<char>(get_buffer_size());
+}
+
+void FusedFilter::process_chain(const fused_context *context, const ZimgImageBufferConst &src, const ZimgImageBuffer &dst, void *tmp,
+                                unsigned i, unsigned left, unsigned right) const
+{
+	ptrdiff_t stride = get_buffer_stride();
+	size_t num_filters = m_filters.size();
+	ZimgImageBufferConst input_buf = src;
+
+	for (size_t n = 0; n < num_filters; ++n) {
+		pair_unsigned col_range{ left, right };
+
+		// Column range required from the n-th filter by the remainder of the chain.
+		for (size_t k = num_filters - 1; k > n; --k) {
+			col_range = m_filters[k]->get_required_col_range(col_range.first, col_range.second);
+		}
+
+		if (n == num_filters - 1) {
+			m_filters[n]->process(context->filter_ctx[n], input_buf, dst, tmp, i, col_range.first, col_range.second);
+		} else {
+			// Intermediate buffers hold a single line. In strip mode, the buffer
+			// is addressed relative to the aligned start of the current strip.
+			ZimgImageBuffer output_buf{};
+			ptrdiff_t offset = m_strip_width ? (ptrdiff_t)mod(left, m_strip_width) * pixel_size(m_attr[n].type) : 0;
+
+			for (unsigned p = 0; p < get_num_planes(); ++p) {
+				output_buf.data[p] = context->buffer[n % 2] + p * stride - offset;
+				output_buf.stride[p] = stride;
+				output_buf.mask[p] = 0;
+			}
+
+			m_filters[n]->process(context->filter_ctx[n], input_buf, output_buf, tmp, i, col_range.first, col_range.second);
+			input_buf = output_buf;
+		}
+	}
+}
+
+void FusedFilter::process(void *ctx, const ZimgImageBufferConst &src, const ZimgImageBuffer &dst, void *tmp, unsigned i, unsigned left, unsigned right) const
+{
+	const fused_context *context = static_cast<const fused_context *>(ctx);
+
+	if (m_strip_width) {
+		for (unsigned j = left; j < right; j = mod(j, m_strip_width) + m_strip_width) {
+			unsigned j_end = std::min(mod(j, m_strip_width) + m_strip_width, right);
+			process_chain(context, src, dst, tmp, i, j, j_end);
+		}
+	} else {
+		process_chain(context, src, dst, tmp, i, left, right);
+	}
+}
+
+} // namespace zimg
@@ -0,0 +1,76 @@
+#pragma once
+
+#ifndef ZIMG_FUSED_FILTER_H_
+#define ZIMG_FUSED_FILTER_H_
+
+#include <memory>
+#include <vector>
+#include "zfilter.h"
+
+namespace zimg {;
+
+/**
+ * Composite of a chain of same_row filters.
+ *
+ * Each line is passed through the entire chain before the next line is
+ * processed. If every filter in the chain is point-wise in the horizontal
+ * direction, the line is further divided into strips small enough for the
+ * intermediate results to remain in the L1 cache.
+ */
+class FusedFilter final : public IZimgFilter {
+	struct fused_context;
+private:
+	std::vector<std::unique_ptr<IZimgFilter>> m_filters;
+	std::vector<image_attributes> m_attr;
+	ZimgFilterFlags m_flags;
+	unsigned m_strip_width;
+
+	unsigned get_num_planes() const;
+
+	ptrdiff_t get_buffer_stride() const;
+
+	size_t get_buffer_size() const;
+
+	void process_chain(const fused_context *context, const ZimgImageBufferConst &src, const ZimgImageBuffer &dst, void *tmp,
+	                   unsigned i, unsigned left, unsigned right) const;
+public:
+	/**
+	 * Check if a filter is eligible for fusion.
+	 *
+	 * @param filter filter
+	 * @return true if eligible
+	 */
+	static bool is_fusable(const IZimgFilter &filter);
+
+	/**
+	 * Initialize a fused filter, taking ownership of the arguments.
+	 *
+	 * @param filters filters in order of execution
+	 * @throws InternalError if the filters can not be fused
+	 */
+	explicit FusedFilter(std::vector<std::unique_ptr<IZimgFilter>> &&filters);
+
+	ZimgFilterFlags get_flags() const override;
+
+	image_attributes get_image_attributes() const override;
+
+	pair_unsigned get_required_row_range(unsigned i) const override;
+
+	pair_unsigned get_required_col_range(unsigned left, unsigned right) const override;
+
+	unsigned get_simultaneous_lines() const override;
+
+	unsigned get_max_buffering() const override;
+
+	size_t get_context_size() const override;
+
+	size_t get_tmp_size(unsigned left, unsigned right) const override;
+
+	void init_context(void *ctx) const override;
+
+	void process(void *ctx, const ZimgImageBufferConst &src, const ZimgImageBuffer &dst, void *tmp, unsigned i, unsigned left, unsigned right) const override;
+};
+
+} // namespace zimg
+
+#endif // ZIMG_FUSED_FILTER_H_
@@ -53,6 +53,12 @@ public:
 	virtual void init_context(void *ctx) const = 0;
 
 	virtual void process(void *ctx, const ZimgImageBufferConst &src, const ZimgImageBuffer &dst, void *tmp, unsigned i, unsigned left, unsigned right) const = 0;
+
+	// Optional detail appended to the filter name in graph statistics.
+	virtual const char *get_stats_annotation() const
+	{
+		return nullptr;
+	}
 };
 
 class ZimgFilter : public IZimgFilter {
@@ -1,3 +1,4 @@
+#include "Common/copy_filter.h"
 #include "Common/except.h"
 #include "Common/pixel.h"
 #include "depth2.h"
@@ -11,7 +12,9 @@ IZimgFilter *create_depth2(DitherType type, unsigned width, unsigned height, con
 {
 	try
 	{
-		if (pixel_out.type == PixelType::HALF || pixel_out.type == PixelType::FLOAT)
+		if (pixel_in == pixel_out)
+			return new CopyFilter{ width, height, pixel_out.type };
+		else if (pixel_out.type == PixelType::HALF || pixel_out.type == PixelType::FLOAT)
 			return new DepthConvert2{ width, height, pixel_in, pixel_out, cpu };
 		else
 			return create_dither_convert2(type, width, height, pixel_in, pixel_out, cpu);
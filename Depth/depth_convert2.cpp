@@ -6,6 +6,7 @@
 #include "Common/linebuffer.h"
 #include "Common/pixel.h"
 #include "depth_convert2.h"
+#include "depth_convert2_x86.h"
 #include "quantize.h"
 
 namespace zimg {;
@@ -60,6 +61,13 @@ std::pair<DepthConvert2::func_type, DepthConvert2::f16c_func_type> select_func(c
 	if (pixel_out.type == PixelType::HALF)
 		f16c = float_to_half_n;
 
+#ifdef ZIMG_X86
+	if (DepthConvert2::func_type func_x86 = select_depth_convert_func_x86(pixel_in, pixel_out, cpu))
+		func = func_x86;
+	if (DepthConvert2::f16c_func_type f16c_x86 = select_depth_convert_f16c_x86(pixel_in, pixel_out, cpu))
+		f16c = f16c_x86;
+#endif
+
 	if (pixel_in == pixel_out) {
 		func = nullptr;
 		f16c = nullptr;
@@ -0,0 +1,93 @@
+#ifdef ZIMG_X86
+
+#include <cstdint>
+#include <immintrin.h>
+#include "Common/osdep.h"
+#include "depth_convert2_x86.h"
+
+namespace zimg {;
+namespace depth {;
+
+namespace {;
+
+inline FORCE_INLINE __mmask16 tail_mask16(unsigned n)
+{
+	return n >= 16 ? 0xFFFFU : (__mmask16)((1U << n) - 1);
+}
+
+inline FORCE_INLINE __m512 load_u8_to_f32(const uint8_t *ptr, __mmask16 mask)
+{
+	return _mm512_maskz_cvtepi32_ps(mask, _mm512_maskz_cvtepu8_epi32(mask, _mm_maskz_loadu_epi8(mask, ptr)));
+}
+
+inline FORCE_INLINE __m512 load_u16_to_f32(const uint16_t *ptr, __mmask16 mask)
+{
+	return _mm512_maskz_cvtepi32_ps(mask, _mm512_maskz_cvtepu16_epi32(mask, _mm256_maskz_loadu_epi16(mask, ptr)));
+}
+
+template <class T, class Load>
+void integer_to_float(const T *src, float *dst, float scale, float offset, unsigned width, Load load)
+{
+	const __m512 scale_ps = _mm512_set1_ps(scale);
+	const __m512 offset_ps = _mm512_set1_ps(offset);
+
+	for (unsigned i = 0; i < width; i += 16) {
+		__mmask16 mask = tail_mask16(width - i);
+		__m512 x = load(src + i, mask);
+
+		// Multiply and add separately to round identically to the C implementation.
+		x = _mm512_mul_ps(x, scale_ps);
+		x = _mm512_add_ps(x, offset_ps);
+
+		_mm512_mask_storeu_ps(dst + i, mask, x);
+	}
+}
+
+} // namespace
+
+
+void depth_convert_b2f_avx512(const void *src, void *dst, float scale, float offset, unsigned width)
+{
+	integer_to_float(static_cast<const uint8_t *>(src), static_cast<float *>(dst), scale, offset, width, load_u8_to_f32);
+}
+
+void depth_convert_w2f_avx512(const void *src, void *dst, float scale, float offset, unsigned width)
+{
+	integer_to_float(static_cast<const uint16_t *>(src), static_cast<float *>(dst), scale, offset, width, load_u16_to_f32);
+}
+
+void depth_convert_h2f_avx512(const void *src, void *dst, float, float, unsigned width)
+{
+	half_to_float_avx512(src, dst, width);
+}
+
+void half_to_float_avx512(const void *src, void *dst, unsigned width)
+{
+	const uint16_t *src_p = static_cast<const uint16_t *>(src);
+	float *dst_p = static_cast<float *>(dst);
+
+	for (unsigned i = 0; i < width; i += 16) {
+		__mmask16 mask = tail_mask16(width - i);
+		__m256i x = _mm256_maskz_loadu_epi16(mask, src_p + i);
+
+		_mm512_mask_storeu_ps(dst_p + i, mask, _mm512_maskz_cvtph_ps(mask, x));
+	}
+}
+
+void float_to_half_avx512(const void *src, void *dst, unsigned width)
+{
+	const float *src_p = static_cast<const float *>(src);
+	uint16_t *dst_p = static_cast<uint16_t *>(dst);
+
+	for (unsigned i = 0; i < width; i += 16) {
+		__mmask16 mask = tail_mask16(width - i);
+		__m512 x = _mm512_maskz_loadu_ps(mask, src_p + i);
+
+		_mm256_mask_storeu_epi16(dst_p + i, mask, _mm512_maskz_cvtps_ph(mask, x, _MM_FROUND_TO_NEAREST_INT));
+	}
+}
+
+} // namespace depth
+} // namespace zimg
+
+#endif // ZIMG_X86
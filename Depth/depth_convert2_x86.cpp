@@ -0,0 +1,66 @@
+#ifdef ZIMG_X86
+
+#include "Common/cpuinfo.h"
+#include "Common/pixel.h"
+#include "depth_convert2_x86.h"
+
+namespace zimg {;
+namespace depth {;
+
+namespace {;
+
+bool select_avx512(CPUClass cpu)
+{
+	X86Capabilities caps = query_x86_capabilities();
+
+	if (cpu == CPUClass::CPU_AUTO)
+		return caps.avx512f && caps.avx512bw && caps.avx512vl;
+	else
+		return cpu >= CPUClass::CPU_X86_AVX512;
+}
+
+} // namespace
+
+
+DepthConvert2::func_type select_depth_convert_func_x86(const PixelFormat &pixel_in, const PixelFormat &pixel_out, CPUClass cpu)
+{
+	DepthConvert2::func_type func = nullptr;
+
+	if (select_avx512(cpu)) {
+		switch (pixel_in.type) {
+		case PixelType::BYTE:
+			func = depth_convert_b2f_avx512;
+			break;
+		case PixelType::WORD:
+			func = depth_convert_w2f_avx512;
+			break;
+		case PixelType::HALF:
+			func = depth_convert_h2f_avx512;
+			break;
+		default:
+			break;
+		}
+	}
+
+	return func;
+}
+
+DepthConvert2::f16c_func_type select_depth_convert_f16c_x86(const PixelFormat &pixel_in, const PixelFormat &pixel_out, CPUClass cpu)
+{
+	DepthConvert2::f16c_func_type f16c = nullptr;
+
+	if (select_avx512(cpu) && pixel_out.type == PixelType::HALF)
+		f16c = float_to_half_avx512;
+
+	return f16c;
+}
+
+DepthConvert2::f16c_func_type select_half_to_float_func_x86(CPUClass cpu)
+{
+	return select_avx512(cpu) ? half_to_float_avx512 : nullptr;
+}
+
+} // namespace depth
+} // namespace zimg
+
+#endif // ZIMG_X86
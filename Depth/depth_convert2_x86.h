@@ -0,0 +1,55 @@
+#pragma once
+
+#ifdef ZIMG_X86
+
+#ifndef ZIMG_DEPTH_DEPTH_CONVERT2_X86_H_
+#define ZIMG_DEPTH_DEPTH_CONVERT2_X86_H_
+
+#include "depth_convert2.h"
+
+namespace zimg {;
+
+enum class CPUClass;
+
+struct PixelFormat;
+
+namespace depth {;
+
+void depth_convert_b2f_avx512(const void *src, void *dst, float scale, float offset, unsigned width);
+void depth_convert_w2f_avx512(const void *src, void *dst, float scale, float offset, unsigned width);
+void depth_convert_h2f_avx512(const void *src, void *dst, float scale, float offset, unsigned width);
+
+void half_to_float_avx512(const void *src, void *dst, unsigned width);
+void float_to_half_avx512(const void *src, void *dst, unsigned width);
+
+/**
+ * Select an x86 optimized integer or half to float conversion for the given CPU.
+ *
+ * @param pixel_in input format
+ * @param pixel_out output format
+ * @param cpu select function for given cpu
+ * @return conversion function, or nullptr if none is available
+ */
+DepthConvert2::func_type select_depth_convert_func_x86(const PixelFormat &pixel_in, const PixelFormat &pixel_out, CPUClass cpu);
+
+/**
+ * Select an x86 optimized float to half conversion for the given CPU.
+ *
+ * @see select_depth_convert_func_x86
+ */
+DepthConvert2::f16c_func_type select_depth_convert_f16c_x86(const PixelFormat &pixel_in, const PixelFormat &pixel_out, CPUClass cpu);
+
+/**
+ * Select an x86 optimized half to float conversion for the given CPU.
+ *
+ * @param cpu select function for given cpu
+ * @return conversion function, or nullptr if none is available
+ */
+DepthConvert2::f16c_func_type select_half_to_float_func_x86(CPUClass cpu);
+
+} // namespace depth
+} // namespace zimg
+
+#endif // ZIMG_DEPTH_DEPTH_CONVERT2_X86_H_
+
+#endif // ZIMG_X86
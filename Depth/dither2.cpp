@@ -6,7 +6,9 @@
 #include "Common/linebuffer.h"
 #include "Common/pixel.h"
 #include "depth2.h"
+#include "depth_convert2_x86.h"
 #include "dither2.h"
+#include "dither2_x86.h"
 #include "quantize.h"
 
 namespace zimg {;
@@ -116,6 +118,15 @@ std::pair<OrderedDitherBase::func_type, OrderedDitherBase::f16c_func_type> selec
 	if (pixel_in.type == PixelType::HALF)
 		f16c = half_to_float_n;
 
+#ifdef ZIMG_X86
+	if (OrderedDitherBase::func_type func_x86 = select_ordered_dither_func_x86(pixel_in, pixel_out, cpu))
+		func = func_x86;
+	if (pixel_in.type == PixelType::HALF) {
+		if (DepthConvert2::f16c_func_type f16c_x86 = select_half_to_float_func_x86(cpu))
+			f16c = f16c_x86;
+	}
+#endif
+
 	if (pixel_in == pixel_out) {
 		func = nullptr;
 		f16c = nullptr;
@@ -145,6 +156,13 @@ std::pair<ErrorDiffusion::func_type, ErrorDiffusion::f16c_func_type> select_func
 	if (pixel_in.type == PixelType::HALF)
 		f16c = half_to_float_n;
 
+#ifdef ZIMG_X86
+	if (pixel_in.type == PixelType::HALF) {
+		if (ErrorDiffusion::f16c_func_type f16c_x86 = select_half_to_float_func_x86(cpu))
+			f16c = f16c_x86;
+	}
+#endif
+
 	if (pixel_in == pixel_out) {
 		func = nullptr;
 		f16c = nullptr;
@@ -0,0 +1,123 @@
+#ifdef ZIMG_X86
+
+#include <cstdint>
+#include <immintrin.h>
+#include "Common/osdep.h"
+#include "dither2_x86.h"
+
+namespace zimg {;
+namespace depth {;
+
+namespace {;
+
+inline FORCE_INLINE __mmask16 tail_mask16(unsigned n)
+{
+	return n >= 16 ? 0xFFFFU : (__mmask16)((1U << n) - 1);
+}
+
+struct LoadU8 {
+	typedef uint8_t type;
+
+	static inline FORCE_INLINE __m512 load(const uint8_t *ptr, __mmask16 mask)
+	{
+		return _mm512_maskz_cvtepi32_ps(mask, _mm512_maskz_cvtepu8_epi32(mask, _mm_maskz_loadu_epi8(mask, ptr)));
+	}
+};
+
+struct LoadU16 {
+	typedef uint16_t type;
+
+	static inline FORCE_INLINE __m512 load(const uint16_t *ptr, __mmask16 mask)
+	{
+		return _mm512_maskz_cvtepi32_ps(mask, _mm512_maskz_cvtepu16_epi32(mask, _mm256_maskz_loadu_epi16(mask, ptr)));
+	}
+};
+
+struct LoadF32 {
+	typedef float type;
+
+	static inline FORCE_INLINE __m512 load(const float *ptr, __mmask16 mask)
+	{
+		return _mm512_maskz_loadu_ps(mask, ptr);
+	}
+};
+
+struct StoreU8 {
+	typedef uint8_t type;
+
+	static inline FORCE_INLINE void store(uint8_t *ptr, __m512i x, __mmask16 mask)
+	{
+		_mm_mask_storeu_epi8(ptr, mask, _mm512_maskz_cvtepi32_epi8(mask, x));
+	}
+};
+
+struct StoreU16 {
+	typedef uint16_t type;
+
+	static inline FORCE_INLINE void store(uint16_t *ptr, __m512i x, __mmask16 mask)
+	{
+		_mm256_mask_storeu_epi16(ptr, mask, _mm512_maskz_cvtepi32_epi16(mask, x));
+	}
+};
+
+template <class Load, class Store>
+void ordered_dither(const float *dither, unsigned dither_offset, unsigned dither_mask, const void *src, void *dst, float scale, float offset, unsigned bits, unsigned width)
+{
+	const typename Load::type *src_p = static_cast<const typename Load::type *>(src);
+	typename Store::type *dst_p = static_cast<typename Store::type *>(dst);
+
+	const __m512 scale_ps = _mm512_set1_ps(scale);
+	const __m512 offset_ps = _mm512_set1_ps(offset);
+	const __m512 clamp_hi = _mm512_set1_ps(static_cast<float>(((uint32_t)1 << bits) - 1));
+	const __m512 half = _mm512_set1_ps(0.5f);
+
+	const __m512i mask_epi32 = _mm512_set1_epi32(dither_mask);
+	const __m512i step = _mm512_set1_epi32(16);
+	__m512i idx = _mm512_add_epi32(_mm512_set1_epi32(dither_offset), _mm512_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15));
+
+	// Small dither tables fit in a single register and are indexed with a permute.
+	bool small_table = dither_mask < 16;
+	__m512 table = small_table ? _mm512_maskz_loadu_ps(tail_mask16(dither_mask + 1), dither) : _mm512_setzero_ps();
+
+	for (unsigned i = 0; i < width; i += 16) {
+		__mmask16 mask = tail_mask16(width - i);
+		__m512i idx_masked = _mm512_and_si512(idx, mask_epi32);
+		__m512 d = small_table ? _mm512_maskz_permutexvar_ps(mask, idx_masked, table) : _mm512_mask_i32gather_ps(_mm512_setzero_ps(), mask, idx_masked, dither, sizeof(float));
+		__m512 x = Load::load(src_p + i, mask);
+
+		// Multiply and add separately to round identically to the C implementation.
+		x = _mm512_mul_ps(x, scale_ps);
+		x = _mm512_add_ps(x, offset_ps);
+		x = _mm512_add_ps(x, d);
+		x = _mm512_maskz_min_ps(mask, _mm512_maskz_max_ps(mask, x, _mm512_setzero_ps()), clamp_hi);
+		x = _mm512_add_ps(x, d);
+		x = _mm512_add_ps(x, half);
+
+		Store::store(dst_p + i, _mm512_maskz_cvttps_epi32(mask, x), mask);
+		idx = _mm512_add_epi32(idx, step);
+	}
+}
+
+} // namespace
+
+
+#define DEFINE_ORDERED_DITHER(x, load, store) \
+void ordered_dither_##x##_avx512(const float *dither, unsigned dither_offset, unsigned dither_mask, \
+                                 const void *src, void *dst, float scale, float offset, unsigned bits, unsigned width) \
+{ \
+  ordered_dither<load, store>(dither, dither_offset, dither_mask, src, dst, scale, offset, bits, width); \
+}
+
+DEFINE_ORDERED_DITHER(b2b, LoadU8, StoreU8)
+DEFINE_ORDERED_DITHER(b2w, LoadU8, StoreU16)
+DEFINE_ORDERED_DITHER(w2b, LoadU16, StoreU8)
+DEFINE_ORDERED_DITHER(w2w, LoadU16, StoreU16)
+DEFINE_ORDERED_DITHER(f2b, LoadF32, StoreU8)
+DEFINE_ORDERED_DITHER(f2w, LoadF32, StoreU16)
+
+#undef DEFINE_ORDERED_DITHER
+
+} // namespace depth
+} // namespace zimg
+
+#endif // ZIMG_X86
@@ -0,0 +1,52 @@
+#ifdef ZIMG_X86
+
+#include "Common/cpuinfo.h"
+#include "Common/pixel.h"
+#include "dither2_x86.h"
+
+namespace zimg {;
+namespace depth {;
+
+namespace {;
+
+OrderedDitherBase::func_type select_ordered_dither_func_avx512(const PixelFormat &pixel_in, const PixelFormat &pixel_out)
+{
+	if (pixel_in.type == PixelType::BYTE && pixel_out.type == PixelType::BYTE)
+		return ordered_dither_b2b_avx512;
+	else if (pixel_in.type == PixelType::BYTE && pixel_out.type == PixelType::WORD)
+		return ordered_dither_b2w_avx512;
+	else if (pixel_in.type == PixelType::WORD && pixel_out.type == PixelType::BYTE)
+		return ordered_dither_w2b_avx512;
+	else if (pixel_in.type == PixelType::WORD && pixel_out.type == PixelType::WORD)
+		return ordered_dither_w2w_avx512;
+	else if ((pixel_in.type == PixelType::HALF || pixel_in.type == PixelType::FLOAT) && pixel_out.type == PixelType::BYTE)
+		return ordered_dither_f2b_avx512;
+	else if ((pixel_in.type == PixelType::HALF || pixel_in.type == PixelType::FLOAT) && pixel_out.type == PixelType::WORD)
+		return ordered_dither_f2w_avx512;
+	else
+		return nullptr;
+}
+
+} // namespace
+
+
+OrderedDitherBase::func_type select_ordered_dither_func_x86(const PixelFormat &pixel_in, const PixelFormat &pixel_out, CPUClass cpu)
+{
+	X86Capabilities caps = query_x86_capabilities();
+	OrderedDitherBase::func_type func = nullptr;
+
+	if (cpu == CPUClass::CPU_AUTO) {
+		if (!func && caps.avx512f && caps.avx512bw && caps.avx512vl)
+			func = select_ordered_dither_func_avx512(pixel_in, pixel_out);
+	} else {
+		if (!func && cpu >= CPUClass::CPU_X86_AVX512)
+			func = select_ordered_dither_func_avx512(pixel_in, pixel_out);
+	}
+
+	return func;
+}
+
+} // namespace depth
+} // namespace zimg
+
+#endif // ZIMG_X86
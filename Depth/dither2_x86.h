@@ -0,0 +1,46 @@
+#pragma once
+
+#ifdef ZIMG_X86
+
+#ifndef ZIMG_DEPTH_DITHER2_X86_H_
+#define ZIMG_DEPTH_DITHER2_X86_H_
+
+#include "dither2.h"
+
+namespace zimg {;
+
+enum class CPUClass;
+
+struct PixelFormat;
+
+namespace depth {;
+
+#define DECLARE_ORDERED_DITHER(x, cpu) \
+void ordered_dither_##x##_##cpu(const float *dither, unsigned dither_offset, unsigned dither_mask, \
+                                const void *src, void *dst, float scale, float offset, unsigned bits, unsigned width);
+
+DECLARE_ORDERED_DITHER(b2b, avx512)
+DECLARE_ORDERED_DITHER(b2w, avx512)
+DECLARE_ORDERED_DITHER(w2b, avx512)
+DECLARE_ORDERED_DITHER(w2w, avx512)
+DECLARE_ORDERED_DITHER(f2b, avx512)
+DECLARE_ORDERED_DITHER(f2w, avx512)
+
+#undef DECLARE_ORDERED_DITHER
+
+/**
+ * Select an x86 optimized ordered dither for the given CPU.
+ *
+ * @param pixel_in input format
+ * @param pixel_out output format
+ * @param cpu select function for given cpu
+ * @return dither function, or nullptr if none is available
+ */
+OrderedDitherBase::func_type select_ordered_dither_func_x86(const PixelFormat &pixel_in, const PixelFormat &pixel_out, CPUClass cpu);
+
+} // namespace depth
+} // namespace zimg
+
+#endif // ZIMG_DEPTH_DITHER2_X86_H_
+
+#endif // ZIMG_X86
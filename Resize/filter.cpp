@@ -1,6 +1,8 @@
 #include <algorithm>
 #include <cstddef>
 #include <cmath>
+#include <cstring>
+#include <map>
 #include <vector>
 #include "Common/except.h"
 #include "Common/libm_wrapper.h"
@@ -30,6 +32,15 @@ double cube(double x)
 	return x * x * x;
 }
 
+struct FilterRowLess {
+	size_t width;
+
+	bool operator()(const float *a, const float *b) const
+	{
+		return std::memcmp(a, b, width * sizeof(float)) < 0;
+	}
+};
+
 FilterContext matrix_to_filter(const RowMatrix<double> &m)
 {
 	size_t width = 0;
@@ -38,28 +49,52 @@ FilterContext matrix_to_filter(const RowMatrix<double> &m)
 		width = std::max(width, m.row_right(i) - m.row_left(i));
 	}
 
+	std::vector<float> rows(width * m.rows());
+	std::vector<unsigned> phase(m.rows());
+	std::vector<unsigned> left(m.rows());
+
+	// Rational scale factors repeat the same filter phase many times. Store each
+	// distinct row once and let every output refer to its phase.
+	std::map<const float *, unsigned, FilterRowLess> phase_map{ FilterRowLess{ width } };
+	unsigned num_phases = 0;
+
+	for (size_t i = 0; i < m.rows(); ++i) {
+		float *row = &rows[num_phases * width];
+
+		left[i] = (unsigned)std::min(m.row_left(i), m.cols() - width);
+
+		for (size_t j = 0; j < width; ++j) {
+			row[j] = (float)m[i][left[i] + j];
+		}
+
+		auto it = phase_map.insert(std::make_pair(row, num_phases));
+		if (it.second)
+			++num_phases;
+
+		phase[i] = it.first->second;
+	}
+
 	FilterContext e{};
 
 	e.filter_width = (unsigned)width;
 	e.filter_rows = (unsigned)m.rows();
+	e.num_phases = num_phases;
 	e.input_width = (unsigned)m.cols();
 	e.stride = (unsigned)align(width, AlignmentOf<float>::value);
 	e.stride_i16 = (unsigned)align(width, AlignmentOf<uint16_t>::value);
-	e.data.resize((size_t)e.stride * e.filter_rows);
-	e.data_i16.resize((size_t)e.stride_i16 * e.filter_rows);
-	e.left.resize(e.filter_rows);
-
-	for (size_t i = 0; i < m.rows(); ++i) {
-		unsigned left = (unsigned)std::min(m.row_left(i), m.cols() - width);
+	e.data.resize((size_t)e.stride * e.num_phases);
+	e.data_i16.resize((size_t)e.stride_i16 * e.num_phases);
+	e.phase.assign(phase.begin(), phase.end());
+	e.left.assign(left.begin(), left.end());
 
+	for (size_t i = 0; i < num_phases; ++i) {
 		for (size_t j = 0; j < width; ++j) {
-			float coeff = (float)m[i][left + j];
+			float coeff = rows[i * width + j];
 			int16_t coeff_i16 = (int16_t)std::round(coeff * (float)(1 << 14));
 
 			e.data[i * e.stride + j] = coeff;
 			e.data_i16[i * e.stride_i16 + j] = coeff_i16;
 		}
-		e.left[i] = left;
 	}
 
 	return e;
@@ -72,6 +107,11 @@ Filter::~Filter()
 {
 }
 
+bool Filter::get_cache_params(std::vector<double> *params) const
+{
+	return false;
+}
+
 int PointFilter::support() const
 {
 	return 0;
@@ -82,6 +122,12 @@ double PointFilter::operator()(double x) const
 	return 1.0;
 }
 
+bool PointFilter::get_cache_params(std::vector<double> *params) const
+{
+	params->clear();
+	return true;
+}
+
 int BilinearFilter::support() const
 {
 	return 1;
@@ -92,6 +138,12 @@ double BilinearFilter::operator()(double x) const
 	return std::max(1.0 - std::abs(x), 0.0);
 }
 
+bool BilinearFilter::get_cache_params(std::vector<double> *params) const
+{
+	params->clear();
+	return true;
+}
+
 BicubicFilter::BicubicFilter(double b, double c) :
 	p0{ (  6.0 -  2.0 * b           ) / 6.0 },
 	p2{ (-18.0 + 12.0 * b +  6.0 * c) / 6.0 },
@@ -120,6 +172,12 @@ double BicubicFilter::operator()(double x) const
 		return 0.0;
 }
 
+bool BicubicFilter::get_cache_params(std::vector<double> *params) const
+{
+	*params = { p0, p2, p3, q0, q1, q2, q3 };
+	return true;
+}
+
 int Spline16Filter::support() const
 {
 	return 2;
@@ -139,6 +197,12 @@ double Spline16Filter::operator()(double x) const
 	}
 }
 
+bool Spline16Filter::get_cache_params(std::vector<double> *params) const
+{
+	params->clear();
+	return true;
+}
+
 int Spline36Filter::support() const
 {
 	return 3;
@@ -161,6 +225,12 @@ double Spline36Filter::operator()(double x) const
 	}
 }
 
+bool Spline36Filter::get_cache_params(std::vector<double> *params) const
+{
+	params->clear();
+	return true;
+}
+
 LanczosFilter::LanczosFilter(int taps) : taps(taps)
 {
 }
@@ -176,6 +246,12 @@ double LanczosFilter::operator()(double x) const
 	return x < taps ? sinc(x) * sinc(x / taps) : 0.0;
 }
 
+bool LanczosFilter::get_cache_params(std::vector<double> *params) const
+{
+	*params = { (double)taps };
+	return true;
+}
+
 FilterContext compute_filter(const Filter &f, int src_dim, int dst_dim, double shift, double width)
 {
 	double scale = (double)dst_dim / width;
@@ -5,6 +5,7 @@
 
 #include <cstddef>
 #include <cstdint>
+#include <vector>
 #include "Common/align.h"
 
 namespace zimg {;
@@ -30,6 +31,16 @@ public:
 	 * @return filter coefficient at position
 	 */
 	virtual double operator()(double x) const = 0;
+
+	/**
+	 * Get the parameters which, together with the dynamic type, determine
+	 * the filter function. Filters which can not be described this way are
+	 * not eligible for caching.
+	 *
+	 * @param params receives the filter parameters
+	 * @return true if the filter can be cached
+	 */
+	virtual bool get_cache_params(std::vector<double> *params) const;
 };
 
 /**
@@ -40,6 +51,8 @@ public:
 	int support() const override;
 
 	double operator()(double x) const override;
+
+	bool get_cache_params(std::vector<double> *params) const override;
 };
 
 /**
@@ -50,6 +63,8 @@ public:
 	int support() const override;
 
 	double operator()(double x) const override;
+
+	bool get_cache_params(std::vector<double> *params) const override;
 };
 
 /**
@@ -70,6 +85,8 @@ public:
 	int support() const override;
 
 	double operator()(double x) const override;
+
+	bool get_cache_params(std::vector<double> *params) const override;
 };
 
 /**
@@ -80,6 +97,8 @@ public:
 	int support() const override;
 
 	double operator()(double x) const override;
+
+	bool get_cache_params(std::vector<double> *params) const override;
 };
 
 /**
@@ -90,6 +109,8 @@ public:
 	int support() const override;
 
 	double operator()(double x) const override;
+
+	bool get_cache_params(std::vector<double> *params) const override;
 };
 
 /**
@@ -108,6 +129,8 @@ public:
 	int support() const override;
 
 	double operator()(double x) const override;
+
+	bool get_cache_params(std::vector<double> *params) const override;
 };
 
 /**
@@ -120,10 +143,15 @@ struct FilterContext {
 	unsigned filter_width;
 
 	/**
-	 * Total number of filter rows.
+	 * Total number of filter rows, one per output sample.
 	 */
 	unsigned filter_rows;
 
+	/**
+	 * Number of distinct coefficient rows stored in the filter data.
+	 */
+	unsigned num_phases;
+
 	/**
 	 * Width of the filter input.
 	 */
@@ -136,11 +164,16 @@ struct FilterContext {
 	unsigned stride_i16;
 
 	/**
-	 * Filter data. Integer data is signed 1.14 fixed point.
+	 * Filter data, one row per phase. Integer data is signed 1.14 fixed point.
 	 */
 	AlignedVector<float> data;
 	AlignedVector<int16_t> data_i16;
 
+	/**
+	 * Index of the coefficient row (phase) used by each filter row.
+	 */
+	AlignedVector<unsigned> phase;
+
 	/**
 	 * Indices of leftmost non-zero coefficients.
 	 */
@@ -0,0 +1,158 @@
+#include <algorithm>
+#include <cstddef>
+#include <list>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <tuple>
+#include <typeindex>
+#include <utility>
+#include <vector>
+#include "filter.h"
+#include "filter_cache.h"
+
+namespace zimg {;
+namespace resize {;
+
+namespace {;
+
+struct FilterKey {
+	std::type_index type;
+	std::vector<double> params;
+	int src_dim;
+	int dst_dim;
+	double shift;
+	double width;
+
+	bool operator<(const FilterKey &other) const
+	{
+		return std::tie(type, params, src_dim, dst_dim, shift, width) <
+		       std::tie(other.type, other.params, other.src_dim, other.dst_dim, other.shift, other.width);
+	}
+};
+
+class FilterCache {
+	typedef std::pair<FilterKey, std::shared_ptr<const FilterContext>> entry_type;
+	typedef std::list<entry_type> list_type;
+
+	// Entries are ordered from most to least recently used.
+	list_type m_list;
+	std::map<FilterKey, list_type::iterator> m_map;
+	size_t m_hits;
+	size_t m_misses;
+	mutable std::mutex m_mutex;
+
+	void touch(list_type::iterator it)
+	{
+		m_list.splice(m_list.begin(), m_list, it);
+	}
+public:
+	FilterCache() : m_hits{}, m_misses{}
+	{
+	}
+
+	std::shared_ptr<const FilterContext> find(const FilterKey &key)
+	{
+		std::lock_guard<std::mutex> lock{ m_mutex };
+		auto it = m_map.find(key);
+
+		if (it == m_map.end())
+			return nullptr;
+
+		touch(it->second);
+		++m_hits;
+		return it->second->second;
+	}
+
+	std::shared_ptr<const FilterContext> insert(const FilterKey &key, std::shared_ptr<const FilterContext> filter)
+	{
+		std::lock_guard<std::mutex> lock{ m_mutex };
+		auto it = m_map.find(key);
+
+		++m_misses;
+
+		// Another thread computed the same filter in the meantime.
+		if (it != m_map.end()) {
+			touch(it->second);
+			return it->second->second;
+		}
+
+		m_list.emplace_front(key, filter);
+
+		try {
+			m_map.emplace(key, m_list.begin());
+		} catch (...) {
+			m_list.pop_front();
+			throw;
+		}
+
+		while (m_list.size() > FILTER_CACHE_MAX_ENTRIES) {
+			m_map.erase(m_list.back().first);
+			m_list.pop_back();
+		}
+
+		return filter;
+	}
+
+	FilterCacheStats get_stats() const
+	{
+		std::lock_guard<std::mutex> lock{ m_mutex };
+		return{ m_hits, m_misses, m_list.size() };
+	}
+
+	void clear()
+	{
+		std::lock_guard<std::mutex> lock{ m_mutex };
+		m_map.clear();
+		m_list.clear();
+		m_hits = 0;
+		m_misses = 0;
+	}
+};
+
+bool is_ordered(double x)
+{
+	return x == x;
+}
+
+FilterCache &get_filter_cache()
+{
+	static FilterCache cache;
+	return cache;
+}
+
+} // namespace
+
+
+std::shared_ptr<const FilterContext> compute_filter_cached(const Filter &f, int src_dim, int dst_dim, double shift, double width)
+{
+	FilterKey key{ typeid(f), {}, src_dim, dst_dim, shift, width };
+
+	bool cacheable = f.get_cache_params(&key.params);
+
+	// NaN keys do not have a strict ordering.
+	cacheable = cacheable && is_ordered(shift) && is_ordered(width) && std::all_of(key.params.begin(), key.params.end(), is_ordered);
+
+	if (!cacheable)
+		return std::make_shared<FilterContext>(compute_filter(f, src_dim, dst_dim, shift, width));
+
+	FilterCache &cache = get_filter_cache();
+
+	if (std::shared_ptr<const FilterContext> filter = cache.find(key))
+		return filter;
+
+	return cache.insert(key, std::make_shared<FilterContext>(compute_filter(f, src_dim, dst_dim, shift, width)));
+}
+
+FilterCacheStats get_filter_cache_stats()
+{
+	return get_filter_cache().get_stats();
+}
+
+void clear_filter_cache()
+{
+	get_filter_cache().clear();
+}
+
+} // namespace resize
+} // namespace zimg
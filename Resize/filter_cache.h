@@ -0,0 +1,65 @@
+#pragma once
+
+#ifndef ZIMG_RESIZE_FILTER_CACHE_H_
+#define ZIMG_RESIZE_FILTER_CACHE_H_
+
+#include <cstddef>
+#include <memory>
+
+namespace zimg {;
+namespace resize {;
+
+class Filter;
+struct FilterContext;
+
+/**
+ * Usage counters of the process-wide filter cache.
+ */
+struct FilterCacheStats {
+	/**
+	 * Number of lookups satisfied by a cached filter.
+	 */
+	size_t hits;
+
+	/**
+	 * Number of lookups which computed a new filter.
+	 */
+	size_t misses;
+
+	/**
+	 * Number of filters currently held by the cache.
+	 */
+	size_t entries;
+};
+
+/**
+ * Maximum number of filters held by the cache. The least recently used
+ * filter is discarded when the limit is exceeded.
+ */
+const size_t FILTER_CACHE_MAX_ENTRIES = 64;
+
+/**
+ * Compute a filter as in {@link compute_filter}, reusing the result of an
+ * earlier call with the same filter function and parameters. The returned
+ * context may be shared between threads and must not be modified.
+ *
+ * @see compute_filter
+ * @return the computed filter
+ * @throws UnsupportedOperation on unsupported parameter combinations
+ */
+std::shared_ptr<const FilterContext> compute_filter_cached(const Filter &f, int src_dim, int dst_dim, double shift, double width);
+
+/**
+ * @return current cache counters
+ */
+FilterCacheStats get_filter_cache_stats();
+
+/**
+ * Discard all cached filters and reset the counters.
+ */
+void clear_filter_cache();
+
+} // namespace resize
+} // namespace zimg
+
+#endif // ZIMG_RESIZE_FILTER_CACHE_H_
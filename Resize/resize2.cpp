@@ -3,9 +3,13 @@
 #include "Common/align.h"
 #include "Common/alloc.h"
 #include "Common/copy_filter.h"
+#include "Common/except.h"
 #include "Common/linebuffer.h"
 #include "Common/pixel.h"
+#include "filter.h"
+#include "filter_cache.h"
 #include "resize2.h"
+#include "resize_cost.h"
 #include "resize_impl2.h"
 
 namespace zimg {;
@@ -13,13 +17,219 @@ namespace resize {;
 
 namespace {;
 
-bool resize_h_first(double xscale, double yscale)
-{
-	double h_first_cost = std::max(xscale, 1.0) * 2.0 + xscale * std::max(yscale, 1.0);
-	double v_first_cost = std::max(yscale, 1.0) + yscale * std::max(xscale, 1.0) * 2.0;
+/**
+ * Composite of a horizontal and a vertical resize.
+ *
+ * In horizontal-first order, the context holds a rolling window of
+ * horizontally filtered rows, each of which is computed once per tile and
+ * consumed directly by the vertical pass. In vertical-first order, the
+ * context holds the vertical output for the current group of lines.
+ */
+class FusedResize2D final : public IZimgFilter {
+	struct fused_context {
+		void *filter_ctx_h;
+		void *filter_ctx_v;
+		char *buffer;
+		unsigned row_first;
+		unsigned row_last;
+		unsigned left;
+		unsigned right;
+	};
 
-	return h_first_cost < v_first_cost;
-}
+	std::unique_ptr<IZimgFilter> m_filter_h;
+	std::unique_ptr<IZimgFilter> m_filter_v;
+	image_attributes m_buffer_attr;
+	ZimgFilterFlags m_flags;
+	unsigned m_step_h;
+	unsigned m_step_v;
+	unsigned m_lines;
+	unsigned m_max_buffering;
+	unsigned m_buffer_mask;
+	unsigned m_buffer_lines;
+	bool m_h_first;
+
+	ptrdiff_t get_buffer_stride() const
+	{
+		return align((size_t)m_buffer_attr.width * pixel_size(m_buffer_attr.type), ALIGNMENT);
+	}
+
+	ZimgImageBuffer get_buffer(const fused_context *context) const
+	{
+		ZimgImageBuffer buf{};
+
+		buf.data[0] = context->buffer;
+		buf.stride[0] = get_buffer_stride();
+		buf.mask[0] = m_buffer_mask;
+
+		return buf;
+	}
+
+	void process_h_first(fused_context *context, const ZimgImageBufferConst &src, const ZimgImageBuffer &dst, void *tmp, unsigned i, unsigned left, unsigned right) const
+	{
+		ZimgImageBuffer buf = get_buffer(context);
+		pair_unsigned row_range = get_required_row_range(i);
+
+		// Discard the window if it does not connect to the requested rows.
+		if (context->left != left || context->right != right || row_range.first < context->row_first || row_range.first > context->row_last) {
+			context->row_first = row_range.first;
+			context->row_last = row_range.first;
+			context->left = left;
+			context->right = right;
+		}
+
+		for (unsigned ii = context->row_last; ii < row_range.second; ii += m_step_h) {
+			m_filter_h->process(context->filter_ctx_h, src, buf, tmp, ii, left, right);
+		}
+
+		context->row_last = std::max(context->row_last, row_range.second);
+		context->row_first = std::max(context->row_first, context->row_last - std::min(context->row_last, m_buffer_lines));
+
+		m_filter_v->process(context->filter_ctx_v, buf, dst, tmp, i, left, right);
+	}
+
+	void process_v_first(fused_context *context, const ZimgImageBufferConst &src, const ZimgImageBuffer &dst, void *tmp, unsigned i, unsigned left, unsigned right) const
+	{
+		ZimgImageBuffer buf = get_buffer(context);
+		pair_unsigned col_range = m_filter_h->get_required_col_range(left, right);
+		unsigned last = std::min(i + m_lines, m_buffer_attr.height);
+
+		for (unsigned ii = i; ii < last; ii += m_step_v) {
+			m_filter_v->process(context->filter_ctx_v, src, buf, tmp, ii, col_range.first, col_range.second);
+		}
+		for (unsigned ii = i; ii < last; ii += m_step_h) {
+			m_filter_h->process(context->filter_ctx_h, buf, dst, tmp, ii, left, right);
+		}
+	}
+public:
+	FusedResize2D(std::unique_ptr<IZimgFilter> &&filter_h, std::unique_ptr<IZimgFilter> &&filter_v, bool h_first) :
+		m_buffer_attr(h_first ? filter_h->get_image_attributes() : filter_v->get_image_attributes()),
+		m_flags{},
+		m_step_h{ filter_h->get_simultaneous_lines() },
+		m_step_v{ filter_v->get_simultaneous_lines() },
+		m_lines{},
+		m_max_buffering{},
+		m_buffer_mask{},
+		m_buffer_lines{},
+		m_h_first{ h_first }
+	{
+		ZimgFilterFlags flags_h = filter_h->get_flags();
+		ZimgFilterFlags flags_v = filter_v->get_flags();
+
+		if (!flags_h.same_row || flags_h.has_state || flags_v.has_state || flags_v.entire_plane)
+			throw error::InternalError{ "resize filters can not be fused" };
+
+		// In vertical-first order, each call covers whole groups of both filters.
+		m_lines = h_first ? m_step_v : std::max(m_step_h, m_step_v);
+
+		if (!h_first && (m_lines % m_step_h || m_lines % m_step_v))
+			throw error::InternalError{ "resize filters can not be fused" };
+
+		m_filter_h = std::move(filter_h);
+		m_filter_v = std::move(filter_v);
+
+		if (m_filter_v->get_max_buffering() == (unsigned)-1) {
+			m_max_buffering = -1;
+		} else {
+			for (unsigned i = 0; i < get_image_attributes().height; ++i) {
+				pair_unsigned range = get_required_row_range(i);
+				m_max_buffering = std::max(m_max_buffering, range.second - range.first);
+			}
+		}
+
+		m_buffer_mask = select_zimg_buffer_mask(h_first ? m_max_buffering : m_lines);
+		m_buffer_lines = m_buffer_mask == (unsigned)-1 ? m_buffer_attr.height : m_buffer_mask + 1;
+
+		m_flags.has_state = h_first;
+		m_flags.entire_row = flags_h.entire_row || flags_v.entire_row;
+	}
+
+	ZimgFilterFlags get_flags() const override
+	{
+		return m_flags;
+	}
+
+	image_attributes get_image_attributes() const override
+	{
+		return m_h_first ? m_filter_v->get_image_attributes() : m_filter_h->get_image_attributes();
+	}
+
+	pair_unsigned get_required_row_range(unsigned i) const override
+	{
+		if (m_h_first) {
+			// Extend the range to whole groups of horizontal output rows.
+			pair_unsigned range = m_filter_v->get_required_row_range(i);
+			unsigned height = m_buffer_attr.height;
+
+			return{ mod(range.first, m_step_h), std::min(align(range.second, m_step_h), height) };
+		} else {
+			unsigned last = std::min(i + m_lines, m_buffer_attr.height) - 1;
+
+			return{ m_filter_v->get_required_row_range(i).first, m_filter_v->get_required_row_range(mod(last - i, m_step_v) + i).second };
+		}
+	}
+
+	pair_unsigned get_required_col_range(unsigned left, unsigned right) const override
+	{
+		return m_filter_h->get_required_col_range(left, right);
+	}
+
+	unsigned get_simultaneous_lines() const override
+	{
+		return m_lines;
+	}
+
+	unsigned get_max_buffering() const override
+	{
+		return m_max_buffering;
+	}
+
+	size_t get_context_size() const override
+	{
+		FakeAllocator alloc;
+
+		alloc.allocate_n<fused_context>(1);
+		alloc.allocate(m_filter_h->get_context_size());
+		alloc.allocate(m_filter_v->get_context_size());
+		alloc.allocate((size_t)m_buffer_lines * get_buffer_stride());
+
+		return alloc.count();
+	}
+
+	size_t get_tmp_size(unsigned left, unsigned right) const override
+	{
+		pair_unsigned col_range = m_h_first ? pair_unsigned{ left, right } : m_filter_h->get_required_col_range(left, right);
+
+		return std::max(m_filter_h->get_tmp_size(left, right), m_filter_v->get_tmp_size(col_range.first, col_range.second));
+	}
+
+	void init_context(void *ctx) const override
+	{
+		LinearAllocator alloc{ ctx };
+
+		fused_context *context = new (alloc.allocate_n<fused_context>(1)) fused_context{};
+		context->filter_ctx_h = alloc.allocate(m_filter_h->get_context_size());
+		context->filter_ctx_v = alloc.allocate(m_filter_v->get_context_size());
+		context->buffer = alloc.allocate<char>((size_t)m_buffer_lines * get_buffer_stride());
+
+		m_filter_h->init_context(context->filter_ctx_h);
+		m_filter_v->init_context(context->filter_ctx_v);
+	}
+
+	void process(void *ctx, const ZimgImageBufferConst &src, const ZimgImageBuffer &dst, void *tmp, unsigned i, unsigned left, unsigned right) const override
+	{
+		fused_context *context = static_cast<fused_context *>(ctx);
+
+		if (m_h_first)
+			process_h_first(context, src, dst, tmp, i, left, right);
+		else
+			process_v_first(context, src, dst, tmp, i, left, right);
+	}
+
+	const char *get_stats_annotation() const override
+	{
+		return m_h_first ? "h-first" : "v-first";
+	}
+};
 
 } // namespace
 
@@ -38,19 +248,22 @@ std::pair<IZimgFilter *, IZimgFilter *> create_resize2(
 	} else if (skip_v) {
 		return{ create_resize_impl2(filter, type, true, depth, src_width, src_height, dst_width, dst_height, shift_w, subwidth, cpu), nullptr };
 	} else {
-		bool h_first = resize_h_first((double)dst_width / src_width, (double)dst_height / src_height);
-		std::unique_ptr<IZimgFilter> stage1;
-		std::unique_ptr<IZimgFilter> stage2;
+		// The filters are cached, so computing them here does not duplicate work.
+		unsigned taps_h = compute_filter_cached(filter, src_width, dst_width, shift_w, subwidth)->filter_width;
+		unsigned taps_v = compute_filter_cached(filter, src_height, dst_height, shift_h, subheight)->filter_width;
+		bool h_first = resize_h_first(get_resize_cost_table(cpu), type, taps_h, taps_v, src_width, src_height, dst_width, dst_height);
+		std::unique_ptr<IZimgFilter> filter_h;
+		std::unique_ptr<IZimgFilter> filter_v;
 
 		if (h_first) {
-			stage1.reset(create_resize_impl2(filter, type, true, depth, src_width, src_height, dst_width, src_height, shift_w, subwidth, cpu));
-			stage2.reset(create_resize_impl2(filter, type, false, depth, dst_width, src_height, dst_width, dst_height, shift_h, subheight, cpu));
+			filter_h.reset(create_resize_impl2(filter, type, true, depth, src_width, src_height, dst_width, src_height, shift_w, subwidth, cpu));
+			filter_v.reset(create_resize_impl2(filter, type, false, depth, dst_width, src_height, dst_width, dst_height, shift_h, subheight, cpu));
 		} else {
-			stage1.reset(create_resize_impl2(filter, type, false, depth, src_width, src_height, src_width, dst_height, shift_h, subheight, cpu));
-			stage2.reset(create_resize_impl2(filter, type, true, depth, src_width, dst_height, dst_width, dst_height, shift_w, subwidth, cpu));
+			filter_v.reset(create_resize_impl2(filter, type, false, depth, src_width, src_height, src_width, dst_height, shift_h, subheight, cpu));
+			filter_h.reset(create_resize_impl2(filter, type, true, depth, src_width, dst_height, dst_width, dst_height, shift_w, subwidth, cpu));
 		}
 
-		return{ stage1.release(), stage2.release() };
+		return{ new FusedResize2D{ std::move(filter_h), std::move(filter_v), h_first }, nullptr };
 	}
 }
 
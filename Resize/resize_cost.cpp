@@ -0,0 +1,83 @@
+#include "Common/cpuinfo.h"
+#include "Common/pixel.h"
+#include "resize_cost.h"
+
+namespace zimg {;
+namespace resize {;
+
+namespace {;
+
+// Generated by "zimg-test resizecost --times 15 --cpu <cpu>", which takes the
+// median of the repeated runs. Each row lists the horizontal or vertical
+// costs for BYTE, WORD, HALF, and FLOAT. Only the ratios between entries
+// affect the chosen order. Types that a tier does not implement repeat the
+// entry of the tier they fall back to.
+const ResizeCostTable RESIZE_COST_C = {
+	{ { 7.301, 0.662 }, { 0.000, 1.034 }, { 9.815, 2.222 }, { 0.000, 1.374 } },
+	{ { 4.269, 0.768 }, { 0.000, 1.446 }, { 9.383, 2.504 }, { 0.000, 1.322 } },
+};
+
+#ifdef ZIMG_X86
+// HALF uses the C kernels.
+const ResizeCostTable RESIZE_COST_SSE2 = {
+	{ { 1.041, 0.155 }, { 0.903, 0.160 }, { 9.815, 2.222 }, { 1.078, 0.353 } },
+	{ { 0.337, 0.141 }, { 0.423, 0.187 }, { 9.383, 2.504 }, { 0.278, 0.266 } },
+};
+
+const ResizeCostTable RESIZE_COST_AVX2 = {
+	{ { 0.877, 0.095 }, { 0.888, 0.104 }, { 0.989, 0.194 }, { 1.165, 0.182 } },
+	{ { 0.364, 0.075 }, { 0.354, 0.075 }, { 0.407, 0.077 }, { 0.301, 0.076 } },
+};
+
+// BYTE and HALF use the AVX2 kernels.
+const ResizeCostTable RESIZE_COST_AVX512 = {
+	{ { 0.877, 0.095 }, { 0.757, 0.056 }, { 0.989, 0.194 }, { 1.097, 0.069 } },
+	{ { 0.364, 0.075 }, { 0.255, 0.041 }, { 0.407, 0.077 }, { 0.049, 0.076 } },
+};
+#endif // ZIMG_X86
+
+} // namespace
+
+
+const ResizeCostTable &get_resize_cost_table(CPUClass cpu)
+{
+#ifdef ZIMG_X86
+	if (cpu == CPUClass::CPU_AUTO) {
+		X86Capabilities caps = query_x86_capabilities();
+
+		if (caps.avx512f && caps.avx512bw && caps.avx512vl)
+			return RESIZE_COST_AVX512;
+		else if (caps.avx2 && caps.fma)
+			return RESIZE_COST_AVX2;
+		else if (caps.sse2)
+			return RESIZE_COST_SSE2;
+	} else if (cpu >= CPUClass::CPU_X86_AVX512) {
+		return RESIZE_COST_AVX512;
+	} else if (cpu >= CPUClass::CPU_X86_AVX2) {
+		return RESIZE_COST_AVX2;
+	} else if (cpu >= CPUClass::CPU_X86_SSE2) {
+		return RESIZE_COST_SSE2;
+	}
+#endif // ZIMG_X86
+	return RESIZE_COST_C;
+}
+
+double estimate_resize_cost(const ResizeKernelCost &cost, unsigned taps, unsigned width, unsigned height)
+{
+	return (cost.fixed + cost.per_tap * taps) * ((double)width * height);
+}
+
+bool resize_h_first(const ResizeCostTable &table, PixelType type, unsigned taps_h, unsigned taps_v,
+                    unsigned src_width, unsigned src_height, unsigned dst_width, unsigned dst_height)
+{
+	const ResizeKernelCost &cost_h = table.h[static_cast<int>(type)];
+	const ResizeKernelCost &cost_v = table.v[static_cast<int>(type)];
+
+	double h_first_cost = estimate_resize_cost(cost_h, taps_h, dst_width, src_height) + estimate_resize_cost(cost_v, taps_v, dst_width, dst_height);
+	double v_first_cost = estimate_resize_cost(cost_v, taps_v, src_width, dst_height) + estimate_resize_cost(cost_h, taps_h, dst_width, dst_height);
+
+	return h_first_cost < v_first_cost;
+}
+
+} // namespace resize
+} // namespace zimg
@@ -0,0 +1,69 @@
+#pragma once
+
+#ifndef ZIMG_RESIZE_RESIZE_COST_H_
+#define ZIMG_RESIZE_RESIZE_COST_H_
+
+namespace zimg {;
+
+enum class CPUClass;
+enum class PixelType;
+
+namespace resize {;
+
+/**
+ * Linear model of the time taken by a resize kernel to produce one output
+ * sample, in nanoseconds: fixed + per_tap * taps.
+ */
+struct ResizeKernelCost {
+	double fixed;
+	double per_tap;
+};
+
+/**
+ * Kernel costs for one CPU class, indexed by pixel type.
+ */
+struct ResizeCostTable {
+	ResizeKernelCost h[4];
+	ResizeKernelCost v[4];
+};
+
+/**
+ * Get the cost table for the kernels selected by a given CPU class.
+ *
+ * @param cpu CPU class, CPU_AUTO selects the table of the host CPU
+ * @return cost table
+ */
+const ResizeCostTable &get_resize_cost_table(CPUClass cpu);
+
+/**
+ * Estimate the time taken by a resize pass.
+ *
+ * @param cost kernel cost
+ * @param taps filter width
+ * @param width output width
+ * @param height output height
+ * @return estimated time in nanoseconds
+ */
+double estimate_resize_cost(const ResizeKernelCost &cost, unsigned taps, unsigned width, unsigned height);
+
+/**
+ * Determine whether a two-dimensional resize is faster when the horizontal
+ * pass is performed first.
+ *
+ * @param table kernel costs
+ * @param type pixel type
+ * @param taps_h filter width of the horizontal pass
+ * @param taps_v filter width of the vertical pass
+ * @param src_width source width
+ * @param src_height source height
+ * @param dst_width destination width
+ * @param dst_height destination height
+ * @return true if the horizontal pass should be performed first
+ */
+bool resize_h_first(const ResizeCostTable &table, PixelType type, unsigned taps_h, unsigned taps_v,
+                    unsigned src_width, unsigned src_height, unsigned dst_width, unsigned dst_height);
+
+} // namespace resize
+} // namespace zimg
+
+#endif // ZIMG_RESIZE_RESIZE_COST_H_
@@ -1,229 +1,401 @@
 #include <algorithm>
+#include <cstddef>
 #include <cstdint>
+#include <memory>
 #include "Common/except.h"
 #include "Common/linebuffer.h"
 #include "Common/pixel.h"
 #include "Common/zfilter.h"
 #include "filter.h"
+#include "filter_cache.h"
 #include "resize_impl2.h"
+#include "resize_impl2_x86.h"
 
 namespace zimg {;
 namespace resize {;
 
 namespace {;
 
-int32_t unpack_pixel_u16(uint16_t x)
-{
-	return (int32_t)x + INT16_MIN;
-}
+class ResizeImplH_C : public ResizeImplH {
+	int32_t m_pixel_max;
+public:
+	ResizeImplH_C(const FilterContext &filter, unsigned height, PixelType type, unsigned depth) :
+		ResizeImplH(filter, image_attributes{ filter.filter_rows, height, type }),
+		m_pixel_max{ (int32_t)((uint32_t)1 << depth) - 1 }
+	{
+		if (type != PixelType::BYTE && type != PixelType::WORD && type != PixelType::HALF && type != PixelType::FLOAT)
+			throw zimg::error::InternalError{ "pixel type not supported" };
+	}
 
-uint16_t pack_pixel_u16(int32_t x, int32_t pixel_max)
-{
-	x = ((x + (1 << 13)) >> 14) - INT16_MIN;
-	x = std::max(std::min(x, pixel_max), (int32_t)0);
+	void process(void *, const ZimgImageBufferConst &src, const ZimgImageBuffer &dst, void *, unsigned i, unsigned left, unsigned right) const override
+	{
+		if (m_attr.type == PixelType::BYTE) {
+			LineBuffer<const uint8_t> src_buf{ src };
+			LineBuffer<uint8_t> dst_buf{ dst };
 
-	return (uint16_t)x;
-}
+			resize_line_h_u8_c(m_filter, src_buf[i], dst_buf[i], left, right, m_pixel_max);
+		} else if (m_attr.type == PixelType::WORD) {
+			LineBuffer<const uint16_t> src_buf{ src };
+			LineBuffer<uint16_t> dst_buf{ dst };
 
-void resize_line_h_u16_c(const FilterContext &filter, const uint16_t *src, uint16_t *dst, unsigned left, unsigned right, unsigned pixel_max)
-{
-	for (unsigned j = left; j < right; ++j) {
-		unsigned left = filter.left[j];
-		int32_t accum = 0;
+			resize_line_h_u16_c(m_filter, src_buf[i], dst_buf[i], left, right, m_pixel_max);
+		} else if (m_attr.type == PixelType::HALF) {
+			LineBuffer<const uint16_t> src_buf{ src };
+			LineBuffer<uint16_t> dst_buf{ dst };
 
-		for (unsigned k = 0; k < filter.filter_width; ++k) {
-			int32_t coeff = filter.data_i16[j * filter.stride_i16 + k];
-			int32_t x = unpack_pixel_u16(src[left + k]);
+			resize_line_h_f16_c(m_filter, src_buf[i], dst_buf[i], left, right);
+		} else {
+			LineBuffer<const float> src_buf{ src };
+			LineBuffer<float> dst_buf{ dst };
 
-			accum += coeff * x;
+			resize_line_h_f32_c(m_filter, src_buf[i], dst_buf[i], left, right);
 		}
+	}
+};
 
-		dst[j] = pack_pixel_u16(accum, pixel_max);
+class ResizeImplV_C : public ResizeImplV {
+	int32_t m_pixel_max;
+public:
+	ResizeImplV_C(const FilterContext &filter, unsigned width, PixelType type, unsigned depth) :
+		ResizeImplV(filter, image_attributes{ width, filter.filter_rows, type }),
+		m_pixel_max{ (int32_t)((uint32_t)1 << depth) - 1 }
+	{
+		if (type != PixelType::BYTE && type != PixelType::WORD && type != PixelType::HALF && type != PixelType::FLOAT)
+			throw zimg::error::InternalError{ "pixel type not supported" };
 	}
-}
 
-void resize_line_h_f32_c(const FilterContext &filter, const float *src, float *dst, unsigned left, unsigned right)
-{
-	for (unsigned j = left; j < right; ++j) {
-		unsigned top = filter.left[j];
-		float accum = 0;
+	void process(void *, const ZimgImageBufferConst &src, const ZimgImageBuffer &dst, void *, unsigned i, unsigned left, unsigned right) const override
+	{
+		if (m_attr.type == PixelType::BYTE) {
+			LineBuffer<const uint8_t> src_buf{ src };
+			LineBuffer<uint8_t> dst_buf{ dst };
 
-		for (unsigned k = 0; k < filter.filter_width; ++k) {
-			float coeff = filter.data[j * filter.stride + k];
-			float x = src[top + k];
+			resize_line_v_u8_c(m_filter, src_buf, dst_buf, i, left, right, m_pixel_max);
+		} else if (m_attr.type == PixelType::WORD) {
+			LineBuffer<const uint16_t> src_buf{ src };
+			LineBuffer<uint16_t> dst_buf{ dst };
 
-			accum += coeff * x;
-		}
+			resize_line_v_u16_c(m_filter, src_buf, dst_buf, i, left, right, m_pixel_max);
+		} else if (m_attr.type == PixelType::HALF) {
+			LineBuffer<const uint16_t> src_buf{ src };
+			LineBuffer<uint16_t> dst_buf{ dst };
+
+			resize_line_v_f16_c(m_filter, src_buf, dst_buf, i, left, right);
+		} else {
+			LineBuffer<const float> src_buf{ src };
+			LineBuffer<float> dst_buf{ dst };
 
-		dst[j] = accum;
+			resize_line_v_f32_c(m_filter, src_buf, dst_buf, i, left, right);
+		}
 	}
-}
+};
 
-void resize_line_v_u16_c(const FilterContext &filter, const LineBuffer<const uint16_t> &src, LineBuffer<uint16_t> &dst, unsigned i, unsigned left, unsigned right, unsigned pixel_max)
-{
-	const int16_t *filter_coeffs = &filter.data_i16[i * filter.stride_i16];
-	unsigned top = filter.left[i];
+struct ScalarPolicy_U8 {
+	typedef uint8_t pixel_type;
+	typedef int32_t num_type;
 
-	for (unsigned j = left; j < right; ++j) {
-		int32_t accum = 0;
+	int32_t pixel_max;
 
-		for (unsigned k = 0; k < filter.filter_width; ++k) {
-			int32_t coeff = filter_coeffs[k];
-			int32_t x = unpack_pixel_u16(src[top + k][j]);
+	const int16_t *coeffs(const FilterContext &filter, unsigned phase) const { return &filter.data_i16[phase * filter.stride_i16]; }
 
-			accum += coeff * x;
-		}
+	int32_t load(uint8_t x) const { return x; }
 
-		dst[i][j] = pack_pixel_u16(accum, pixel_max);
-	}
-}
+	uint8_t store(int32_t x) const { return pack_pixel_u8(x, pixel_max); }
+};
+
+struct ScalarPolicy_U16 {
+	typedef uint16_t pixel_type;
+	typedef int32_t num_type;
+
+	int32_t pixel_max;
+
+	const int16_t *coeffs(const FilterContext &filter, unsigned phase) const { return &filter.data_i16[phase * filter.stride_i16]; }
+
+	int32_t load(uint16_t x) const { return unpack_pixel_u16(x); }
+
+	uint16_t store(int32_t x) const { return pack_pixel_u16(x, pixel_max); }
+};
+
+struct ScalarPolicy_F16 {
+	typedef uint16_t pixel_type;
+	typedef float num_type;
+
+	const float *coeffs(const FilterContext &filter, unsigned phase) const { return &filter.data[phase * filter.stride]; }
+
+	float load(uint16_t x) const { return depth::half_to_float(x); }
 
-void resize_line_v_f32_c(const FilterContext &filter, const LineBuffer<const float> &src, LineBuffer<float> &dst, unsigned i, unsigned left, unsigned right)
+	uint16_t store(float x) const { return depth::float_to_half(x); }
+};
+
+struct ScalarPolicy_F32 {
+	typedef float pixel_type;
+	typedef float num_type;
+
+	const float *coeffs(const FilterContext &filter, unsigned phase) const { return &filter.data[phase * filter.stride]; }
+
+	float load(float x) const { return x; }
+
+	float store(float x) const { return x; }
+};
+
+// Same arithmetic as the generic kernels, with the tap count and block layout known at compile time.
+template <unsigned OutPeriod, unsigned InPeriod, unsigned Taps, class Policy>
+void resize_line_h_periodic_c(const FilterContext &filter, const FilterPeriod &period, const typename Policy::pixel_type *src, typename Policy::pixel_type *dst,
+                              unsigned left, unsigned right, const Policy &policy)
 {
-	const float *filter_coeffs = &filter.data[i * filter.stride];
-	unsigned top = filter.left[i];
+	typedef typename Policy::num_type num_type;
 
 	for (unsigned j = left; j < right; ++j) {
-		float accum = 0;
+		unsigned b = j / OutPeriod;
+		unsigned r = j % OutPeriod;
 
-		for (unsigned k = 0; k < filter.filter_width; ++k) {
-			float coeff = filter_coeffs[k];
-			float x = src[top + k][j];
+		auto coeffs = policy.coeffs(filter, period.phase[r]);
+		const typename Policy::pixel_type *src_p = src + (ptrdiff_t)InPeriod * b + period.offset[r];
+		num_type accum = 0;
 
-			accum += coeff * x;
+		for (unsigned k = 0; k < Taps; ++k) {
+			accum += coeffs[k] * policy.load(src_p[k]);
 		}
 
-		dst[i][j] = accum;
+		dst[j] = policy.store(accum);
 	}
 }
 
-
-class ResizeImplH_C : public ZimgFilter {
-	FilterContext m_filter;
-	unsigned m_height;
-	PixelType m_type;
+template <unsigned OutPeriod, unsigned InPeriod, unsigned Taps>
+class ResizeImplH_Int_C : public ResizeImplH {
+	FilterPeriod m_period;
 	int32_t m_pixel_max;
-	bool m_is_sorted;
 public:
-	ResizeImplH_C(const FilterContext &filter, unsigned height, PixelType type, unsigned depth) :
-		m_filter(filter),
-		m_height{ height },
-		m_type{ type },
-		m_pixel_max{ (int32_t)((uint32_t)1 << depth) - 1 },
-		m_is_sorted{ std::is_sorted(m_filter.left.begin(), m_filter.left.end()) }
+	ResizeImplH_Int_C(const FilterContext &filter, const FilterPeriod &period, unsigned height, PixelType type, unsigned depth) :
+		ResizeImplH(filter, image_attributes{ filter.filter_rows, height, type }),
+		m_period(period),
+		m_pixel_max{ (int32_t)((uint32_t)1 << depth) - 1 }
 	{
-		if (m_type != PixelType::WORD && m_type != PixelType::FLOAT)
+		if (type != PixelType::BYTE && type != PixelType::WORD && type != PixelType::HALF && type != PixelType::FLOAT)
 			throw zimg::error::InternalError{ "pixel type not supported" };
 	}
 
-	ZimgFilterFlags get_flags() const override
+	void process(void *, const ZimgImageBufferConst &src, const ZimgImageBuffer &dst, void *, unsigned i, unsigned left, unsigned right) const override
 	{
-		ZimgFilterFlags flags{};
+		const FilterContext &filter = m_filter;
+		const FilterPeriod &period = m_period;
+		int32_t pixel_max = m_pixel_max;
+
+		if (m_attr.type == PixelType::BYTE) {
+			const uint8_t *src_p = LineBuffer<const uint8_t>{ src }[i];
+			uint8_t *dst_p = LineBuffer<uint8_t>{ dst }[i];
+
+			resize_line_h_periodic(period, left, right,
+				[&](unsigned l, unsigned r) { resize_line_h_u8_c(filter, src_p, dst_p, l, r, pixel_max); },
+				[&](unsigned l, unsigned r) { resize_line_h_periodic_c<OutPeriod, InPeriod, Taps>(filter, period, src_p, dst_p, l, r, ScalarPolicy_U8{ pixel_max }); });
+		} else if (m_attr.type == PixelType::WORD) {
+			const uint16_t *src_p = LineBuffer<const uint16_t>{ src }[i];
+			uint16_t *dst_p = LineBuffer<uint16_t>{ dst }[i];
+
+			resize_line_h_periodic(period, left, right,
+				[&](unsigned l, unsigned r) { resize_line_h_u16_c(filter, src_p, dst_p, l, r, pixel_max); },
+				[&](unsigned l, unsigned r) { resize_line_h_periodic_c<OutPeriod, InPeriod, Taps>(filter, period, src_p, dst_p, l, r, ScalarPolicy_U16{ pixel_max }); });
+		} else if (m_attr.type == PixelType::HALF) {
+			const uint16_t *src_p = LineBuffer<const uint16_t>{ src }[i];
+			uint16_t *dst_p = LineBuffer<uint16_t>{ dst }[i];
+
+			resize_line_h_periodic(period, left, right,
+				[&](unsigned l, unsigned r) { resize_line_h_f16_c(filter, src_p, dst_p, l, r); },
+				[&](unsigned l, unsigned r) { resize_line_h_periodic_c<OutPeriod, InPeriod, Taps>(filter, period, src_p, dst_p, l, r, ScalarPolicy_F16{}); });
+		} else {
+			const float *src_p = LineBuffer<const float>{ src }[i];
+			float *dst_p = LineBuffer<float>{ dst }[i];
 
-		flags.same_row = true;
-		flags.entire_row = !m_is_sorted;
+			resize_line_h_periodic(period, left, right,
+				[&](unsigned l, unsigned r) { resize_line_h_f32_c(filter, src_p, dst_p, l, r); },
+				[&](unsigned l, unsigned r) { resize_line_h_periodic_c<OutPeriod, InPeriod, Taps>(filter, period, src_p, dst_p, l, r, ScalarPolicy_F32{}); });
+		}
+	}
+};
 
-		return flags;
+bool get_integer_period(unsigned src_dim, unsigned dst_dim, double shift, double subwidth, unsigned *out_period, unsigned *in_period)
+{
+	if (shift != 0.0 || subwidth != src_dim)
+		return false;
+
+	if (src_dim == dst_dim * 2 || src_dim == dst_dim * 4) {
+		*out_period = 1;
+		*in_period = src_dim / dst_dim;
+		return true;
+	} else if (dst_dim == src_dim * 2) {
+		*out_period = 2;
+		*in_period = 1;
+		return true;
+	} else {
+		return false;
 	}
+}
 
-	image_attributes get_image_attributes() const override
-	{
-		return{ m_filter.filter_rows, m_height, m_type };
+} // namespace
+
+
+FilterPeriod compute_filter_period(const FilterContext &filter, unsigned out_period, unsigned in_period)
+{
+	FilterPeriod period{};
+	unsigned num_blocks = filter.filter_rows / out_period;
+
+	if (out_period > FilterPeriod::max_period)
+		throw zimg::error::InternalError{ "filter period too large" };
+
+	period.out_period = out_period;
+	period.in_period = in_period;
+
+	if (num_blocks == 0)
+		return period;
+
+	// Border rows are mirrored, so search outwards from the center for the periodic interior.
+	unsigned mid = num_blocks / 2;
+
+	for (unsigned r = 0; r < out_period; ++r) {
+		period.phase[r] = filter.phase[mid * out_period + r];
+		period.offset[r] = (int)filter.left[mid * out_period + r] - (int)(mid * in_period);
 	}
 
-	pair_unsigned get_required_col_range(unsigned left, unsigned right) const override
+	auto is_periodic = [&](unsigned b)
 	{
-		if (m_is_sorted) {
-			unsigned col_left = m_filter.left[left];
-			unsigned col_right = m_filter.left[right - 1] + m_filter.filter_width;
-
-			return{ col_left, col_right };
-		} else {
-			return{ 0, m_filter.input_width };
+		for (unsigned r = 0; r < out_period; ++r) {
+			if (filter.phase[b * out_period + r] != period.phase[r] || (int)filter.left[b * out_period + r] != (int)(b * in_period) + period.offset[r])
+				return false;
 		}
+		return true;
+	};
+
+	period.block_left = mid;
+	period.block_right = mid + 1;
+
+	while (period.block_left > 0 && is_periodic(period.block_left - 1)) {
+		--period.block_left;
+	}
+	while (period.block_right < num_blocks && is_periodic(period.block_right)) {
+		++period.block_right;
 	}
 
-	void process(void *, const ZimgImageBufferConst &src, const ZimgImageBuffer &dst, void *, unsigned i, unsigned left, unsigned right) const override
-	{
-		if (m_type == PixelType::WORD) {
-			LineBuffer<const uint16_t> src_buf{ src };
-			LineBuffer<uint16_t> dst_buf{ dst };
+	return period;
+}
 
-			resize_line_h_u16_c(m_filter, src_buf[i], dst_buf[i], left, right, m_pixel_max);
-		} else {
-			LineBuffer<const float> src_buf{ src };
-			LineBuffer<float> dst_buf{ dst };
+void pack_filter_pairs(const FilterContext &filter, unsigned i, unsigned n, uint32_t *pairs)
+{
+	unsigned top = filter.left[i];
+	unsigned span_pairs = (filter_span(filter, i, n) + 1) / 2;
 
-			resize_line_h_f32_c(m_filter, src_buf[i], dst_buf[i], left, right);
+	for (unsigned r = 0; r < n; ++r) {
+		const int16_t *coeffs = &filter.data_i16[filter.phase[i + r] * filter.stride_i16];
+		unsigned offset = filter.left[i + r] - top;
+
+		for (unsigned p = 0; p < span_pairs; ++p) {
+			// Indices before the row's first tap wrap around and fail the bounds check.
+			unsigned k0 = p * 2 - offset;
+			unsigned k1 = p * 2 + 1 - offset;
+
+			uint16_t c0 = k0 < filter.filter_width ? (uint16_t)coeffs[k0] : 0;
+			uint16_t c1 = k1 < filter.filter_width ? (uint16_t)coeffs[k1] : 0;
+
+			pairs[r * span_pairs + p] = c0 | ((uint32_t)c1 << 16);
 		}
 	}
-};
+}
 
-class ResizeImplV_C : public ZimgFilter {
-	FilterContext m_filter;
-	unsigned m_width;
-	PixelType m_type;
-	int32_t m_pixel_max;
-	bool m_is_sorted;
-public:
-	ResizeImplV_C(const FilterContext &filter, unsigned width, PixelType type, unsigned depth) :
-		m_filter(filter),
-		m_width{ width },
-		m_type{ type },
-		m_pixel_max{ (int32_t)((uint32_t)1 << depth) - 1 },
-		m_is_sorted{ std::is_sorted(m_filter.left.begin(), m_filter.left.end()) }
-	{
-		if (m_type != PixelType::WORD && m_type != PixelType::FLOAT)
-			throw zimg::error::InternalError{ "pixel type not supported" };
-	}
+ResizeImplH::ResizeImplH(const FilterContext &filter, const image_attributes &attr) :
+	m_filter(filter),
+	m_attr(attr),
+	m_is_sorted{ std::is_sorted(m_filter.left.begin(), m_filter.left.end()) }
+{
+}
 
-	ZimgFilterFlags get_flags() const override
-	{
-		ZimgFilterFlags flags{};
+ZimgFilterFlags ResizeImplH::get_flags() const
+{
+	ZimgFilterFlags flags{};
 
-		flags.entire_row = !m_is_sorted;
+	flags.same_row = true;
+	flags.entire_row = !m_is_sorted;
 
-		return flags;
-	}
+	return flags;
+}
 
-	image_attributes get_image_attributes() const override
-	{
-		return{ m_width, m_filter.filter_rows, m_type };
+IZimgFilter::image_attributes ResizeImplH::get_image_attributes() const
+{
+	return m_attr;
+}
+
+IZimgFilter::pair_unsigned ResizeImplH::get_required_row_range(unsigned i) const
+{
+	return{ i, std::min(i + get_simultaneous_lines(), m_attr.height) };
+}
+
+IZimgFilter::pair_unsigned ResizeImplH::get_required_col_range(unsigned left, unsigned right) const
+{
+	if (m_is_sorted) {
+		unsigned col_left = m_filter.left[left];
+		unsigned col_right = m_filter.left[right - 1] + m_filter.filter_width;
+
+		return{ col_left, col_right };
+	} else {
+		return{ 0, m_filter.input_width };
 	}
+}
 
-	pair_unsigned get_required_row_range(unsigned i) const override
-	{
-		if (m_is_sorted) {
-			unsigned row = m_filter.left[i];
+unsigned ResizeImplH::get_max_buffering() const
+{
+	return get_simultaneous_lines();
+}
 
-			return{ row, row + m_filter.filter_width };
-		} else {
-			return{ 0, m_filter.input_width };
+
+ResizeImplV::ResizeImplV(const FilterContext &filter, const image_attributes &attr, unsigned lines) :
+	m_filter(filter),
+	m_attr(attr),
+	m_is_sorted{ std::is_sorted(m_filter.left.begin(), m_filter.left.end()) },
+	m_lines{ m_is_sorted ? lines : 1 },
+	m_max_buffering{}
+{
+	if (m_is_sorted) {
+		for (unsigned i = 0; i < m_attr.height; ++i) {
+			pair_unsigned range = ResizeImplV::get_required_row_range(i);
+			m_max_buffering = std::max(m_max_buffering, range.second - range.first);
 		}
+	} else {
+		m_max_buffering = -1;
 	}
+}
 
-	unsigned get_max_buffering() const override
-	{
-		return m_is_sorted ? m_filter.filter_width : -1;
-	}
+ZimgFilterFlags ResizeImplV::get_flags() const
+{
+	ZimgFilterFlags flags{};
 
-	void process(void *, const ZimgImageBufferConst &src, const ZimgImageBuffer &dst, void *, unsigned i, unsigned left, unsigned right) const override
-	{
-		if (m_type == PixelType::WORD) {
-			LineBuffer<const uint16_t> src_buf{ src };
-			LineBuffer<uint16_t> dst_buf{ dst };
+	flags.entire_row = !m_is_sorted;
 
-			resize_line_v_u16_c(m_filter, src_buf, dst_buf, i, left, right, m_pixel_max);
-		} else {
-			LineBuffer<const float> src_buf{ src };
-			LineBuffer<float> dst_buf{ dst };
+	return flags;
+}
 
-			resize_line_v_f32_c(m_filter, src_buf, dst_buf, i, left, right);
-		}
+IZimgFilter::image_attributes ResizeImplV::get_image_attributes() const
+{
+	return m_attr;
+}
+
+IZimgFilter::pair_unsigned ResizeImplV::get_required_row_range(unsigned i) const
+{
+	if (m_is_sorted) {
+		unsigned last = std::min(i + m_lines, m_attr.height) - 1;
+
+		return{ m_filter.left[i], m_filter.left[last] + m_filter.filter_width };
+	} else {
+		return{ 0, m_filter.input_width };
 	}
-};
+}
 
-} // namespace
+unsigned ResizeImplV::get_simultaneous_lines() const
+{
+	return m_lines;
+}
+
+unsigned ResizeImplV::get_max_buffering() const
+{
+	return m_max_buffering;
+}
 
 
 IZimgFilter *create_resize_impl2(const Filter &f, PixelType type, bool horizontal, unsigned depth, unsigned src_width, unsigned src_height, unsigned dst_width, unsigned dst_height,
@@ -235,12 +407,34 @@ IZimgFilter *create_resize_impl2(const Filter &f, PixelType type, bool horizonta
 	if (src_width != dst_width && src_height != dst_height)
 		throw zimg::error::InternalError{ "cannot resize both width and height" };
 
-	FilterContext filter_ctx = compute_filter(f, src_dim, dst_dim, shift, subwidth);
-
-	if (horizontal)
-		return new ResizeImplH_C{ filter_ctx, dst_height, type, depth };
-	else
-		return new ResizeImplV_C{ filter_ctx, dst_width, type, depth };
+	std::shared_ptr<const FilterContext> filter_ptr = compute_filter_cached(f, src_dim, dst_dim, shift, subwidth);
+	const FilterContext &filter_ctx = *filter_ptr;
+	FilterPeriod period{};
+	IZimgFilter *ret = nullptr;
+
+	// Integer scale factors have dedicated horizontal kernels with a fixed number of taps.
+	unsigned out_period;
+	unsigned in_period;
+	bool is_integer = horizontal && get_integer_period(src_dim, dst_dim, shift, subwidth, &out_period, &in_period);
+
+	if (is_integer)
+		period = compute_filter_period(filter_ctx, out_period, in_period);
+#ifdef ZIMG_X86
+	if (!ret && is_integer)
+		ret = create_resize_impl2_int_h_x86(filter_ctx, period, dst_height, type, depth, cpu);
+	if (!ret && horizontal)
+		ret = create_resize_impl2_h_x86(filter_ctx, dst_height, type, depth, cpu);
+	else if (!ret)
+		ret = create_resize_impl2_v_x86(filter_ctx, dst_width, type, depth, cpu);
+#endif
+	if (!ret && is_integer)
+		ret = create_resize_impl2_int_h<ResizeImplH_Int_C>(period, filter_ctx.filter_width, filter_ctx, period, dst_height, type, depth);
+	if (!ret && horizontal)
+		ret = new ResizeImplH_C{ filter_ctx, dst_height, type, depth };
+	else if (!ret)
+		ret = new ResizeImplV_C{ filter_ctx, dst_width, type, depth };
+
+	return ret;
 }
 
 } // namespace resize
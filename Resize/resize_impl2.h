@@ -3,16 +3,303 @@
 #ifndef ZIMG_RESIZE_RESIZE_IMPL2_H_
 #define ZIMG_RESIZE_RESIZE_IMPL2_H_
 
+#include <algorithm>
+#include <cstdint>
+#include <utility>
+#include "Common/linebuffer.h"
+#include "Common/zfilter.h"
+#include "Depth/quantize.h"
+#include "filter.h"
+
 namespace zimg {;
 
 enum class CPUClass;
 enum class PixelType;
 
-class IZimgFilter;
-
 namespace resize {;
 
-class Filter;
+inline int32_t unpack_pixel_u16(uint16_t x)
+{
+	return (int32_t)x + INT16_MIN;
+}
+
+inline uint16_t pack_pixel_u16(int32_t x, int32_t pixel_max)
+{
+	x = ((x + (1 << 13)) >> 14) - INT16_MIN;
+	x = std::max(std::min(x, pixel_max), (int32_t)0);
+
+	return (uint16_t)x;
+}
+
+inline uint8_t pack_pixel_u8(int32_t x, int32_t pixel_max)
+{
+	x = (x + (1 << 13)) >> 14;
+	x = std::max(std::min(x, pixel_max), (int32_t)0);
+
+	return (uint8_t)x;
+}
+
+inline void resize_line_h_u8_c(const FilterContext &filter, const uint8_t *src, uint8_t *dst, unsigned left, unsigned right, unsigned pixel_max)
+{
+	for (unsigned j = left; j < right; ++j) {
+		unsigned left = filter.left[j];
+		int32_t accum = 0;
+
+		for (unsigned k = 0; k < filter.filter_width; ++k) {
+			int32_t coeff = filter.data_i16[filter.phase[j] * filter.stride_i16 + k];
+			int32_t x = src[left + k];
+
+			accum += coeff * x;
+		}
+
+		dst[j] = pack_pixel_u8(accum, pixel_max);
+	}
+}
+
+inline void resize_line_h_u16_c(const FilterContext &filter, const uint16_t *src, uint16_t *dst, unsigned left, unsigned right, unsigned pixel_max)
+{
+	for (unsigned j = left; j < right; ++j) {
+		unsigned left = filter.left[j];
+		int32_t accum = 0;
+
+		for (unsigned k = 0; k < filter.filter_width; ++k) {
+			int32_t coeff = filter.data_i16[filter.phase[j] * filter.stride_i16 + k];
+			int32_t x = unpack_pixel_u16(src[left + k]);
+
+			accum += coeff * x;
+		}
+
+		dst[j] = pack_pixel_u16(accum, pixel_max);
+	}
+}
+
+inline void resize_line_h_f32_c(const FilterContext &filter, const float *src, float *dst, unsigned left, unsigned right)
+{
+	for (unsigned j = left; j < right; ++j) {
+		unsigned top = filter.left[j];
+		float accum = 0;
+
+		for (unsigned k = 0; k < filter.filter_width; ++k) {
+			float coeff = filter.data[filter.phase[j] * filter.stride + k];
+			float x = src[top + k];
+
+			accum += coeff * x;
+		}
+
+		dst[j] = accum;
+	}
+}
+
+inline void resize_line_h_f16_c(const FilterContext &filter, const uint16_t *src, uint16_t *dst, unsigned left, unsigned right)
+{
+	for (unsigned j = left; j < right; ++j) {
+		unsigned top = filter.left[j];
+		float accum = 0;
+
+		for (unsigned k = 0; k < filter.filter_width; ++k) {
+			float coeff = filter.data[filter.phase[j] * filter.stride + k];
+			float x = depth::half_to_float(src[top + k]);
+
+			accum += coeff * x;
+		}
+
+		dst[j] = depth::float_to_half(accum);
+	}
+}
+
+inline void resize_line_v_u16_c(const FilterContext &filter, const LineBuffer<const uint16_t> &src, LineBuffer<uint16_t> &dst, unsigned i, unsigned left, unsigned right, unsigned pixel_max)
+{
+	const int16_t *filter_coeffs = &filter.data_i16[filter.phase[i] * filter.stride_i16];
+	unsigned top = filter.left[i];
+
+	for (unsigned j = left; j < right; ++j) {
+		int32_t accum = 0;
+
+		for (unsigned k = 0; k < filter.filter_width; ++k) {
+			int32_t coeff = filter_coeffs[k];
+			int32_t x = unpack_pixel_u16(src[top + k][j]);
+
+			accum += coeff * x;
+		}
+
+		dst[i][j] = pack_pixel_u16(accum, pixel_max);
+	}
+}
+
+inline void resize_line_v_u8_c(const FilterContext &filter, const LineBuffer<const uint8_t> &src, LineBuffer<uint8_t> &dst, unsigned i, unsigned left, unsigned right, unsigned pixel_max)
+{
+	const int16_t *filter_coeffs = &filter.data_i16[filter.phase[i] * filter.stride_i16];
+	unsigned top = filter.left[i];
+
+	for (unsigned j = left; j < right; ++j) {
+		int32_t accum = 0;
+
+		for (unsigned k = 0; k < filter.filter_width; ++k) {
+			int32_t coeff = filter_coeffs[k];
+			int32_t x = src[top + k][j];
+
+			accum += coeff * x;
+		}
+
+		dst[i][j] = pack_pixel_u8(accum, pixel_max);
+	}
+}
+
+inline void resize_line_v_f32_c(const FilterContext &filter, const LineBuffer<const float> &src, LineBuffer<float> &dst, unsigned i, unsigned left, unsigned right)
+{
+	const float *filter_coeffs = &filter.data[filter.phase[i] * filter.stride];
+	unsigned top = filter.left[i];
+
+	for (unsigned j = left; j < right; ++j) {
+		float accum = 0;
+
+		for (unsigned k = 0; k < filter.filter_width; ++k) {
+			float coeff = filter_coeffs[k];
+			float x = src[top + k][j];
+
+			accum += coeff * x;
+		}
+
+		dst[i][j] = accum;
+	}
+}
+
+inline void resize_line_v_f16_c(const FilterContext &filter, const LineBuffer<const uint16_t> &src, LineBuffer<uint16_t> &dst, unsigned i, unsigned left, unsigned right)
+{
+	const float *filter_coeffs = &filter.data[filter.phase[i] * filter.stride];
+	unsigned top = filter.left[i];
+
+	for (unsigned j = left; j < right; ++j) {
+		float accum = 0;
+
+		for (unsigned k = 0; k < filter.filter_width; ++k) {
+			float coeff = filter_coeffs[k];
+			float x = depth::half_to_float(src[top + k][j]);
+
+			accum += coeff * x;
+		}
+
+		dst[i][j] = depth::float_to_half(accum);
+	}
+}
+
+// Number of input rows spanned by the filter rows [i, i + n).
+inline unsigned filter_span(const FilterContext &filter, unsigned i, unsigned n)
+{
+	return filter.left[i + n - 1] + filter.filter_width - filter.left[i];
+}
+
+/**
+ * Pack the integer coefficients of the filter rows [i, i + n) as word pairs,
+ * aligned to the first input row of the group. Taps outside a row's own
+ * support are zero. Row r is stored at pairs + r * ceil(span / 2).
+ */
+void pack_filter_pairs(const FilterContext &filter, unsigned i, unsigned n, uint32_t *pairs);
+
+/**
+ * Periodic interior of a filter with an integer scale factor. Each block of
+ * out_period outputs starts in_period input samples after the previous block
+ * and reuses the same coefficient rows.
+ */
+struct FilterPeriod {
+	static const unsigned max_period = 2;
+
+	unsigned out_period;
+	unsigned in_period;
+	unsigned block_left;
+	unsigned block_right;
+	int offset[max_period];
+	unsigned phase[max_period];
+};
+
+FilterPeriod compute_filter_period(const FilterContext &filter, unsigned out_period, unsigned in_period);
+
+// Split the output range into edge outputs, which use the generic kernel, and interior outputs.
+template <class Generic, class Interior>
+void resize_line_h_periodic(const FilterPeriod &period, unsigned left, unsigned right, Generic generic, Interior interior)
+{
+	unsigned interior_left = std::max(left, period.block_left * period.out_period);
+	unsigned interior_right = std::min(right, period.block_right * period.out_period);
+
+	if (interior_left >= interior_right) {
+		generic(left, right);
+		return;
+	}
+
+	if (left < interior_left)
+		generic(left, interior_left);
+
+	interior(interior_left, interior_right);
+
+	if (interior_right < right)
+		generic(interior_right, right);
+}
+
+// Instantiate Impl<OutPeriod, InPeriod, Taps> for the specialized integer factors and tap counts.
+template <template <unsigned, unsigned, unsigned> class Impl, class ...Args>
+IZimgFilter *create_resize_impl2_int_h(const FilterPeriod &period, unsigned taps, Args &&...args)
+{
+	unsigned out_period = period.out_period;
+	unsigned in_period = period.in_period;
+	IZimgFilter *ret = nullptr;
+
+	if (out_period == 1 && in_period == 2 && taps == 4)
+		ret = new Impl<1, 2, 4>{ std::forward<Args>(args)... };
+	else if (out_period == 1 && in_period == 2 && taps == 8)
+		ret = new Impl<1, 2, 8>{ std::forward<Args>(args)... };
+	else if (out_period == 1 && in_period == 4 && taps == 8)
+		ret = new Impl<1, 4, 8>{ std::forward<Args>(args)... };
+	else if (out_period == 1 && in_period == 4 && taps == 16)
+		ret = new Impl<1, 4, 16>{ std::forward<Args>(args)... };
+	else if (out_period == 2 && in_period == 1 && taps == 2)
+		ret = new Impl<2, 1, 2>{ std::forward<Args>(args)... };
+	else if (out_period == 2 && in_period == 1 && taps == 4)
+		ret = new Impl<2, 1, 4>{ std::forward<Args>(args)... };
+
+	return ret;
+}
+
+
+class ResizeImplH : public ZimgFilter {
+protected:
+	FilterContext m_filter;
+	image_attributes m_attr;
+	bool m_is_sorted;
+
+	ResizeImplH(const FilterContext &filter, const image_attributes &attr);
+public:
+	ZimgFilterFlags get_flags() const override;
+
+	image_attributes get_image_attributes() const override;
+
+	pair_unsigned get_required_row_range(unsigned i) const override;
+
+	pair_unsigned get_required_col_range(unsigned left, unsigned right) const override;
+
+	unsigned get_max_buffering() const override;
+};
+
+class ResizeImplV : public ZimgFilter {
+protected:
+	FilterContext m_filter;
+	image_attributes m_attr;
+	bool m_is_sorted;
+	unsigned m_lines;
+	unsigned m_max_buffering;
+
+	// Kernels producing several output rows per call pass the number of rows in lines.
+	ResizeImplV(const FilterContext &filter, const image_attributes &attr, unsigned lines = 1);
+public:
+	ZimgFilterFlags get_flags() const override;
+
+	image_attributes get_image_attributes() const override;
+
+	pair_unsigned get_required_row_range(unsigned i) const override;
+
+	unsigned get_simultaneous_lines() const override;
+
+	unsigned get_max_buffering() const override;
+};
 
 IZimgFilter *create_resize_impl2(const Filter &f, PixelType type, bool horizontal, unsigned depth, unsigned src_width, unsigned src_height, unsigned dst_width, unsigned dst_height,
                                  double shift, double subwidth, CPUClass cpu);
@@ -0,0 +1,1216 @@
+#ifdef ZIMG_X86
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include <immintrin.h>
+#include "Common/align.h"
+#include "Common/except.h"
+#include "Common/linebuffer.h"
+#include "Common/osdep.h"
+#include "Common/pixel.h"
+#include "Common/zfilter.h"
+#include "resize_impl2.h"
+#include "resize_impl2_x86.h"
+
+namespace zimg {;
+namespace resize {;
+
+namespace {;
+
+// Output rows computed per call by the vertical kernels.
+const unsigned RESIZE_V_LINES = 4;
+
+// Transpose two 8x8 blocks, one in each 128-bit lane.
+inline FORCE_INLINE void transpose8_epi16(__m256i &x0, __m256i &x1, __m256i &x2, __m256i &x3, __m256i &x4, __m256i &x5, __m256i &x6, __m256i &x7)
+{
+	__m256i t0, t1, t2, t3, t4, t5, t6, t7;
+	__m256i u0, u1, u2, u3, u4, u5, u6, u7;
+
+	t0 = _mm256_unpacklo_epi16(x0, x1);
+	t1 = _mm256_unpackhi_epi16(x0, x1);
+	t2 = _mm256_unpacklo_epi16(x2, x3);
+	t3 = _mm256_unpackhi_epi16(x2, x3);
+	t4 = _mm256_unpacklo_epi16(x4, x5);
+	t5 = _mm256_unpackhi_epi16(x4, x5);
+	t6 = _mm256_unpacklo_epi16(x6, x7);
+	t7 = _mm256_unpackhi_epi16(x6, x7);
+
+	u0 = _mm256_unpacklo_epi32(t0, t2);
+	u1 = _mm256_unpackhi_epi32(t0, t2);
+	u2 = _mm256_unpacklo_epi32(t1, t3);
+	u3 = _mm256_unpackhi_epi32(t1, t3);
+	u4 = _mm256_unpacklo_epi32(t4, t6);
+	u5 = _mm256_unpackhi_epi32(t4, t6);
+	u6 = _mm256_unpacklo_epi32(t5, t7);
+	u7 = _mm256_unpackhi_epi32(t5, t7);
+
+	x0 = _mm256_unpacklo_epi64(u0, u4);
+	x1 = _mm256_unpackhi_epi64(u0, u4);
+	x2 = _mm256_unpacklo_epi64(u1, u5);
+	x3 = _mm256_unpackhi_epi64(u1, u5);
+	x4 = _mm256_unpacklo_epi64(u2, u6);
+	x5 = _mm256_unpackhi_epi64(u2, u6);
+	x6 = _mm256_unpacklo_epi64(u3, u7);
+	x7 = _mm256_unpackhi_epi64(u3, u7);
+}
+
+inline FORCE_INLINE void transpose8_ps(__m256 &row0, __m256 &row1, __m256 &row2, __m256 &row3, __m256 &row4, __m256 &row5, __m256 &row6, __m256 &row7)
+{
+	__m256 t0, t1, t2, t3, t4, t5, t6, t7;
+	__m256 tt0, tt1, tt2, tt3, tt4, tt5, tt6, tt7;
+
+	t0 = _mm256_unpacklo_ps(row0, row1);
+	t1 = _mm256_unpackhi_ps(row0, row1);
+	t2 = _mm256_unpacklo_ps(row2, row3);
+	t3 = _mm256_unpackhi_ps(row2, row3);
+	t4 = _mm256_unpacklo_ps(row4, row5);
+	t5 = _mm256_unpackhi_ps(row4, row5);
+	t6 = _mm256_unpacklo_ps(row6, row7);
+	t7 = _mm256_unpackhi_ps(row6, row7);
+
+	tt0 = _mm256_shuffle_ps(t0, t2, _MM_SHUFFLE(1, 0, 1, 0));
+	tt1 = _mm256_shuffle_ps(t0, t2, _MM_SHUFFLE(3, 2, 3, 2));
+	tt2 = _mm256_shuffle_ps(t1, t3, _MM_SHUFFLE(1, 0, 1, 0));
+	tt3 = _mm256_shuffle_ps(t1, t3, _MM_SHUFFLE(3, 2, 3, 2));
+	tt4 = _mm256_shuffle_ps(t4, t6, _MM_SHUFFLE(1, 0, 1, 0));
+	tt5 = _mm256_shuffle_ps(t4, t6, _MM_SHUFFLE(3, 2, 3, 2));
+	tt6 = _mm256_shuffle_ps(t5, t7, _MM_SHUFFLE(1, 0, 1, 0));
+	tt7 = _mm256_shuffle_ps(t5, t7, _MM_SHUFFLE(3, 2, 3, 2));
+
+	row0 = _mm256_permute2f128_ps(tt0, tt4, 0x20);
+	row1 = _mm256_permute2f128_ps(tt1, tt5, 0x20);
+	row2 = _mm256_permute2f128_ps(tt2, tt6, 0x20);
+	row3 = _mm256_permute2f128_ps(tt3, tt7, 0x20);
+	row4 = _mm256_permute2f128_ps(tt0, tt4, 0x31);
+	row5 = _mm256_permute2f128_ps(tt1, tt5, 0x31);
+	row6 = _mm256_permute2f128_ps(tt2, tt6, 0x31);
+	row7 = _mm256_permute2f128_ps(tt3, tt7, 0x31);
+}
+
+inline FORCE_INLINE __m256i coeff_pair_epi16(const int16_t *coeffs, unsigned k)
+{
+	return _mm256_set1_epi32((uint16_t)coeffs[k] | ((uint32_t)(uint16_t)coeffs[k + 1] << 16));
+}
+
+inline FORCE_INLINE __m256i pack_i30_epi32(__m256i lo, __m256i hi, __m256i limit)
+{
+	const __m256i round = _mm256_set1_epi32(1 << 13);
+
+	lo = _mm256_srai_epi32(_mm256_add_epi32(lo, round), 14);
+	hi = _mm256_srai_epi32(_mm256_add_epi32(hi, round), 14);
+
+	// Saturation to INT16 implements the lower bound of zero after biasing.
+	return _mm256_min_epi16(_mm256_packs_epi32(lo, hi), limit);
+}
+
+inline FORCE_INLINE __m256i shift_i30_epi32(__m256i x)
+{
+	return _mm256_srai_epi32(_mm256_add_epi32(x, _mm256_set1_epi32(1 << 13)), 14);
+}
+
+// Words are biased to signed, while bytes are zero-extended.
+inline FORCE_INLINE __m256i load16_epi16(const uint16_t *ptr)
+{
+	return _mm256_xor_si256(_mm256_loadu_si256((const __m256i *)ptr), _mm256_set1_epi16(INT16_MIN));
+}
+
+inline FORCE_INLINE __m256i load16_epi16(const uint8_t *ptr)
+{
+	return _mm256_cvtepu8_epi16(_mm_loadu_si128((const __m128i *)ptr));
+}
+
+inline FORCE_INLINE void store16_epi16(uint16_t *ptr, __m256i x)
+{
+	_mm256_storeu_si256((__m256i *)ptr, _mm256_xor_si256(x, _mm256_set1_epi16(INT16_MIN)));
+}
+
+inline FORCE_INLINE void store16_epi16(uint8_t *ptr, __m256i x)
+{
+	x = _mm256_permute4x64_epi64(_mm256_packus_epi16(x, x), _MM_SHUFFLE(3, 1, 2, 0));
+	_mm_storeu_si128((__m128i *)ptr, _mm256_castsi256_si128(x));
+}
+
+inline int16_t unpack_pixel(uint16_t x) { return (int16_t)unpack_pixel_u16(x); }
+inline int16_t unpack_pixel(uint8_t x) { return x; }
+
+inline uint16_t pack_pixel(int16_t x, uint16_t *) { return (uint16_t)(x - INT16_MIN); }
+inline uint8_t pack_pixel(int16_t x, uint8_t *) { return (uint8_t)x; }
+
+// Transpose columns [left, right) of sixteen rows into column-interleaved order.
+template <class T>
+void transpose_line_in_u16(const T * const src[16], int16_t *dst, unsigned left, unsigned right)
+{
+	unsigned vec_right = left + mod(right - left, 16);
+
+	for (unsigned j = left; j < vec_right; j += 16) {
+		for (unsigned g = 0; g < 16; g += 8) {
+			__m256i x[8];
+
+			for (unsigned r = 0; r < 8; ++r) {
+				x[r] = load16_epi16(&src[g + r][j]);
+			}
+
+			transpose8_epi16(x[0], x[1], x[2], x[3], x[4], x[5], x[6], x[7]);
+
+			for (unsigned c = 0; c < 8; ++c) {
+				int16_t *dst_p = dst + (j - left + c) * 16 + g;
+
+				_mm_store_si128((__m128i *)dst_p, _mm256_castsi256_si128(x[c]));
+				_mm_store_si128((__m128i *)(dst_p + 8 * 16), _mm256_extracti128_si256(x[c], 1));
+			}
+		}
+	}
+	for (unsigned j = vec_right; j < right; ++j) {
+		for (unsigned r = 0; r < 16; ++r) {
+			dst[(j - left) * 16 + r] = unpack_pixel(src[r][j]);
+		}
+	}
+
+	// Padding column for filters with an odd number of taps.
+	_mm256_store_si256((__m256i *)(dst + (right - left) * 16), _mm256_setzero_si256());
+}
+
+// Inverse of transpose_line_in_u16, storing only the first n rows.
+template <class T>
+void transpose_line_out_u16(const int16_t *src, T * const dst[16], unsigned n, unsigned left, unsigned right)
+{
+	unsigned vec_right = left + mod(right - left, 16);
+
+	for (unsigned j = left; j < vec_right; j += 16) {
+		for (unsigned g = 0; g < n; g += 8) {
+			__m256i x[8];
+
+			for (unsigned c = 0; c < 8; ++c) {
+				const int16_t *src_p = src + (j - left + c) * 16 + g;
+				__m128i lo = _mm_load_si128((const __m128i *)src_p);
+				__m128i hi = _mm_load_si128((const __m128i *)(src_p + 8 * 16));
+
+				x[c] = _mm256_inserti128_si256(_mm256_castsi128_si256(lo), hi, 1);
+			}
+
+			transpose8_epi16(x[0], x[1], x[2], x[3], x[4], x[5], x[6], x[7]);
+
+			for (unsigned r = 0; r < std::min(n - g, 8U); ++r) {
+				store16_epi16(&dst[g + r][j], x[r]);
+			}
+		}
+	}
+	for (unsigned j = vec_right; j < right; ++j) {
+		for (unsigned r = 0; r < n; ++r) {
+			dst[r][j] = pack_pixel(src[(j - left) * 16 + r], (T *)nullptr);
+		}
+	}
+}
+
+// Half precision pixels are widened to float on load and rounded on store.
+inline FORCE_INLINE __m256 load8_ps(const float *ptr)
+{
+	return _mm256_loadu_ps(ptr);
+}
+
+inline FORCE_INLINE __m256 load8_ps(const uint16_t *ptr)
+{
+	return _mm256_cvtph_ps(_mm_loadu_si128((const __m128i *)ptr));
+}
+
+inline FORCE_INLINE void store8_ps(float *ptr, __m256 x)
+{
+	_mm256_storeu_ps(ptr, x);
+}
+
+inline FORCE_INLINE void store8_ps(uint16_t *ptr, __m256 x)
+{
+	_mm_storeu_si128((__m128i *)ptr, _mm256_cvtps_ph(x, 0));
+}
+
+inline float unpack_pixel_ps(float x) { return x; }
+inline float unpack_pixel_ps(uint16_t x) { return _cvtsh_ss(x); }
+
+inline float pack_pixel_ps(float x, float *) { return x; }
+inline uint16_t pack_pixel_ps(float x, uint16_t *) { return _cvtss_sh(x, 0); }
+
+// Transpose columns [left, right) of eight rows into column-interleaved order.
+template <class T>
+void transpose_line_in_f32(const T * const src[8], float *dst, unsigned left, unsigned right)
+{
+	unsigned vec_right = left + mod(right - left, 8);
+
+	for (unsigned j = left; j < vec_right; j += 8) {
+		__m256 x0 = load8_ps(&src[0][j]);
+		__m256 x1 = load8_ps(&src[1][j]);
+		__m256 x2 = load8_ps(&src[2][j]);
+		__m256 x3 = load8_ps(&src[3][j]);
+		__m256 x4 = load8_ps(&src[4][j]);
+		__m256 x5 = load8_ps(&src[5][j]);
+		__m256 x6 = load8_ps(&src[6][j]);
+		__m256 x7 = load8_ps(&src[7][j]);
+		float *dst_p = dst + (j - left) * 8;
+
+		transpose8_ps(x0, x1, x2, x3, x4, x5, x6, x7);
+
+		_mm256_store_ps(dst_p + 0, x0);
+		_mm256_store_ps(dst_p + 8, x1);
+		_mm256_store_ps(dst_p + 16, x2);
+		_mm256_store_ps(dst_p + 24, x3);
+		_mm256_store_ps(dst_p + 32, x4);
+		_mm256_store_ps(dst_p + 40, x5);
+		_mm256_store_ps(dst_p + 48, x6);
+		_mm256_store_ps(dst_p + 56, x7);
+	}
+	for (unsigned j = vec_right; j < right; ++j) {
+		for (unsigned r = 0; r < 8; ++r) {
+			dst[(j - left) * 8 + r] = unpack_pixel_ps(src[r][j]);
+		}
+	}
+}
+
+// Inverse of transpose_line_in_f32, storing only the first n rows.
+template <class T>
+void transpose_line_out_f32(const float *src, T * const dst[8], unsigned n, unsigned left, unsigned right)
+{
+	unsigned vec_right = left + mod(right - left, 8);
+
+	for (unsigned j = left; j < vec_right; j += 8) {
+		const float *src_p = src + (j - left) * 8;
+		__m256 x[8];
+
+		for (unsigned c = 0; c < 8; ++c) {
+			x[c] = _mm256_load_ps(src_p + c * 8);
+		}
+
+		transpose8_ps(x[0], x[1], x[2], x[3], x[4], x[5], x[6], x[7]);
+
+		for (unsigned r = 0; r < n; ++r) {
+			store8_ps(&dst[r][j], x[r]);
+		}
+	}
+	for (unsigned j = vec_right; j < right; ++j) {
+		for (unsigned r = 0; r < n; ++r) {
+			dst[r][j] = pack_pixel_ps(src[(j - left) * 8 + r], (T *)nullptr);
+		}
+	}
+}
+
+template <class T>
+void resize_tile_h_u16_avx2(const FilterContext &filter, const int16_t *src, int16_t *dst, unsigned src_left, unsigned left, unsigned right, uint16_t pixel_max)
+{
+	// Bytes are not biased and must also be clamped to zero.
+	const bool is_byte = std::is_same<T, uint8_t>::value;
+	const __m256i limit = _mm256_set1_epi16(is_byte ? (int16_t)pixel_max : (int16_t)(pixel_max + INT16_MIN));
+
+	for (unsigned j = left; j < right; ++j) {
+		const int16_t *coeffs = &filter.data_i16[filter.phase[j] * filter.stride_i16];
+		const int16_t *src_p = src + (filter.left[j] - src_left) * 16;
+
+		__m256i accum_lo = _mm256_setzero_si256();
+		__m256i accum_hi = _mm256_setzero_si256();
+
+		for (unsigned k = 0; k < filter.filter_width; k += 2) {
+			__m256i coeff = coeff_pair_epi16(coeffs, k);
+			__m256i x0 = _mm256_load_si256((const __m256i *)(src_p + k * 16));
+			__m256i x1 = _mm256_load_si256((const __m256i *)(src_p + k * 16 + 16));
+
+			accum_lo = _mm256_add_epi32(accum_lo, _mm256_madd_epi16(_mm256_unpacklo_epi16(x0, x1), coeff));
+			accum_hi = _mm256_add_epi32(accum_hi, _mm256_madd_epi16(_mm256_unpackhi_epi16(x0, x1), coeff));
+		}
+
+		__m256i result = pack_i30_epi32(accum_lo, accum_hi, limit);
+
+		if (is_byte)
+			result = _mm256_max_epi16(result, _mm256_setzero_si256());
+
+		_mm256_store_si256((__m256i *)(dst + (j - left) * 16), result);
+	}
+}
+
+void resize_tile_h_f32_avx2(const FilterContext &filter, const float *src, float *dst, unsigned src_left, unsigned left, unsigned right)
+{
+	for (unsigned j = left; j < right; ++j) {
+		const float *coeffs = &filter.data[filter.phase[j] * filter.stride];
+		const float *src_p = src + (filter.left[j] - src_left) * 8;
+
+		__m256 accum = _mm256_setzero_ps();
+
+		for (unsigned k = 0; k < filter.filter_width; ++k) {
+			__m256 coeff = _mm256_broadcast_ss(&coeffs[k]);
+			__m256 x = _mm256_load_ps(src_p + k * 8);
+
+			accum = _mm256_fmadd_ps(coeff, x, accum);
+		}
+
+		_mm256_store_ps(dst + (j - left) * 8, accum);
+	}
+}
+
+inline FORCE_INLINE __m256i coeff_quad_epi16(const int16_t *coeffs, unsigned k)
+{
+	return _mm256_broadcastq_epi64(_mm_loadl_epi64((const __m128i *)(coeffs + k)));
+}
+
+// Integer factor kernels. Each call computes one vector of consecutive blocks
+// starting at block b.
+template <unsigned Taps, class T>
+inline FORCE_INLINE void resize_vec_h_down2_u16_avx2(const int16_t *coeffs, const T *src, int offset, unsigned b, T *dst, uint16_t pixel_max)
+{
+	const bool is_byte = std::is_same<T, uint8_t>::value;
+	const __m256i limit = _mm256_set1_epi16(is_byte ? (int16_t)pixel_max : (int16_t)(pixel_max + INT16_MIN));
+	const T *src_p = src + (ptrdiff_t)b * 2 + offset;
+
+	__m256i accum_lo = _mm256_setzero_si256();
+	__m256i accum_hi = _mm256_setzero_si256();
+
+	// Adjacent inputs belong to the same output, so pmaddwd reduces each pair directly.
+	for (unsigned k = 0; k < Taps; k += 2) {
+		__m256i coeff = coeff_pair_epi16(coeffs, k);
+
+		accum_lo = _mm256_add_epi32(accum_lo, _mm256_madd_epi16(load16_epi16(src_p + k), coeff));
+		accum_hi = _mm256_add_epi32(accum_hi, _mm256_madd_epi16(load16_epi16(src_p + k + 16), coeff));
+	}
+
+	__m256i result = pack_i30_epi32(accum_lo, accum_hi, limit);
+	result = _mm256_permute4x64_epi64(result, _MM_SHUFFLE(3, 1, 2, 0));
+
+	if (is_byte)
+		result = _mm256_max_epi16(result, _mm256_setzero_si256());
+
+	store16_epi16(dst, result);
+}
+
+template <unsigned Taps, class T>
+inline FORCE_INLINE void resize_vec_h_down4_u16_avx2(const int16_t *coeffs, const T *src, int offset, unsigned b, T *dst, uint16_t pixel_max)
+{
+	const bool is_byte = std::is_same<T, uint8_t>::value;
+	const __m256i limit = _mm256_set1_epi16(is_byte ? (int16_t)pixel_max : (int16_t)(pixel_max + INT16_MIN));
+	const T *src_p = src + (ptrdiff_t)b * 4 + offset;
+
+	__m256i accum_lo = _mm256_setzero_si256();
+	__m256i accum_hi = _mm256_setzero_si256();
+
+	// Each output spans two pmaddwd lanes, which are summed with phaddd.
+	for (unsigned k = 0; k < Taps; k += 4) {
+		__m256i coeff = coeff_quad_epi16(coeffs, k);
+		__m256i x0 = _mm256_madd_epi16(load16_epi16(src_p + k + 0), coeff);
+		__m256i x1 = _mm256_madd_epi16(load16_epi16(src_p + k + 16), coeff);
+		__m256i x2 = _mm256_madd_epi16(load16_epi16(src_p + k + 32), coeff);
+		__m256i x3 = _mm256_madd_epi16(load16_epi16(src_p + k + 48), coeff);
+
+		accum_lo = _mm256_add_epi32(accum_lo, _mm256_hadd_epi32(x0, x1));
+		accum_hi = _mm256_add_epi32(accum_hi, _mm256_hadd_epi32(x2, x3));
+	}
+
+	__m256i result = pack_i30_epi32(accum_lo, accum_hi, limit);
+	result = _mm256_permutevar8x32_epi32(result, _mm256_setr_epi32(0, 4, 1, 5, 2, 6, 3, 7));
+
+	if (is_byte)
+		result = _mm256_max_epi16(result, _mm256_setzero_si256());
+
+	store16_epi16(dst, result);
+}
+
+template <unsigned Taps, class T>
+inline FORCE_INLINE void resize_vec_h_up2_u16_avx2(const int16_t *coeffs0, const int16_t *coeffs1, const T *src, int offset0, int offset1, unsigned b, T *dst, uint16_t pixel_max)
+{
+	const bool is_byte = std::is_same<T, uint8_t>::value;
+	const __m256i limit = _mm256_set1_epi16(is_byte ? (int16_t)pixel_max : (int16_t)(pixel_max + INT16_MIN));
+	const T *src_p0 = src + (ptrdiff_t)b + offset0;
+	const T *src_p1 = src + (ptrdiff_t)b + offset1;
+
+	__m256i even_lo = _mm256_setzero_si256();
+	__m256i even_hi = _mm256_setzero_si256();
+	__m256i odd_lo = _mm256_setzero_si256();
+	__m256i odd_hi = _mm256_setzero_si256();
+
+	for (unsigned k = 0; k < Taps; k += 2) {
+		__m256i coeff0 = coeff_pair_epi16(coeffs0, k);
+		__m256i coeff1 = coeff_pair_epi16(coeffs1, k);
+		__m256i x0, x1;
+
+		x0 = load16_epi16(src_p0 + k);
+		x1 = load16_epi16(src_p0 + k + 1);
+		even_lo = _mm256_add_epi32(even_lo, _mm256_madd_epi16(_mm256_unpacklo_epi16(x0, x1), coeff0));
+		even_hi = _mm256_add_epi32(even_hi, _mm256_madd_epi16(_mm256_unpackhi_epi16(x0, x1), coeff0));
+
+		x0 = load16_epi16(src_p1 + k);
+		x1 = load16_epi16(src_p1 + k + 1);
+		odd_lo = _mm256_add_epi32(odd_lo, _mm256_madd_epi16(_mm256_unpacklo_epi16(x0, x1), coeff1));
+		odd_hi = _mm256_add_epi32(odd_hi, _mm256_madd_epi16(_mm256_unpackhi_epi16(x0, x1), coeff1));
+	}
+
+	even_lo = shift_i30_epi32(even_lo);
+	even_hi = shift_i30_epi32(even_hi);
+	odd_lo = shift_i30_epi32(odd_lo);
+	odd_hi = shift_i30_epi32(odd_hi);
+
+	// Interleave the two phases. Blocks 0-3 and 8-11 are in the low halves of each lane.
+	__m256i r0 = _mm256_packs_epi32(_mm256_unpacklo_epi32(even_lo, odd_lo), _mm256_unpackhi_epi32(even_lo, odd_lo));
+	__m256i r1 = _mm256_packs_epi32(_mm256_unpacklo_epi32(even_hi, odd_hi), _mm256_unpackhi_epi32(even_hi, odd_hi));
+	__m256i out0 = _mm256_min_epi16(_mm256_permute2x128_si256(r0, r1, 0x20), limit);
+	__m256i out1 = _mm256_min_epi16(_mm256_permute2x128_si256(r0, r1, 0x31), limit);
+
+	if (is_byte) {
+		out0 = _mm256_max_epi16(out0, _mm256_setzero_si256());
+		out1 = _mm256_max_epi16(out1, _mm256_setzero_si256());
+	}
+
+	store16_epi16(dst + 0, out0);
+	store16_epi16(dst + 16, out1);
+}
+
+template <unsigned Taps, class T>
+inline FORCE_INLINE void resize_vec_h_down2_f32_avx2(const float *coeffs, const T *src, int offset, unsigned b, T *dst)
+{
+	const T *src_p = src + (ptrdiff_t)b * 2 + offset;
+
+	__m256 accum0 = _mm256_setzero_ps();
+	__m256 accum1 = _mm256_setzero_ps();
+
+	for (unsigned k = 0; k < Taps; k += 2) {
+		__m256 coeff = _mm256_castpd_ps(_mm256_broadcast_sd((const double *)(coeffs + k)));
+
+		accum0 = _mm256_fmadd_ps(coeff, load8_ps(src_p + k + 0), accum0);
+		accum1 = _mm256_fmadd_ps(coeff, load8_ps(src_p + k + 8), accum1);
+	}
+
+	// Reduce the pairs once, after all taps have been accumulated.
+	__m256 result = _mm256_hadd_ps(accum0, accum1);
+	result = _mm256_castpd_ps(_mm256_permute4x64_pd(_mm256_castps_pd(result), _MM_SHUFFLE(3, 1, 2, 0)));
+
+	store8_ps(dst, result);
+}
+
+template <unsigned Taps, class T>
+inline FORCE_INLINE void resize_vec_h_down4_f32_avx2(const float *coeffs, const T *src, int offset, unsigned b, T *dst)
+{
+	const T *src_p = src + (ptrdiff_t)b * 4 + offset;
+
+	__m256 accum0 = _mm256_setzero_ps();
+	__m256 accum1 = _mm256_setzero_ps();
+	__m256 accum2 = _mm256_setzero_ps();
+	__m256 accum3 = _mm256_setzero_ps();
+
+	for (unsigned k = 0; k < Taps; k += 4) {
+		__m256 coeff = _mm256_broadcast_ps((const __m128 *)(coeffs + k));
+
+		accum0 = _mm256_fmadd_ps(coeff, load8_ps(src_p + k + 0), accum0);
+		accum1 = _mm256_fmadd_ps(coeff, load8_ps(src_p + k + 8), accum1);
+		accum2 = _mm256_fmadd_ps(coeff, load8_ps(src_p + k + 16), accum2);
+		accum3 = _mm256_fmadd_ps(coeff, load8_ps(src_p + k + 24), accum3);
+	}
+
+	__m256 result = _mm256_hadd_ps(_mm256_hadd_ps(accum0, accum1), _mm256_hadd_ps(accum2, accum3));
+	result = _mm256_permutevar8x32_ps(result, _mm256_setr_epi32(0, 4, 1, 5, 2, 6, 3, 7));
+
+	store8_ps(dst, result);
+}
+
+template <unsigned Taps, class T>
+inline FORCE_INLINE void resize_vec_h_up2_f32_avx2(const float *coeffs0, const float *coeffs1, const T *src, int offset0, int offset1, unsigned b, T *dst)
+{
+	const T *src_p0 = src + (ptrdiff_t)b + offset0;
+	const T *src_p1 = src + (ptrdiff_t)b + offset1;
+
+	__m256 even = _mm256_setzero_ps();
+	__m256 odd = _mm256_setzero_ps();
+
+	for (unsigned k = 0; k < Taps; ++k) {
+		even = _mm256_fmadd_ps(_mm256_broadcast_ss(coeffs0 + k), load8_ps(src_p0 + k), even);
+		odd = _mm256_fmadd_ps(_mm256_broadcast_ss(coeffs1 + k), load8_ps(src_p1 + k), odd);
+	}
+
+	__m256 lo = _mm256_unpacklo_ps(even, odd);
+	__m256 hi = _mm256_unpackhi_ps(even, odd);
+
+	store8_ps(dst + 0, _mm256_permute2f128_ps(lo, hi, 0x20));
+	store8_ps(dst + 8, _mm256_permute2f128_ps(lo, hi, 0x31));
+}
+
+// Process interior outputs [left, right) in vectors of N blocks. Whole vectors
+// are stored directly, recomputing an overlapping vector at the right edge.
+// Partial vectors go through a temporary, so that every interior output is
+// computed the same way regardless of how the line is split.
+template <unsigned N, unsigned OutPeriod, class T, class Kernel>
+void resize_blocks_h_avx2(const FilterPeriod &period, T *dst, unsigned left, unsigned right, Kernel kernel)
+{
+	auto partial = [&](unsigned l, unsigned r)
+	{
+		T tmp[N * OutPeriod];
+
+		while (l < r) {
+			unsigned b = std::min(l / OutPeriod, period.block_right - N);
+			unsigned n = std::min(r, (b + N) * OutPeriod);
+
+			kernel(b, tmp);
+			std::copy(tmp + (l - b * OutPeriod), tmp + (n - b * OutPeriod), dst + l);
+			l = n;
+		}
+	};
+
+	unsigned vec_left = (left + OutPeriod - 1) / OutPeriod;
+	unsigned vec_right = right / OutPeriod;
+
+	if (vec_right < vec_left + N) {
+		partial(left, right);
+		return;
+	}
+
+	partial(left, vec_left * OutPeriod);
+
+	for (unsigned bb = vec_left; bb < vec_right; bb += N) {
+		unsigned b = std::min(bb, vec_right - N);
+		kernel(b, dst + (ptrdiff_t)b * OutPeriod);
+	}
+
+	partial(vec_right * OutPeriod, right);
+}
+
+// Generic C kernels for the edges of integer factor resizes.
+inline void resize_line_h_int_c(const FilterContext &filter, const uint8_t *src, uint8_t *dst, unsigned left, unsigned right, unsigned pixel_max)
+{
+	resize_line_h_u8_c(filter, src, dst, left, right, pixel_max);
+}
+
+inline void resize_line_h_int_c(const FilterContext &filter, const uint16_t *src, uint16_t *dst, unsigned left, unsigned right, unsigned pixel_max)
+{
+	resize_line_h_u16_c(filter, src, dst, left, right, pixel_max);
+}
+
+inline void resize_line_h_fp_c(const FilterContext &filter, const uint16_t *src, uint16_t *dst, unsigned left, unsigned right)
+{
+	resize_line_h_f16_c(filter, src, dst, left, right);
+}
+
+inline void resize_line_h_fp_c(const FilterContext &filter, const float *src, float *dst, unsigned left, unsigned right)
+{
+	resize_line_h_f32_c(filter, src, dst, left, right);
+}
+
+void resize_line_v_u16_avx2(const FilterContext &filter, const LineBuffer<const uint16_t> &src, LineBuffer<uint16_t> &dst, unsigned i, unsigned left, unsigned right, uint16_t pixel_max)
+{
+	const __m256i bias = _mm256_set1_epi16(INT16_MIN);
+	const __m256i limit = _mm256_set1_epi16((int16_t)(pixel_max + INT16_MIN));
+
+	const int16_t *coeffs = &filter.data_i16[filter.phase[i] * filter.stride_i16];
+	unsigned top = filter.left[i];
+	unsigned filter_width_even = mod(filter.filter_width, 2);
+	uint16_t *dst_p = dst[i];
+
+	if (right - left < 16) {
+		resize_line_v_u16_c(filter, src, dst, i, left, right, pixel_max);
+		return;
+	}
+
+	for (unsigned jj = left; jj < right; jj += 16) {
+		// Handle the right edge by recomputing an overlapping vector.
+		unsigned j = std::min(jj, right - 16);
+
+		__m256i accum_lo = _mm256_setzero_si256();
+		__m256i accum_hi = _mm256_setzero_si256();
+
+		for (unsigned k = 0; k < filter_width_even; k += 2) {
+			__m256i coeff = coeff_pair_epi16(coeffs, k);
+			__m256i x0 = _mm256_xor_si256(_mm256_loadu_si256((const __m256i *)&src[top + k][j]), bias);
+			__m256i x1 = _mm256_xor_si256(_mm256_loadu_si256((const __m256i *)&src[top + k + 1][j]), bias);
+
+			accum_lo = _mm256_add_epi32(accum_lo, _mm256_madd_epi16(_mm256_unpacklo_epi16(x0, x1), coeff));
+			accum_hi = _mm256_add_epi32(accum_hi, _mm256_madd_epi16(_mm256_unpackhi_epi16(x0, x1), coeff));
+		}
+		if (filter_width_even != filter.filter_width) {
+			unsigned k = filter_width_even;
+
+			__m256i coeff = coeff_pair_epi16(coeffs, k);
+			__m256i x0 = _mm256_xor_si256(_mm256_loadu_si256((const __m256i *)&src[top + k][j]), bias);
+			__m256i x1 = _mm256_setzero_si256();
+
+			accum_lo = _mm256_add_epi32(accum_lo, _mm256_madd_epi16(_mm256_unpacklo_epi16(x0, x1), coeff));
+			accum_hi = _mm256_add_epi32(accum_hi, _mm256_madd_epi16(_mm256_unpackhi_epi16(x0, x1), coeff));
+		}
+
+		_mm256_storeu_si256((__m256i *)&dst_p[j], _mm256_xor_si256(pack_i30_epi32(accum_lo, accum_hi, limit), bias));
+	}
+}
+
+void resize_line_v_u8_avx2(const FilterContext &filter, const LineBuffer<const uint8_t> &src, LineBuffer<uint8_t> &dst, unsigned i, unsigned left, unsigned right, uint8_t pixel_max)
+{
+	const __m256i zero = _mm256_setzero_si256();
+	const __m256i limit = _mm256_set1_epi8((char)pixel_max);
+
+	const int16_t *coeffs = &filter.data_i16[filter.phase[i] * filter.stride_i16];
+	unsigned top = filter.left[i];
+	uint8_t *dst_p = dst[i];
+
+	if (right - left < 32) {
+		resize_line_v_u8_c(filter, src, dst, i, left, right, pixel_max);
+		return;
+	}
+
+	for (unsigned jj = left; jj < right; jj += 32) {
+		unsigned j = std::min(jj, right - 32);
+
+		__m256i accum0 = _mm256_setzero_si256();
+		__m256i accum1 = _mm256_setzero_si256();
+		__m256i accum2 = _mm256_setzero_si256();
+		__m256i accum3 = _mm256_setzero_si256();
+
+		for (unsigned k = 0; k < filter.filter_width; k += 2) {
+			__m256i coeff = coeff_pair_epi16(coeffs, k);
+			__m256i x0 = _mm256_loadu_si256((const __m256i *)&src[top + k][j]);
+			__m256i x1 = k + 1 < filter.filter_width ? _mm256_loadu_si256((const __m256i *)&src[top + k + 1][j]) : zero;
+
+			// Interleave the rows, then zero-extend to the word pairs consumed by pmaddwd.
+			__m256i lo = _mm256_unpacklo_epi8(x0, x1);
+			__m256i hi = _mm256_unpackhi_epi8(x0, x1);
+
+			accum0 = _mm256_add_epi32(accum0, _mm256_madd_epi16(_mm256_unpacklo_epi8(lo, zero), coeff));
+			accum1 = _mm256_add_epi32(accum1, _mm256_madd_epi16(_mm256_unpackhi_epi8(lo, zero), coeff));
+			accum2 = _mm256_add_epi32(accum2, _mm256_madd_epi16(_mm256_unpacklo_epi8(hi, zero), coeff));
+			accum3 = _mm256_add_epi32(accum3, _mm256_madd_epi16(_mm256_unpackhi_epi8(hi, zero), coeff));
+		}
+
+		// The unpacks and packs are both within 128-bit lanes, so the column order is restored.
+		__m256i lo = _mm256_packs_epi32(shift_i30_epi32(accum0), shift_i30_epi32(accum1));
+		__m256i hi = _mm256_packs_epi32(shift_i30_epi32(accum2), shift_i30_epi32(accum3));
+
+		_mm256_storeu_si256((__m256i *)&dst_p[j], _mm256_min_epu8(_mm256_packus_epi16(lo, hi), limit));
+	}
+}
+
+template <class T>
+void resize_line_v_f32_avx2(const FilterContext &filter, const LineBuffer<const T> &src, LineBuffer<T> &dst, unsigned i, unsigned left, unsigned right)
+{
+	const float *coeffs = &filter.data[filter.phase[i] * filter.stride];
+	unsigned top = filter.left[i];
+	T *dst_p = dst[i];
+
+	if (right - left < 16) {
+		for (unsigned j = left; j < right; ++j) {
+			float accum = 0;
+
+			for (unsigned k = 0; k < filter.filter_width; ++k) {
+				accum += coeffs[k] * unpack_pixel_ps(src[top + k][j]);
+			}
+
+			dst_p[j] = pack_pixel_ps(accum, (T *)nullptr);
+		}
+		return;
+	}
+
+	for (unsigned jj = left; jj < right; jj += 16) {
+		unsigned j = std::min(jj, right - 16);
+
+		__m256 accum0 = _mm256_setzero_ps();
+		__m256 accum1 = _mm256_setzero_ps();
+
+		for (unsigned k = 0; k < filter.filter_width; ++k) {
+			__m256 coeff = _mm256_broadcast_ss(&coeffs[k]);
+			const T *src_p = src[top + k];
+
+			accum0 = _mm256_fmadd_ps(coeff, load8_ps(&src_p[j + 0]), accum0);
+			accum1 = _mm256_fmadd_ps(coeff, load8_ps(&src_p[j + 8]), accum1);
+		}
+
+		store8_ps(&dst_p[j + 0], accum0);
+		store8_ps(&dst_p[j + 8], accum1);
+	}
+}
+
+
+// Multi-row vertical kernels. Each input row spanned by the group of output
+// rows is loaded once and accumulated into every output row that uses it.
+// The rows are unrolled by hand so that the accumulators stay in registers.
+inline FORCE_INLINE void resize_accum_v_u16_avx2(const uint32_t *pairs, unsigned p, unsigned pair_first, unsigned pair_last, __m256i lo, __m256i hi, __m256i &accum_lo, __m256i &accum_hi)
+{
+	if (p < pair_first || p >= pair_last)
+		return;
+
+	__m256i coeff = _mm256_set1_epi32(pairs[p]);
+	accum_lo = _mm256_add_epi32(accum_lo, _mm256_madd_epi16(lo, coeff));
+	accum_hi = _mm256_add_epi32(accum_hi, _mm256_madd_epi16(hi, coeff));
+}
+
+template <class T>
+inline FORCE_INLINE void resize_store_v_u16_avx2(T *dst, __m256i accum_lo, __m256i accum_hi, __m256i limit)
+{
+	__m256i result = pack_i30_epi32(accum_lo, accum_hi, limit);
+
+	if (std::is_same<T, uint8_t>::value)
+		result = _mm256_max_epi16(result, _mm256_setzero_si256());
+
+	store16_epi16(dst, result);
+}
+
+template <unsigned N, class T>
+void resize_lines_v_u16_avx2(const FilterContext &filter, const LineBuffer<const T> &src, LineBuffer<T> &dst, unsigned i, unsigned left, unsigned right, uint16_t pixel_max, uint32_t *pairs)
+{
+	static_assert(N >= 2 && N <= 4, "unsupported line count");
+
+	const bool is_byte = std::is_same<T, uint8_t>::value;
+	const __m256i limit = _mm256_set1_epi16(is_byte ? (int16_t)pixel_max : (int16_t)(pixel_max + INT16_MIN));
+
+	unsigned top = filter.left[i];
+	unsigned span = filter_span(filter, i, N);
+	unsigned span_pairs = (span + 1) / 2;
+	unsigned pair_first[4] = { 0 };
+	unsigned pair_last[4] = { 0 };
+
+	pack_filter_pairs(filter, i, N, pairs);
+
+	for (unsigned r = 0; r < N; ++r) {
+		unsigned offset = filter.left[i + r] - top;
+
+		pair_first[r] = offset / 2;
+		pair_last[r] = (offset + filter.filter_width + 1) / 2;
+	}
+
+	const uint32_t *pairs0 = pairs;
+	const uint32_t *pairs1 = pairs + span_pairs;
+	const uint32_t *pairs2 = pairs + span_pairs * 2;
+	const uint32_t *pairs3 = pairs + span_pairs * 3;
+
+	for (unsigned jj = left; jj < right; jj += 16) {
+		unsigned j = std::min(jj, right - 16);
+
+		__m256i accum0_lo = _mm256_setzero_si256();
+		__m256i accum0_hi = _mm256_setzero_si256();
+		__m256i accum1_lo = _mm256_setzero_si256();
+		__m256i accum1_hi = _mm256_setzero_si256();
+		__m256i accum2_lo = _mm256_setzero_si256();
+		__m256i accum2_hi = _mm256_setzero_si256();
+		__m256i accum3_lo = _mm256_setzero_si256();
+		__m256i accum3_hi = _mm256_setzero_si256();
+
+		for (unsigned p = 0; p < span_pairs; ++p) {
+			unsigned k = p * 2;
+			__m256i x0 = load16_epi16(&src[top + k][j]);
+			__m256i x1 = k + 1 < span ? load16_epi16(&src[top + k + 1][j]) : _mm256_setzero_si256();
+			__m256i lo = _mm256_unpacklo_epi16(x0, x1);
+			__m256i hi = _mm256_unpackhi_epi16(x0, x1);
+
+			resize_accum_v_u16_avx2(pairs0, p, pair_first[0], pair_last[0], lo, hi, accum0_lo, accum0_hi);
+			resize_accum_v_u16_avx2(pairs1, p, pair_first[1], pair_last[1], lo, hi, accum1_lo, accum1_hi);
+			if (N >= 3)
+				resize_accum_v_u16_avx2(pairs2, p, pair_first[2], pair_last[2], lo, hi, accum2_lo, accum2_hi);
+			if (N >= 4)
+				resize_accum_v_u16_avx2(pairs3, p, pair_first[3], pair_last[3], lo, hi, accum3_lo, accum3_hi);
+		}
+
+		resize_store_v_u16_avx2(&dst[i + 0][j], accum0_lo, accum0_hi, limit);
+		resize_store_v_u16_avx2(&dst[i + 1][j], accum1_lo, accum1_hi, limit);
+		if (N >= 3)
+			resize_store_v_u16_avx2(&dst[i + 2][j], accum2_lo, accum2_hi, limit);
+		if (N >= 4)
+			resize_store_v_u16_avx2(&dst[i + 3][j], accum3_lo, accum3_hi, limit);
+	}
+}
+
+inline FORCE_INLINE void resize_accum_v_f32_avx2(const float *coeffs, unsigned k, unsigned filter_width, __m256 x0, __m256 x1, __m256 &accum0, __m256 &accum1)
+{
+	// Indices before the row's first tap wrap around and fail the bounds check.
+	if (k >= filter_width)
+		return;
+
+	__m256 coeff = _mm256_broadcast_ss(&coeffs[k]);
+	accum0 = _mm256_fmadd_ps(coeff, x0, accum0);
+	accum1 = _mm256_fmadd_ps(coeff, x1, accum1);
+}
+
+template <unsigned N, class T>
+void resize_lines_v_f32_avx2(const FilterContext &filter, const LineBuffer<const T> &src, LineBuffer<T> &dst, unsigned i, unsigned left, unsigned right)
+{
+	static_assert(N >= 2 && N <= 4, "unsupported line count");
+
+	unsigned top = filter.left[i];
+	unsigned span = filter_span(filter, i, N);
+	unsigned filter_width = filter.filter_width;
+	const float *coeffs[4] = { nullptr };
+	unsigned offset[4] = { 0 };
+
+	for (unsigned r = 0; r < N; ++r) {
+		coeffs[r] = &filter.data[filter.phase[i + r] * filter.stride];
+		offset[r] = filter.left[i + r] - top;
+	}
+
+	for (unsigned jj = left; jj < right; jj += 16) {
+		unsigned j = std::min(jj, right - 16);
+
+		__m256 accum0_lo = _mm256_setzero_ps();
+		__m256 accum0_hi = _mm256_setzero_ps();
+		__m256 accum1_lo = _mm256_setzero_ps();
+		__m256 accum1_hi = _mm256_setzero_ps();
+		__m256 accum2_lo = _mm256_setzero_ps();
+		__m256 accum2_hi = _mm256_setzero_ps();
+		__m256 accum3_lo = _mm256_setzero_ps();
+		__m256 accum3_hi = _mm256_setzero_ps();
+
+		// Each output row sums its own taps in the same order as the single-row kernel.
+		for (unsigned k = 0; k < span; ++k) {
+			const T *src_p = src[top + k];
+			__m256 x0 = load8_ps(&src_p[j + 0]);
+			__m256 x1 = load8_ps(&src_p[j + 8]);
+
+			resize_accum_v_f32_avx2(coeffs[0], k - offset[0], filter_width, x0, x1, accum0_lo, accum0_hi);
+			resize_accum_v_f32_avx2(coeffs[1], k - offset[1], filter_width, x0, x1, accum1_lo, accum1_hi);
+			if (N >= 3)
+				resize_accum_v_f32_avx2(coeffs[2], k - offset[2], filter_width, x0, x1, accum2_lo, accum2_hi);
+			if (N >= 4)
+				resize_accum_v_f32_avx2(coeffs[3], k - offset[3], filter_width, x0, x1, accum3_lo, accum3_hi);
+		}
+
+		store8_ps(&dst[i + 0][j + 0], accum0_lo);
+		store8_ps(&dst[i + 0][j + 8], accum0_hi);
+		store8_ps(&dst[i + 1][j + 0], accum1_lo);
+		store8_ps(&dst[i + 1][j + 8], accum1_hi);
+		if (N >= 3) {
+			store8_ps(&dst[i + 2][j + 0], accum2_lo);
+			store8_ps(&dst[i + 2][j + 8], accum2_hi);
+		}
+		if (N >= 4) {
+			store8_ps(&dst[i + 3][j + 0], accum3_lo);
+			store8_ps(&dst[i + 3][j + 8], accum3_hi);
+		}
+	}
+}
+
+inline void resize_line_v_int_avx2(const FilterContext &filter, const LineBuffer<const uint8_t> &src, LineBuffer<uint8_t> &dst, unsigned i, unsigned left, unsigned right, uint16_t pixel_max)
+{
+	resize_line_v_u8_avx2(filter, src, dst, i, left, right, (uint8_t)pixel_max);
+}
+
+inline void resize_line_v_int_avx2(const FilterContext &filter, const LineBuffer<const uint16_t> &src, LineBuffer<uint16_t> &dst, unsigned i, unsigned left, unsigned right, uint16_t pixel_max)
+{
+	resize_line_v_u16_avx2(filter, src, dst, i, left, right, pixel_max);
+}
+
+// Dispatch a group of n output rows to the multi-row kernels.
+template <class T>
+void resize_group_v_u16_avx2(const FilterContext &filter, const LineBuffer<const T> &src, LineBuffer<T> &dst, unsigned i, unsigned n, unsigned left, unsigned right, uint16_t pixel_max, uint32_t *pairs)
+{
+	if (n == 4 && right - left >= 16) {
+		resize_lines_v_u16_avx2<4>(filter, src, dst, i, left, right, pixel_max, pairs);
+	} else if (n == 3 && right - left >= 16) {
+		resize_lines_v_u16_avx2<3>(filter, src, dst, i, left, right, pixel_max, pairs);
+	} else if (n == 2 && right - left >= 16) {
+		resize_lines_v_u16_avx2<2>(filter, src, dst, i, left, right, pixel_max, pairs);
+	} else {
+		for (unsigned ii = i; ii < i + n; ++ii) {
+			resize_line_v_int_avx2(filter, src, dst, ii, left, right, pixel_max);
+		}
+	}
+}
+
+template <class T>
+void resize_group_v_f32_avx2(const FilterContext &filter, const LineBuffer<const T> &src, LineBuffer<T> &dst, unsigned i, unsigned n, unsigned left, unsigned right)
+{
+	if (n == 4 && right - left >= 16) {
+		resize_lines_v_f32_avx2<4>(filter, src, dst, i, left, right);
+	} else if (n == 3 && right - left >= 16) {
+		resize_lines_v_f32_avx2<3>(filter, src, dst, i, left, right);
+	} else if (n == 2 && right - left >= 16) {
+		resize_lines_v_f32_avx2<2>(filter, src, dst, i, left, right);
+	} else {
+		for (unsigned ii = i; ii < i + n; ++ii) {
+			resize_line_v_f32_avx2(filter, src, dst, ii, left, right);
+		}
+	}
+}
+
+
+template <class T>
+class ResizeImplH_U16_AVX2 final : public ResizeImplH {
+	uint16_t m_pixel_max;
+public:
+	ResizeImplH_U16_AVX2(const FilterContext &filter, unsigned height, unsigned depth) :
+		ResizeImplH(filter, image_attributes{ filter.filter_rows, height, std::is_same<T, uint8_t>::value ? PixelType::BYTE : PixelType::WORD }),
+		m_pixel_max{ (uint16_t)((1UL << depth) - 1) }
+	{
+	}
+
+	unsigned get_simultaneous_lines() const override
+	{
+		return 16;
+	}
+
+	size_t get_tmp_size(unsigned left, unsigned right) const override
+	{
+		auto range = get_required_col_range(left, right);
+
+		size_t size = 0;
+		size += align((size_t)(range.second - range.first + 1) * 16 * sizeof(int16_t), ALIGNMENT);
+		size += align((size_t)(right - left) * 16 * sizeof(int16_t), ALIGNMENT);
+		return size;
+	}
+
+	void process(void *, const ZimgImageBufferConst &src, const ZimgImageBuffer &dst, void *tmp, unsigned i, unsigned left, unsigned right) const override
+	{
+		LineBuffer<const T> src_buf{ src };
+		LineBuffer<T> dst_buf{ dst };
+
+		auto range = get_required_col_range(left, right);
+		unsigned n = std::min(m_attr.height - i, 16U);
+
+		const T *src_ptr[16];
+		T *dst_ptr[16];
+
+		for (unsigned r = 0; r < 16; ++r) {
+			src_ptr[r] = src_buf[std::min(i + r, m_attr.height - 1)];
+			dst_ptr[r] = dst_buf[std::min(i + r, m_attr.height - 1)];
+		}
+
+		int16_t *tmp_in = (int16_t *)tmp;
+		int16_t *tmp_out = tmp_in + align((size_t)(range.second - range.first + 1) * 16, AlignmentOf<int16_t>::value);
+
+		transpose_line_in_u16(src_ptr, tmp_in, range.first, range.second);
+		resize_tile_h_u16_avx2<T>(m_filter, tmp_in, tmp_out, range.first, left, right, m_pixel_max);
+		transpose_line_out_u16(tmp_out, dst_ptr, n, left, right);
+	}
+};
+
+template <class T>
+class ResizeImplH_F32_AVX2 final : public ResizeImplH {
+public:
+	ResizeImplH_F32_AVX2(const FilterContext &filter, unsigned height) :
+		ResizeImplH(filter, image_attributes{ filter.filter_rows, height, std::is_same<T, float>::value ? PixelType::FLOAT : PixelType::HALF })
+	{
+	}
+
+	unsigned get_simultaneous_lines() const override
+	{
+		return 8;
+	}
+
+	size_t get_tmp_size(unsigned left, unsigned right) const override
+	{
+		auto range = get_required_col_range(left, right);
+
+		size_t size = 0;
+		size += align((size_t)(range.second - range.first) * 8 * sizeof(float), ALIGNMENT);
+		size += align((size_t)(right - left) * 8 * sizeof(float), ALIGNMENT);
+		return size;
+	}
+
+	void process(void *, const ZimgImageBufferConst &src, const ZimgImageBuffer &dst, void *tmp, unsigned i, unsigned left, unsigned right) const override
+	{
+		LineBuffer<const T> src_buf{ src };
+		LineBuffer<T> dst_buf{ dst };
+
+		auto range = get_required_col_range(left, right);
+		unsigned n = std::min(m_attr.height - i, 8U);
+
+		const T *src_ptr[8];
+		T *dst_ptr[8];
+
+		for (unsigned r = 0; r < 8; ++r) {
+			src_ptr[r] = src_buf[std::min(i + r, m_attr.height - 1)];
+			dst_ptr[r] = dst_buf[std::min(i + r, m_attr.height - 1)];
+		}
+
+		float *tmp_in = (float *)tmp;
+		float *tmp_out = tmp_in + align((size_t)(range.second - range.first) * 8, AlignmentOf<float>::value);
+
+		transpose_line_in_f32(src_ptr, tmp_in, range.first, range.second);
+		resize_tile_h_f32_avx2(m_filter, tmp_in, tmp_out, range.first, left, right);
+		transpose_line_out_f32(tmp_out, dst_ptr, n, left, right);
+	}
+};
+
+template <unsigned OutPeriod, unsigned InPeriod, unsigned Taps, class T>
+class ResizeImplH_Int_U16_AVX2 final : public ResizeImplH {
+	FilterPeriod m_period;
+	uint16_t m_pixel_max;
+public:
+	ResizeImplH_Int_U16_AVX2(const FilterContext &filter, const FilterPeriod &period, unsigned height, unsigned depth) :
+		ResizeImplH(filter, image_attributes{ filter.filter_rows, height, std::is_same<T, uint8_t>::value ? PixelType::BYTE : PixelType::WORD }),
+		m_period(period),
+		m_pixel_max{ (uint16_t)((1UL << depth) - 1) }
+	{
+	}
+
+	void process(void *, const ZimgImageBufferConst &src, const ZimgImageBuffer &dst, void *, unsigned i, unsigned left, unsigned right) const override
+	{
+		const FilterContext &filter = m_filter;
+		const FilterPeriod &period = m_period;
+		uint16_t pixel_max = m_pixel_max;
+
+		const T *src_p = LineBuffer<const T>{ src }[i];
+		T *dst_p = LineBuffer<T>{ dst }[i];
+
+		const int16_t *coeffs0 = &filter.data_i16[period.phase[0] * filter.stride_i16];
+		const int16_t *coeffs1 = &filter.data_i16[period.phase[OutPeriod - 1] * filter.stride_i16];
+
+		auto generic = [&](unsigned l, unsigned r) { resize_line_h_int_c(filter, src_p, dst_p, l, r, pixel_max); };
+		auto kernel = [&](unsigned b, T *dst_b)
+		{
+			if (OutPeriod == 2)
+				resize_vec_h_up2_u16_avx2<Taps>(coeffs0, coeffs1, src_p, period.offset[0], period.offset[OutPeriod - 1], b, dst_b, pixel_max);
+			else if (InPeriod == 2)
+				resize_vec_h_down2_u16_avx2<Taps>(coeffs0, src_p, period.offset[0], b, dst_b, pixel_max);
+			else
+				resize_vec_h_down4_u16_avx2<Taps>(coeffs0, src_p, period.offset[0], b, dst_b, pixel_max);
+		};
+		auto interior = [&](unsigned l, unsigned r)
+		{
+			if (period.block_right - period.block_left < 16)
+				generic(l, r);
+			else
+				resize_blocks_h_avx2<16, OutPeriod>(period, dst_p, l, r, kernel);
+		};
+
+		resize_line_h_periodic(period, left, right, generic, interior);
+	}
+};
+
+template <unsigned OutPeriod, unsigned InPeriod, unsigned Taps, class T>
+class ResizeImplH_Int_F32_AVX2 final : public ResizeImplH {
+	FilterPeriod m_period;
+public:
+	ResizeImplH_Int_F32_AVX2(const FilterContext &filter, const FilterPeriod &period, unsigned height) :
+		ResizeImplH(filter, image_attributes{ filter.filter_rows, height, std::is_same<T, float>::value ? PixelType::FLOAT : PixelType::HALF }),
+		m_period(period)
+	{
+	}
+
+	void process(void *, const ZimgImageBufferConst &src, const ZimgImageBuffer &dst, void *, unsigned i, unsigned left, unsigned right) const override
+	{
+		const FilterContext &filter = m_filter;
+		const FilterPeriod &period = m_period;
+
+		const T *src_p = LineBuffer<const T>{ src }[i];
+		T *dst_p = LineBuffer<T>{ dst }[i];
+
+		const float *coeffs0 = &filter.data[period.phase[0] * filter.stride];
+		const float *coeffs1 = &filter.data[period.phase[OutPeriod - 1] * filter.stride];
+
+		auto generic = [&](unsigned l, unsigned r) { resize_line_h_fp_c(filter, src_p, dst_p, l, r); };
+		auto kernel = [&](unsigned b, T *dst_b)
+		{
+			if (OutPeriod == 2)
+				resize_vec_h_up2_f32_avx2<Taps>(coeffs0, coeffs1, src_p, period.offset[0], period.offset[OutPeriod - 1], b, dst_b);
+			else if (InPeriod == 2)
+				resize_vec_h_down2_f32_avx2<Taps>(coeffs0, src_p, period.offset[0], b, dst_b);
+			else
+				resize_vec_h_down4_f32_avx2<Taps>(coeffs0, src_p, period.offset[0], b, dst_b);
+		};
+		auto interior = [&](unsigned l, unsigned r)
+		{
+			if (period.block_right - period.block_left < 8)
+				generic(l, r);
+			else
+				resize_blocks_h_avx2<8, OutPeriod>(period, dst_p, l, r, kernel);
+		};
+
+		resize_line_h_periodic(period, left, right, generic, interior);
+	}
+};
+
+template <unsigned OutPeriod, unsigned InPeriod, unsigned Taps>
+using ResizeImplH_Int_Byte_AVX2 = ResizeImplH_Int_U16_AVX2<OutPeriod, InPeriod, Taps, uint8_t>;
+
+template <unsigned OutPeriod, unsigned InPeriod, unsigned Taps>
+using ResizeImplH_Int_Word_AVX2 = ResizeImplH_Int_U16_AVX2<OutPeriod, InPeriod, Taps, uint16_t>;
+
+template <unsigned OutPeriod, unsigned InPeriod, unsigned Taps>
+using ResizeImplH_Int_Half_AVX2 = ResizeImplH_Int_F32_AVX2<OutPeriod, InPeriod, Taps, uint16_t>;
+
+template <unsigned OutPeriod, unsigned InPeriod, unsigned Taps>
+using ResizeImplH_Int_Float_AVX2 = ResizeImplH_Int_F32_AVX2<OutPeriod, InPeriod, Taps, float>;
+
+template <class T>
+class ResizeImplV_U16_AVX2 final : public ResizeImplV {
+	uint16_t m_pixel_max;
+public:
+	ResizeImplV_U16_AVX2(const FilterContext &filter, unsigned width, unsigned depth) :
+		ResizeImplV(filter, image_attributes{ width, filter.filter_rows, std::is_same<T, uint8_t>::value ? PixelType::BYTE : PixelType::WORD }, RESIZE_V_LINES),
+		m_pixel_max{ (uint16_t)((1UL << depth) - 1) }
+	{
+	}
+
+	size_t get_tmp_size(unsigned, unsigned) const override
+	{
+		return m_lines > 1 ? m_lines * ((m_max_buffering + 1) / 2) * sizeof(uint32_t) : 0;
+	}
+
+	void process(void *, const ZimgImageBufferConst &src, const ZimgImageBuffer &dst, void *tmp, unsigned i, unsigned left, unsigned right) const override
+	{
+		LineBuffer<const T> src_buf{ src };
+		LineBuffer<T> dst_buf{ dst };
+		unsigned n = std::min(m_lines, m_attr.height - i);
+
+		resize_group_v_u16_avx2(m_filter, src_buf, dst_buf, i, n, left, right, m_pixel_max, static_cast<uint32_t *>(tmp));
+	}
+};
+
+template <class T>
+class ResizeImplV_F32_AVX2 final : public ResizeImplV {
+public:
+	ResizeImplV_F32_AVX2(const FilterContext &filter, unsigned width) :
+		ResizeImplV(filter, image_attributes{ width, filter.filter_rows, std::is_same<T, float>::value ? PixelType::FLOAT : PixelType::HALF }, RESIZE_V_LINES)
+	{
+	}
+
+	void process(void *, const ZimgImageBufferConst &src, const ZimgImageBuffer &dst, void *, unsigned i, unsigned left, unsigned right) const override
+	{
+		LineBuffer<const T> src_buf{ src };
+		LineBuffer<T> dst_buf{ dst };
+		unsigned n = std::min(m_lines, m_attr.height - i);
+
+		resize_group_v_f32_avx2(m_filter, src_buf, dst_buf, i, n, left, right);
+	}
+};
+
+} // namespace
+
+
+IZimgFilter *create_resize_impl2_h_avx2(const FilterContext &context, unsigned height, PixelType type, unsigned depth)
+{
+	IZimgFilter *ret = nullptr;
+
+	if (type == PixelType::BYTE)
+		ret = new ResizeImplH_U16_AVX2<uint8_t>{ context, height, depth };
+	else if (type == PixelType::WORD)
+		ret = new ResizeImplH_U16_AVX2<uint16_t>{ context, height, depth };
+	else if (type == PixelType::HALF)
+		ret = new ResizeImplH_F32_AVX2<uint16_t>{ context, height };
+	else if (type == PixelType::FLOAT)
+		ret = new ResizeImplH_F32_AVX2<float>{ context, height };
+
+	return ret;
+}
+
+IZimgFilter *create_resize_impl2_int_h_avx2(const FilterContext &context, const FilterPeriod &period, unsigned height, PixelType type, unsigned depth)
+{
+	unsigned taps = context.filter_width;
+	IZimgFilter *ret = nullptr;
+
+	if (type == PixelType::BYTE)
+		ret = create_resize_impl2_int_h<ResizeImplH_Int_Byte_AVX2>(period, taps, context, period, height, depth);
+	else if (type == PixelType::WORD)
+		ret = create_resize_impl2_int_h<ResizeImplH_Int_Word_AVX2>(period, taps, context, period, height, depth);
+	else if (type == PixelType::HALF)
+		ret = create_resize_impl2_int_h<ResizeImplH_Int_Half_AVX2>(period, taps, context, period, height);
+	else if (type == PixelType::FLOAT)
+		ret = create_resize_impl2_int_h<ResizeImplH_Int_Float_AVX2>(period, taps, context, period, height);
+
+	return ret;
+}
+
+IZimgFilter *create_resize_impl2_v_avx2(const FilterContext &context, unsigned width, PixelType type, unsigned depth)
+{
+	IZimgFilter *ret = nullptr;
+
+	if (type == PixelType::BYTE)
+		ret = new ResizeImplV_U16_AVX2<uint8_t>{ context, width, depth };
+	else if (type == PixelType::WORD)
+		ret = new ResizeImplV_U16_AVX2<uint16_t>{ context, width, depth };
+	else if (type == PixelType::HALF)
+		ret = new ResizeImplV_F32_AVX2<uint16_t>{ context, width };
+	else if (type == PixelType::FLOAT)
+		ret = new ResizeImplV_F32_AVX2<float>{ context, width };
+
+	return ret;
+}
+
+} // namespace resize
+} // namespace zimg
+
+#endif // ZIMG_X86
@@ -0,0 +1,684 @@
+#ifdef ZIMG_X86
+
+#include <algorithm>
+#include <cstdint>
+#include <immintrin.h>
+#include "Common/align.h"
+#include "Common/except.h"
+#include "Common/linebuffer.h"
+#include "Common/osdep.h"
+#include "Common/pixel.h"
+#include "Common/zfilter.h"
+#include "resize_impl2.h"
+#include "resize_impl2_x86.h"
+
+namespace zimg {;
+namespace resize {;
+
+namespace {;
+
+// Output rows computed per call by the vertical kernels.
+const unsigned RESIZE_V_LINES = 4;
+
+// Transpose two 8x8 blocks, one in each 128-bit lane.
+inline FORCE_INLINE void transpose8_epi16(__m256i &x0, __m256i &x1, __m256i &x2, __m256i &x3, __m256i &x4, __m256i &x5, __m256i &x6, __m256i &x7)
+{
+	__m256i t0, t1, t2, t3, t4, t5, t6, t7;
+	__m256i u0, u1, u2, u3, u4, u5, u6, u7;
+
+	t0 = _mm256_unpacklo_epi16(x0, x1);
+	t1 = _mm256_unpackhi_epi16(x0, x1);
+	t2 = _mm256_unpacklo_epi16(x2, x3);
+	t3 = _mm256_unpackhi_epi16(x2, x3);
+	t4 = _mm256_unpacklo_epi16(x4, x5);
+	t5 = _mm256_unpackhi_epi16(x4, x5);
+	t6 = _mm256_unpacklo_epi16(x6, x7);
+	t7 = _mm256_unpackhi_epi16(x6, x7);
+
+	u0 = _mm256_unpacklo_epi32(t0, t2);
+	u1 = _mm256_unpackhi_epi32(t0, t2);
+	u2 = _mm256_unpacklo_epi32(t1, t3);
+	u3 = _mm256_unpackhi_epi32(t1, t3);
+	u4 = _mm256_unpacklo_epi32(t4, t6);
+	u5 = _mm256_unpackhi_epi32(t4, t6);
+	u6 = _mm256_unpacklo_epi32(t5, t7);
+	u7 = _mm256_unpackhi_epi32(t5, t7);
+
+	x0 = _mm256_unpacklo_epi64(u0, u4);
+	x1 = _mm256_unpackhi_epi64(u0, u4);
+	x2 = _mm256_unpacklo_epi64(u1, u5);
+	x3 = _mm256_unpackhi_epi64(u1, u5);
+	x4 = _mm256_unpacklo_epi64(u2, u6);
+	x5 = _mm256_unpackhi_epi64(u2, u6);
+	x6 = _mm256_unpacklo_epi64(u3, u7);
+	x7 = _mm256_unpackhi_epi64(u3, u7);
+}
+
+inline FORCE_INLINE void transpose8_ps(__m256 &row0, __m256 &row1, __m256 &row2, __m256 &row3, __m256 &row4, __m256 &row5, __m256 &row6, __m256 &row7)
+{
+	__m256 t0, t1, t2, t3, t4, t5, t6, t7;
+	__m256 tt0, tt1, tt2, tt3, tt4, tt5, tt6, tt7;
+
+	t0 = _mm256_unpacklo_ps(row0, row1);
+	t1 = _mm256_unpackhi_ps(row0, row1);
+	t2 = _mm256_unpacklo_ps(row2, row3);
+	t3 = _mm256_unpackhi_ps(row2, row3);
+	t4 = _mm256_unpacklo_ps(row4, row5);
+	t5 = _mm256_unpackhi_ps(row4, row5);
+	t6 = _mm256_unpacklo_ps(row6, row7);
+	t7 = _mm256_unpackhi_ps(row6, row7);
+
+	tt0 = _mm256_shuffle_ps(t0, t2, _MM_SHUFFLE(1, 0, 1, 0));
+	tt1 = _mm256_shuffle_ps(t0, t2, _MM_SHUFFLE(3, 2, 3, 2));
+	tt2 = _mm256_shuffle_ps(t1, t3, _MM_SHUFFLE(1, 0, 1, 0));
+	tt3 = _mm256_shuffle_ps(t1, t3, _MM_SHUFFLE(3, 2, 3, 2));
+	tt4 = _mm256_shuffle_ps(t4, t6, _MM_SHUFFLE(1, 0, 1, 0));
+	tt5 = _mm256_shuffle_ps(t4, t6, _MM_SHUFFLE(3, 2, 3, 2));
+	tt6 = _mm256_shuffle_ps(t5, t7, _MM_SHUFFLE(1, 0, 1, 0));
+	tt7 = _mm256_shuffle_ps(t5, t7, _MM_SHUFFLE(3, 2, 3, 2));
+
+	row0 = _mm256_permute2f128_ps(tt0, tt4, 0x20);
+	row1 = _mm256_permute2f128_ps(tt1, tt5, 0x20);
+	row2 = _mm256_permute2f128_ps(tt2, tt6, 0x20);
+	row3 = _mm256_permute2f128_ps(tt3, tt7, 0x20);
+	row4 = _mm256_permute2f128_ps(tt0, tt4, 0x31);
+	row5 = _mm256_permute2f128_ps(tt1, tt5, 0x31);
+	row6 = _mm256_permute2f128_ps(tt2, tt6, 0x31);
+	row7 = _mm256_permute2f128_ps(tt3, tt7, 0x31);
+}
+
+inline FORCE_INLINE __m512i coeff_pair_epi16(const int16_t *coeffs, unsigned k)
+{
+	return _mm512_set1_epi32((uint16_t)coeffs[k] | ((uint32_t)(uint16_t)coeffs[k + 1] << 16));
+}
+
+inline FORCE_INLINE __m512i pack_i30_epi32(__m512i lo, __m512i hi, __m512i limit)
+{
+	const __m512i round = _mm512_set1_epi32(1 << 13);
+
+	// A full zero mask avoids the undefined pass-through operand of the unmasked form.
+	lo = _mm512_maskz_srai_epi32(0xFFFF, _mm512_add_epi32(lo, round), 14);
+	hi = _mm512_maskz_srai_epi32(0xFFFF, _mm512_add_epi32(hi, round), 14);
+
+	// Saturation to INT16 implements the lower bound of zero after biasing.
+	return _mm512_min_epi16(_mm512_packs_epi32(lo, hi), limit);
+}
+
+inline FORCE_INLINE __mmask16 tail_mask16(unsigned n)
+{
+	return n >= 16 ? 0xFFFFU : (__mmask16)((1U << n) - 1);
+}
+
+inline FORCE_INLINE __mmask32 tail_mask32(unsigned n)
+{
+	return n >= 32 ? 0xFFFFFFFFU : (__mmask32)((1U << n) - 1);
+}
+
+// Transpose columns [left, right) of 32 rows into column-interleaved order, biased to signed.
+void transpose_line_in_u16(const uint16_t * const src[32], int16_t *dst, unsigned left, unsigned right)
+{
+	const __m256i bias = _mm256_set1_epi16(INT16_MIN);
+	unsigned vec_right = left + mod(right - left, 16);
+
+	for (unsigned j = left; j < vec_right; j += 16) {
+		for (unsigned g = 0; g < 32; g += 8) {
+			__m256i x[8];
+
+			for (unsigned r = 0; r < 8; ++r) {
+				x[r] = _mm256_xor_si256(_mm256_loadu_si256((const __m256i *)&src[g + r][j]), bias);
+			}
+
+			transpose8_epi16(x[0], x[1], x[2], x[3], x[4], x[5], x[6], x[7]);
+
+			for (unsigned c = 0; c < 8; ++c) {
+				int16_t *dst_p = dst + (j - left + c) * 32 + g;
+
+				_mm_store_si128((__m128i *)dst_p, _mm256_castsi256_si128(x[c]));
+				_mm_store_si128((__m128i *)(dst_p + 8 * 32), _mm256_extracti128_si256(x[c], 1));
+			}
+		}
+	}
+	for (unsigned j = vec_right; j < right; ++j) {
+		for (unsigned r = 0; r < 32; ++r) {
+			dst[(j - left) * 32 + r] = (int16_t)unpack_pixel_u16(src[r][j]);
+		}
+	}
+
+	// Padding column for filters with an odd number of taps.
+	_mm512_storeu_si512(dst + (right - left) * 32, _mm512_setzero_si512());
+}
+
+// Inverse of transpose_line_in_u16, storing only the first n rows.
+void transpose_line_out_u16(const int16_t *src, uint16_t * const dst[32], unsigned n, unsigned left, unsigned right)
+{
+	const __m256i bias = _mm256_set1_epi16(INT16_MIN);
+	unsigned vec_right = left + mod(right - left, 16);
+
+	for (unsigned j = left; j < vec_right; j += 16) {
+		for (unsigned g = 0; g < n; g += 8) {
+			__m256i x[8];
+
+			for (unsigned c = 0; c < 8; ++c) {
+				const int16_t *src_p = src + (j - left + c) * 32 + g;
+				__m128i lo = _mm_load_si128((const __m128i *)src_p);
+				__m128i hi = _mm_load_si128((const __m128i *)(src_p + 8 * 32));
+
+				x[c] = _mm256_inserti128_si256(_mm256_castsi128_si256(lo), hi, 1);
+			}
+
+			transpose8_epi16(x[0], x[1], x[2], x[3], x[4], x[5], x[6], x[7]);
+
+			for (unsigned r = 0; r < std::min(n - g, 8U); ++r) {
+				_mm256_storeu_si256((__m256i *)&dst[g + r][j], _mm256_xor_si256(x[r], bias));
+			}
+		}
+	}
+	for (unsigned j = vec_right; j < right; ++j) {
+		for (unsigned r = 0; r < n; ++r) {
+			dst[r][j] = (uint16_t)(src[(j - left) * 32 + r] - INT16_MIN);
+		}
+	}
+}
+
+// Transpose columns [left, right) of sixteen rows into column-interleaved order.
+void transpose_line_in_f32(const float * const src[16], float *dst, unsigned left, unsigned right)
+{
+	unsigned vec_right = left + mod(right - left, 8);
+
+	for (unsigned j = left; j < vec_right; j += 8) {
+		for (unsigned g = 0; g < 16; g += 8) {
+			__m256 x[8];
+
+			for (unsigned r = 0; r < 8; ++r) {
+				x[r] = _mm256_loadu_ps(&src[g + r][j]);
+			}
+
+			transpose8_ps(x[0], x[1], x[2], x[3], x[4], x[5], x[6], x[7]);
+
+			for (unsigned c = 0; c < 8; ++c) {
+				_mm256_store_ps(dst + (j - left + c) * 16 + g, x[c]);
+			}
+		}
+	}
+	for (unsigned j = vec_right; j < right; ++j) {
+		for (unsigned r = 0; r < 16; ++r) {
+			dst[(j - left) * 16 + r] = src[r][j];
+		}
+	}
+}
+
+// Inverse of transpose_line_in_f32, storing only the first n rows.
+void transpose_line_out_f32(const float *src, float * const dst[16], unsigned n, unsigned left, unsigned right)
+{
+	unsigned vec_right = left + mod(right - left, 8);
+
+	for (unsigned j = left; j < vec_right; j += 8) {
+		for (unsigned g = 0; g < n; g += 8) {
+			__m256 x[8];
+
+			for (unsigned c = 0; c < 8; ++c) {
+				x[c] = _mm256_load_ps(src + (j - left + c) * 16 + g);
+			}
+
+			transpose8_ps(x[0], x[1], x[2], x[3], x[4], x[5], x[6], x[7]);
+
+			for (unsigned r = 0; r < std::min(n - g, 8U); ++r) {
+				_mm256_storeu_ps(&dst[g + r][j], x[r]);
+			}
+		}
+	}
+	for (unsigned j = vec_right; j < right; ++j) {
+		for (unsigned r = 0; r < n; ++r) {
+			dst[r][j] = src[(j - left) * 16 + r];
+		}
+	}
+}
+
+void resize_tile_h_u16_avx512(const FilterContext &filter, const int16_t *src, int16_t *dst, unsigned src_left, unsigned left, unsigned right, uint16_t pixel_max)
+{
+	const __m512i limit = _mm512_set1_epi16((int16_t)(pixel_max + INT16_MIN));
+
+	for (unsigned j = left; j < right; ++j) {
+		const int16_t *coeffs = &filter.data_i16[filter.phase[j] * filter.stride_i16];
+		const int16_t *src_p = src + (filter.left[j] - src_left) * 32;
+
+		__m512i accum_lo = _mm512_setzero_si512();
+		__m512i accum_hi = _mm512_setzero_si512();
+
+		for (unsigned k = 0; k < filter.filter_width; k += 2) {
+			__m512i coeff = coeff_pair_epi16(coeffs, k);
+			__m512i x0 = _mm512_loadu_si512(src_p + k * 32);
+			__m512i x1 = _mm512_loadu_si512(src_p + k * 32 + 32);
+
+			accum_lo = _mm512_add_epi32(accum_lo, _mm512_madd_epi16(_mm512_unpacklo_epi16(x0, x1), coeff));
+			accum_hi = _mm512_add_epi32(accum_hi, _mm512_madd_epi16(_mm512_unpackhi_epi16(x0, x1), coeff));
+		}
+
+		_mm512_storeu_si512(dst + (j - left) * 32, pack_i30_epi32(accum_lo, accum_hi, limit));
+	}
+}
+
+void resize_tile_h_f32_avx512(const FilterContext &filter, const float *src, float *dst, unsigned src_left, unsigned left, unsigned right)
+{
+	for (unsigned j = left; j < right; ++j) {
+		const float *coeffs = &filter.data[filter.phase[j] * filter.stride];
+		const float *src_p = src + (filter.left[j] - src_left) * 16;
+
+		__m512 accum = _mm512_setzero_ps();
+
+		for (unsigned k = 0; k < filter.filter_width; ++k) {
+			__m512 coeff = _mm512_set1_ps(coeffs[k]);
+			__m512 x = _mm512_loadu_ps(src_p + k * 16);
+
+			accum = _mm512_fmadd_ps(coeff, x, accum);
+		}
+
+		_mm512_storeu_ps(dst + (j - left) * 16, accum);
+	}
+}
+
+void resize_line_v_u16_avx512(const FilterContext &filter, const LineBuffer<const uint16_t> &src, LineBuffer<uint16_t> &dst, unsigned i, unsigned left, unsigned right, uint16_t pixel_max)
+{
+	const __m512i bias = _mm512_set1_epi16(INT16_MIN);
+	const __m512i limit = _mm512_set1_epi16((int16_t)(pixel_max + INT16_MIN));
+
+	const int16_t *coeffs = &filter.data_i16[filter.phase[i] * filter.stride_i16];
+	unsigned top = filter.left[i];
+	unsigned filter_width_even = mod(filter.filter_width, 2);
+	uint16_t *dst_p = dst[i];
+
+	for (unsigned j = left; j < right; j += 32) {
+		// Masked loads do not fault on columns past the right edge.
+		__mmask32 mask = tail_mask32(right - j);
+
+		__m512i accum_lo = _mm512_setzero_si512();
+		__m512i accum_hi = _mm512_setzero_si512();
+
+		for (unsigned k = 0; k < filter_width_even; k += 2) {
+			__m512i coeff = coeff_pair_epi16(coeffs, k);
+			__m512i x0 = _mm512_xor_si512(_mm512_maskz_loadu_epi16(mask, &src[top + k][j]), bias);
+			__m512i x1 = _mm512_xor_si512(_mm512_maskz_loadu_epi16(mask, &src[top + k + 1][j]), bias);
+
+			accum_lo = _mm512_add_epi32(accum_lo, _mm512_madd_epi16(_mm512_unpacklo_epi16(x0, x1), coeff));
+			accum_hi = _mm512_add_epi32(accum_hi, _mm512_madd_epi16(_mm512_unpackhi_epi16(x0, x1), coeff));
+		}
+		if (filter_width_even != filter.filter_width) {
+			unsigned k = filter_width_even;
+
+			__m512i coeff = coeff_pair_epi16(coeffs, k);
+			__m512i x0 = _mm512_xor_si512(_mm512_maskz_loadu_epi16(mask, &src[top + k][j]), bias);
+			__m512i x1 = _mm512_setzero_si512();
+
+			accum_lo = _mm512_add_epi32(accum_lo, _mm512_madd_epi16(_mm512_unpacklo_epi16(x0, x1), coeff));
+			accum_hi = _mm512_add_epi32(accum_hi, _mm512_madd_epi16(_mm512_unpackhi_epi16(x0, x1), coeff));
+		}
+
+		_mm512_mask_storeu_epi16(&dst_p[j], mask, _mm512_xor_si512(pack_i30_epi32(accum_lo, accum_hi, limit), bias));
+	}
+}
+
+void resize_line_v_f32_avx512(const FilterContext &filter, const LineBuffer<const float> &src, LineBuffer<float> &dst, unsigned i, unsigned left, unsigned right)
+{
+	const float *coeffs = &filter.data[filter.phase[i] * filter.stride];
+	unsigned top = filter.left[i];
+	unsigned vec_right = left + mod(right - left, 32);
+	float *dst_p = dst[i];
+
+	for (unsigned j = left; j < vec_right; j += 32) {
+		__m512 accum0 = _mm512_setzero_ps();
+		__m512 accum1 = _mm512_setzero_ps();
+
+		for (unsigned k = 0; k < filter.filter_width; ++k) {
+			__m512 coeff = _mm512_set1_ps(coeffs[k]);
+			const float *src_p = src[top + k];
+
+			accum0 = _mm512_fmadd_ps(coeff, _mm512_loadu_ps(&src_p[j + 0]), accum0);
+			accum1 = _mm512_fmadd_ps(coeff, _mm512_loadu_ps(&src_p[j + 16]), accum1);
+		}
+
+		_mm512_storeu_ps(&dst_p[j + 0], accum0);
+		_mm512_storeu_ps(&dst_p[j + 16], accum1);
+	}
+	for (unsigned j = vec_right; j < right; j += 16) {
+		__mmask16 mask = tail_mask16(right - j);
+		__m512 accum = _mm512_setzero_ps();
+
+		for (unsigned k = 0; k < filter.filter_width; ++k) {
+			__m512 coeff = _mm512_set1_ps(coeffs[k]);
+			accum = _mm512_fmadd_ps(coeff, _mm512_maskz_loadu_ps(mask, &src[top + k][j]), accum);
+		}
+
+		_mm512_mask_storeu_ps(&dst_p[j], mask, accum);
+	}
+}
+
+// Multi-row vertical kernels. Each input row spanned by the group of output
+// rows is loaded once and accumulated into every output row that uses it.
+inline FORCE_INLINE void resize_accum_v_u16_avx512(const uint32_t *pairs, unsigned p, unsigned pair_first, unsigned pair_last, __m512i lo, __m512i hi, __m512i &accum_lo, __m512i &accum_hi)
+{
+	if (p < pair_first || p >= pair_last)
+		return;
+
+	__m512i coeff = _mm512_set1_epi32(pairs[p]);
+	accum_lo = _mm512_add_epi32(accum_lo, _mm512_madd_epi16(lo, coeff));
+	accum_hi = _mm512_add_epi32(accum_hi, _mm512_madd_epi16(hi, coeff));
+}
+
+template <unsigned N>
+void resize_lines_v_u16_avx512(const FilterContext &filter, const LineBuffer<const uint16_t> &src, LineBuffer<uint16_t> &dst, unsigned i, unsigned left, unsigned right, uint16_t pixel_max, uint32_t *pairs)
+{
+	static_assert(N >= 2 && N <= 4, "unsupported line count");
+
+	const __m512i bias = _mm512_set1_epi16(INT16_MIN);
+	const __m512i limit = _mm512_set1_epi16((int16_t)(pixel_max + INT16_MIN));
+
+	unsigned top = filter.left[i];
+	unsigned span = filter_span(filter, i, N);
+	unsigned span_pairs = (span + 1) / 2;
+	unsigned pair_first[4] = { 0 };
+	unsigned pair_last[4] = { 0 };
+
+	pack_filter_pairs(filter, i, N, pairs);
+
+	for (unsigned r = 0; r < N; ++r) {
+		unsigned offset = filter.left[i + r] - top;
+
+		pair_first[r] = offset / 2;
+		pair_last[r] = (offset + filter.filter_width + 1) / 2;
+	}
+
+	const uint32_t *pairs0 = pairs;
+	const uint32_t *pairs1 = pairs + span_pairs;
+	const uint32_t *pairs2 = pairs + span_pairs * 2;
+	const uint32_t *pairs3 = pairs + span_pairs * 3;
+
+	for (unsigned j = left; j < right; j += 32) {
+		__mmask32 mask = tail_mask32(right - j);
+
+		__m512i accum0_lo = _mm512_setzero_si512();
+		__m512i accum0_hi = _mm512_setzero_si512();
+		__m512i accum1_lo = _mm512_setzero_si512();
+		__m512i accum1_hi = _mm512_setzero_si512();
+		__m512i accum2_lo = _mm512_setzero_si512();
+		__m512i accum2_hi = _mm512_setzero_si512();
+		__m512i accum3_lo = _mm512_setzero_si512();
+		__m512i accum3_hi = _mm512_setzero_si512();
+
+		for (unsigned p = 0; p < span_pairs; ++p) {
+			unsigned k = p * 2;
+			__m512i x0 = _mm512_xor_si512(_mm512_maskz_loadu_epi16(mask, &src[top + k][j]), bias);
+			__m512i x1 = k + 1 < span ? _mm512_xor_si512(_mm512_maskz_loadu_epi16(mask, &src[top + k + 1][j]), bias) : _mm512_setzero_si512();
+			__m512i lo = _mm512_unpacklo_epi16(x0, x1);
+			__m512i hi = _mm512_unpackhi_epi16(x0, x1);
+
+			resize_accum_v_u16_avx512(pairs0, p, pair_first[0], pair_last[0], lo, hi, accum0_lo, accum0_hi);
+			resize_accum_v_u16_avx512(pairs1, p, pair_first[1], pair_last[1], lo, hi, accum1_lo, accum1_hi);
+			if (N >= 3)
+				resize_accum_v_u16_avx512(pairs2, p, pair_first[2], pair_last[2], lo, hi, accum2_lo, accum2_hi);
+			if (N >= 4)
+				resize_accum_v_u16_avx512(pairs3, p, pair_first[3], pair_last[3], lo, hi, accum3_lo, accum3_hi);
+		}
+
+		_mm512_mask_storeu_epi16(&dst[i + 0][j], mask, _mm512_xor_si512(pack_i30_epi32(accum0_lo, accum0_hi, limit), bias));
+		_mm512_mask_storeu_epi16(&dst[i + 1][j], mask, _mm512_xor_si512(pack_i30_epi32(accum1_lo, accum1_hi, limit), bias));
+		if (N >= 3)
+			_mm512_mask_storeu_epi16(&dst[i + 2][j], mask, _mm512_xor_si512(pack_i30_epi32(accum2_lo, accum2_hi, limit), bias));
+		if (N >= 4)
+			_mm512_mask_storeu_epi16(&dst[i + 3][j], mask, _mm512_xor_si512(pack_i30_epi32(accum3_lo, accum3_hi, limit), bias));
+	}
+}
+
+inline FORCE_INLINE void resize_accum_v_f32_avx512(const float *coeffs, unsigned k, unsigned filter_width, __m512 x, __m512 &accum)
+{
+	// Indices before the row's first tap wrap around and fail the bounds check.
+	if (k >= filter_width)
+		return;
+
+	accum = _mm512_fmadd_ps(_mm512_set1_ps(coeffs[k]), x, accum);
+}
+
+template <unsigned N>
+void resize_lines_v_f32_avx512(const FilterContext &filter, const LineBuffer<const float> &src, LineBuffer<float> &dst, unsigned i, unsigned left, unsigned right)
+{
+	static_assert(N >= 2 && N <= 4, "unsupported line count");
+
+	unsigned top = filter.left[i];
+	unsigned span = filter_span(filter, i, N);
+	unsigned filter_width = filter.filter_width;
+	const float *coeffs[4] = { nullptr };
+	unsigned offset[4] = { 0 };
+
+	for (unsigned r = 0; r < N; ++r) {
+		coeffs[r] = &filter.data[filter.phase[i + r] * filter.stride];
+		offset[r] = filter.left[i + r] - top;
+	}
+
+	for (unsigned j = left; j < right; j += 16) {
+		__mmask16 mask = tail_mask16(right - j);
+
+		__m512 accum0 = _mm512_setzero_ps();
+		__m512 accum1 = _mm512_setzero_ps();
+		__m512 accum2 = _mm512_setzero_ps();
+		__m512 accum3 = _mm512_setzero_ps();
+
+		// Each output row sums its own taps in the same order as the single-row kernel.
+		for (unsigned k = 0; k < span; ++k) {
+			__m512 x = _mm512_maskz_loadu_ps(mask, &src[top + k][j]);
+
+			resize_accum_v_f32_avx512(coeffs[0], k - offset[0], filter_width, x, accum0);
+			resize_accum_v_f32_avx512(coeffs[1], k - offset[1], filter_width, x, accum1);
+			if (N >= 3)
+				resize_accum_v_f32_avx512(coeffs[2], k - offset[2], filter_width, x, accum2);
+			if (N >= 4)
+				resize_accum_v_f32_avx512(coeffs[3], k - offset[3], filter_width, x, accum3);
+		}
+
+		_mm512_mask_storeu_ps(&dst[i + 0][j], mask, accum0);
+		_mm512_mask_storeu_ps(&dst[i + 1][j], mask, accum1);
+		if (N >= 3)
+			_mm512_mask_storeu_ps(&dst[i + 2][j], mask, accum2);
+		if (N >= 4)
+			_mm512_mask_storeu_ps(&dst[i + 3][j], mask, accum3);
+	}
+}
+
+// Dispatch a group of n output rows to the multi-row kernels.
+void resize_group_v_u16_avx512(const FilterContext &filter, const LineBuffer<const uint16_t> &src, LineBuffer<uint16_t> &dst, unsigned i, unsigned n, unsigned left, unsigned right, uint16_t pixel_max, uint32_t *pairs)
+{
+	if (n == 4) {
+		resize_lines_v_u16_avx512<4>(filter, src, dst, i, left, right, pixel_max, pairs);
+	} else if (n == 3) {
+		resize_lines_v_u16_avx512<3>(filter, src, dst, i, left, right, pixel_max, pairs);
+	} else if (n == 2) {
+		resize_lines_v_u16_avx512<2>(filter, src, dst, i, left, right, pixel_max, pairs);
+	} else {
+		for (unsigned ii = i; ii < i + n; ++ii) {
+			resize_line_v_u16_avx512(filter, src, dst, ii, left, right, pixel_max);
+		}
+	}
+}
+
+void resize_group_v_f32_avx512(const FilterContext &filter, const LineBuffer<const float> &src, LineBuffer<float> &dst, unsigned i, unsigned n, unsigned left, unsigned right)
+{
+	if (n == 4) {
+		resize_lines_v_f32_avx512<4>(filter, src, dst, i, left, right);
+	} else if (n == 3) {
+		resize_lines_v_f32_avx512<3>(filter, src, dst, i, left, right);
+	} else if (n == 2) {
+		resize_lines_v_f32_avx512<2>(filter, src, dst, i, left, right);
+	} else {
+		for (unsigned ii = i; ii < i + n; ++ii) {
+			resize_line_v_f32_avx512(filter, src, dst, ii, left, right);
+		}
+	}
+}
+
+
+class ResizeImplH_U16_AVX512 final : public ResizeImplH {
+	uint16_t m_pixel_max;
+public:
+	ResizeImplH_U16_AVX512(const FilterContext &filter, unsigned height, unsigned depth) :
+		ResizeImplH(filter, image_attributes{ filter.filter_rows, height, PixelType::WORD }),
+		m_pixel_max{ (uint16_t)((1UL << depth) - 1) }
+	{
+	}
+
+	unsigned get_simultaneous_lines() const override
+	{
+		return 32;
+	}
+
+	size_t get_tmp_size(unsigned left, unsigned right) const override
+	{
+		auto range = get_required_col_range(left, right);
+
+		size_t size = 0;
+		size += align((size_t)(range.second - range.first + 1) * 32 * sizeof(int16_t), ALIGNMENT);
+		size += align((size_t)(right - left) * 32 * sizeof(int16_t), ALIGNMENT);
+		return size;
+	}
+
+	void process(void *, const ZimgImageBufferConst &src, const ZimgImageBuffer &dst, void *tmp, unsigned i, unsigned left, unsigned right) const override
+	{
+		LineBuffer<const uint16_t> src_buf{ src };
+		LineBuffer<uint16_t> dst_buf{ dst };
+
+		auto range = get_required_col_range(left, right);
+		unsigned n = std::min(m_attr.height - i, 32U);
+
+		const uint16_t *src_ptr[32];
+		uint16_t *dst_ptr[32];
+
+		for (unsigned r = 0; r < 32; ++r) {
+			src_ptr[r] = src_buf[std::min(i + r, m_attr.height - 1)];
+			dst_ptr[r] = dst_buf[std::min(i + r, m_attr.height - 1)];
+		}
+
+		int16_t *tmp_in = (int16_t *)tmp;
+		int16_t *tmp_out = tmp_in + align((size_t)(range.second - range.first + 1) * 32, AlignmentOf<int16_t>::value);
+
+		transpose_line_in_u16(src_ptr, tmp_in, range.first, range.second);
+		resize_tile_h_u16_avx512(m_filter, tmp_in, tmp_out, range.first, left, right, m_pixel_max);
+		transpose_line_out_u16(tmp_out, dst_ptr, n, left, right);
+	}
+};
+
+class ResizeImplH_F32_AVX512 final : public ResizeImplH {
+public:
+	ResizeImplH_F32_AVX512(const FilterContext &filter, unsigned height) :
+		ResizeImplH(filter, image_attributes{ filter.filter_rows, height, PixelType::FLOAT })
+	{
+	}
+
+	unsigned get_simultaneous_lines() const override
+	{
+		return 16;
+	}
+
+	size_t get_tmp_size(unsigned left, unsigned right) const override
+	{
+		auto range = get_required_col_range(left, right);
+
+		size_t size = 0;
+		size += align((size_t)(range.second - range.first) * 16 * sizeof(float), ALIGNMENT);
+		size += align((size_t)(right - left) * 16 * sizeof(float), ALIGNMENT);
+		return size;
+	}
+
+	void process(void *, const ZimgImageBufferConst &src, const ZimgImageBuffer &dst, void *tmp, unsigned i, unsigned left, unsigned right) const override
+	{
+		LineBuffer<const float> src_buf{ src };
+		LineBuffer<float> dst_buf{ dst };
+
+		auto range = get_required_col_range(left, right);
+		unsigned n = std::min(m_attr.height - i, 16U);
+
+		const float *src_ptr[16];
+		float *dst_ptr[16];
+
+		for (unsigned r = 0; r < 16; ++r) {
+			src_ptr[r] = src_buf[std::min(i + r, m_attr.height - 1)];
+			dst_ptr[r] = dst_buf[std::min(i + r, m_attr.height - 1)];
+		}
+
+		float *tmp_in = (float *)tmp;
+		float *tmp_out = tmp_in + align((size_t)(range.second - range.first) * 16, AlignmentOf<float>::value);
+
+		transpose_line_in_f32(src_ptr, tmp_in, range.first, range.second);
+		resize_tile_h_f32_avx512(m_filter, tmp_in, tmp_out, range.first, left, right);
+		transpose_line_out_f32(tmp_out, dst_ptr, n, left, right);
+	}
+};
+
+class ResizeImplV_U16_AVX512 final : public ResizeImplV {
+	uint16_t m_pixel_max;
+public:
+	ResizeImplV_U16_AVX512(const FilterContext &filter, unsigned width, unsigned depth) :
+		ResizeImplV(filter, image_attributes{ width, filter.filter_rows, PixelType::WORD }, RESIZE_V_LINES),
+		m_pixel_max{ (uint16_t)((1UL << depth) - 1) }
+	{
+	}
+
+	size_t get_tmp_size(unsigned, unsigned) const override
+	{
+		return m_lines > 1 ? m_lines * ((m_max_buffering + 1) / 2) * sizeof(uint32_t) : 0;
+	}
+
+	void process(void *, const ZimgImageBufferConst &src, const ZimgImageBuffer &dst, void *tmp, unsigned i, unsigned left, unsigned right) const override
+	{
+		LineBuffer<const uint16_t> src_buf{ src };
+		LineBuffer<uint16_t> dst_buf{ dst };
+		unsigned n = std::min(m_lines, m_attr.height - i);
+
+		resize_group_v_u16_avx512(m_filter, src_buf, dst_buf, i, n, left, right, m_pixel_max, static_cast<uint32_t *>(tmp));
+	}
+};
+
+class ResizeImplV_F32_AVX512 final : public ResizeImplV {
+public:
+	ResizeImplV_F32_AVX512(const FilterContext &filter, unsigned width) :
+		ResizeImplV(filter, image_attributes{ width, filter.filter_rows, PixelType::FLOAT }, RESIZE_V_LINES)
+	{
+	}
+
+	void process(void *, const ZimgImageBufferConst &src, const ZimgImageBuffer &dst, void *, unsigned i, unsigned left, unsigned right) const override
+	{
+		LineBuffer<const float> src_buf{ src };
+		LineBuffer<float> dst_buf{ dst };
+		unsigned n = std::min(m_lines, m_attr.height - i);
+
+		resize_group_v_f32_avx512(m_filter, src_buf, dst_buf, i, n, left, right);
+	}
+};
+
+} // namespace
+
+
+IZimgFilter *create_resize_impl2_h_avx512(const FilterContext &context, unsigned height, PixelType type, unsigned depth)
+{
+	IZimgFilter *ret = nullptr;
+
+	if (type == PixelType::WORD)
+		ret = new ResizeImplH_U16_AVX512{ context, height, depth };
+	else if (type == PixelType::FLOAT)
+		ret = new ResizeImplH_F32_AVX512{ context, height };
+
+	return ret;
+}
+
+IZimgFilter *create_resize_impl2_v_avx512(const FilterContext &context, unsigned width, PixelType type, unsigned depth)
+{
+	IZimgFilter *ret = nullptr;
+
+	if (type == PixelType::WORD)
+		ret = new ResizeImplV_U16_AVX512{ context, width, depth };
+	else if (type == PixelType::FLOAT)
+		ret = new ResizeImplV_F32_AVX512{ context, width };
+
+	return ret;
+}
+
+} // namespace resize
+} // namespace zimg
+
+#endif // ZIMG_X86
@@ -0,0 +1,579 @@
+#ifdef ZIMG_X86
+
+#include <algorithm>
+#include <cstdint>
+#include <type_traits>
+#include <emmintrin.h>
+#include "Common/align.h"
+#include "Common/except.h"
+#include "Common/linebuffer.h"
+#include "Common/osdep.h"
+#include "Common/pixel.h"
+#include "Common/zfilter.h"
+#include "resize_impl2.h"
+#include "resize_impl2_x86.h"
+
+namespace zimg {;
+namespace resize {;
+
+namespace {;
+
+inline FORCE_INLINE void transpose8_epi16(__m128i &x0, __m128i &x1, __m128i &x2, __m128i &x3, __m128i &x4, __m128i &x5, __m128i &x6, __m128i &x7)
+{
+	__m128i t0, t1, t2, t3, t4, t5, t6, t7;
+	__m128i u0, u1, u2, u3, u4, u5, u6, u7;
+
+	t0 = _mm_unpacklo_epi16(x0, x1);
+	t1 = _mm_unpackhi_epi16(x0, x1);
+	t2 = _mm_unpacklo_epi16(x2, x3);
+	t3 = _mm_unpackhi_epi16(x2, x3);
+	t4 = _mm_unpacklo_epi16(x4, x5);
+	t5 = _mm_unpackhi_epi16(x4, x5);
+	t6 = _mm_unpacklo_epi16(x6, x7);
+	t7 = _mm_unpackhi_epi16(x6, x7);
+
+	u0 = _mm_unpacklo_epi32(t0, t2);
+	u1 = _mm_unpackhi_epi32(t0, t2);
+	u2 = _mm_unpacklo_epi32(t1, t3);
+	u3 = _mm_unpackhi_epi32(t1, t3);
+	u4 = _mm_unpacklo_epi32(t4, t6);
+	u5 = _mm_unpackhi_epi32(t4, t6);
+	u6 = _mm_unpacklo_epi32(t5, t7);
+	u7 = _mm_unpackhi_epi32(t5, t7);
+
+	x0 = _mm_unpacklo_epi64(u0, u4);
+	x1 = _mm_unpackhi_epi64(u0, u4);
+	x2 = _mm_unpacklo_epi64(u1, u5);
+	x3 = _mm_unpackhi_epi64(u1, u5);
+	x4 = _mm_unpacklo_epi64(u2, u6);
+	x5 = _mm_unpackhi_epi64(u2, u6);
+	x6 = _mm_unpacklo_epi64(u3, u7);
+	x7 = _mm_unpackhi_epi64(u3, u7);
+}
+
+inline FORCE_INLINE __m128i coeff_pair_epi16(const int16_t *coeffs, unsigned k)
+{
+	return _mm_set1_epi32((uint16_t)coeffs[k] | ((uint32_t)(uint16_t)coeffs[k + 1] << 16));
+}
+
+inline FORCE_INLINE __m128i pack_i30_epi32(__m128i lo, __m128i hi, __m128i limit)
+{
+	const __m128i round = _mm_set1_epi32(1 << 13);
+
+	lo = _mm_srai_epi32(_mm_add_epi32(lo, round), 14);
+	hi = _mm_srai_epi32(_mm_add_epi32(hi, round), 14);
+
+	// Saturation to INT16 implements the lower bound of zero after biasing.
+	return _mm_min_epi16(_mm_packs_epi32(lo, hi), limit);
+}
+
+inline FORCE_INLINE __m128i shift_i30_epi32(__m128i x)
+{
+	return _mm_srai_epi32(_mm_add_epi32(x, _mm_set1_epi32(1 << 13)), 14);
+}
+
+// Words are biased to signed, while bytes are zero-extended.
+inline FORCE_INLINE __m128i load8_epi16(const uint16_t *ptr)
+{
+	return _mm_xor_si128(_mm_loadu_si128((const __m128i *)ptr), _mm_set1_epi16(INT16_MIN));
+}
+
+inline FORCE_INLINE __m128i load8_epi16(const uint8_t *ptr)
+{
+	return _mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i *)ptr), _mm_setzero_si128());
+}
+
+inline FORCE_INLINE void store8_epi16(uint16_t *ptr, __m128i x)
+{
+	_mm_storeu_si128((__m128i *)ptr, _mm_xor_si128(x, _mm_set1_epi16(INT16_MIN)));
+}
+
+inline FORCE_INLINE void store8_epi16(uint8_t *ptr, __m128i x)
+{
+	_mm_storel_epi64((__m128i *)ptr, _mm_packus_epi16(x, x));
+}
+
+inline int16_t unpack_pixel(uint16_t x) { return (int16_t)unpack_pixel_u16(x); }
+inline int16_t unpack_pixel(uint8_t x) { return x; }
+
+inline uint16_t pack_pixel(int16_t x, uint16_t *) { return (uint16_t)(x - INT16_MIN); }
+inline uint8_t pack_pixel(int16_t x, uint8_t *) { return (uint8_t)x; }
+
+// Transpose columns [left, right) of eight rows into column-interleaved order.
+template <class T>
+void transpose_line_in_u16(const T * const src[8], int16_t *dst, unsigned left, unsigned right)
+{
+	unsigned vec_right = left + mod(right - left, 8);
+
+	for (unsigned j = left; j < vec_right; j += 8) {
+		__m128i x0 = load8_epi16(&src[0][j]);
+		__m128i x1 = load8_epi16(&src[1][j]);
+		__m128i x2 = load8_epi16(&src[2][j]);
+		__m128i x3 = load8_epi16(&src[3][j]);
+		__m128i x4 = load8_epi16(&src[4][j]);
+		__m128i x5 = load8_epi16(&src[5][j]);
+		__m128i x6 = load8_epi16(&src[6][j]);
+		__m128i x7 = load8_epi16(&src[7][j]);
+		int16_t *dst_p = dst + (j - left) * 8;
+
+		transpose8_epi16(x0, x1, x2, x3, x4, x5, x6, x7);
+
+		_mm_store_si128((__m128i *)(dst_p + 0), x0);
+		_mm_store_si128((__m128i *)(dst_p + 8), x1);
+		_mm_store_si128((__m128i *)(dst_p + 16), x2);
+		_mm_store_si128((__m128i *)(dst_p + 24), x3);
+		_mm_store_si128((__m128i *)(dst_p + 32), x4);
+		_mm_store_si128((__m128i *)(dst_p + 40), x5);
+		_mm_store_si128((__m128i *)(dst_p + 48), x6);
+		_mm_store_si128((__m128i *)(dst_p + 56), x7);
+	}
+	for (unsigned j = vec_right; j < right; ++j) {
+		for (unsigned r = 0; r < 8; ++r) {
+			dst[(j - left) * 8 + r] = unpack_pixel(src[r][j]);
+		}
+	}
+
+	// Padding column for filters with an odd number of taps.
+	_mm_store_si128((__m128i *)(dst + (right - left) * 8), _mm_setzero_si128());
+}
+
+// Inverse of transpose_line_in_u16, storing only the first n rows.
+template <class T>
+void transpose_line_out_u16(const int16_t *src, T * const dst[8], unsigned n, unsigned left, unsigned right)
+{
+	unsigned vec_right = left + mod(right - left, 8);
+
+	for (unsigned j = left; j < vec_right; j += 8) {
+		const int16_t *src_p = src + (j - left) * 8;
+		__m128i x[8];
+
+		x[0] = _mm_load_si128((const __m128i *)(src_p + 0));
+		x[1] = _mm_load_si128((const __m128i *)(src_p + 8));
+		x[2] = _mm_load_si128((const __m128i *)(src_p + 16));
+		x[3] = _mm_load_si128((const __m128i *)(src_p + 24));
+		x[4] = _mm_load_si128((const __m128i *)(src_p + 32));
+		x[5] = _mm_load_si128((const __m128i *)(src_p + 40));
+		x[6] = _mm_load_si128((const __m128i *)(src_p + 48));
+		x[7] = _mm_load_si128((const __m128i *)(src_p + 56));
+
+		transpose8_epi16(x[0], x[1], x[2], x[3], x[4], x[5], x[6], x[7]);
+
+		for (unsigned r = 0; r < n; ++r) {
+			store8_epi16(&dst[r][j], x[r]);
+		}
+	}
+	for (unsigned j = vec_right; j < right; ++j) {
+		for (unsigned r = 0; r < n; ++r) {
+			dst[r][j] = pack_pixel(src[(j - left) * 8 + r], (T *)nullptr);
+		}
+	}
+}
+
+// Transpose columns [left, right) of four rows into column-interleaved order.
+void transpose_line_in_f32(const float * const src[4], float *dst, unsigned left, unsigned right)
+{
+	unsigned vec_right = left + mod(right - left, 4);
+
+	for (unsigned j = left; j < vec_right; j += 4) {
+		__m128 x0 = _mm_loadu_ps(&src[0][j]);
+		__m128 x1 = _mm_loadu_ps(&src[1][j]);
+		__m128 x2 = _mm_loadu_ps(&src[2][j]);
+		__m128 x3 = _mm_loadu_ps(&src[3][j]);
+		float *dst_p = dst + (j - left) * 4;
+
+		_MM_TRANSPOSE4_PS(x0, x1, x2, x3);
+
+		_mm_store_ps(dst_p + 0, x0);
+		_mm_store_ps(dst_p + 4, x1);
+		_mm_store_ps(dst_p + 8, x2);
+		_mm_store_ps(dst_p + 12, x3);
+	}
+	for (unsigned j = vec_right; j < right; ++j) {
+		for (unsigned r = 0; r < 4; ++r) {
+			dst[(j - left) * 4 + r] = src[r][j];
+		}
+	}
+}
+
+// Inverse of transpose_line_in_f32, storing only the first n rows.
+void transpose_line_out_f32(const float *src, float * const dst[4], unsigned n, unsigned left, unsigned right)
+{
+	unsigned vec_right = left + mod(right - left, 4);
+
+	for (unsigned j = left; j < vec_right; j += 4) {
+		const float *src_p = src + (j - left) * 4;
+		__m128 x[4];
+
+		x[0] = _mm_load_ps(src_p + 0);
+		x[1] = _mm_load_ps(src_p + 4);
+		x[2] = _mm_load_ps(src_p + 8);
+		x[3] = _mm_load_ps(src_p + 12);
+
+		_MM_TRANSPOSE4_PS(x[0], x[1], x[2], x[3]);
+
+		for (unsigned r = 0; r < n; ++r) {
+			_mm_storeu_ps(&dst[r][j], x[r]);
+		}
+	}
+	for (unsigned j = vec_right; j < right; ++j) {
+		for (unsigned r = 0; r < n; ++r) {
+			dst[r][j] = src[(j - left) * 4 + r];
+		}
+	}
+}
+
+template <class T>
+void resize_tile_h_u16_sse2(const FilterContext &filter, const int16_t *src, int16_t *dst, unsigned src_left, unsigned left, unsigned right, uint16_t pixel_max)
+{
+	// Bytes are not biased and must also be clamped to zero.
+	const bool is_byte = std::is_same<T, uint8_t>::value;
+	const __m128i limit = _mm_set1_epi16(is_byte ? (int16_t)pixel_max : (int16_t)(pixel_max + INT16_MIN));
+
+	for (unsigned j = left; j < right; ++j) {
+		const int16_t *coeffs = &filter.data_i16[filter.phase[j] * filter.stride_i16];
+		const int16_t *src_p = src + (filter.left[j] - src_left) * 8;
+
+		__m128i accum_lo = _mm_setzero_si128();
+		__m128i accum_hi = _mm_setzero_si128();
+
+		for (unsigned k = 0; k < filter.filter_width; k += 2) {
+			__m128i coeff = coeff_pair_epi16(coeffs, k);
+			__m128i x0 = _mm_load_si128((const __m128i *)(src_p + k * 8));
+			__m128i x1 = _mm_load_si128((const __m128i *)(src_p + k * 8 + 8));
+
+			accum_lo = _mm_add_epi32(accum_lo, _mm_madd_epi16(_mm_unpacklo_epi16(x0, x1), coeff));
+			accum_hi = _mm_add_epi32(accum_hi, _mm_madd_epi16(_mm_unpackhi_epi16(x0, x1), coeff));
+		}
+
+		__m128i result = pack_i30_epi32(accum_lo, accum_hi, limit);
+
+		if (is_byte)
+			result = _mm_max_epi16(result, _mm_setzero_si128());
+
+		_mm_store_si128((__m128i *)(dst + (j - left) * 8), result);
+	}
+}
+
+void resize_tile_h_f32_sse2(const FilterContext &filter, const float *src, float *dst, unsigned src_left, unsigned left, unsigned right)
+{
+	for (unsigned j = left; j < right; ++j) {
+		const float *coeffs = &filter.data[filter.phase[j] * filter.stride];
+		const float *src_p = src + (filter.left[j] - src_left) * 4;
+
+		__m128 accum = _mm_setzero_ps();
+
+		for (unsigned k = 0; k < filter.filter_width; ++k) {
+			__m128 coeff = _mm_set_ps1(coeffs[k]);
+			__m128 x = _mm_load_ps(src_p + k * 4);
+
+			accum = _mm_add_ps(accum, _mm_mul_ps(coeff, x));
+		}
+
+		_mm_store_ps(dst + (j - left) * 4, accum);
+	}
+}
+
+void resize_line_v_u16_sse2(const FilterContext &filter, const LineBuffer<const uint16_t> &src, LineBuffer<uint16_t> &dst, unsigned i, unsigned left, unsigned right, uint16_t pixel_max)
+{
+	const __m128i bias = _mm_set1_epi16(INT16_MIN);
+	const __m128i limit = _mm_set1_epi16((int16_t)(pixel_max + INT16_MIN));
+
+	const int16_t *coeffs = &filter.data_i16[filter.phase[i] * filter.stride_i16];
+	unsigned top = filter.left[i];
+	unsigned filter_width_even = mod(filter.filter_width, 2);
+	uint16_t *dst_p = dst[i];
+
+	if (right - left < 8) {
+		resize_line_v_u16_c(filter, src, dst, i, left, right, pixel_max);
+		return;
+	}
+
+	for (unsigned jj = left; jj < right; jj += 8) {
+		// Handle the right edge by recomputing an overlapping vector.
+		unsigned j = std::min(jj, right - 8);
+
+		__m128i accum_lo = _mm_setzero_si128();
+		__m128i accum_hi = _mm_setzero_si128();
+
+		for (unsigned k = 0; k < filter_width_even; k += 2) {
+			__m128i coeff = coeff_pair_epi16(coeffs, k);
+			__m128i x0 = _mm_xor_si128(_mm_loadu_si128((const __m128i *)&src[top + k][j]), bias);
+			__m128i x1 = _mm_xor_si128(_mm_loadu_si128((const __m128i *)&src[top + k + 1][j]), bias);
+
+			accum_lo = _mm_add_epi32(accum_lo, _mm_madd_epi16(_mm_unpacklo_epi16(x0, x1), coeff));
+			accum_hi = _mm_add_epi32(accum_hi, _mm_madd_epi16(_mm_unpackhi_epi16(x0, x1), coeff));
+		}
+		if (filter_width_even != filter.filter_width) {
+			unsigned k = filter_width_even;
+
+			__m128i coeff = coeff_pair_epi16(coeffs, k);
+			__m128i x0 = _mm_xor_si128(_mm_loadu_si128((const __m128i *)&src[top + k][j]), bias);
+			__m128i x1 = _mm_setzero_si128();
+
+			accum_lo = _mm_add_epi32(accum_lo, _mm_madd_epi16(_mm_unpacklo_epi16(x0, x1), coeff));
+			accum_hi = _mm_add_epi32(accum_hi, _mm_madd_epi16(_mm_unpackhi_epi16(x0, x1), coeff));
+		}
+
+		_mm_storeu_si128((__m128i *)&dst_p[j], _mm_xor_si128(pack_i30_epi32(accum_lo, accum_hi, limit), bias));
+	}
+}
+
+void resize_line_v_u8_sse2(const FilterContext &filter, const LineBuffer<const uint8_t> &src, LineBuffer<uint8_t> &dst, unsigned i, unsigned left, unsigned right, uint8_t pixel_max)
+{
+	const __m128i zero = _mm_setzero_si128();
+	const __m128i limit = _mm_set1_epi8((char)pixel_max);
+
+	const int16_t *coeffs = &filter.data_i16[filter.phase[i] * filter.stride_i16];
+	unsigned top = filter.left[i];
+	uint8_t *dst_p = dst[i];
+
+	if (right - left < 16) {
+		resize_line_v_u8_c(filter, src, dst, i, left, right, pixel_max);
+		return;
+	}
+
+	for (unsigned jj = left; jj < right; jj += 16) {
+		unsigned j = std::min(jj, right - 16);
+
+		__m128i accum0 = _mm_setzero_si128();
+		__m128i accum1 = _mm_setzero_si128();
+		__m128i accum2 = _mm_setzero_si128();
+		__m128i accum3 = _mm_setzero_si128();
+
+		for (unsigned k = 0; k < filter.filter_width; k += 2) {
+			__m128i coeff = coeff_pair_epi16(coeffs, k);
+			__m128i x0 = _mm_loadu_si128((const __m128i *)&src[top + k][j]);
+			__m128i x1 = k + 1 < filter.filter_width ? _mm_loadu_si128((const __m128i *)&src[top + k + 1][j]) : zero;
+
+			// Interleave the rows, then zero-extend to the word pairs consumed by pmaddwd.
+			__m128i lo = _mm_unpacklo_epi8(x0, x1);
+			__m128i hi = _mm_unpackhi_epi8(x0, x1);
+
+			accum0 = _mm_add_epi32(accum0, _mm_madd_epi16(_mm_unpacklo_epi8(lo, zero), coeff));
+			accum1 = _mm_add_epi32(accum1, _mm_madd_epi16(_mm_unpackhi_epi8(lo, zero), coeff));
+			accum2 = _mm_add_epi32(accum2, _mm_madd_epi16(_mm_unpacklo_epi8(hi, zero), coeff));
+			accum3 = _mm_add_epi32(accum3, _mm_madd_epi16(_mm_unpackhi_epi8(hi, zero), coeff));
+		}
+
+		__m128i lo = _mm_packs_epi32(shift_i30_epi32(accum0), shift_i30_epi32(accum1));
+		__m128i hi = _mm_packs_epi32(shift_i30_epi32(accum2), shift_i30_epi32(accum3));
+
+		_mm_storeu_si128((__m128i *)&dst_p[j], _mm_min_epu8(_mm_packus_epi16(lo, hi), limit));
+	}
+}
+
+void resize_line_v_f32_sse2(const FilterContext &filter, const LineBuffer<const float> &src, LineBuffer<float> &dst, unsigned i, unsigned left, unsigned right)
+{
+	const float *coeffs = &filter.data[filter.phase[i] * filter.stride];
+	unsigned top = filter.left[i];
+	float *dst_p = dst[i];
+
+	if (right - left < 8) {
+		resize_line_v_f32_c(filter, src, dst, i, left, right);
+		return;
+	}
+
+	for (unsigned jj = left; jj < right; jj += 8) {
+		unsigned j = std::min(jj, right - 8);
+
+		__m128 accum0 = _mm_setzero_ps();
+		__m128 accum1 = _mm_setzero_ps();
+
+		for (unsigned k = 0; k < filter.filter_width; ++k) {
+			__m128 coeff = _mm_set_ps1(coeffs[k]);
+			const float *src_p = src[top + k];
+
+			accum0 = _mm_add_ps(accum0, _mm_mul_ps(coeff, _mm_loadu_ps(&src_p[j + 0])));
+			accum1 = _mm_add_ps(accum1, _mm_mul_ps(coeff, _mm_loadu_ps(&src_p[j + 4])));
+		}
+
+		_mm_storeu_ps(&dst_p[j + 0], accum0);
+		_mm_storeu_ps(&dst_p[j + 4], accum1);
+	}
+}
+
+
+template <class T>
+class ResizeImplH_U16_SSE2 final : public ResizeImplH {
+	uint16_t m_pixel_max;
+public:
+	ResizeImplH_U16_SSE2(const FilterContext &filter, unsigned height, unsigned depth) :
+		ResizeImplH(filter, image_attributes{ filter.filter_rows, height, std::is_same<T, uint8_t>::value ? PixelType::BYTE : PixelType::WORD }),
+		m_pixel_max{ (uint16_t)((1UL << depth) - 1) }
+	{
+	}
+
+	unsigned get_simultaneous_lines() const override
+	{
+		return 8;
+	}
+
+	size_t get_tmp_size(unsigned left, unsigned right) const override
+	{
+		auto range = get_required_col_range(left, right);
+
+		size_t size = 0;
+		size += align((size_t)(range.second - range.first + 1) * 8 * sizeof(int16_t), ALIGNMENT);
+		size += align((size_t)(right - left) * 8 * sizeof(int16_t), ALIGNMENT);
+		return size;
+	}
+
+	void process(void *, const ZimgImageBufferConst &src, const ZimgImageBuffer &dst, void *tmp, unsigned i, unsigned left, unsigned right) const override
+	{
+		LineBuffer<const T> src_buf{ src };
+		LineBuffer<T> dst_buf{ dst };
+
+		auto range = get_required_col_range(left, right);
+		unsigned n = std::min(m_attr.height - i, 8U);
+
+		const T *src_ptr[8];
+		T *dst_ptr[8];
+
+		for (unsigned r = 0; r < 8; ++r) {
+			src_ptr[r] = src_buf[std::min(i + r, m_attr.height - 1)];
+			dst_ptr[r] = dst_buf[std::min(i + r, m_attr.height - 1)];
+		}
+
+		int16_t *tmp_in = (int16_t *)tmp;
+		int16_t *tmp_out = tmp_in + align((size_t)(range.second - range.first + 1) * 8, AlignmentOf<int16_t>::value);
+
+		transpose_line_in_u16(src_ptr, tmp_in, range.first, range.second);
+		resize_tile_h_u16_sse2<T>(m_filter, tmp_in, tmp_out, range.first, left, right, m_pixel_max);
+		transpose_line_out_u16(tmp_out, dst_ptr, n, left, right);
+	}
+};
+
+class ResizeImplH_F32_SSE2 final : public ResizeImplH {
+public:
+	ResizeImplH_F32_SSE2(const FilterContext &filter, unsigned height) :
+		ResizeImplH(filter, image_attributes{ filter.filter_rows, height, PixelType::FLOAT })
+	{
+	}
+
+	unsigned get_simultaneous_lines() const override
+	{
+		return 4;
+	}
+
+	size_t get_tmp_size(unsigned left, unsigned right) const override
+	{
+		auto range = get_required_col_range(left, right);
+
+		size_t size = 0;
+		size += align((size_t)(range.second - range.first) * 4 * sizeof(float), ALIGNMENT);
+		size += align((size_t)(right - left) * 4 * sizeof(float), ALIGNMENT);
+		return size;
+	}
+
+	void process(void *, const ZimgImageBufferConst &src, const ZimgImageBuffer &dst, void *tmp, unsigned i, unsigned left, unsigned right) const override
+	{
+		LineBuffer<const float> src_buf{ src };
+		LineBuffer<float> dst_buf{ dst };
+
+		auto range = get_required_col_range(left, right);
+		unsigned n = std::min(m_attr.height - i, 4U);
+
+		const float *src_ptr[4];
+		float *dst_ptr[4];
+
+		for (unsigned r = 0; r < 4; ++r) {
+			src_ptr[r] = src_buf[std::min(i + r, m_attr.height - 1)];
+			dst_ptr[r] = dst_buf[std::min(i + r, m_attr.height - 1)];
+		}
+
+		float *tmp_in = (float *)tmp;
+		float *tmp_out = tmp_in + align((size_t)(range.second - range.first) * 4, AlignmentOf<float>::value);
+
+		transpose_line_in_f32(src_ptr, tmp_in, range.first, range.second);
+		resize_tile_h_f32_sse2(m_filter, tmp_in, tmp_out, range.first, left, right);
+		transpose_line_out_f32(tmp_out, dst_ptr, n, left, right);
+	}
+};
+
+class ResizeImplV_U16_SSE2 final : public ResizeImplV {
+	uint16_t m_pixel_max;
+public:
+	ResizeImplV_U16_SSE2(const FilterContext &filter, unsigned width, unsigned depth) :
+		ResizeImplV(filter, image_attributes{ width, filter.filter_rows, PixelType::WORD }),
+		m_pixel_max{ (uint16_t)((1UL << depth) - 1) }
+	{
+	}
+
+	void process(void *, const ZimgImageBufferConst &src, const ZimgImageBuffer &dst, void *, unsigned i, unsigned left, unsigned right) const override
+	{
+		LineBuffer<const uint16_t> src_buf{ src };
+		LineBuffer<uint16_t> dst_buf{ dst };
+
+		resize_line_v_u16_sse2(m_filter, src_buf, dst_buf, i, left, right, m_pixel_max);
+	}
+};
+
+class ResizeImplV_U8_SSE2 final : public ResizeImplV {
+	uint8_t m_pixel_max;
+public:
+	ResizeImplV_U8_SSE2(const FilterContext &filter, unsigned width, unsigned depth) :
+		ResizeImplV(filter, image_attributes{ width, filter.filter_rows, PixelType::BYTE }),
+		m_pixel_max{ (uint8_t)((1UL << depth) - 1) }
+	{
+	}
+
+	void process(void *, const ZimgImageBufferConst &src, const ZimgImageBuffer &dst, void *, unsigned i, unsigned left, unsigned right) const override
+	{
+		LineBuffer<const uint8_t> src_buf{ src };
+		LineBuffer<uint8_t> dst_buf{ dst };
+
+		resize_line_v_u8_sse2(m_filter, src_buf, dst_buf, i, left, right, m_pixel_max);
+	}
+};
+
+class ResizeImplV_F32_SSE2 final : public ResizeImplV {
+public:
+	ResizeImplV_F32_SSE2(const FilterContext &filter, unsigned width) :
+		ResizeImplV(filter, image_attributes{ width, filter.filter_rows, PixelType::FLOAT })
+	{
+	}
+
+	void process(void *, const ZimgImageBufferConst &src, const ZimgImageBuffer &dst, void *, unsigned i, unsigned left, unsigned right) const override
+	{
+		LineBuffer<const float> src_buf{ src };
+		LineBuffer<float> dst_buf{ dst };
+
+		resize_line_v_f32_sse2(m_filter, src_buf, dst_buf, i, left, right);
+	}
+};
+
+} // namespace
+
+
+IZimgFilter *create_resize_impl2_h_sse2(const FilterContext &context, unsigned height, PixelType type, unsigned depth)
+{
+	IZimgFilter *ret = nullptr;
+
+	if (type == PixelType::BYTE)
+		ret = new ResizeImplH_U16_SSE2<uint8_t>{ context, height, depth };
+	else if (type == PixelType::WORD)
+		ret = new ResizeImplH_U16_SSE2<uint16_t>{ context, height, depth };
+	else if (type == PixelType::FLOAT)
+		ret = new ResizeImplH_F32_SSE2{ context, height };
+
+	return ret;
+}
+
+IZimgFilter *create_resize_impl2_v_sse2(const FilterContext &context, unsigned width, PixelType type, unsigned depth)
+{
+	IZimgFilter *ret = nullptr;
+
+	if (type == PixelType::BYTE)
+		ret = new ResizeImplV_U8_SSE2{ context, width, depth };
+	else if (type == PixelType::WORD)
+		ret = new ResizeImplV_U16_SSE2{ context, width, depth };
+	else if (type == PixelType::FLOAT)
+		ret = new ResizeImplV_F32_SSE2{ context, width };
+
+	return ret;
+}
+
+} // namespace resize
+} // namespace zimg
+
+#endif // ZIMG_X86
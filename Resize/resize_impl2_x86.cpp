@@ -0,0 +1,81 @@
+#ifdef ZIMG_X86
+
+#include "Common/cpuinfo.h"
+#include "Common/pixel.h"
+#include "resize_impl2_x86.h"
+
+namespace zimg {;
+namespace resize {;
+
+IZimgFilter *create_resize_impl2_h_x86(const FilterContext &context, unsigned height, PixelType type, unsigned depth, CPUClass cpu)
+{
+	X86Capabilities caps = query_x86_capabilities();
+	IZimgFilter *ret = nullptr;
+
+	// Fall back to lower tiers for pixel types that a tier does not implement.
+	// The AVX2 kernels convert HALF with F16C.
+	if (cpu == CPUClass::CPU_AUTO) {
+		if (!ret && caps.avx512f && caps.avx512bw && caps.avx512vl)
+			ret = create_resize_impl2_h_avx512(context, height, type, depth);
+		if (!ret && caps.avx2 && caps.fma && (type != PixelType::HALF || caps.f16c))
+			ret = create_resize_impl2_h_avx2(context, height, type, depth);
+		if (!ret && caps.sse2)
+			ret = create_resize_impl2_h_sse2(context, height, type, depth);
+	} else {
+		if (!ret && cpu >= CPUClass::CPU_X86_AVX512)
+			ret = create_resize_impl2_h_avx512(context, height, type, depth);
+		if (!ret && cpu >= CPUClass::CPU_X86_AVX2)
+			ret = create_resize_impl2_h_avx2(context, height, type, depth);
+		if (!ret && cpu >= CPUClass::CPU_X86_SSE2)
+			ret = create_resize_impl2_h_sse2(context, height, type, depth);
+	}
+
+	return ret;
+}
+
+IZimgFilter *create_resize_impl2_v_x86(const FilterContext &context, unsigned width, PixelType type, unsigned depth, CPUClass cpu)
+{
+	X86Capabilities caps = query_x86_capabilities();
+	IZimgFilter *ret = nullptr;
+
+	// Fall back to lower tiers for pixel types that a tier does not implement.
+	// The AVX2 kernels convert HALF with F16C.
+	if (cpu == CPUClass::CPU_AUTO) {
+		if (!ret && caps.avx512f && caps.avx512bw && caps.avx512vl)
+			ret = create_resize_impl2_v_avx512(context, width, type, depth);
+		if (!ret && caps.avx2 && caps.fma && (type != PixelType::HALF || caps.f16c))
+			ret = create_resize_impl2_v_avx2(context, width, type, depth);
+		if (!ret && caps.sse2)
+			ret = create_resize_impl2_v_sse2(context, width, type, depth);
+	} else {
+		if (!ret && cpu >= CPUClass::CPU_X86_AVX512)
+			ret = create_resize_impl2_v_avx512(context, width, type, depth);
+		if (!ret && cpu >= CPUClass::CPU_X86_AVX2)
+			ret = create_resize_impl2_v_avx2(context, width, type, depth);
+		if (!ret && cpu >= CPUClass::CPU_X86_SSE2)
+			ret = create_resize_impl2_v_sse2(context, width, type, depth);
+	}
+
+	return ret;
+}
+
+IZimgFilter *create_resize_impl2_int_h_x86(const FilterContext &context, const FilterPeriod &period, unsigned height, PixelType type, unsigned depth, CPUClass cpu)
+{
+	X86Capabilities caps = query_x86_capabilities();
+	IZimgFilter *ret = nullptr;
+
+	if (cpu == CPUClass::CPU_AUTO) {
+		if (!ret && caps.avx2 && caps.fma)
+			ret = create_resize_impl2_int_h_avx2(context, period, height, type, depth);
+	} else {
+		if (!ret && cpu >= CPUClass::CPU_X86_AVX2)
+			ret = create_resize_impl2_int_h_avx2(context, period, height, type, depth);
+	}
+
+	return ret;
+}
+
+} // namespace resize
+} // namespace zimg
+
+#endif // ZIMG_X86
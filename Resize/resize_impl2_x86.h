@@ -0,0 +1,65 @@
+#pragma once
+
+#ifdef ZIMG_X86
+
+#ifndef ZIMG_RESIZE_RESIZE_IMPL2_X86_H_
+#define ZIMG_RESIZE_RESIZE_IMPL2_X86_H_
+
+namespace zimg {;
+
+enum class CPUClass;
+enum class PixelType;
+
+class IZimgFilter;
+
+namespace resize {;
+
+struct FilterContext;
+struct FilterPeriod;
+
+IZimgFilter *create_resize_impl2_h_sse2(const FilterContext &context, unsigned height, PixelType type, unsigned depth);
+IZimgFilter *create_resize_impl2_v_sse2(const FilterContext &context, unsigned width, PixelType type, unsigned depth);
+
+IZimgFilter *create_resize_impl2_h_avx2(const FilterContext &context, unsigned height, PixelType type, unsigned depth);
+IZimgFilter *create_resize_impl2_v_avx2(const FilterContext &context, unsigned width, PixelType type, unsigned depth);
+
+IZimgFilter *create_resize_impl2_int_h_avx2(const FilterContext &context, const FilterPeriod &period, unsigned height, PixelType type, unsigned depth);
+
+IZimgFilter *create_resize_impl2_h_avx512(const FilterContext &context, unsigned height, PixelType type, unsigned depth);
+IZimgFilter *create_resize_impl2_v_avx512(const FilterContext &context, unsigned width, PixelType type, unsigned depth);
+
+/**
+ * Create an appropriate x86 optimized horizontal resizer for the given CPU.
+ *
+ * @param context filter coefficients
+ * @param height image height
+ * @param type pixel type
+ * @param depth bit depth of integer pixels
+ * @param cpu create filter for given cpu
+ * @return concrete filter, or nullptr if no optimized filter is available
+ */
+IZimgFilter *create_resize_impl2_h_x86(const FilterContext &context, unsigned height, PixelType type, unsigned depth, CPUClass cpu);
+
+/**
+ * Create an appropriate x86 optimized vertical resizer for the given CPU.
+ *
+ * @see create_resize_impl2_h_x86
+ */
+IZimgFilter *create_resize_impl2_v_x86(const FilterContext &context, unsigned width, PixelType type, unsigned depth, CPUClass cpu);
+
+/**
+ * Create an x86 optimized horizontal resizer for an integer scale factor.
+ *
+ * @param context filter coefficients
+ * @param period periodic interior of the filter
+ * @see create_resize_impl2_h_x86
+ * @return concrete filter, or nullptr if the factor or tap count is not specialized
+ */
+IZimgFilter *create_resize_impl2_int_h_x86(const FilterContext &context, const FilterPeriod &period, unsigned height, PixelType type, unsigned depth, CPUClass cpu);
+
+} // namespace resize
+} // namespace zimg
+
+#endif // ZIMG_RESIZE_RESIZE_IMPL2_X86_H_
+
+#endif // ZIMG_X86
@@ -9,6 +9,8 @@ int depth_main(int argc, const char **argv);
 
 int resize_main(int argc, const char **argv);
 
+int resizecost_main(int argc, const char **argv);
+
 int unresize_main(int argc, const char **argv);
 
 #endif // APPS_H_
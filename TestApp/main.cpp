@@ -11,6 +11,7 @@ void usage()
 	std::cout << "    colorspace - change colorspace\n";
 	std::cout << "    depth      - change depth\n";
 	std::cout << "    resize     - resize images\n";
+	std::cout << "    resizecost - measure resize kernel costs\n";
 	std::cout << "    unresize   - unresize images\n";
 }
 
@@ -31,6 +32,8 @@ int main(int argc, const char **argv)
 			return depth_main(argc - 1, argv + 1);
 		} else if (!strcmp(argv[1], "resize")) {
 			return resize_main(argc - 1, argv + 1);
+		} else if (!strcmp(argv[1], "resizecost")) {
+			return resizecost_main(argc - 1, argv + 1);
 		} else if (!strcmp(argv[1], "unresize")) {
 			return unresize_main(argc - 1, argv + 1);
 		} else {
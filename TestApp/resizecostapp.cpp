@@ -0,0 +1,158 @@
+#include <algorithm>
+#include <cstddef>
+#include <iostream>
+#include <iterator>
+#include <memory>
+#include <stdexcept>
+#include <vector>
+#include "Common/cpuinfo.h"
+#include "Common/pixel.h"
+#include "Common/zfilter.h"
+#include "Resize/filter.h"
+#include "Resize/resize_cost.h"
+#include "Resize/resize_impl2.h"
+#include "apps.h"
+#include "frame.h"
+#include "timer.h"
+#include "utils.h"
+
+using namespace zimg;
+
+namespace {;
+
+const int SRC_WIDTH = 1920;
+const int SRC_HEIGHT = 1080;
+const int MAX_LANCZOS_TAPS = 6;
+
+// Downscaling factors, which widen the filters beyond their support.
+const int NUM_SCALES = 2;
+const double SCALES[NUM_SCALES] = { 3.0 / 4.0, 1.0 / 3.0 };
+
+struct AppContext {
+	int times;
+	CPUClass cpu;
+};
+
+const AppOption OPTIONS[] = {
+	{ "times", OptionType::OPTION_INTEGER,  offsetof(AppContext, times) },
+	{ "cpu",   OptionType::OPTION_CPUCLASS, offsetof(AppContext, cpu) }
+};
+
+void usage()
+{
+	std::cout << "resizecost [--times n] [--cpu cpu]\n";
+	std::cout << "    --times             number of cycles per measurement, of which the median is used\n";
+	std::cout << "    --cpu               select CPU type\n";
+}
+
+// Time per output sample in nanoseconds.
+double measure_kernel(const resize::Filter &filter, PixelType type, bool horizontal, int dst_dim, int times, CPUClass cpu)
+{
+	int src_width = SRC_WIDTH;
+	int src_height = SRC_HEIGHT;
+	int dst_width = horizontal ? dst_dim : SRC_WIDTH;
+	int dst_height = horizontal ? SRC_HEIGHT : dst_dim;
+
+	std::unique_ptr<IZimgFilter> resize{ resize::create_resize_impl2(filter, type, horizontal, pixel_size(type) * 8, src_width, src_height, dst_width, dst_height,
+	                                                                 0.0, horizontal ? src_width : src_height, cpu) };
+
+	Frame src{ src_width, src_height, pixel_size(type), 1 };
+	Frame dst{ dst_width, dst_height, pixel_size(type), 1 };
+	auto tmp = alloc_filter_tmp(*resize, src, dst);
+
+	Timer timer;
+	std::vector<double> elapsed(times);
+
+	for (int n = 0; n < times; ++n) {
+		timer.start();
+		apply_filter(*resize, src, dst, tmp.data(), 0);
+		timer.stop();
+
+		elapsed[n] = timer.elapsed();
+	}
+
+	// The median is less sensitive than the minimum to outliers in either direction.
+	std::nth_element(elapsed.begin(), elapsed.begin() + times / 2, elapsed.end());
+
+	return elapsed[times / 2] * 1e9 / ((double)dst_width * dst_height);
+}
+
+// Least squares fit of the time per sample to the filter width.
+resize::ResizeKernelCost fit_kernel_cost(PixelType type, bool horizontal, int times, CPUClass cpu)
+{
+	double sum_x = 0.0;
+	double sum_y = 0.0;
+	double sum_xx = 0.0;
+	double sum_xy = 0.0;
+
+	for (int k = 0; k < NUM_SCALES; ++k) {
+		for (int n = 1; n <= MAX_LANCZOS_TAPS; ++n) {
+			resize::LanczosFilter filter{ n };
+			int src_dim = horizontal ? SRC_WIDTH : SRC_HEIGHT;
+			int dst_dim = (int)(src_dim * SCALES[k]);
+
+			double x = resize::compute_filter(filter, src_dim, dst_dim, 0.0, src_dim).filter_width;
+			double y = measure_kernel(filter, type, horizontal, dst_dim, times, cpu);
+
+			sum_x += x;
+			sum_y += y;
+			sum_xx += x * x;
+			sum_xy += x * y;
+		}
+	}
+
+	double count = NUM_SCALES * MAX_LANCZOS_TAPS;
+	double per_tap = (count * sum_xy - sum_x * sum_y) / (count * sum_xx - sum_x * sum_x);
+	double fixed = (sum_y - per_tap * sum_x) / count;
+
+	return{ std::max(fixed, 0.0), std::max(per_tap, 0.0) };
+}
+
+void print_row(const resize::ResizeKernelCost *costs)
+{
+	std::cout << "\t{ ";
+
+	for (int n = 0; n < 4; ++n) {
+		std::cout << "{ " << costs[n].fixed << ", " << costs[n].per_tap << " }" << (n == 3 ? " },\n" : ", ");
+	}
+}
+
+} // namespace
+
+
+int resizecost_main(int argc, const char **argv)
+{
+	AppContext c{};
+
+	c.times = 10;
+	c.cpu = CPUClass::CPU_AUTO;
+
+	try {
+		parse_opts(argv + 1, argv + argc, std::begin(OPTIONS), std::end(OPTIONS), &c, nullptr);
+	} catch (const std::invalid_argument &e) {
+		std::cerr << e.what() << '\n';
+		usage();
+		return -1;
+	}
+	if (c.times < 1) {
+		std::cerr << "times must be positive\n";
+		return -1;
+	}
+
+	const PixelType types[] = { PixelType::BYTE, PixelType::WORD, PixelType::HALF, PixelType::FLOAT };
+	resize::ResizeCostTable table{};
+
+	for (int n = 0; n < 4; ++n) {
+		table.h[n] = fit_kernel_cost(types[n], true, c.times, c.cpu);
+		table.v[n] = fit_kernel_cost(types[n], false, c.times, c.cpu);
+	}
+
+	std::cout.precision(3);
+	std::cout << std::fixed;
+	std::cout << "{\n";
+	print_row(table.h);
+	print_row(table.v);
+	std::cout << "};\n";
+
+	return 0;
+}
@@ -37,12 +37,13 @@ int required_args(OptionType type)
 
 zimg::CPUClass select_cpu(const char *cpu)
 {
-	static const static_string_map<CPUClass, 4> map{
+	static const static_string_map<CPUClass, 5> map{
 		{ "none", CPUClass::CPU_NONE },
 		{ "auto", CPUClass::CPU_AUTO },
 #ifdef ZIMG_X86
 		{ "sse2", CPUClass::CPU_X86_SSE2 },
 		{ "avx2", CPUClass::CPU_X86_AVX2 },
+		{ "avx512", CPUClass::CPU_X86_AVX512 },
 #endif
 	};
 	auto it = map.find(cpu);
@@ -0,0 +1,230 @@
+#include <cmath>
+#include <cstddef>
+#include <memory>
+#include "API/zimg3.h"
+#include "Common/align.h"
+#include "Common/alloc.h"
+
+#include "gtest/gtest.h"
+
+namespace {;
+
+struct GraphDeleter {
+	void operator()(zimg_filter_graph *ptr) { zimg2_filter_graph_free(ptr); }
+};
+
+struct Image {
+	zimg_image_format format;
+	zimg::AlignedVector<float> planes[3];
+	ptrdiff_t stride[3];
+
+	Image(const zimg_image_format &format) : format(format), stride{}
+	{
+		for (unsigned p = 0; p < 3; ++p) {
+			unsigned width = p ? format.width >> format.subsample_w : format.width;
+			unsigned height = p ? format.height >> format.subsample_h : format.height;
+
+			stride[p] = zimg::align(width, zimg::AlignmentOf<float>::value);
+			planes[p].resize(stride[p] * height);
+		}
+	}
+
+	zimg_image_buffer_const as_buffer_const() const
+	{
+		zimg_image_buffer_const buf{ ZIMG_API_VERSION };
+
+		for (unsigned p = 0; p < 3; ++p) {
+			buf.data[p] = planes[p].data();
+			buf.stride[p] = stride[p] * sizeof(float);
+			buf.mask[p] = (unsigned)-1;
+		}
+		return buf;
+	}
+
+	zimg_image_buffer as_buffer()
+	{
+		zimg_image_buffer buf{ { ZIMG_API_VERSION } };
+
+		for (unsigned p = 0; p < 3; ++p) {
+			buf.m.data[p] = planes[p].data();
+			buf.m.stride[p] = stride[p] * sizeof(float);
+			buf.m.mask[p] = (unsigned)-1;
+		}
+		return buf;
+	}
+};
+
+void convert(const Image &src, Image &dst, const zimg_filter_graph_params &params)
+{
+	std::unique_ptr<zimg_filter_graph, GraphDeleter> graph{ zimg2_filter_graph_build(&src.format, &dst.format, &params) };
+	char err_msg[1024] = { 0 };
+
+	if (!graph)
+		zimg_get_last_error(err_msg, sizeof(err_msg));
+	ASSERT_TRUE(graph) << err_msg;
+
+	size_t tmp_size;
+	ASSERT_EQ(ZIMG_ERROR_SUCCESS, zimg2_filter_graph_get_tmp_size(graph.get(), &tmp_size));
+
+	zimg::AlignedVector<char> tmp(tmp_size);
+	zimg_image_buffer_const src_buf = src.as_buffer_const();
+	zimg_image_buffer dst_buf = dst.as_buffer();
+
+	ASSERT_EQ(ZIMG_ERROR_SUCCESS, zimg2_filter_graph_process(graph.get(), &src_buf, &dst_buf, tmp.data(), nullptr, nullptr, nullptr, nullptr));
+}
+
+// Upsample a 4:2:0 image, then check that descaling recovers it.
+void test_descale_roundtrip(zimg_chroma_location_e chroma_location, zimg_field_parity_e parity)
+{
+	zimg_image_format format;
+	zimg2_image_format_default(&format, ZIMG_API_VERSION);
+
+	format.width = 320;
+	format.height = 240;
+	format.pixel_type = ZIMG_PIXEL_FLOAT;
+	format.subsample_w = 1;
+	format.subsample_h = 1;
+	format.color_family = ZIMG_COLOR_YUV;
+	format.field_parity = parity;
+	format.chroma_location = chroma_location;
+
+	zimg_image_format format_up = format;
+	format_up.width = 512;
+	format_up.height = 384;
+
+	Image src{ format };
+	Image up{ format_up };
+	Image dst{ format };
+
+	for (unsigned p = 0; p < 3; ++p) {
+		for (size_t n = 0; n < src.planes[p].size(); ++n) {
+			src.planes[p][n] = (float)((n * 7919 + p * 31) % 101) / 100.0f;
+		}
+	}
+
+	zimg_filter_graph_params params;
+	zimg2_filter_graph_params_default(&params, ZIMG_API_VERSION);
+
+	convert(src, up, params);
+
+	params.descale = 1;
+	convert(up, dst, params);
+
+	for (unsigned p = 0; p < 3; ++p) {
+		SCOPED_TRACE(p);
+
+		unsigned width = p ? format.width >> format.subsample_w : format.width;
+		unsigned height = p ? format.height >> format.subsample_h : format.height;
+
+		for (unsigned i = 0; i < height; ++i) {
+			for (unsigned j = 0; j < width; ++j) {
+				ASSERT_NEAR(src.planes[p][i * src.stride[p] + j], dst.planes[p][i * dst.stride[p] + j], 1e-3) << "at (" << i << ", " << j << ")";
+			}
+		}
+	}
+}
+
+} // namespace
+
+
+TEST(APITest, test_descale_roundtrip)
+{
+	const struct {
+		const char *name;
+		zimg_chroma_location_e chroma_location;
+		zimg_field_parity_e parity;
+	} cases[] = {
+		{ "center", ZIMG_CHROMA_CENTER, ZIMG_FIELD_PROGRESSIVE },
+		{ "left", ZIMG_CHROMA_LEFT, ZIMG_FIELD_PROGRESSIVE },
+		{ "top-left", ZIMG_CHROMA_TOP_LEFT, ZIMG_FIELD_PROGRESSIVE },
+		{ "left-field-top", ZIMG_CHROMA_LEFT, ZIMG_FIELD_TOP },
+		{ "top-left-field-bottom", ZIMG_CHROMA_TOP_LEFT, ZIMG_FIELD_BOTTOM },
+	};
+
+	for (const auto &c : cases) {
+		SCOPED_TRACE(c.name);
+		test_descale_roundtrip(c.chroma_location, c.parity);
+	}
+}
+
+TEST(APITest, test_descale_to_rgb)
+{
+	zimg_image_format format;
+	zimg2_image_format_default(&format, ZIMG_API_VERSION);
+
+	format.width = 512;
+	format.height = 384;
+	format.pixel_type = ZIMG_PIXEL_FLOAT;
+	format.subsample_w = 1;
+	format.subsample_h = 1;
+	format.color_family = ZIMG_COLOR_YUV;
+	format.matrix_coefficients = ZIMG_MATRIX_709;
+
+	zimg_image_format format_444 = format;
+	format_444.width = 320;
+	format_444.height = 240;
+	format_444.subsample_w = 0;
+	format_444.subsample_h = 0;
+
+	zimg_image_format format_rgb = format_444;
+	format_rgb.color_family = ZIMG_COLOR_RGB;
+	format_rgb.matrix_coefficients = ZIMG_MATRIX_RGB;
+
+	Image src{ format };
+	Image yuv{ format_444 };
+	Image expected{ format_rgb };
+	Image dst{ format_rgb };
+
+	for (unsigned p = 0; p < 3; ++p) {
+		for (size_t n = 0; n < src.planes[p].size(); ++n) {
+			src.planes[p][n] = (float)((n * 7919 + p * 31) % 101) / 100.0f - (p ? 0.5f : 0.0f);
+		}
+	}
+
+	zimg_filter_graph_params params;
+	zimg2_filter_graph_params_default(&params, ZIMG_API_VERSION);
+
+	// The chroma planes grow to 4:4:4, so only luma is descaled.
+	params.descale = 1;
+	convert(src, dst, params);
+	convert(src, yuv, params);
+
+	params.descale = 0;
+	convert(yuv, expected, params);
+
+	for (unsigned p = 0; p < 3; ++p) {
+		SCOPED_TRACE(p);
+
+		for (unsigned i = 0; i < format_rgb.height; ++i) {
+			for (unsigned j = 0; j < format_rgb.width; ++j) {
+				ASSERT_NEAR(expected.planes[p][i * expected.stride[p] + j], dst.planes[p][i * dst.stride[p] + j], 1e-5) << "at (" << i << ", " << j << ")";
+			}
+		}
+	}
+}
+
+TEST(APITest, test_float_fullrange)
+{
+	zimg_image_format src_format;
+	zimg_image_format dst_format;
+
+	zimg2_image_format_default(&src_format, ZIMG_API_VERSION);
+
+	src_format.width = 64;
+	src_format.height = 48;
+	src_format.pixel_type = ZIMG_PIXEL_WORD;
+	src_format.color_family = ZIMG_COLOR_YUV;
+	src_format.matrix_coefficients = ZIMG_MATRIX_709;
+	src_format.depth = 16;
+	src_format.pixel_range = ZIMG_RANGE_FULL;
+
+	dst_format = src_format;
+	dst_format.pixel_type = ZIMG_PIXEL_FLOAT;
+	dst_format.color_family = ZIMG_COLOR_RGB;
+	dst_format.matrix_coefficients = ZIMG_MATRIX_RGB;
+	dst_format.depth = 32;
+
+	// Floating point formats ignore the range, which must not leave a depth conversion pending.
+	std::unique_ptr<zimg_filter_graph, GraphDeleter> graph{ zimg2_filter_graph_build(&src_format, &dst_format, nullptr) };
+	EXPECT_TRUE(graph);
+}
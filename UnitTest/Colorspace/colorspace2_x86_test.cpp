@@ -0,0 +1,48 @@
+#ifdef ZIMG_X86
+
+#include "Common/cpuinfo.h"
+#include "Common/pixel.h"
+#include "Colorspace/colorspace_param.h"
+#include "Colorspace/colorspace2.h"
+
+#include "gtest/gtest.h"
+#include "Common/filter_validator.h"
+
+namespace {;
+
+void test_case(const zimg::colorspace::ColorspaceDefinition &csp_in, const zimg::colorspace::ColorspaceDefinition &csp_out, zimg::CPUClass cpu, double snr_thresh)
+{
+	const unsigned w = 637;
+	const unsigned h = 479;
+
+	zimg::PixelFormat format = zimg::default_pixel_format(zimg::PixelType::FLOAT);
+	zimg::colorspace::ColorspaceConversion2 convert_c{ w, h, csp_in, csp_out, zimg::CPUClass::CPU_NONE };
+	zimg::colorspace::ColorspaceConversion2 convert_x86{ w, h, csp_in, csp_out, cpu };
+
+	validate_filter(&convert_x86, w, h, format);
+	validate_filter_reference(&convert_c, &convert_x86, w, h, format, snr_thresh);
+}
+
+} // namespace
+
+
+TEST(ColorspaceConversionX86Test, test_avx512)
+{
+	using namespace zimg::colorspace;
+
+	zimg::X86Capabilities caps = zimg::query_x86_capabilities();
+
+	if (!caps.avx512f || !caps.avx512bw || !caps.avx512vl) {
+		SUCCEED() << "avx512 not available, skipping";
+		return;
+	}
+
+	test_case({ MatrixCoefficients::MATRIX_RGB, TransferCharacteristics::TRANSFER_UNSPECIFIED, ColorPrimaries::PRIMARIES_UNSPECIFIED },
+	          { MatrixCoefficients::MATRIX_709, TransferCharacteristics::TRANSFER_UNSPECIFIED, ColorPrimaries::PRIMARIES_UNSPECIFIED },
+	          zimg::CPUClass::CPU_X86_AVX512, 120.0);
+	test_case({ MatrixCoefficients::MATRIX_709, TransferCharacteristics::TRANSFER_709, ColorPrimaries::PRIMARIES_709 },
+	          { MatrixCoefficients::MATRIX_2020_NCL, TransferCharacteristics::TRANSFER_709, ColorPrimaries::PRIMARIES_2020 },
+	          zimg::CPUClass::CPU_X86_AVX512, 120.0);
+}
+
+#endif // ZIMG_X86
@@ -1,5 +1,6 @@
 #include <algorithm>
 #include <array>
+#include <cmath>
 #include <cstdint>
 #include <cstring>
 #include <string>
@@ -89,7 +90,7 @@ void validate_same_row(const zimg::IZimgFilter *filter)
 	for (unsigned i = 0; i < attr.height; i += step) {
 		auto range = filter->get_required_row_range(i);
 		ASSERT_EQ(i, range.first);
-		ASSERT_EQ(i + fstep, range.second);
+		ASSERT_EQ(std::min(i + fstep, attr.height), range.second);
 	}
 }
 
@@ -140,6 +141,8 @@ void validate_filter_buffered(const zimg::IZimgFilter *filter, unsigned src_widt
 	zimg::AlignedVector<char> ctx(filter->get_context_size());
 	zimg::AlignedVector<char> tmp(filter->get_tmp_size(left, right));
 
+	filter->init_context(ctx.data());
+
 	auto col_range = filter->get_required_col_range(left, right);
 
 	for (unsigned i = init; i < attr.height; i += step) {
@@ -198,6 +201,52 @@ void validate_filter_T(const zimg::IZimgFilter *filter, unsigned src_width, unsi
 		validate_filter_buffered<T, U>(filter, src_width, src_height, src_format, dst_buf);
 }
 
+template <class T, class U>
+void validate_filter_reference_T(const zimg::IZimgFilter *ref_filter, const zimg::IZimgFilter *test_filter, unsigned src_width, unsigned src_height, const zimg::PixelFormat &src_format, double snr_thresh)
+{
+	zimg::ZimgFilterFlags flags = ref_filter->get_flags();
+	auto attr = ref_filter->get_image_attributes();
+
+	ASSERT_TRUE(attr == test_filter->get_image_attributes());
+
+	AuditBuffer<T> src_buf{ src_width, src_height, src_format, (unsigned)-1, 0, 0, !!flags.color };
+	AuditBuffer<U> ref_buf{ attr.width, attr.height, zimg::default_pixel_format(attr.type), (unsigned)-1, 0, 0, !!flags.color };
+	AuditBuffer<U> test_buf{ attr.width, attr.height, zimg::default_pixel_format(attr.type), (unsigned)-1, 0, 0, !!flags.color };
+
+	src_buf.random_fill(0, src_height, 0, src_width);
+	ref_buf.default_fill();
+	test_buf.default_fill();
+
+	validate_filter_plane(ref_filter, &src_buf, &ref_buf);
+	validate_filter_plane(test_filter, &src_buf, &test_buf);
+
+	for (unsigned p = 0; p < (flags.color ? 3U : 1U); ++p) {
+		const zimg::ZimgImageBufferConst &ref_image = ref_buf.as_image_buffer();
+		const zimg::ZimgImageBufferConst &test_image = test_buf.as_image_buffer();
+		double signal = 0.0;
+		double noise = 0.0;
+
+		for (unsigned i = 0; i < attr.height; ++i) {
+			const U *ref_ptr = (const U *)((const unsigned char *)ref_image.data[p] + (ptrdiff_t)i * ref_image.stride[p]);
+			const U *test_ptr = (const U *)((const unsigned char *)test_image.data[p] + (ptrdiff_t)i * test_image.stride[p]);
+
+			for (unsigned j = 0; j < attr.width; ++j) {
+				double x = ref_ptr[j];
+				double err = x - test_ptr[j];
+
+				signal += x * x;
+				noise += err * err;
+			}
+		}
+
+		if (noise == 0.0)
+			continue;
+
+		double snr = 10.0 * std::log10(signal / noise);
+		EXPECT_GE(snr, snr_thresh) << "snr below threshold: plane (" << p << ")";
+	}
+}
+
 } // namespace
 
 
@@ -234,3 +283,32 @@ void validate_filter(const zimg::IZimgFilter *filter, unsigned src_width, unsign
 			validate_filter_T<float, float>(filter, src_width, src_height, src_format, sha1_str);
 	}
 }
+
+void validate_filter_reference(const zimg::IZimgFilter *ref_filter, const zimg::IZimgFilter *test_filter, unsigned src_width, unsigned src_height, const zimg::PixelFormat &src_format, double snr_thresh)
+{
+	zimg::PixelType src_type = src_format.type;
+	auto attr = ref_filter->get_image_attributes();
+
+	if (src_type == zimg::PixelType::BYTE) {
+		if (attr.type == zimg::PixelType::BYTE)
+			validate_filter_reference_T<uint8_t, uint8_t>(ref_filter, test_filter, src_width, src_height, src_format, snr_thresh);
+		else if (attr.type == zimg::PixelType::WORD || attr.type == zimg::PixelType::HALF)
+			validate_filter_reference_T<uint8_t, uint16_t>(ref_filter, test_filter, src_width, src_height, src_format, snr_thresh);
+		else
+			validate_filter_reference_T<uint8_t, float>(ref_filter, test_filter, src_width, src_height, src_format, snr_thresh);
+	} else if (src_type == zimg::PixelType::WORD || src_type == zimg::PixelType::HALF) {
+		if (attr.type == zimg::PixelType::BYTE)
+			validate_filter_reference_T<uint16_t, uint8_t>(ref_filter, test_filter, src_width, src_height, src_format, snr_thresh);
+		else if (attr.type == zimg::PixelType::WORD || attr.type == zimg::PixelType::HALF)
+			validate_filter_reference_T<uint16_t, uint16_t>(ref_filter, test_filter, src_width, src_height, src_format, snr_thresh);
+		else
+			validate_filter_reference_T<uint16_t, float>(ref_filter, test_filter, src_width, src_height, src_format, snr_thresh);
+	} else {
+		if (attr.type == zimg::PixelType::BYTE)
+			validate_filter_reference_T<float, uint8_t>(ref_filter, test_filter, src_width, src_height, src_format, snr_thresh);
+		else if (attr.type == zimg::PixelType::WORD || attr.type == zimg::PixelType::HALF)
+			validate_filter_reference_T<float, uint16_t>(ref_filter, test_filter, src_width, src_height, src_format, snr_thresh);
+		else
+			validate_filter_reference_T<float, float>(ref_filter, test_filter, src_width, src_height, src_format, snr_thresh);
+	}
+}
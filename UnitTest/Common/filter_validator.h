@@ -17,4 +17,6 @@ void validate_filter(const zimg::IZimgFilter *filter, unsigned src_width, unsign
 
 void validate_filter(const zimg::IZimgFilter *filter, unsigned src_width, unsigned src_height, const zimg::PixelFormat &src_format, const char * const sha1_str[3] = nullptr);
 
+void validate_filter_reference(const zimg::IZimgFilter *ref_filter, const zimg::IZimgFilter *test_filter, unsigned src_width, unsigned src_height, const zimg::PixelFormat &src_format, double snr_thresh);
+
 #endif // ZIMG_UNIT_TEST_FILTER_VALIDATOR_H_
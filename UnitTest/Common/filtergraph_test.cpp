@@ -1,8 +1,13 @@
 #include <algorithm>
 #include <cstdint>
 #include <cstring>
+#include <map>
+#include <mutex>
+#include <string>
+#include <tuple>
 
 #include "Common/align.h"
+#include "Common/copy_filter.h"
 #include "Common/except.h"
 #include "Common/filtergraph.h"
 #include "Common/linebuffer.h"
@@ -35,6 +40,42 @@ public:
 	}
 };
 
+class CallbackCounter {
+	std::map<std::tuple<unsigned, unsigned, unsigned>, unsigned> m_calls;
+	std::mutex m_mutex;
+public:
+	static int callback(void *user, unsigned i, unsigned left, unsigned right)
+	{
+		CallbackCounter *self = static_cast<CallbackCounter *>(user);
+		std::lock_guard<std::mutex> lock{ self->m_mutex };
+
+		++self->m_calls[std::make_tuple(i, left, right)];
+		return 0;
+	}
+
+	zimg::FilterGraph::callback get_callback() { return{ callback, this }; }
+
+	unsigned total_calls() const
+	{
+		unsigned total = 0;
+
+		for (const auto &x : m_calls) {
+			total += x.second;
+		}
+		return total;
+	}
+
+	unsigned duplicate_calls() const
+	{
+		unsigned total = 0;
+
+		for (const auto &x : m_calls) {
+			total += x.second - 1;
+		}
+		return total;
+	}
+};
+
 }
 
 
@@ -93,6 +134,59 @@ TEST(FilterGraphTest, test_noop_subsampling)
 	}
 }
 
+TEST(FilterGraphTest, test_copy_elimination)
+{
+	const unsigned w = 640;
+	const unsigned h = 480;
+	const zimg::PixelType type = zimg::PixelType::WORD;
+
+	const uint8_t test_byte1 = 0xCD;
+	const uint8_t test_byte2 = 0xDD;
+
+	std::unique_ptr<SplatFilter<uint16_t>> filter_uptr{ new SplatFilter<uint16_t>{ w, h, type } };
+	SplatFilter<uint16_t> *filter = filter_uptr.get();
+
+	filter->set_input_val(test_byte1);
+	filter->set_output_val(test_byte2);
+
+	zimg::FilterGraph graph{ w, h, type, 1, 1, true };
+	graph.attach_filter(new zimg::CopyFilter{ w, h, type });
+	graph.attach_filter(filter);
+	filter_uptr.release();
+	graph.attach_filter(new zimg::CopyFilter{ w, h, type });
+	graph.attach_filter_uv(new zimg::CopyFilter{ w / 2, h / 2, type });
+	graph.attach_filter_uv(new zimg::CopyFilter{ w / 2, h / 2, type });
+	graph.set_stats_enabled(true);
+	graph.complete();
+
+	AuditImage<uint16_t> src_image{ w, h, type, 1, 1, true };
+	AuditImage<uint16_t> dst_image{ w, h, type, 1, 1, true };
+	zimg::AlignedVector<char> tmp(graph.get_tmp_size());
+
+	src_image.set_fill_val(test_byte1);
+	src_image.default_fill();
+	graph.process(src_image.as_image_buffer(), dst_image.as_image_buffer(), tmp.data(), nullptr, nullptr);
+	dst_image.set_fill_val(test_byte2, 0);
+	dst_image.set_fill_val(test_byte1, 1);
+	dst_image.set_fill_val(test_byte1, 2);
+
+	// Only the filter itself and the final chroma copy to the output remain.
+	auto stats = graph.get_stats();
+	auto num_copies = std::count_if(stats.begin(), stats.end(), [](const zimg::FilterGraph::node_stats &x)
+	{
+		return std::string{ x.name }.find("CopyFilter") != std::string::npos;
+	});
+
+	EXPECT_EQ(2U, stats.size());
+	EXPECT_EQ(1, num_copies);
+	EXPECT_EQ(h, filter->get_total_calls());
+
+	SCOPED_TRACE("validating src");
+	src_image.validate();
+	SCOPED_TRACE("validating dst");
+	dst_image.validate();
+}
+
 TEST(FilterGraphTest, test_basic)
 {
 	const unsigned w = 640;
@@ -276,6 +370,7 @@ TEST(FilterGraphTest, test_support)
 		filter1_uptr.release();
 		graph.attach_filter(filter2);
 		filter2_uptr.release();
+		graph.set_tile_width(512);
 		graph.complete();
 
 		AuditImage<uint16_t> src_image{ w, h, type, 0, 0, false };
@@ -311,6 +406,881 @@ TEST(FilterGraphTest, test_support)
 	}
 }
 
+TEST(FilterGraphTest, test_parallel)
+{
+	const unsigned w = 1920;
+	const unsigned h = 1080;
+	const zimg::PixelType type = zimg::PixelType::WORD;
+
+	const uint8_t test_byte1 = 0xCD;
+	const uint8_t test_byte2 = 0xDD;
+	const uint8_t test_byte3 = 0xDC;
+
+	for (unsigned threads = 1; threads <= 4; ++threads) {
+		SCOPED_TRACE(threads);
+
+		std::unique_ptr<SplatFilter<uint16_t>> filter1_uptr{ new SplatFilter<uint16_t>{ w, h, type } };
+		std::unique_ptr<SplatFilter<uint16_t>> filter2_uptr{ new SplatFilter<uint16_t>{ w >> 1, h >> 1, type } };
+		SplatFilter<uint16_t> *filter1 = filter1_uptr.get();
+		SplatFilter<uint16_t> *filter2 = filter2_uptr.get();
+
+		filter1->set_input_val(test_byte1);
+		filter1->set_output_val(test_byte2);
+		filter1->set_horizontal_support(3);
+		filter1->set_vertical_support(2);
+
+		filter2->set_input_val(test_byte1);
+		filter2->set_output_val(test_byte3);
+		filter2->set_horizontal_support(5);
+
+		zimg::FilterGraph graph{ w, h, type, 1, 1, true };
+		graph.attach_filter(filter1);
+		filter1_uptr.release();
+		graph.attach_filter_uv(filter2);
+		filter2_uptr.release();
+		graph.complete();
+
+		AuditImage<uint16_t> src_image{ w, h, type, 1, 1, true };
+		AuditImage<uint16_t> dst_image{ w, h, type, 1, 1, true };
+		zimg::AlignedVector<char> tmp(graph.get_tmp_size_mt(threads));
+
+		ASSERT_EQ(graph.get_tmp_size() * threads, graph.get_tmp_size_mt(threads));
+
+		src_image.set_fill_val(test_byte1);
+		src_image.default_fill();
+
+		graph.process_mt(src_image.as_image_buffer(), dst_image.as_image_buffer(), tmp.data(), nullptr, nullptr, threads);
+		dst_image.set_fill_val(test_byte2, 0);
+		dst_image.set_fill_val(test_byte3, 1);
+		dst_image.set_fill_val(test_byte3, 2);
+
+		SCOPED_TRACE("validating src");
+		src_image.validate();
+		SCOPED_TRACE("validating dst");
+		dst_image.validate();
+	}
+}
+
+TEST(FilterGraphTest, test_parallel_bands)
+{
+	const unsigned w = 640;
+	const unsigned h = 480;
+	const zimg::PixelType type = zimg::PixelType::FLOAT;
+
+	const uint8_t test_byte1 = 0xCD;
+	const uint8_t test_byte2 = 0xDD;
+	const uint8_t test_byte3 = 0xDC;
+
+	for (unsigned x = 0; x < 2; ++x) {
+		SCOPED_TRACE(!!x);
+
+		zimg::ZimgFilterFlags flags1{};
+		flags1.entire_row = true;
+		flags1.color = true;
+
+		zimg::ZimgFilterFlags flags2{};
+		flags2.has_state = !!x;
+		flags2.entire_row = true;
+
+		std::unique_ptr<SplatFilter<float>> filter1_uptr{ new SplatFilter<float>{ w, h, type, flags1 } };
+		std::unique_ptr<SplatFilter<float>> filter2_uptr{ new SplatFilter<float>{ w, h, type, flags2 } };
+		SplatFilter<float> *filter1 = filter1_uptr.get();
+		SplatFilter<float> *filter2 = filter2_uptr.get();
+
+		filter1->set_input_val(test_byte1);
+		filter1->set_output_val(test_byte2);
+		filter1->set_vertical_support(3);
+
+		filter2->set_input_val(test_byte2);
+		filter2->set_output_val(test_byte3);
+		filter2->set_simultaneous_lines(2);
+		filter2->set_vertical_support(5);
+
+		zimg::FilterGraph graph{ w, h, type, 0, 0, true };
+		graph.attach_filter(filter1);
+		filter1_uptr.release();
+		graph.attach_filter_uv(filter2);
+		filter2_uptr.release();
+		graph.complete();
+
+		AuditImage<float> src_image{ w, h, type, 0, 0, true };
+		AuditImage<float> dst_image{ w, h, type, 0, 0, true };
+		zimg::AlignedVector<char> tmp(graph.get_tmp_size_mt(4));
+
+		src_image.set_fill_val(test_byte1);
+		src_image.default_fill();
+
+		graph.process_mt(src_image.as_image_buffer(), dst_image.as_image_buffer(), tmp.data(), nullptr, nullptr, 4);
+		dst_image.set_fill_val(test_byte2, 0);
+		dst_image.set_fill_val(test_byte3, 1);
+		dst_image.set_fill_val(test_byte3, 2);
+
+		if (x) {
+			EXPECT_EQ(h, filter1->get_total_calls());
+			EXPECT_EQ(h, filter2->get_total_calls());
+		} else {
+			EXPECT_LT(h, filter1->get_total_calls());
+		}
+
+		SCOPED_TRACE("validating src");
+		src_image.validate();
+		SCOPED_TRACE("validating dst");
+		dst_image.validate();
+	}
+}
+
+TEST(FilterGraphTest, test_parallel_bands_callback)
+{
+	const unsigned w = 640;
+	const unsigned h = 480;
+	const zimg::PixelType type = zimg::PixelType::FLOAT;
+
+	const uint8_t test_byte1 = 0xCD;
+	const uint8_t test_byte2 = 0xDD;
+
+	zimg::ZimgFilterFlags flags{};
+	flags.entire_row = true;
+
+	std::unique_ptr<SplatFilter<float>> filter_uptr{ new SplatFilter<float>{ w, h, type, flags } };
+	SplatFilter<float> *filter = filter_uptr.get();
+
+	filter->set_input_val(test_byte1);
+	filter->set_output_val(test_byte2);
+	filter->set_vertical_support(3);
+
+	zimg::FilterGraph graph{ w, h, type, 0, 0, false };
+	graph.attach_filter(filter);
+	filter_uptr.release();
+	graph.complete();
+
+	AuditImage<float> src_image{ w, h, type, 0, 0, false };
+	AuditImage<float> dst_image{ w, h, type, 0, 0, false };
+	zimg::AlignedVector<char> tmp(graph.get_tmp_size_mt(4));
+
+	src_image.set_fill_val(test_byte1);
+	src_image.default_fill();
+
+	CallbackCounter serial;
+	CallbackCounter parallel;
+
+	graph.process(src_image.as_image_buffer(), dst_image.as_image_buffer(), tmp.data(), serial.get_callback(), nullptr);
+	graph.process_mt(src_image.as_image_buffer(), dst_image.as_image_buffer(), tmp.data(), parallel.get_callback(), nullptr, 4);
+	dst_image.set_fill_val(test_byte2);
+
+	// Bands would unpack the rows they share more than once.
+	EXPECT_EQ(h, serial.total_calls());
+	EXPECT_EQ(serial.total_calls(), parallel.total_calls());
+	EXPECT_EQ(0U, parallel.duplicate_calls());
+
+	SCOPED_TRACE("validating src");
+	src_image.validate();
+	SCOPED_TRACE("validating dst");
+	dst_image.validate();
+}
+
+TEST(FilterGraphTest, test_parallel_planes)
+{
+	const unsigned w = 640;
+	const unsigned h = 480;
+	const zimg::PixelType type = zimg::PixelType::WORD;
+
+	const uint8_t test_byte1 = 0xCD;
+	const uint8_t test_byte2 = 0xDD;
+	const uint8_t test_byte3 = 0xDC;
+
+	zimg::ZimgFilterFlags flags{};
+	flags.has_state = true;
+
+	std::unique_ptr<SplatFilter<uint16_t>> filter1_uptr{ new SplatFilter<uint16_t>{ w, h, type, flags } };
+	std::unique_ptr<SplatFilter<uint16_t>> filter2_uptr{ new SplatFilter<uint16_t>{ w / 2, h / 2, type, flags } };
+	SplatFilter<uint16_t> *filter1 = filter1_uptr.get();
+	SplatFilter<uint16_t> *filter2 = filter2_uptr.get();
+
+	filter1->set_input_val(test_byte1);
+	filter1->set_output_val(test_byte2);
+	filter1->set_vertical_support(2);
+
+	filter2->set_input_val(test_byte1);
+	filter2->set_output_val(test_byte3);
+	filter2->set_vertical_support(1);
+
+	zimg::FilterGraph graph{ w, h, type, 1, 1, true };
+	graph.attach_filter(filter1);
+	filter1_uptr.release();
+	graph.attach_filter_uv(filter2);
+	filter2_uptr.release();
+	graph.set_tile_width(w);
+	graph.complete();
+
+	AuditImage<uint16_t> src_image{ w, h, type, 1, 1, true };
+	AuditImage<uint16_t> dst_image{ w, h, type, 1, 1, true };
+	zimg::AlignedVector<char> tmp(graph.get_tmp_size_mt(2));
+
+	src_image.set_fill_val(test_byte1);
+	src_image.default_fill();
+
+	// The luma and chroma paths are processed as separate work items.
+	graph.process_mt(src_image.as_image_buffer(), dst_image.as_image_buffer(), tmp.data(), nullptr, nullptr, 2);
+	dst_image.set_fill_val(test_byte2, 0);
+	dst_image.set_fill_val(test_byte3, 1);
+	dst_image.set_fill_val(test_byte3, 2);
+
+	EXPECT_EQ(h, filter1->get_total_calls());
+	EXPECT_EQ(h, filter2->get_total_calls());
+
+	SCOPED_TRACE("validating src");
+	src_image.validate();
+	SCOPED_TRACE("validating dst");
+	dst_image.validate();
+}
+
+TEST(FilterGraphTest, test_parallel_planes_callback)
+{
+	const unsigned w = 640;
+	const unsigned h = 480;
+	const zimg::PixelType type = zimg::PixelType::WORD;
+
+	const uint8_t test_byte1 = 0xCD;
+	const uint8_t test_byte2 = 0xDD;
+	const uint8_t test_byte3 = 0xDC;
+
+	zimg::ZimgFilterFlags flags{};
+	flags.has_state = true;
+
+	std::unique_ptr<SplatFilter<uint16_t>> filter1_uptr{ new SplatFilter<uint16_t>{ w, h, type, flags } };
+	std::unique_ptr<SplatFilter<uint16_t>> filter2_uptr{ new SplatFilter<uint16_t>{ w / 2, h / 2, type, flags } };
+	SplatFilter<uint16_t> *filter1 = filter1_uptr.get();
+	SplatFilter<uint16_t> *filter2 = filter2_uptr.get();
+
+	filter1->set_input_val(test_byte1);
+	filter1->set_output_val(test_byte2);
+
+	filter2->set_input_val(test_byte1);
+	filter2->set_output_val(test_byte3);
+
+	zimg::FilterGraph graph{ w, h, type, 1, 1, true };
+	graph.attach_filter(filter1);
+	filter1_uptr.release();
+	graph.attach_filter_uv(filter2);
+	filter2_uptr.release();
+	graph.set_tile_width(w);
+	graph.complete();
+
+	AuditImage<uint16_t> src_image{ w, h, type, 1, 1, true };
+	AuditImage<uint16_t> dst_image{ w, h, type, 1, 1, true };
+	zimg::AlignedVector<char> tmp(graph.get_tmp_size_mt(2));
+
+	src_image.set_fill_val(test_byte1);
+	src_image.default_fill();
+
+	CallbackCounter serial;
+	CallbackCounter parallel;
+
+	graph.process(src_image.as_image_buffer(), dst_image.as_image_buffer(), tmp.data(), serial.get_callback(), nullptr);
+	graph.process_mt(src_image.as_image_buffer(), dst_image.as_image_buffer(), tmp.data(), parallel.get_callback(), nullptr, 2);
+	dst_image.set_fill_val(test_byte2, 0);
+	dst_image.set_fill_val(test_byte3, 1);
+	dst_image.set_fill_val(test_byte3, 2);
+
+	// Splitting the planes would unpack each row once per plane.
+	EXPECT_EQ(h / 2, serial.total_calls());
+	EXPECT_EQ(serial.total_calls(), parallel.total_calls());
+	EXPECT_EQ(0U, parallel.duplicate_calls());
+
+	SCOPED_TRACE("validating src");
+	src_image.validate();
+	SCOPED_TRACE("validating dst");
+	dst_image.validate();
+}
+
+TEST(FilterGraphTest, test_region)
+{
+	const unsigned w = 640;
+	const unsigned h = 480;
+	const zimg::PixelType type = zimg::PixelType::BYTE;
+
+	const unsigned left = 100;
+	const unsigned top = 50;
+	const unsigned right = 300;
+	const unsigned bottom = 150;
+
+	const uint8_t test_byte1 = 0xCD;
+	const uint8_t test_byte2 = 0xDD;
+	const uint8_t test_byte3 = 0xDC;
+
+	for (unsigned x = 0; x < 2; ++x) {
+		SCOPED_TRACE(!!x);
+
+		zimg::ZimgFilterFlags flags{};
+		flags.has_state = !!x;
+
+		std::unique_ptr<SplatFilter<uint8_t>> filter_uptr{ new SplatFilter<uint8_t>{ w, h, type, flags } };
+		SplatFilter<uint8_t> *filter = filter_uptr.get();
+
+		filter->set_input_val(test_byte1);
+		filter->set_output_val(test_byte2);
+		filter->set_vertical_support(2);
+		filter->set_horizontal_support(2);
+
+		zimg::FilterGraph graph{ w, h, type, 0, 0, false };
+		graph.attach_filter(filter);
+		filter_uptr.release();
+		graph.set_tile_width(256);
+		graph.complete();
+
+		AuditImage<uint8_t> src_image{ w, h, type, 0, 0, false };
+		AuditImage<uint8_t> dst_image{ w, h, type, 0, 0, false };
+		zimg::AlignedVector<char> tmp(graph.get_tmp_size());
+
+		src_image.set_fill_val(test_byte1);
+		src_image.default_fill();
+		dst_image.set_fill_val(test_byte3);
+		dst_image.default_fill();
+
+		graph.process_region(src_image.as_image_buffer(), dst_image.as_image_buffer(), tmp.data(), left, top, right, bottom, nullptr, nullptr);
+
+		// The region spans two tiles. Stateful filters start from the first row.
+		unsigned first_row = x ? 0 : top;
+		EXPECT_EQ(2 * (bottom - first_row), filter->get_total_calls());
+
+		for (unsigned i = 0; i < h; ++i) {
+			dst_image.set_fill_val(test_byte2);
+			ASSERT_EQ(i >= first_row && i < bottom, !dst_image.detect_write(i, left, right)) << "line: " << i;
+			dst_image.set_fill_val(test_byte3);
+			ASSERT_FALSE(dst_image.detect_write(i, right, w)) << "unexpected write at line: " << i;
+		}
+
+		EXPECT_THROW(graph.process_region(src_image.as_image_buffer(), dst_image.as_image_buffer(), tmp.data(), left, top, w + 1, bottom, nullptr, nullptr),
+		             zimg::error::IllegalArgument);
+	}
+}
+
+TEST(FilterGraphTest, test_tile_width)
+{
+	const unsigned w = 1024;
+	const unsigned h = 576;
+	const zimg::PixelType type = zimg::PixelType::BYTE;
+
+	const uint8_t test_byte1 = 0xCD;
+	const uint8_t test_byte2 = 0xDC;
+
+	for (unsigned tile_width : { 0U, 100U, 256U, 2048U }) {
+		SCOPED_TRACE(tile_width);
+
+		std::unique_ptr<SplatFilter<uint8_t>> filter_uptr{ new SplatFilter<uint8_t>{ w, h, type } };
+		SplatFilter<uint8_t> *filter = filter_uptr.get();
+
+		filter->set_input_val(test_byte1);
+		filter->set_output_val(test_byte2);
+		filter->set_horizontal_support(3);
+		filter->set_vertical_support(3);
+
+		zimg::FilterGraph graph{ w, h, type, 0, 0, false };
+		graph.attach_filter(filter);
+		filter_uptr.release();
+		graph.set_tile_width(tile_width);
+		graph.complete();
+
+		AuditImage<uint8_t> src_image{ w, h, type, 0, 0, false };
+		AuditImage<uint8_t> dst_image{ w, h, type, 0, 0, false };
+		zimg::AlignedVector<char> tmp(graph.get_tmp_size());
+
+		src_image.set_fill_val(test_byte1);
+		src_image.default_fill();
+
+		graph.process(src_image.as_image_buffer(), dst_image.as_image_buffer(), tmp.data(), nullptr, nullptr);
+		dst_image.set_fill_val(test_byte2);
+
+		if (tile_width == 100) {
+			EXPECT_EQ(8 * h, filter->get_total_calls());
+		} else if (tile_width == 256) {
+			EXPECT_EQ(4 * h, filter->get_total_calls());
+		} else if (tile_width == 2048) {
+			EXPECT_EQ(h, filter->get_total_calls());
+		}
+
+		SCOPED_TRACE("validating src");
+		src_image.validate();
+		SCOPED_TRACE("validating dst");
+		dst_image.validate();
+	}
+}
+
+TEST(FilterGraphTest, test_fusion)
+{
+	const unsigned w = 640;
+	const unsigned h = 480;
+	const zimg::PixelType type = zimg::PixelType::WORD;
+
+	const uint8_t test_byte1 = 0xCD;
+	const uint8_t test_byte2 = 0xDD;
+	const uint8_t test_byte3 = 0xDC;
+	const uint8_t test_byte4 = 0xAA;
+
+	for (unsigned x = 0; x < 2; ++x) {
+		SCOPED_TRACE(!!x);
+
+		zimg::ZimgFilterFlags flags{};
+		flags.same_row = true;
+		flags.color = !!x;
+
+		std::unique_ptr<SplatFilter<uint16_t>> filter1_uptr{ new SplatFilter<uint16_t>{ w, h, type, flags } };
+		std::unique_ptr<SplatFilter<uint16_t>> filter2_uptr{ new SplatFilter<uint16_t>{ w, h, type, flags } };
+		std::unique_ptr<SplatFilter<uint16_t>> filter3_uptr{ new SplatFilter<uint16_t>{ w, h, type, flags } };
+		SplatFilter<uint16_t> *filter1 = filter1_uptr.get();
+		SplatFilter<uint16_t> *filter2 = filter2_uptr.get();
+		SplatFilter<uint16_t> *filter3 = filter3_uptr.get();
+
+		filter1->set_input_val(test_byte1);
+		filter1->set_output_val(test_byte2);
+
+		filter2->set_input_val(test_byte2);
+		filter2->set_output_val(test_byte3);
+		filter2->set_horizontal_support(2);
+
+		filter3->set_input_val(test_byte3);
+		filter3->set_output_val(test_byte4);
+
+		zimg::FilterGraph graph{ w, h, type, 0, 0, !!x };
+
+		graph.attach_filter(filter1);
+		filter1_uptr.release();
+		graph.attach_filter(filter2);
+		filter2_uptr.release();
+		graph.attach_filter(filter3);
+		filter3_uptr.release();
+		graph.set_tile_width(w);
+		graph.complete();
+
+		AuditImage<uint16_t> src_image{ w, h, type, 0, 0, !!x };
+		AuditImage<uint16_t> dst_image{ w, h, type, 0, 0, !!x };
+		zimg::AlignedVector<char> tmp(graph.get_tmp_size());
+
+		src_image.set_fill_val(test_byte1);
+		src_image.default_fill();
+		graph.process(src_image.as_image_buffer(), dst_image.as_image_buffer(), tmp.data(), nullptr, nullptr);
+		dst_image.set_fill_val(test_byte4);
+
+		ASSERT_EQ(h, filter1->get_total_calls());
+		ASSERT_EQ(h, filter2->get_total_calls());
+		ASSERT_EQ(h, filter3->get_total_calls());
+
+		SCOPED_TRACE("validating src");
+		src_image.validate();
+		SCOPED_TRACE("validating dst");
+		dst_image.validate();
+	}
+}
+
+TEST(FilterGraphTest, test_cache_sharing)
+{
+	const unsigned w = 640;
+	const unsigned h = 480;
+	const zimg::PixelType type = zimg::PixelType::BYTE;
+
+	const uint8_t test_byte1 = 0xCD;
+	const uint8_t test_byte2 = 0xDD;
+	const uint8_t test_byte3 = 0xDC;
+	const uint8_t test_byte4 = 0xAA;
+	const uint8_t test_byte5 = 0x55;
+
+	zimg::ZimgFilterFlags flags_plane{};
+	flags_plane.has_state = true;
+	flags_plane.entire_row = true;
+	flags_plane.entire_plane = true;
+
+	std::unique_ptr<SplatFilter<uint8_t>> filter1_uptr{ new SplatFilter<uint8_t>{ w, h, type } };
+	std::unique_ptr<SplatFilter<uint8_t>> filter2_uptr{ new SplatFilter<uint8_t>{ w, h, type, flags_plane } };
+	std::unique_ptr<SplatFilter<uint8_t>> filter3_uptr{ new SplatFilter<uint8_t>{ w, h, type } };
+	std::unique_ptr<SplatFilter<uint8_t>> filter4_uptr{ new SplatFilter<uint8_t>{ w, h, type } };
+	SplatFilter<uint8_t> *filter1 = filter1_uptr.get();
+	SplatFilter<uint8_t> *filter2 = filter2_uptr.get();
+	SplatFilter<uint8_t> *filter3 = filter3_uptr.get();
+	SplatFilter<uint8_t> *filter4 = filter4_uptr.get();
+
+	filter1->set_input_val(test_byte1);
+	filter1->set_output_val(test_byte2);
+
+	filter2->set_input_val(test_byte2);
+	filter2->set_output_val(test_byte3);
+
+	filter3->set_input_val(test_byte3);
+	filter3->set_output_val(test_byte4);
+	filter3->set_vertical_support(4);
+
+	filter4->set_input_val(test_byte4);
+	filter4->set_output_val(test_byte5);
+	filter4->set_vertical_support(4);
+
+	zimg::FilterGraph graph{ w, h, type, 0, 0, false };
+
+	graph.attach_filter(filter1);
+	filter1_uptr.release();
+	graph.attach_filter(filter2);
+	filter2_uptr.release();
+	graph.attach_filter(filter3);
+	filter3_uptr.release();
+	graph.attach_filter(filter4);
+	filter4_uptr.release();
+	graph.complete();
+
+	// The cache of the first filter is dead once the second filter has read
+	// the entire plane, so it can be reused by the third filter.
+	EXPECT_LT(graph.get_cache_size(), graph.get_cache_size_unshared());
+	EXPECT_LT(graph.get_cache_size(), graph.get_tmp_size());
+
+	AuditImage<uint8_t> src_image{ w, h, type, 0, 0, false };
+	AuditImage<uint8_t> dst_image{ w, h, type, 0, 0, false };
+	zimg::AlignedVector<char> tmp(graph.get_tmp_size());
+
+	src_image.set_fill_val(test_byte1);
+	src_image.default_fill();
+	graph.process(src_image.as_image_buffer(), dst_image.as_image_buffer(), tmp.data(), nullptr, nullptr);
+	dst_image.set_fill_val(test_byte5);
+
+	SCOPED_TRACE("validating src");
+	src_image.validate();
+	SCOPED_TRACE("validating dst");
+	dst_image.validate();
+}
+
+TEST(FilterGraphTest, test_cache_sharing_bands)
+{
+	const unsigned w = 640;
+	const unsigned h = 480;
+	const zimg::PixelType type = zimg::PixelType::BYTE;
+
+	const uint8_t test_bytes[] = { 0xCD, 0xDD, 0xDC, 0xAA, 0x55, 0x5A };
+
+	zimg::FilterGraph graph{ w, h, type, 0, 0, false };
+	SplatFilter<uint8_t> *filters[5];
+
+	for (unsigned n = 0; n < 5; ++n) {
+		std::unique_ptr<SplatFilter<uint8_t>> filter_uptr{ new SplatFilter<uint8_t>{ w, h, type } };
+		filters[n] = filter_uptr.get();
+
+		filters[n]->set_input_val(test_bytes[n]);
+		filters[n]->set_output_val(test_bytes[n + 1]);
+
+		graph.attach_filter(filters[n]);
+		filter_uptr.release();
+	}
+	filters[1]->set_vertical_support(3);
+	graph.complete();
+
+	// The second and fourth caches each hold a line that is consumed by the
+	// next filter before the other is written, even in banded execution.
+	EXPECT_LT(graph.get_cache_size(), graph.get_cache_size_unshared());
+
+	AuditImage<uint8_t> src_image{ w, h, type, 0, 0, false };
+	zimg::AlignedVector<char> tmp(graph.get_tmp_size_mt(4));
+
+	src_image.set_fill_val(test_bytes[0]);
+	src_image.default_fill();
+
+	{
+		SCOPED_TRACE("bands");
+		AuditImage<uint8_t> dst_image{ w, h, type, 0, 0, false };
+
+		graph.process_mt(src_image.as_image_buffer(), dst_image.as_image_buffer(), tmp.data(), nullptr, nullptr, 4);
+		dst_image.set_fill_val(test_bytes[5]);
+		EXPECT_LT(h, filters[0]->get_total_calls());
+
+		dst_image.validate();
+	}
+	{
+		SCOPED_TRACE("region");
+		AuditImage<uint8_t> dst_image{ w, h, type, 0, 0, false };
+
+		dst_image.set_fill_val(test_bytes[5]);
+		dst_image.default_fill();
+		graph.process_region(src_image.as_image_buffer(), dst_image.as_image_buffer(), tmp.data(), 0, 101, w, 301, nullptr, nullptr);
+		dst_image.validate();
+	}
+
+	SCOPED_TRACE("validating src");
+	src_image.validate();
+}
+
+TEST(FilterGraphTest, test_stats)
+{
+	const unsigned w = 640;
+	const unsigned h = 480;
+	const zimg::PixelType type = zimg::PixelType::WORD;
+
+	const uint8_t test_byte1 = 0xCD;
+	const uint8_t test_byte2 = 0xDD;
+	const uint8_t test_byte3 = 0xDC;
+
+	for (unsigned x = 0; x < 2; ++x) {
+		SCOPED_TRACE(!!x);
+
+		std::unique_ptr<SplatFilter<uint16_t>> filter1_uptr{ new SplatFilter<uint16_t>{ w, h, type } };
+		std::unique_ptr<SplatFilter<uint16_t>> filter2_uptr{ new SplatFilter<uint16_t>{ w, h, type } };
+		SplatFilter<uint16_t> *filter1 = filter1_uptr.get();
+		SplatFilter<uint16_t> *filter2 = filter2_uptr.get();
+
+		filter1->set_input_val(test_byte1);
+		filter1->set_output_val(test_byte2);
+		filter1->set_vertical_support(2);
+
+		filter2->set_input_val(test_byte2);
+		filter2->set_output_val(test_byte3);
+
+		zimg::FilterGraph graph{ w, h, type, 0, 0, false };
+
+		graph.attach_filter(filter1);
+		filter1_uptr.release();
+		graph.attach_filter(filter2);
+		filter2_uptr.release();
+		graph.set_tile_width(w);
+		graph.set_stats_enabled(!!x);
+		graph.complete();
+
+		AuditImage<uint16_t> src_image{ w, h, type, 0, 0, false };
+		AuditImage<uint16_t> dst_image{ w, h, type, 0, 0, false };
+		zimg::AlignedVector<char> tmp(graph.get_tmp_size());
+
+		src_image.set_fill_val(test_byte1);
+		src_image.default_fill();
+		graph.process(src_image.as_image_buffer(), dst_image.as_image_buffer(), tmp.data(), nullptr, nullptr);
+		graph.process(src_image.as_image_buffer(), dst_image.as_image_buffer(), tmp.data(), nullptr, nullptr);
+		dst_image.set_fill_val(test_byte3);
+
+		auto stats = graph.get_stats();
+
+		if (!x) {
+			EXPECT_TRUE(stats.empty());
+		} else {
+			ASSERT_EQ(2U, stats.size());
+
+			for (const auto &node_stats : stats) {
+				EXPECT_NE(std::string::npos, std::string{ node_stats.name }.find("SplatFilter"));
+				EXPECT_EQ(2ULL * h, node_stats.calls);
+				EXPECT_EQ(2ULL * h, node_stats.lines);
+				EXPECT_EQ(2ULL * w * h * sizeof(uint16_t), node_stats.bytes_written);
+				EXPECT_GE(node_stats.seconds, 0.0);
+			}
+
+			// The first filter reads the rows above and below each output row.
+			EXPECT_EQ(2ULL * (5 * h - 6) * w * sizeof(uint16_t), stats[0].bytes_read);
+			EXPECT_EQ(2ULL * w * h * sizeof(uint16_t), stats[1].bytes_read);
+		}
+
+		SCOPED_TRACE("validating src");
+		src_image.validate();
+		SCOPED_TRACE("validating dst");
+		dst_image.validate();
+	}
+}
+
+TEST(FilterGraphTest, test_stats_no_fusion)
+{
+	const unsigned w = 640;
+	const unsigned h = 480;
+	const zimg::PixelType type = zimg::PixelType::WORD;
+
+	const uint8_t test_byte1 = 0xCD;
+	const uint8_t test_byte2 = 0xDD;
+	const uint8_t test_byte3 = 0xDC;
+
+	zimg::ZimgFilterFlags flags{};
+	flags.same_row = true;
+
+	std::unique_ptr<SplatFilter<uint16_t>> filter1_uptr{ new SplatFilter<uint16_t>{ w, h, type, flags } };
+	std::unique_ptr<SplatFilter<uint16_t>> filter2_uptr{ new SplatFilter<uint16_t>{ w, h, type, flags } };
+	SplatFilter<uint16_t> *filter1 = filter1_uptr.get();
+	SplatFilter<uint16_t> *filter2 = filter2_uptr.get();
+
+	filter1->set_input_val(test_byte1);
+	filter1->set_output_val(test_byte2);
+
+	filter2->set_input_val(test_byte2);
+	filter2->set_output_val(test_byte3);
+
+	zimg::FilterGraph graph{ w, h, type, 0, 0, false };
+
+	graph.attach_filter(filter1);
+	filter1_uptr.release();
+	graph.attach_filter(filter2);
+	filter2_uptr.release();
+	graph.set_tile_width(w);
+	graph.set_stats_enabled(true);
+	graph.complete();
+
+	AuditImage<uint16_t> src_image{ w, h, type, 0, 0, false };
+	AuditImage<uint16_t> dst_image{ w, h, type, 0, 0, false };
+	zimg::AlignedVector<char> tmp(graph.get_tmp_size());
+
+	src_image.set_fill_val(test_byte1);
+	src_image.default_fill();
+	graph.process(src_image.as_image_buffer(), dst_image.as_image_buffer(), tmp.data(), nullptr, nullptr);
+	dst_image.set_fill_val(test_byte3);
+
+	// Fusable filters are reported individually when statistics are enabled.
+	auto stats = graph.get_stats();
+	ASSERT_EQ(2U, stats.size());
+
+	for (const auto &node_stats : stats) {
+		EXPECT_NE(std::string::npos, std::string{ node_stats.name }.find("SplatFilter"));
+		EXPECT_EQ(std::string::npos, std::string{ node_stats.name }.find("FusedFilter"));
+		EXPECT_EQ(1ULL * h, node_stats.lines);
+	}
+
+	SCOPED_TRACE("validating src");
+	src_image.validate();
+	SCOPED_TRACE("validating dst");
+	dst_image.validate();
+}
+
+TEST(FilterGraphTest, test_context)
+{
+	const unsigned w = 640;
+	const unsigned h = 480;
+	const zimg::PixelType type = zimg::PixelType::BYTE;
+
+	const uint8_t test_byte1 = 0xCD;
+	const uint8_t test_byte2 = 0xDD;
+	const uint8_t test_byte3 = 0xDC;
+
+	zimg::ZimgFilterFlags flags1{};
+	flags1.has_state = true;
+
+	std::unique_ptr<SplatFilter<uint8_t>> filter1_uptr{ new SplatFilter<uint8_t>{ w, h, type, flags1 } };
+	std::unique_ptr<SplatFilter<uint8_t>> filter2_uptr{ new SplatFilter<uint8_t>{ w, h, type } };
+	SplatFilter<uint8_t> *filter1 = filter1_uptr.get();
+	SplatFilter<uint8_t> *filter2 = filter2_uptr.get();
+
+	filter1->set_input_val(test_byte1);
+	filter1->set_output_val(test_byte2);
+	filter1->set_vertical_support(1);
+
+	filter2->set_input_val(test_byte2);
+	filter2->set_output_val(test_byte3);
+	filter2->set_horizontal_support(2);
+
+	zimg::FilterGraph graph{ w, h, type, 0, 0, false };
+
+	graph.attach_filter(filter1);
+	filter1_uptr.release();
+	graph.attach_filter(filter2);
+	filter2_uptr.release();
+	graph.set_tile_width(256);
+	graph.complete();
+
+	zimg::FilterGraphContext context{ graph };
+
+	for (unsigned n = 0; n < 3; ++n) {
+		SCOPED_TRACE(n);
+
+		AuditImage<uint8_t> src_image{ w, h, type, 0, 0, false };
+		AuditImage<uint8_t> dst_image{ w, h, type, 0, 0, false };
+
+		src_image.set_fill_val(test_byte1);
+		src_image.default_fill();
+		context.process(src_image.as_image_buffer(), dst_image.as_image_buffer(), nullptr, nullptr);
+		dst_image.set_fill_val(test_byte3);
+
+		EXPECT_EQ(3 * h * (n + 1), filter1->get_total_calls());
+		EXPECT_EQ(3 * h * (n + 1), filter2->get_total_calls());
+
+		SCOPED_TRACE("validating src");
+		src_image.validate();
+		SCOPED_TRACE("validating dst");
+		dst_image.validate();
+	}
+}
+
+TEST(FilterGraphTest, test_push_rows)
+{
+	static const unsigned w = 640;
+	static const unsigned h = 480;
+	const zimg::PixelType type = zimg::PixelType::BYTE;
+
+	const unsigned slice_height = 16;
+	const unsigned support = 4;
+
+	const uint8_t test_byte1 = 0xCD;
+	const uint8_t test_byte2 = 0xDD;
+
+	struct callback_data {
+		unsigned next_row;
+		unsigned call_count;
+	};
+
+	auto cb = [](void *ptr, unsigned i, unsigned left, unsigned right) -> int
+	{
+		callback_data *xptr = reinterpret_cast<callback_data *>(ptr);
+
+		EXPECT_EQ(xptr->next_row, i);
+		EXPECT_EQ(0U, left);
+		EXPECT_EQ(w, right);
+
+		xptr->next_row = i + 1;
+		++xptr->call_count;
+		return HasFatalFailure();
+	};
+
+	std::unique_ptr<SplatFilter<uint8_t>> filter_uptr{ new SplatFilter<uint8_t>{ w, h, type } };
+	SplatFilter<uint8_t> *filter = filter_uptr.get();
+
+	filter->set_input_val(test_byte1);
+	filter->set_output_val(test_byte2);
+	filter->set_vertical_support(support);
+
+	zimg::FilterGraph graph{ w, h, type, 0, 0, false };
+	graph.attach_filter(filter);
+	filter_uptr.release();
+	graph.set_tile_width(256);
+	graph.complete();
+
+	unsigned input_lines = graph.get_push_buffering(slice_height);
+	ASSERT_NE((unsigned)-1, input_lines);
+	EXPECT_GE(input_lines, graph.get_input_buffering() + slice_height);
+
+	zimg::FilterGraphContext context{ graph };
+
+	for (unsigned n = 0; n < 2; ++n) {
+		SCOPED_TRACE(n);
+
+		AuditBuffer<uint8_t> src_buffer{ w, h, zimg::default_pixel_format(type), input_lines, 0, 0, false };
+		AuditImage<uint8_t> dst_image{ w, h, type, 0, 0, false };
+		callback_data cb_data = { 0, 0 };
+		unsigned out_rows = 0;
+
+		src_buffer.set_fill_val(test_byte1);
+		src_buffer.default_fill();
+
+		for (unsigned i = 0; i < h; i += slice_height) {
+			unsigned count = std::min(slice_height, h - i);
+			unsigned prev_rows = out_rows;
+
+			out_rows = context.push_rows(src_buffer.as_image_buffer(), dst_image.as_image_buffer(), i, count, { cb, &cb_data });
+
+			EXPECT_GE(out_rows, prev_rows);
+			EXPECT_LE(out_rows, i + count == h ? h : i + count - support);
+			EXPECT_EQ(out_rows, cb_data.call_count);
+		}
+		dst_image.set_fill_val(test_byte2);
+
+		EXPECT_EQ(h, out_rows);
+		EXPECT_EQ(h * (n + 1), filter->get_total_calls());
+
+		SCOPED_TRACE("validating dst");
+		dst_image.validate();
+	}
+
+	AuditImage<uint8_t> src_image{ w, h, type, 0, 0, false };
+	AuditImage<uint8_t> dst_image{ w, h, type, 0, 0, false };
+
+	src_image.set_fill_val(test_byte1);
+	src_image.default_fill();
+
+	context.push_rows(src_image.as_image_buffer(), dst_image.as_image_buffer(), 0, slice_height, nullptr);
+	EXPECT_THROW(context.push_rows(src_image.as_image_buffer(), dst_image.as_image_buffer(), slice_height * 2, slice_height, nullptr), zimg::error::IllegalArgument);
+	EXPECT_THROW(context.push_rows(src_image.as_image_buffer(), dst_image.as_image_buffer(), slice_height, h, nullptr), zimg::error::IllegalArgument);
+}
+
 TEST(FilterGraphTest, test_callback)
 {
 	static const unsigned w = 1024;
@@ -383,6 +1353,7 @@ TEST(FilterGraphTest, test_callback)
 				filter1_uptr.release();
 				graph.attach_filter_uv(filter2);
 				filter2_uptr.release();
+				graph.set_tile_width(512);
 				graph.complete();
 
 				AuditImage<uint8_t> src_image{ w, h, type, sw, sh, true };
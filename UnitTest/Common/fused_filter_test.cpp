@@ -0,0 +1,106 @@
+#include <cstdint>
+#include <memory>
+#include <utility>
+#include <vector>
+#include "Common/except.h"
+#include "Common/fused_filter.h"
+#include "Common/pixel.h"
+#include "Common/zfilter.h"
+
+#include "gtest/gtest.h"
+#include "filter_validator.h"
+#include "mock_filter.h"
+
+namespace {;
+
+void test_case(unsigned hsupport, bool entire_row)
+{
+	const unsigned w = 640;
+	const unsigned h = 480;
+	const zimg::PixelType type = zimg::PixelType::BYTE;
+
+	const uint8_t test_byte1 = 0xDC;
+	const uint8_t test_byte2 = 0xAA;
+	const uint8_t test_byte3 = 0x55;
+
+	const char *expected_sha1[3] = { "6bfc86a323d47a0814dc57a6143920ede3ffa0e4" };
+
+	zimg::ZimgFilterFlags flags{};
+	flags.same_row = true;
+
+	zimg::ZimgFilterFlags flags_last = flags;
+	flags_last.entire_row = entire_row;
+
+	std::unique_ptr<SplatFilter<uint8_t>> filter1{ new SplatFilter<uint8_t>{ w, h, type, flags } };
+	std::unique_ptr<SplatFilter<uint8_t>> filter2{ new SplatFilter<uint8_t>{ w, h, type, flags } };
+	std::unique_ptr<SplatFilter<uint8_t>> filter3{ new SplatFilter<uint8_t>{ w, h, type, flags_last } };
+
+	filter1->set_horizontal_support(hsupport);
+	filter1->set_output_val(test_byte3);
+	filter1->enable_input_checking(false);
+
+	filter2->set_horizontal_support(hsupport);
+	filter2->set_input_val(test_byte3);
+	filter2->set_output_val(test_byte1);
+
+	filter3->set_input_val(test_byte1);
+	filter3->set_output_val(test_byte2);
+
+	std::vector<std::unique_ptr<zimg::IZimgFilter>> filters;
+	filters.emplace_back(std::move(filter1));
+	filters.emplace_back(std::move(filter2));
+	filters.emplace_back(std::move(filter3));
+
+	zimg::FusedFilter fused{ std::move(filters) };
+
+	auto fused_flags = fused.get_flags();
+	auto fused_attr = fused.get_image_attributes();
+
+	EXPECT_TRUE(fused_flags.same_row);
+	EXPECT_FALSE(fused_flags.has_state);
+	EXPECT_EQ(entire_row, !!fused_flags.entire_row);
+
+	EXPECT_EQ(w, fused_attr.width);
+	EXPECT_EQ(h, fused_attr.height);
+	EXPECT_EQ(type, fused_attr.type);
+	EXPECT_EQ(1U, fused.get_max_buffering());
+
+	if (!entire_row) {
+		auto range = fused.get_required_col_range(10, 300);
+		EXPECT_EQ(10U - 2 * hsupport, range.first);
+		EXPECT_EQ(300U + 2 * hsupport, range.second);
+	}
+
+	validate_filter(&fused, w, h, type, expected_sha1);
+}
+
+} // namespace
+
+
+TEST(FusedFilterTest, test_strip)
+{
+	test_case(0, false);
+}
+
+TEST(FusedFilterTest, test_row)
+{
+	test_case(3, false);
+}
+
+TEST(FusedFilterTest, test_entire_row)
+{
+	test_case(3, true);
+}
+
+TEST(FusedFilterTest, test_not_fusable)
+{
+	zimg::ZimgFilterFlags flags{};
+	flags.same_row = true;
+
+	std::vector<std::unique_ptr<zimg::IZimgFilter>> filters;
+	filters.emplace_back(new SplatFilter<uint8_t>{ 640, 480, zimg::PixelType::BYTE, flags });
+	filters.emplace_back(new SplatFilter<uint8_t>{ 640, 480, zimg::PixelType::BYTE });
+
+	EXPECT_FALSE(zimg::FusedFilter::is_fusable(*filters.back()));
+	EXPECT_THROW(zimg::FusedFilter{ std::move(filters) }, zimg::error::InternalError);
+}
@@ -3,6 +3,7 @@
 #ifndef ZIMG_MOCK_FILTER_H_
 #define ZIMG_MOCK_FILTER_H_
 
+#include <atomic>
 #include <cstdint>
 
 #include "Common/zfilter.h"
@@ -17,7 +18,7 @@ protected:
 
 	image_attributes m_attr;
 	zimg::ZimgFilterFlags m_flags;
-	mutable unsigned m_total_calls;
+	mutable std::atomic<unsigned> m_total_calls;
 	unsigned m_simultaneous_lines;
 	unsigned m_horizontal_support;
 	unsigned m_vertical_support;
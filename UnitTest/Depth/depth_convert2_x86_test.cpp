@@ -0,0 +1,59 @@
+#ifdef ZIMG_X86
+
+#include <cmath>
+#include "Common/cpuinfo.h"
+#include "Common/pixel.h"
+#include "Depth/depth_convert2.h"
+
+#include "gtest/gtest.h"
+#include "Common/filter_validator.h"
+
+namespace {;
+
+void test_case(zimg::CPUClass cpu, bool fullrange, bool chroma)
+{
+	const unsigned w = 637;
+	const unsigned h = 479;
+
+	zimg::PixelType pixel_in[] = { zimg::PixelType::BYTE, zimg::PixelType::WORD, zimg::PixelType::HALF, zimg::PixelType::FLOAT };
+	zimg::PixelType pixel_out[] = { zimg::PixelType::HALF, zimg::PixelType::FLOAT };
+
+	for (zimg::PixelType pxin : pixel_in) {
+		for (zimg::PixelType pxout : pixel_out) {
+			SCOPED_TRACE(static_cast<int>(pxin));
+			SCOPED_TRACE(static_cast<int>(pxout));
+
+			zimg::PixelFormat fmt_in = zimg::default_pixel_format(pxin);
+			fmt_in.fullrange = fullrange;
+			fmt_in.chroma = chroma;
+
+			zimg::PixelFormat fmt_out = zimg::default_pixel_format(pxout);
+			fmt_out.chroma = chroma;
+
+			zimg::depth::DepthConvert2 convert_c{ w, h, fmt_in, fmt_out, zimg::CPUClass::CPU_NONE };
+			zimg::depth::DepthConvert2 convert_x86{ w, h, fmt_in, fmt_out, cpu };
+
+			validate_filter(&convert_x86, w, h, fmt_in);
+			// The C float to half conversion does not round to nearest-even.
+			validate_filter_reference(&convert_c, &convert_x86, w, h, fmt_in, pxout == zimg::PixelType::HALF ? 90.0 : INFINITY);
+		}
+	}
+}
+
+} // namespace
+
+
+TEST(DepthConvert2X86Test, test_avx512)
+{
+	zimg::X86Capabilities caps = zimg::query_x86_capabilities();
+
+	if (!caps.avx512f || !caps.avx512bw || !caps.avx512vl) {
+		SUCCEED() << "avx512 not available, skipping";
+		return;
+	}
+
+	test_case(zimg::CPUClass::CPU_X86_AVX512, false, false);
+	test_case(zimg::CPUClass::CPU_X86_AVX512, true, true);
+}
+
+#endif // ZIMG_X86
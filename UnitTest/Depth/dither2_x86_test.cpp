@@ -0,0 +1,64 @@
+#ifdef ZIMG_X86
+
+#include <cmath>
+#include "Common/cpuinfo.h"
+#include "Common/pixel.h"
+#include "Depth/dither2.h"
+
+#include "gtest/gtest.h"
+#include "Common/filter_validator.h"
+
+namespace {;
+
+template <class T>
+void test_case(zimg::CPUClass cpu, bool fullrange, bool chroma)
+{
+	const unsigned w = 637;
+	const unsigned h = 479;
+
+	zimg::PixelType pixel_in[] = { zimg::PixelType::BYTE, zimg::PixelType::WORD, zimg::PixelType::HALF, zimg::PixelType::FLOAT };
+	zimg::PixelType pixel_out[] = { zimg::PixelType::BYTE, zimg::PixelType::WORD };
+
+	for (zimg::PixelType pxin : pixel_in) {
+		for (zimg::PixelType pxout : pixel_out) {
+			SCOPED_TRACE(static_cast<int>(pxin));
+			SCOPED_TRACE(static_cast<int>(pxout));
+
+			zimg::PixelFormat fmt_in = zimg::default_pixel_format(pxin);
+			fmt_in.fullrange = fullrange;
+			fmt_in.chroma = chroma;
+
+			zimg::PixelFormat fmt_out = zimg::default_pixel_format(pxout);
+			fmt_out.fullrange = fullrange;
+			fmt_out.chroma = chroma;
+
+			T dither_c{ w, h, fmt_in, fmt_out, zimg::CPUClass::CPU_NONE };
+			T dither_x86{ w, h, fmt_in, fmt_out, cpu };
+
+			validate_filter(&dither_x86, w, h, fmt_in);
+			validate_filter_reference(&dither_c, &dither_x86, w, h, fmt_in, INFINITY);
+		}
+	}
+}
+
+} // namespace
+
+
+TEST(DitherX86Test, test_avx512)
+{
+	zimg::X86Capabilities caps = zimg::query_x86_capabilities();
+
+	if (!caps.avx512f || !caps.avx512bw || !caps.avx512vl) {
+		SUCCEED() << "avx512 not available, skipping";
+		return;
+	}
+
+	SCOPED_TRACE("none");
+	test_case<zimg::depth::NoneDither>(zimg::CPUClass::CPU_X86_AVX512, false, false);
+	SCOPED_TRACE("ordered");
+	test_case<zimg::depth::BayerDither>(zimg::CPUClass::CPU_X86_AVX512, false, true);
+	SCOPED_TRACE("random");
+	test_case<zimg::depth::RandomDither>(zimg::CPUClass::CPU_X86_AVX512, true, false);
+}
+
+#endif // ZIMG_X86
@@ -0,0 +1,107 @@
+#include <algorithm>
+#include <memory>
+#include "Resize/filter.h"
+#include "Resize/filter_cache.h"
+
+#include "gtest/gtest.h"
+
+namespace {;
+
+class OpaqueFilter : public zimg::resize::Filter {
+public:
+	int support() const override { return 1; }
+
+	double operator()(double x) const override { return x < 1.0 ? 1.0 - x : 0.0; }
+};
+
+} // namespace
+
+
+TEST(FilterCacheTest, test_hit_miss)
+{
+	const zimg::resize::BicubicFilter bicubic1{ 1.0 / 3.0, 1.0 / 3.0 };
+	const zimg::resize::BicubicFilter bicubic2{ 1.0 / 3.0, 1.0 / 3.0 };
+	const zimg::resize::BicubicFilter catmull_rom{ 0.0, 0.5 };
+	const zimg::resize::LanczosFilter lanczos3{ 3 };
+	const zimg::resize::LanczosFilter lanczos4{ 4 };
+
+	zimg::resize::clear_filter_cache();
+
+	auto a = zimg::resize::compute_filter_cached(bicubic1, 1920, 1280, 0.0, 1920);
+	auto b = zimg::resize::compute_filter_cached(bicubic2, 1920, 1280, 0.0, 1920);
+	EXPECT_EQ(a, b);
+
+	// Any difference in the filter or its parameters must yield a distinct filter.
+	EXPECT_NE(a, zimg::resize::compute_filter_cached(catmull_rom, 1920, 1280, 0.0, 1920));
+	EXPECT_NE(a, zimg::resize::compute_filter_cached(bicubic1, 1920, 1281, 0.0, 1920));
+	EXPECT_NE(a, zimg::resize::compute_filter_cached(bicubic1, 1921, 1280, 0.0, 1920));
+	EXPECT_NE(a, zimg::resize::compute_filter_cached(bicubic1, 1920, 1280, 0.25, 1920));
+	EXPECT_NE(a, zimg::resize::compute_filter_cached(bicubic1, 1920, 1280, 0.0, 1919));
+	EXPECT_NE(zimg::resize::compute_filter_cached(lanczos3, 1920, 1280, 0.0, 1920),
+	          zimg::resize::compute_filter_cached(lanczos4, 1920, 1280, 0.0, 1920));
+
+	zimg::resize::FilterCacheStats stats = zimg::resize::get_filter_cache_stats();
+	EXPECT_EQ(1U, stats.hits);
+	EXPECT_EQ(8U, stats.misses);
+	EXPECT_EQ(8U, stats.entries);
+
+	// The cached filter must be identical to a freshly computed one.
+	zimg::resize::FilterContext ref = zimg::resize::compute_filter(bicubic1, 1920, 1280, 0.0, 1920);
+	EXPECT_EQ(ref.filter_width, a->filter_width);
+	EXPECT_EQ(ref.num_phases, a->num_phases);
+	EXPECT_TRUE(std::equal(ref.data.begin(), ref.data.end(), a->data.begin()));
+	EXPECT_TRUE(std::equal(ref.data_i16.begin(), ref.data_i16.end(), a->data_i16.begin()));
+	EXPECT_TRUE(std::equal(ref.phase.begin(), ref.phase.end(), a->phase.begin()));
+	EXPECT_TRUE(std::equal(ref.left.begin(), ref.left.end(), a->left.begin()));
+
+	zimg::resize::clear_filter_cache();
+	stats = zimg::resize::get_filter_cache_stats();
+	EXPECT_EQ(0U, stats.hits);
+	EXPECT_EQ(0U, stats.misses);
+	EXPECT_EQ(0U, stats.entries);
+}
+
+TEST(FilterCacheTest, test_uncacheable)
+{
+	const OpaqueFilter opaque{};
+
+	zimg::resize::clear_filter_cache();
+
+	auto a = zimg::resize::compute_filter_cached(opaque, 640, 480, 0.0, 640);
+	auto b = zimg::resize::compute_filter_cached(opaque, 640, 480, 0.0, 640);
+	EXPECT_NE(a, b);
+
+	zimg::resize::FilterCacheStats stats = zimg::resize::get_filter_cache_stats();
+	EXPECT_EQ(0U, stats.hits);
+	EXPECT_EQ(0U, stats.misses);
+	EXPECT_EQ(0U, stats.entries);
+}
+
+TEST(FilterCacheTest, test_eviction)
+{
+	const zimg::resize::BilinearFilter bilinear{};
+
+	zimg::resize::clear_filter_cache();
+
+	auto first = zimg::resize::compute_filter_cached(bilinear, 640, 100, 0.0, 640);
+
+	for (unsigned i = 1; i < zimg::resize::FILTER_CACHE_MAX_ENTRIES; ++i) {
+		zimg::resize::compute_filter_cached(bilinear, 640, 100 + i, 0.0, 640);
+	}
+
+	// Refresh the first entry so that the second becomes least recently used.
+	EXPECT_EQ(first, zimg::resize::compute_filter_cached(bilinear, 640, 100, 0.0, 640));
+	zimg::resize::compute_filter_cached(bilinear, 640, 99, 0.0, 640);
+
+	zimg::resize::FilterCacheStats stats = zimg::resize::get_filter_cache_stats();
+	EXPECT_EQ(zimg::resize::FILTER_CACHE_MAX_ENTRIES, stats.entries);
+
+	EXPECT_EQ(first, zimg::resize::compute_filter_cached(bilinear, 640, 100, 0.0, 640));
+	zimg::resize::compute_filter_cached(bilinear, 640, 101, 0.0, 640);
+
+	stats = zimg::resize::get_filter_cache_stats();
+	EXPECT_EQ(2U, stats.hits);
+	EXPECT_EQ(zimg::resize::FILTER_CACHE_MAX_ENTRIES + 2, stats.misses);
+
+	zimg::resize::clear_filter_cache();
+}
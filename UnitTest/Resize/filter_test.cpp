@@ -0,0 +1,49 @@
+#include <cstring>
+#include "Resize/filter.h"
+
+#include "gtest/gtest.h"
+
+namespace {;
+
+void test_case(const zimg::resize::Filter &f, int src_dim, int dst_dim, unsigned max_phases)
+{
+	zimg::resize::FilterContext filter = zimg::resize::compute_filter(f, src_dim, dst_dim, 0.0, src_dim);
+
+	ASSERT_EQ((unsigned)dst_dim, filter.filter_rows);
+	ASSERT_EQ(filter.filter_rows, filter.phase.size());
+	ASSERT_EQ(filter.filter_rows, filter.left.size());
+	ASSERT_EQ((size_t)filter.stride * filter.num_phases, filter.data.size());
+	ASSERT_EQ((size_t)filter.stride_i16 * filter.num_phases, filter.data_i16.size());
+	EXPECT_LE(filter.num_phases, max_phases);
+
+	for (unsigned i = 0; i < filter.filter_rows; ++i) {
+		ASSERT_LT(filter.phase[i], filter.num_phases);
+	}
+
+	// Every stored phase must be distinct.
+	for (unsigned p = 0; p < filter.num_phases; ++p) {
+		for (unsigned q = p + 1; q < filter.num_phases; ++q) {
+			EXPECT_NE(0, std::memcmp(&filter.data[p * filter.stride], &filter.data[q * filter.stride], filter.filter_width * sizeof(float)));
+		}
+	}
+}
+
+} // namespace
+
+TEST(FilterTest, test_phase_dedup)
+{
+	const zimg::resize::BilinearFilter bilinear{};
+	const zimg::resize::Spline36Filter spline36{};
+	const zimg::resize::LanczosFilter lanczos4{ 4 };
+
+	// Interior rows of an integer or small rational ratio share a handful of
+	// phases. The remaining phases come from mirroring at the image borders.
+	SCOPED_TRACE("2:1");
+	test_case(lanczos4, 7680, 3840, 32);
+	SCOPED_TRACE("1:2");
+	test_case(spline36, 3840, 7680, 32);
+	SCOPED_TRACE("3:2");
+	test_case(lanczos4, 7680, 5120, 64);
+	SCOPED_TRACE("4:3");
+	test_case(bilinear, 1920, 1440, 64);
+}
@@ -0,0 +1,247 @@
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include "Common/cpuinfo.h"
+#include "Common/filtergraph.h"
+#include "Common/pixel.h"
+#include "Common/zfilter.h"
+#include "Resize/filter.h"
+#include "Resize/resize2.h"
+#include "Resize/resize_impl2.h"
+
+#include "gtest/gtest.h"
+#include "Common/audit_buffer.h"
+#include "Common/filter_validator.h"
+
+namespace {;
+
+template <class T>
+void process_graph(const zimg::FilterGraph &graph, const AuditBuffer<T> &src, AuditBuffer<T> &dst)
+{
+	zimg::AlignedVector<char> tmp(graph.get_tmp_size());
+	graph.process(src.as_image_buffer(), dst.as_image_buffer(), tmp.data(), nullptr, nullptr);
+}
+
+template <class T>
+void test_case(const zimg::PixelFormat &format, unsigned src_w, unsigned src_h, unsigned dst_w, unsigned dst_h, bool h_first, zimg::CPUClass cpu)
+{
+	const zimg::resize::BilinearFilter bilinear{};
+	const zimg::resize::LanczosFilter lanczos3{ 3 };
+
+	const zimg::resize::Filter *resample_filters[] = { &bilinear, &lanczos3 };
+
+	for (const zimg::resize::Filter *resample_filter : resample_filters) {
+		SCOPED_TRACE(resample_filter->support());
+
+		auto filter_pair = zimg::resize::create_resize2(*resample_filter, format.type, format.depth, src_w, src_h, dst_w, dst_h,
+		                                                0.0, 0.0, src_w, src_h, cpu);
+		std::unique_ptr<zimg::IZimgFilter> fused{ filter_pair.first };
+		std::unique_ptr<zimg::IZimgFilter> stage1;
+		std::unique_ptr<zimg::IZimgFilter> stage2;
+
+		ASSERT_TRUE(fused);
+		ASSERT_FALSE(filter_pair.second);
+		EXPECT_EQ(h_first, !!fused->get_flags().has_state);
+
+		validate_filter(fused.get(), src_w, src_h, format);
+
+		if (h_first) {
+			stage1.reset(zimg::resize::create_resize_impl2(*resample_filter, format.type, true, format.depth,
+			                                               src_w, src_h, dst_w, src_h, 0.0, src_w, cpu));
+			stage2.reset(zimg::resize::create_resize_impl2(*resample_filter, format.type, false, format.depth,
+			                                               dst_w, src_h, dst_w, dst_h, 0.0, src_h, cpu));
+		} else {
+			stage1.reset(zimg::resize::create_resize_impl2(*resample_filter, format.type, false, format.depth,
+			                                               src_w, src_h, src_w, dst_h, 0.0, src_h, cpu));
+			stage2.reset(zimg::resize::create_resize_impl2(*resample_filter, format.type, true, format.depth,
+			                                               src_w, dst_h, dst_w, dst_h, 0.0, src_w, cpu));
+		}
+
+		// The fused filter must match the equivalent two-node graph, including when the image is tiled.
+		zimg::FilterGraph graph_fused{ src_w, src_h, format.type, 0, 0, false };
+		zimg::FilterGraph graph_ref{ src_w, src_h, format.type, 0, 0, false };
+
+		graph_fused.attach_filter(fused.get());
+		fused.release();
+		graph_fused.set_tile_width(128);
+		graph_fused.complete();
+
+		graph_ref.attach_filter(stage1.get());
+		stage1.release();
+		graph_ref.attach_filter(stage2.get());
+		stage2.release();
+		graph_ref.complete();
+
+		AuditBuffer<T> src_buf{ src_w, src_h, format, (unsigned)-1, 0, 0, false };
+		AuditBuffer<T> dst_fused{ dst_w, dst_h, format, (unsigned)-1, 0, 0, false };
+		AuditBuffer<T> dst_ref{ dst_w, dst_h, format, (unsigned)-1, 0, 0, false };
+
+		src_buf.random_fill(0, src_h, 0, src_w);
+		dst_fused.default_fill();
+		dst_ref.default_fill();
+
+		process_graph(graph_fused, src_buf, dst_fused);
+		process_graph(graph_ref, src_buf, dst_ref);
+
+		for (unsigned i = 0; i < dst_h; ++i) {
+			dst_fused.assert_eq(dst_ref, i, 0, dst_w);
+		}
+	}
+}
+
+void test_order(unsigned src_w, unsigned src_h, unsigned dst_w, unsigned dst_h, bool h_first, zimg::CPUClass cpu)
+{
+	const zimg::PixelFormat format = zimg::default_pixel_format(zimg::PixelType::WORD);
+	const zimg::resize::BicubicFilter bicubic{ 1.0 / 3.0, 1.0 / 3.0 };
+
+	auto filter_pair = zimg::resize::create_resize2(bicubic, format.type, format.depth, src_w, src_h, dst_w, dst_h,
+	                                                0.0, 0.0, src_w, src_h, cpu);
+	std::unique_ptr<zimg::IZimgFilter> filter{ filter_pair.first };
+
+	ASSERT_TRUE(filter);
+	ASSERT_FALSE(filter_pair.second);
+	EXPECT_EQ(h_first, !!filter->get_flags().has_state);
+
+	// The chosen order is reported in the graph statistics.
+	zimg::FilterGraph graph{ src_w, src_h, format.type, 0, 0, false };
+	graph.attach_filter(filter.get());
+	filter.release();
+	graph.set_stats_enabled(true);
+	graph.complete();
+
+	auto stats = graph.get_stats();
+	bool found = std::any_of(stats.begin(), stats.end(), [=](const zimg::FilterGraph::node_stats &x)
+	{
+		return std::string{ x.name }.find(h_first ? "(h-first)" : "(v-first)") != std::string::npos;
+	});
+	EXPECT_TRUE(found);
+}
+
+#ifdef ZIMG_X86
+// Resize to a width whose last tile is narrower than the minimum, so that it is merged into the preceding tile.
+void test_tile_remainder(unsigned src_w, unsigned dst_w, zimg::CPUClass cpu)
+{
+	const zimg::PixelFormat format = zimg::default_pixel_format(zimg::PixelType::WORD);
+	const zimg::resize::BicubicFilter bicubic{ 1.0 / 3.0, 1.0 / 3.0 };
+	const unsigned h = 32;
+	const size_t guard_size = 16384;
+
+	zimg::FilterGraph graph{ src_w, h, format.type, 0, 0, false };
+	zimg::FilterGraph graph_ref{ src_w, h, format.type, 0, 0, false };
+
+	std::unique_ptr<zimg::IZimgFilter> filter{
+		zimg::resize::create_resize_impl2(bicubic, format.type, true, format.depth, src_w, h, dst_w, h, 0.0, src_w, cpu) };
+	std::unique_ptr<zimg::IZimgFilter> filter_ref{
+		zimg::resize::create_resize_impl2(bicubic, format.type, true, format.depth, src_w, h, dst_w, h, 0.0, src_w, zimg::CPUClass::CPU_NONE) };
+
+	graph.attach_filter(filter.get());
+	filter.release();
+	graph.set_tile_width(128);
+	graph.complete();
+
+	graph_ref.attach_filter(filter_ref.get());
+	filter_ref.release();
+	graph_ref.complete();
+
+	AuditBuffer<uint16_t> src_buf{ src_w, h, format, (unsigned)-1, 0, 0, false };
+	AuditBuffer<uint16_t> dst_buf{ dst_w, h, format, (unsigned)-1, 0, 0, false };
+	AuditBuffer<uint16_t> dst_ref{ dst_w, h, format, (unsigned)-1, 0, 0, false };
+
+	src_buf.random_fill(0, h, 0, src_w);
+	dst_buf.default_fill();
+	dst_ref.default_fill();
+
+	// Place a guard region after the temporary buffer to detect overruns.
+	size_t tmp_size = graph.get_tmp_size();
+	zimg::AlignedVector<char> tmp(tmp_size + guard_size, (char)0xCD);
+
+	graph.process(src_buf.as_image_buffer(), dst_buf.as_image_buffer(), tmp.data(), nullptr, nullptr);
+	process_graph(graph_ref, src_buf, dst_ref);
+
+	for (size_t n = tmp_size; n < tmp_size + guard_size; ++n) {
+		ASSERT_EQ((char)0xCD, tmp[n]) << "temporary buffer overrun at " << n - tmp_size;
+	}
+
+	for (unsigned i = 0; i < h; ++i) {
+		dst_buf.assert_eq(dst_ref, i, 0, dst_w);
+	}
+}
+#endif // ZIMG_X86
+
+} // namespace
+
+
+TEST(Resize2Test, test_fused_h_first)
+{
+	SCOPED_TRACE("byte");
+	test_case<uint8_t>(zimg::default_pixel_format(zimg::PixelType::BYTE), 640, 480, 320, 720, true, zimg::CPUClass::CPU_NONE);
+	SCOPED_TRACE("word");
+	test_case<uint16_t>(zimg::default_pixel_format(zimg::PixelType::WORD), 640, 480, 320, 720, true, zimg::CPUClass::CPU_NONE);
+	SCOPED_TRACE("float");
+	test_case<float>(zimg::default_pixel_format(zimg::PixelType::FLOAT), 640, 480, 320, 720, true, zimg::CPUClass::CPU_NONE);
+}
+
+TEST(Resize2Test, test_fused_v_first)
+{
+	SCOPED_TRACE("byte");
+	test_case<uint8_t>(zimg::default_pixel_format(zimg::PixelType::BYTE), 640, 480, 480, 240, false, zimg::CPUClass::CPU_NONE);
+	SCOPED_TRACE("word");
+	test_case<uint16_t>(zimg::default_pixel_format(zimg::PixelType::WORD), 640, 480, 480, 240, false, zimg::CPUClass::CPU_NONE);
+	SCOPED_TRACE("float");
+	test_case<float>(zimg::default_pixel_format(zimg::PixelType::FLOAT), 640, 480, 480, 240, false, zimg::CPUClass::CPU_NONE);
+}
+
+TEST(Resize2Test, test_order)
+{
+	// Reduce the larger dimension first, regardless of the kernels used.
+	zimg::CPUClass cpus[] = {
+		zimg::CPUClass::CPU_NONE,
+		zimg::CPUClass::CPU_AUTO,
+#ifdef ZIMG_X86
+		zimg::CPUClass::CPU_X86_SSE2,
+		zimg::CPUClass::CPU_X86_AVX2,
+		zimg::CPUClass::CPU_X86_AVX512,
+#endif
+	};
+
+	for (zimg::CPUClass cpu : cpus) {
+		SCOPED_TRACE(static_cast<int>(cpu));
+		test_order(3840, 2160, 720, 2000, true, cpu);
+		test_order(2160, 3840, 2000, 720, false, cpu);
+	}
+}
+
+#ifdef ZIMG_X86
+TEST(Resize2Test, test_fused_x86)
+{
+	// The x86 kernels produce several rows per call.
+	SCOPED_TRACE("word-h-first");
+	test_case<uint16_t>(zimg::default_pixel_format(zimg::PixelType::WORD), 640, 480, 320, 720, true, zimg::CPUClass::CPU_AUTO);
+	SCOPED_TRACE("float-h-first");
+	test_case<float>(zimg::default_pixel_format(zimg::PixelType::FLOAT), 640, 480, 320, 720, true, zimg::CPUClass::CPU_AUTO);
+	SCOPED_TRACE("word-v-first");
+	test_case<uint16_t>(zimg::default_pixel_format(zimg::PixelType::WORD), 640, 480, 480, 241, false, zimg::CPUClass::CPU_AUTO);
+	SCOPED_TRACE("float-v-first");
+	test_case<float>(zimg::default_pixel_format(zimg::PixelType::FLOAT), 640, 480, 480, 242, false, zimg::CPUClass::CPU_AUTO);
+}
+
+TEST(Resize2Test, test_tile_remainder_x86)
+{
+	zimg::CPUClass cpus[] = {
+		zimg::CPUClass::CPU_AUTO,
+		zimg::CPUClass::CPU_X86_SSE2,
+		zimg::CPUClass::CPU_X86_AVX2,
+		zimg::CPUClass::CPU_X86_AVX512,
+	};
+
+	for (zimg::CPUClass cpu : cpus) {
+		SCOPED_TRACE(static_cast<int>(cpu));
+
+		for (unsigned dst_w : { 160U, 180U, 300U }) {
+			SCOPED_TRACE(dst_w);
+			test_tile_remainder(640, dst_w, cpu);
+		}
+	}
+}
+#endif // ZIMG_X86
@@ -45,12 +45,24 @@ void test_case(const zimg::PixelFormat &format, bool horizontal, double scale_fa
 
 TEST(ResizeImplTest, test_nop)
 {
+	const char *expected_sha1_u8[][3] = {
+		{ "02c0adca6d301444ac4bf717fa691fe2758752a5" },
+		{ "02c0adca6d301444ac4bf717fa691fe2758752a5" },
+		{ "02c0adca6d301444ac4bf717fa691fe2758752a5" },
+		{ "02c0adca6d301444ac4bf717fa691fe2758752a5" }
+	};
 	const char *expected_sha1_u16[][3] = {
 		{ "8ba35ed1784cb6d7903a9092abefb3d9afd7a683" },
 		{ "8ba35ed1784cb6d7903a9092abefb3d9afd7a683" },
 		{ "8ba35ed1784cb6d7903a9092abefb3d9afd7a683" },
 		{ "8ba35ed1784cb6d7903a9092abefb3d9afd7a683" }
 	};
+	const char *expected_sha1_f16[][3] = {
+		{ "4184caae2bd2a3f54722cba1d561cc8720b117ce" },
+		{ "4184caae2bd2a3f54722cba1d561cc8720b117ce" },
+		{ "4184caae2bd2a3f54722cba1d561cc8720b117ce" },
+		{ "4184caae2bd2a3f54722cba1d561cc8720b117ce" }
+	};
 	const char *expected_sha1_f32[][3] = {
 		{ "483b6bdf608afbf1fba6bbca9657a8ca3822eef1" },
 		{ "483b6bdf608afbf1fba6bbca9657a8ca3822eef1" },
@@ -58,10 +70,18 @@ TEST(ResizeImplTest, test_nop)
 		{ "483b6bdf608afbf1fba6bbca9657a8ca3822eef1" }
 	};
 
+	SCOPED_TRACE("byte-h");
+	test_case(zimg::default_pixel_format(zimg::PixelType::BYTE), true, 1.0, 0.0, 1.0, expected_sha1_u8);
+	SCOPED_TRACE("byte-v");
+	test_case(zimg::default_pixel_format(zimg::PixelType::BYTE), false, 1.0, 0.0, 1.0, expected_sha1_u8);
 	SCOPED_TRACE("word-h");
 	test_case(zimg::default_pixel_format(zimg::PixelType::WORD), true, 1.0, 0.0, 1.0, expected_sha1_u16);
 	SCOPED_TRACE("word-v");
 	test_case(zimg::default_pixel_format(zimg::PixelType::WORD), false, 1.0, 0.0, 1.0, expected_sha1_u16);
+	SCOPED_TRACE("half-h");
+	test_case(zimg::default_pixel_format(zimg::PixelType::HALF), true, 1.0, 0.0, 1.0, expected_sha1_f16);
+	SCOPED_TRACE("half-v");
+	test_case(zimg::default_pixel_format(zimg::PixelType::HALF), false, 1.0, 0.0, 1.0, expected_sha1_f16);
 	SCOPED_TRACE("float-h");
 	test_case(zimg::default_pixel_format(zimg::PixelType::FLOAT), true, 1.0, 0.0, 1.0, expected_sha1_f32);
 	SCOPED_TRACE("float-v");
@@ -70,12 +90,24 @@ TEST(ResizeImplTest, test_nop)
 
 TEST(ResizeImplTest, test_horizontal_up)
 {
+	const char *expected_sha1_u8[][3] = {
+		{ "b46f8a97f348eb35d73abf5885bd27f439f1792f" },
+		{ "13dd5489659a8c3cb2c26c07441ac9883750ae49" },
+		{ "6e309fcf4e4ba26529ba2a6a8f7393cb6bb10a9e" },
+		{ "40b190ccafdfd096bb6e08e83dc8e84a32eacad4" }
+	};
 	const char *expected_sha1_u16[][3] = {
 		{ "9f37efd7adc0570ad9bab87abedea0e83601a207" },
 		{ "c9f3368bc3a15079abd56df2dd6f0be7f8d92fba" },
 		{ "9b7e9585d298b165e1fd78a5762c03f2be9750be" },
 		{ "19b0ae79289a47d2795e937519cda28f31352d6f" }
 	};
+	const char *expected_sha1_f16[][3] = {
+		{ "76fa5e989bf39d7112704c42b3fb5460ea53f6cd" },
+		{ "4c7c0b16d909ec942e9601bbb8f2ffbd0257fbba" },
+		{ "3c9fcd6bb90b009c4f7b464284ac5464e51b0a4e" },
+		{ "056b852895bbf35778fc7ee85ad9f38c009f3d24" }
+	};
 	const char *expected_sha1_f32[][3] = {
 		{ "982dbdbb4c8b4d35f4f77fd9107b6a7f306b0a0a" },
 		{ "558b5ad491be4e009064cb3a458f8d9da0fbe515" },
@@ -83,14 +115,24 @@ TEST(ResizeImplTest, test_horizontal_up)
 		{ "f8a06d162e5a00b2b47dbaa76a24f1f4c077a7bf" }
 	};
 
+	SCOPED_TRACE("byte");
+	test_case(zimg::default_pixel_format(zimg::PixelType::BYTE), true, 2.1, 0.0, 1.0, expected_sha1_u8);
 	SCOPED_TRACE("word");
 	test_case(zimg::default_pixel_format(zimg::PixelType::WORD), true, 2.1, 0.0, 1.0, expected_sha1_u16);
+	SCOPED_TRACE("half");
+	test_case(zimg::default_pixel_format(zimg::PixelType::HALF), true, 2.1, 0.0, 1.0, expected_sha1_f16);
 	SCOPED_TRACE("float");
 	test_case(zimg::default_pixel_format(zimg::PixelType::FLOAT), true, 2.1, 0.0, 1.0, expected_sha1_f32);
 }
 
 TEST(ResizeImplTest, test_horizontal_down)
 {
+	const char *expected_sha1_u8[][3] = {
+		{ "e782f47173bd1f1227edcd8a2c931d7a256cd323" },
+		{ "b078eab39a85a5c87b08ad3bcc2e4ab90c8c8315" },
+		{ "4ce0984f9dc0d228cd7cec3ab6cf3f4ce2b7d077" },
+		{ "a21d73130245f87045da2aef163a4ae5eff2c827" }
+	};
 	const char *expected_sha1_u16[][3] = {
 		{ "35f664a086caaa5823a8dd031e06f91cdffa47d0" },
 		{ "7ddad53e36e73b724bf28db0ae09a5f4e515c146" },
@@ -104,20 +146,116 @@ TEST(ResizeImplTest, test_horizontal_down)
 		{ "b8c8d10c0e9e5f4df0eead282a4279866492d6ee" }
 	};
 
+	SCOPED_TRACE("byte");
+	test_case(zimg::default_pixel_format(zimg::PixelType::BYTE), true, 1.0 / 2.1, 0.0, 1.0, expected_sha1_u8);
 	SCOPED_TRACE("word");
 	test_case(zimg::default_pixel_format(zimg::PixelType::WORD), true, 1.0 / 2.1, 0.0, 1.0, expected_sha1_u16);
 	SCOPED_TRACE("float");
 	test_case(zimg::default_pixel_format(zimg::PixelType::FLOAT), true, 1.0 / 2.1, 0.0, 1.0, expected_sha1_f32);
 }
 
+TEST(ResizeImplTest, test_horizontal_integer_up)
+{
+	const char *expected_sha1_u8[][3] = {
+		{ "e9587ac91d9b275d2d0cd5fbf86d603d676b2b42" },
+		{ "b2269e684b09bd9f23f3b03afcfa1ff5295aa8bc" },
+		{ "dc09250c7ad1e12d4727035c2302bd5a5e13fb68" },
+		{ "b46577824e5f8d1abe802236688a64c50d5399da" }
+	};
+	const char *expected_sha1_u16[][3] = {
+		{ "4d513718afe1b27eddfa1cd535fd84135cf66435" },
+		{ "c5f0ca8a78ec5ea76ffd7681521b5dc48c3ea25d" },
+		{ "4f48822a46108918cd73eb92ac2110fffa6ccf7d" },
+		{ "3af9753563b72efb2cf9c7f50683b9c103b4a0af" }
+	};
+	const char *expected_sha1_f16[][3] = {
+		{ "1913e80a7260c2f57a4ee1e580fd859c6a034c6b" },
+		{ "cc2715df7a4d76102969206a45c81f49e06aed3c" },
+		{ "b2d42a7f557a8c1693c18c3c93ae59bc2f3a593f" },
+		{ "c21438af900418ca47be9681cad2839476b7028a" }
+	};
+	const char *expected_sha1_f32[][3] = {
+		{ "19c436707c8e7904df9efc4121ab87517311eb14" },
+		{ "e9e6828c207937db9e813fa2b1b8dae38d86a489" },
+		{ "170caa5d986b074a0516867fe26a09472a89498c" },
+		{ "d0b5b1875cfb29a156b4fce9f590be72cb10bdc1" }
+	};
+
+	SCOPED_TRACE("byte");
+	test_case(zimg::default_pixel_format(zimg::PixelType::BYTE), true, 2.0, 0.0, 1.0, expected_sha1_u8);
+	SCOPED_TRACE("word");
+	test_case(zimg::default_pixel_format(zimg::PixelType::WORD), true, 2.0, 0.0, 1.0, expected_sha1_u16);
+	SCOPED_TRACE("half");
+	test_case(zimg::default_pixel_format(zimg::PixelType::HALF), true, 2.0, 0.0, 1.0, expected_sha1_f16);
+	SCOPED_TRACE("float");
+	test_case(zimg::default_pixel_format(zimg::PixelType::FLOAT), true, 2.0, 0.0, 1.0, expected_sha1_f32);
+}
+
+TEST(ResizeImplTest, test_horizontal_integer_down)
+{
+	const char *expected_sha1_u8[][3] = {
+		{ "23b5fc7e21d4c4b215cb033cad7b63f3288729bf" },
+		{ "bdda8ce0a4a4e8984f1a1455c9042796081977be" },
+		{ "a0b3b8152e86ba5fe6eaf66a6dd5872d0bd4cf81" },
+		{ "018bf6d112d88a87f577892d8e1be2bfd94c9106" }
+	};
+	const char *expected_sha1_u16[][3] = {
+		{ "decc7aa04e064257a93effd37c62cf0c938b5343" },
+		{ "682978e53780afe2412dedc49ad291ac83747072" },
+		{ "7d95b7c521322feca201d16451af1390669da141" },
+		{ "9f5888e21510bff95aed6cb0809ac29bf5620fba" }
+	};
+	const char *expected_sha1_u16_4x[][3] = {
+		{ "05d8166ca081149ecb5e49d282b14d39df2662ac" },
+		{ "c1da633da8bcad10d68c25d796d4fd3945b31345" },
+		{ "944a9b4773809659bb7343e1a9f71205b30148db" },
+		{ "1820e8a329c8f76d3dabe1eed27351deaabb2681" }
+	};
+	const char *expected_sha1_f32[][3] = {
+		{ "465fb0dca16f99e366e5791936171c0484f1f1a4" },
+		{ "59a3b2cd59f27aaafa814d33959c6f06a6651944" },
+		{ "ab0f55414bc146d406e941b75e309dd25f9a2a99" },
+		{ "a5ed3387791480c34e576398a2fe75603a85a76a" }
+	};
+	const char *expected_sha1_f32_4x[][3] = {
+		{ "3a612bbe7c0c57d43c51c6a5808d9401761cd507" },
+		{ "d8f152e15ac9576e1037306d99b21167556a51da" },
+		{ "d55554adc43b3c14dae77584ea8dc5f67a2af9fe" },
+		{ "4e39c68015ccb9aec15f9737e06f5fa08e1a572a" }
+	};
+
+	SCOPED_TRACE("byte");
+	test_case(zimg::default_pixel_format(zimg::PixelType::BYTE), true, 0.5, 0.0, 1.0, expected_sha1_u8);
+	SCOPED_TRACE("word");
+	test_case(zimg::default_pixel_format(zimg::PixelType::WORD), true, 0.5, 0.0, 1.0, expected_sha1_u16);
+	SCOPED_TRACE("word-4x");
+	test_case(zimg::default_pixel_format(zimg::PixelType::WORD), true, 0.25, 0.0, 1.0, expected_sha1_u16_4x);
+	SCOPED_TRACE("float");
+	test_case(zimg::default_pixel_format(zimg::PixelType::FLOAT), true, 0.5, 0.0, 1.0, expected_sha1_f32);
+	SCOPED_TRACE("float-4x");
+	test_case(zimg::default_pixel_format(zimg::PixelType::FLOAT), true, 0.25, 0.0, 1.0, expected_sha1_f32_4x);
+}
+
 TEST(ResizeImplTest, test_vertical_up)
 {
+	const char *expected_sha1_u8[][3] = {
+		{ "bbc7f0f6995afb6a58e30cfd606e68eb1cb8aacc" },
+		{ "bf07354d65fbb3c293c85ad82107b43bd8d464d4" },
+		{ "9da380fc5d990ba441d2f1f047c86bbcdba74653" },
+		{ "2425eb607333b8d88d3c19518b7e0864439b324d" }
+	};
 	const char *expected_sha1_u16[][3] = {
 		{ "0ceeec49fef9ff273d1159701b9e2496b0fbb6de" },
 		{ "dea6c6833de29cd297e9d8dfddcfb7602deb3e2e" },
 		{ "e23d8162a237adf1d0a5a6745a9e1209847f3cbf" },
 		{ "7f988ff9f373ecb1f9bd8d195366c1b5d34180a5" }
 	};
+	const char *expected_sha1_f16[][3] = {
+		{ "fbb385a44e147e85bd86d628e18b42910b7c503c" },
+		{ "bcab576c47c3e3f0fad0c60363f2469fb9f7fe1a" },
+		{ "a2bcc8e1215c1c8dc9f5b06b4d62aa4081f42f9c" },
+		{ "3da0e9e89d246f7a2e2ef5f3c821793d48a860ab" }
+	};
 	const char *expected_sha1_f32[][3] = {
 		{ "c080343cb22d40e31be08cdada3985099a3bff5c" },
 		{ "110ed0b2979b36c6f590c6315558dbd5a9a027bd" },
@@ -125,14 +263,24 @@ TEST(ResizeImplTest, test_vertical_up)
 		{ "69cf86bd0cc6a04ac14025721849f31714a28b58" }
 	};
 
+	SCOPED_TRACE("byte");
+	test_case(zimg::default_pixel_format(zimg::PixelType::BYTE), false, 2.1, 0.0, 1.0, expected_sha1_u8);
 	SCOPED_TRACE("word");
 	test_case(zimg::default_pixel_format(zimg::PixelType::WORD), false, 2.1, 0.0, 1.0, expected_sha1_u16);
+	SCOPED_TRACE("half");
+	test_case(zimg::default_pixel_format(zimg::PixelType::HALF), false, 2.1, 0.0, 1.0, expected_sha1_f16);
 	SCOPED_TRACE("float");
 	test_case(zimg::default_pixel_format(zimg::PixelType::FLOAT), false, 2.1, 0.0, 1.0, expected_sha1_f32);
 }
 
 TEST(ResizeImplTest, test_vertical_down)
 {
+	const char *expected_sha1_u8[][3] = {
+		{ "a34fbe0a087717b439878bcb94f24ccb482576ba" },
+		{ "54e5bdf1a316621c076a94218cc56fa41745a40d" },
+		{ "3a40da6801d17dcdbabe79452a8849257d20ee7d" },
+		{ "97948db44a3eb559fc1fb0c6850196f54ffd8ddc" }
+	};
 	const char *expected_sha1_u16[][3] = {
 		{ "aaef348f13b54c47b75c364a4c5db9348387753d" },
 		{ "8e8da56422e90bf16e1b3c335db4daabef8983f3" },
@@ -146,6 +294,8 @@ TEST(ResizeImplTest, test_vertical_down)
 		{ "b6e0cf62c008a995c314dd8aef3c36317b75aebf" }
 	};
 
+	SCOPED_TRACE("byte");
+	test_case(zimg::default_pixel_format(zimg::PixelType::BYTE), false, 1.0 / 2.1, 0.0, 1.0, expected_sha1_u8);
 	SCOPED_TRACE("word");
 	test_case(zimg::default_pixel_format(zimg::PixelType::WORD), false, 1.0 / 2.1, 0.0, 1.0, expected_sha1_u16);
 	SCOPED_TRACE("float");
@@ -0,0 +1,162 @@
+#ifdef ZIMG_X86
+
+#include <cmath>
+#include <memory>
+#include <typeinfo>
+#include "Common/cpuinfo.h"
+#include "Common/pixel.h"
+#include "Common/zfilter.h"
+#include "Resize/filter.h"
+#include "Resize/resize_impl2.h"
+
+#include "gtest/gtest.h"
+#include "Common/filter_validator.h"
+
+namespace {;
+
+void test_case(const zimg::PixelFormat &format, bool horizontal, unsigned src_w, unsigned src_h, unsigned dst_w, unsigned dst_h, zimg::CPUClass cpu, double snr_thresh)
+{
+	const zimg::resize::PointFilter point{};
+	const zimg::resize::BilinearFilter bilinear{};
+	const zimg::resize::Spline36Filter spline36{};
+	const zimg::resize::LanczosFilter lanczos3{ 3 };
+
+	const zimg::resize::Filter *resample_filters[] = { &point, &bilinear, &spline36, &lanczos3 };
+	double subwidth = horizontal ? src_w : src_h;
+
+	for (const zimg::resize::Filter *resample_filter : resample_filters) {
+		SCOPED_TRACE(resample_filter->support());
+
+		std::unique_ptr<zimg::IZimgFilter> filter_c;
+		std::unique_ptr<zimg::IZimgFilter> filter_x86;
+
+		filter_c.reset(zimg::resize::create_resize_impl2(*resample_filter, format.type, horizontal, format.depth,
+		                                                 src_w, src_h, dst_w, dst_h, 0.0, subwidth, zimg::CPUClass::CPU_NONE));
+		filter_x86.reset(zimg::resize::create_resize_impl2(*resample_filter, format.type, horizontal, format.depth,
+		                                                   src_w, src_h, dst_w, dst_h, 0.0, subwidth, cpu));
+
+		ASSERT_TRUE(filter_c);
+		ASSERT_TRUE(filter_x86);
+		ASSERT_NE(typeid(*filter_c), typeid(*filter_x86));
+
+		validate_filter(filter_x86.get(), src_w, src_h, format);
+		validate_filter_reference(filter_c.get(), filter_x86.get(), src_w, src_h, format, snr_thresh);
+	}
+}
+
+void test_all(zimg::CPUClass cpu, double snr_thresh_f32, bool test_f16)
+{
+	zimg::PixelFormat format_u8 = zimg::default_pixel_format(zimg::PixelType::BYTE);
+	zimg::PixelFormat format_u16 = zimg::default_pixel_format(zimg::PixelType::WORD);
+	zimg::PixelFormat format_u10{ zimg::PixelType::WORD, 10, false, false };
+	zimg::PixelFormat format_f16 = zimg::default_pixel_format(zimg::PixelType::HALF);
+	zimg::PixelFormat format_f32 = zimg::default_pixel_format(zimg::PixelType::FLOAT);
+
+	SCOPED_TRACE("byte-h-up");
+	test_case(format_u8, true, 637, 479, 1337, 479, cpu, INFINITY);
+	SCOPED_TRACE("byte-h-down");
+	test_case(format_u8, true, 637, 479, 301, 479, cpu, INFINITY);
+	SCOPED_TRACE("byte-v-up");
+	test_case(format_u8, false, 637, 479, 637, 1001, cpu, INFINITY);
+	SCOPED_TRACE("byte-v-down");
+	test_case(format_u8, false, 637, 479, 637, 229, cpu, INFINITY);
+
+	SCOPED_TRACE("word-h-up");
+	test_case(format_u16, true, 637, 479, 1337, 479, cpu, INFINITY);
+	SCOPED_TRACE("word-h-down");
+	test_case(format_u16, true, 637, 479, 301, 479, cpu, INFINITY);
+	SCOPED_TRACE("word-v-up");
+	test_case(format_u16, false, 637, 479, 637, 1001, cpu, INFINITY);
+	SCOPED_TRACE("word-v-down");
+	test_case(format_u16, false, 637, 479, 637, 229, cpu, INFINITY);
+
+	SCOPED_TRACE("word10-h");
+	test_case(format_u10, true, 637, 479, 1337, 479, cpu, INFINITY);
+	SCOPED_TRACE("word10-v");
+	test_case(format_u10, false, 637, 479, 637, 1001, cpu, INFINITY);
+
+	SCOPED_TRACE("float-h-up");
+	test_case(format_f32, true, 637, 479, 1337, 479, cpu, snr_thresh_f32);
+	SCOPED_TRACE("float-h-down");
+	test_case(format_f32, true, 637, 479, 301, 479, cpu, snr_thresh_f32);
+	SCOPED_TRACE("float-v-up");
+	test_case(format_f32, false, 637, 479, 637, 1001, cpu, snr_thresh_f32);
+	SCOPED_TRACE("float-v-down");
+	test_case(format_f32, false, 637, 479, 637, 229, cpu, snr_thresh_f32);
+
+	// Heights that leave a partial group of rows for the multi-row vertical kernels.
+	SCOPED_TRACE("byte-v-down-partial");
+	test_case(format_u8, false, 637, 479, 637, 230, cpu, INFINITY);
+	SCOPED_TRACE("word-v-up-partial");
+	test_case(format_u16, false, 637, 479, 637, 1003, cpu, INFINITY);
+	SCOPED_TRACE("float-v-up-partial");
+	test_case(format_f32, false, 637, 479, 637, 1002, cpu, snr_thresh_f32);
+
+	SCOPED_TRACE("byte-h-2x-down");
+	test_case(format_u8, true, 650, 479, 325, 479, cpu, INFINITY);
+	SCOPED_TRACE("byte-h-2x-up");
+	test_case(format_u8, true, 333, 479, 666, 479, cpu, INFINITY);
+	SCOPED_TRACE("word-h-2x-down");
+	test_case(format_u16, true, 650, 479, 325, 479, cpu, INFINITY);
+	SCOPED_TRACE("word-h-4x-down");
+	test_case(format_u16, true, 648, 479, 162, 479, cpu, INFINITY);
+	SCOPED_TRACE("word-h-2x-up");
+	test_case(format_u16, true, 333, 479, 666, 479, cpu, INFINITY);
+	SCOPED_TRACE("float-h-2x-down");
+	test_case(format_f32, true, 650, 479, 325, 479, cpu, snr_thresh_f32);
+	SCOPED_TRACE("float-h-4x-down");
+	test_case(format_f32, true, 648, 479, 162, 479, cpu, snr_thresh_f32);
+	SCOPED_TRACE("float-h-2x-up");
+	test_case(format_f32, true, 333, 479, 666, 479, cpu, snr_thresh_f32);
+
+	if (test_f16) {
+		// The C implementation does not round to nearest-even when converting to half.
+		SCOPED_TRACE("half-h");
+		test_case(format_f16, true, 637, 479, 1337, 479, cpu, 60.0);
+		SCOPED_TRACE("half-v");
+		test_case(format_f16, false, 637, 479, 637, 1001, cpu, 60.0);
+		SCOPED_TRACE("half-h-2x-down");
+		test_case(format_f16, true, 650, 479, 325, 479, cpu, 60.0);
+		SCOPED_TRACE("half-h-2x-up");
+		test_case(format_f16, true, 333, 479, 666, 479, cpu, 60.0);
+	}
+}
+
+} // namespace
+
+TEST(ResizeImplX86Test, test_sse2)
+{
+	if (!zimg::query_x86_capabilities().sse2) {
+		SUCCEED() << "sse2 not available, skipping";
+		return;
+	}
+
+	// The SSE2 kernels sum in the same order as the C kernels.
+	test_all(zimg::CPUClass::CPU_X86_SSE2, INFINITY, false);
+}
+
+TEST(ResizeImplX86Test, test_avx2)
+{
+	zimg::X86Capabilities caps = zimg::query_x86_capabilities();
+
+	if (!caps.avx2 || !caps.fma) {
+		SUCCEED() << "avx2 not available, skipping";
+		return;
+	}
+
+	test_all(zimg::CPUClass::CPU_X86_AVX2, 120.0, !!caps.f16c);
+}
+
+TEST(ResizeImplX86Test, test_avx512)
+{
+	zimg::X86Capabilities caps = zimg::query_x86_capabilities();
+
+	if (!caps.avx512f || !caps.avx512bw || !caps.avx512vl) {
+		SUCCEED() << "avx512 not available, skipping";
+		return;
+	}
+
+	test_all(zimg::CPUClass::CPU_X86_AVX512, 120.0, !!caps.f16c);
+}
+
+#endif // ZIMG_X86
@@ -0,0 +1,132 @@
+#include <cmath>
+#include <memory>
+#include "Common/alloc.h"
+#include "Common/cpuinfo.h"
+#include "Common/filtergraph.h"
+#include "Common/linebuffer.h"
+#include "Common/pixel.h"
+#include "Common/zfilter.h"
+#include "Resize/filter.h"
+#include "Resize/resize2.h"
+#include "Unresize/unresize2.h"
+#include "Unresize/unresize_impl.h"
+
+#include "gtest/gtest.h"
+#include "Common/audit_buffer.h"
+#include "Common/filter_validator.h"
+
+namespace {;
+
+void test_case(zimg::PixelType type, bool horizontal, unsigned src_w, unsigned src_h, unsigned dst_w, unsigned dst_h)
+{
+	const zimg::resize::BilinearFilter bilinear{};
+	const zimg::resize::LanczosFilter lanczos3{ 3 };
+
+	const zimg::resize::Filter *resample_filters[] = { &bilinear, &lanczos3 };
+
+	for (const zimg::resize::Filter *resample_filter : resample_filters) {
+		SCOPED_TRACE(resample_filter->support());
+
+		std::unique_ptr<zimg::IZimgFilter> filter;
+		filter.reset(zimg::unresize::create_unresize_impl2(*resample_filter, type, horizontal, src_w, src_h, dst_w, dst_h, 0.0, zimg::CPUClass::CPU_NONE));
+
+		ASSERT_TRUE(filter);
+		validate_filter(filter.get(), src_w, src_h, type);
+	}
+}
+
+// Upsample an image with a resampling filter and check that unresizing recovers it.
+void test_roundtrip(const zimg::resize::Filter &resample_filter, unsigned w, unsigned h, unsigned up_w, unsigned up_h, zimg::CPUClass cpu)
+{
+	const zimg::PixelFormat format = zimg::default_pixel_format(zimg::PixelType::FLOAT);
+
+	zimg::FilterGraph graph{ w, h, format.type, 0, 0, false };
+
+	auto resize_pair = zimg::resize::create_resize2(resample_filter, format.type, format.depth, w, h, up_w, up_h, 0.0, 0.0, w, h, cpu);
+	auto unresize_pair = zimg::unresize::create_unresize2(resample_filter, format.type, up_w, up_h, w, h, 0.0, 0.0, cpu);
+
+	for (zimg::IZimgFilter *filter : { resize_pair.first, resize_pair.second, unresize_pair.first, unresize_pair.second }) {
+		std::unique_ptr<zimg::IZimgFilter> filter_ptr{ filter };
+
+		if (filter_ptr) {
+			graph.attach_filter(filter_ptr.get());
+			filter_ptr.release();
+		}
+	}
+	graph.set_tile_width(64);
+	graph.complete();
+
+	AuditBuffer<float> src_buf{ w, h, format, (unsigned)-1, 0, 0, false };
+	AuditBuffer<float> dst_buf{ w, h, format, (unsigned)-1, 0, 0, false };
+
+	src_buf.random_fill(0, h, 0, w);
+	dst_buf.default_fill();
+
+	zimg::AlignedVector<char> tmp(graph.get_tmp_size());
+	graph.process(src_buf.as_image_buffer(), dst_buf.as_image_buffer(), tmp.data(), nullptr, nullptr);
+
+	zimg::LineBuffer<const float> src_lines{ src_buf.as_image_buffer() };
+	zimg::LineBuffer<const float> dst_lines{ dst_buf.as_image_buffer() };
+
+	for (unsigned i = 0; i < h; ++i) {
+		for (unsigned j = 0; j < w; ++j) {
+			ASSERT_NEAR(src_lines[i][j], dst_lines[i][j], 1e-3) << "at (" << i << ", " << j << ")";
+		}
+	}
+}
+
+} // namespace
+
+TEST(UnresizeImplTest, test_unresize_h)
+{
+	SCOPED_TRACE("half");
+	test_case(zimg::PixelType::HALF, true, 640, 480, 320, 480);
+	SCOPED_TRACE("float");
+	test_case(zimg::PixelType::FLOAT, true, 640, 480, 320, 480);
+	SCOPED_TRACE("float-odd");
+	test_case(zimg::PixelType::FLOAT, true, 639, 479, 427, 479);
+}
+
+TEST(UnresizeImplTest, test_unresize_v)
+{
+	SCOPED_TRACE("half");
+	test_case(zimg::PixelType::HALF, false, 640, 480, 640, 240);
+	SCOPED_TRACE("float");
+	test_case(zimg::PixelType::FLOAT, false, 640, 480, 640, 240);
+	SCOPED_TRACE("float-odd");
+	test_case(zimg::PixelType::FLOAT, false, 639, 479, 639, 319);
+}
+
+TEST(UnresizeImplTest, test_roundtrip)
+{
+	const zimg::resize::BilinearFilter bilinear{};
+
+	SCOPED_TRACE("h");
+	test_roundtrip(bilinear, 320, 240, 640, 240, zimg::CPUClass::CPU_NONE);
+	SCOPED_TRACE("v");
+	test_roundtrip(bilinear, 320, 240, 320, 480, zimg::CPUClass::CPU_NONE);
+	SCOPED_TRACE("hv");
+	test_roundtrip(bilinear, 301, 203, 512, 384, zimg::CPUClass::CPU_NONE);
+#ifdef ZIMG_X86
+	SCOPED_TRACE("hv-x86");
+	test_roundtrip(bilinear, 301, 203, 512, 384, zimg::CPUClass::CPU_AUTO);
+#endif
+}
+
+TEST(UnresizeImplTest, test_roundtrip_banded)
+{
+	// Wider filters give a banded system instead of a tridiagonal one.
+	const zimg::resize::BicubicFilter bicubic{ 1.0 / 3.0, 1.0 / 3.0 };
+	const zimg::resize::Spline36Filter spline36{};
+	const zimg::resize::LanczosFilter lanczos3{ 3 };
+
+	const zimg::resize::Filter *resample_filters[] = { &bicubic, &spline36, &lanczos3 };
+
+	for (const zimg::resize::Filter *resample_filter : resample_filters) {
+		SCOPED_TRACE(resample_filter->support());
+		test_roundtrip(*resample_filter, 301, 203, 512, 384, zimg::CPUClass::CPU_NONE);
+#ifdef ZIMG_X86
+		test_roundtrip(*resample_filter, 301, 203, 512, 384, zimg::CPUClass::CPU_AUTO);
+#endif
+	}
+}
@@ -0,0 +1,102 @@
+#ifdef ZIMG_X86
+
+#include <cmath>
+#include <memory>
+#include <typeinfo>
+#include "Common/cpuinfo.h"
+#include "Common/pixel.h"
+#include "Common/zfilter.h"
+#include "Resize/filter.h"
+#include "Unresize/unresize_impl.h"
+
+#include "gtest/gtest.h"
+#include "Common/filter_validator.h"
+
+namespace {;
+
+void test_case(zimg::PixelType type, bool horizontal, unsigned src_w, unsigned src_h, unsigned dst_w, unsigned dst_h, zimg::CPUClass cpu, double snr_thresh)
+{
+	const zimg::resize::BilinearFilter bilinear{};
+	const zimg::resize::BicubicFilter bicubic{ 1.0 / 3.0, 1.0 / 3.0 };
+	const zimg::resize::LanczosFilter lanczos3{ 3 };
+
+	const zimg::resize::Filter *resample_filters[] = { &bilinear, &bicubic, &lanczos3 };
+
+	for (const zimg::resize::Filter *resample_filter : resample_filters) {
+		SCOPED_TRACE(resample_filter->support());
+
+		std::unique_ptr<zimg::IZimgFilter> filter_c;
+		std::unique_ptr<zimg::IZimgFilter> filter_x86;
+
+		filter_c.reset(zimg::unresize::create_unresize_impl2(*resample_filter, type, horizontal, src_w, src_h, dst_w, dst_h, 0.0, zimg::CPUClass::CPU_NONE));
+		filter_x86.reset(zimg::unresize::create_unresize_impl2(*resample_filter, type, horizontal, src_w, src_h, dst_w, dst_h, 0.0, cpu));
+
+		ASSERT_TRUE(filter_c);
+		ASSERT_TRUE(filter_x86);
+		ASSERT_NE(typeid(*filter_c), typeid(*filter_x86));
+
+		validate_filter(filter_x86.get(), src_w, src_h, type);
+		validate_filter_reference(filter_c.get(), filter_x86.get(), src_w, src_h, zimg::default_pixel_format(type), snr_thresh);
+	}
+}
+
+void test_all(zimg::CPUClass cpu, double snr_thresh, double half_h_snr_thresh)
+{
+	// Heights and widths that leave partial groups of rows and columns.
+	SCOPED_TRACE("float-h");
+	test_case(zimg::PixelType::FLOAT, true, 640, 480, 320, 480, cpu, snr_thresh);
+	SCOPED_TRACE("float-h-partial");
+	test_case(zimg::PixelType::FLOAT, true, 637, 479, 427, 479, cpu, snr_thresh);
+	SCOPED_TRACE("float-v");
+	test_case(zimg::PixelType::FLOAT, false, 640, 480, 640, 240, cpu, snr_thresh);
+	SCOPED_TRACE("float-v-partial");
+	test_case(zimg::PixelType::FLOAT, false, 637, 479, 637, 319, cpu, snr_thresh);
+
+	if (half_h_snr_thresh) {
+		SCOPED_TRACE("half-h");
+		test_case(zimg::PixelType::HALF, true, 637, 479, 427, 479, cpu, half_h_snr_thresh);
+		// The vertical pass stores the intermediate rows as half, which the solver amplifies.
+		SCOPED_TRACE("half-v");
+		test_case(zimg::PixelType::HALF, false, 637, 479, 637, 319, cpu, 30.0);
+	}
+}
+
+} // namespace
+
+TEST(UnresizeImplX86Test, test_sse2)
+{
+	if (!zimg::query_x86_capabilities().sse2) {
+		SUCCEED() << "sse2 not available, skipping";
+		return;
+	}
+
+	test_all(zimg::CPUClass::CPU_X86_SSE2, 120.0, 0.0);
+}
+
+TEST(UnresizeImplX86Test, test_avx2)
+{
+	zimg::X86Capabilities caps = zimg::query_x86_capabilities();
+
+	if (!caps.avx2 || !caps.fma || !caps.f16c) {
+		SUCCEED() << "avx2 not available, skipping";
+		return;
+	}
+
+	test_all(zimg::CPUClass::CPU_X86_AVX2, 120.0, 60.0);
+}
+
+TEST(UnresizeImplX86Test, test_avx512)
+{
+	zimg::X86Capabilities caps = zimg::query_x86_capabilities();
+
+	if (!caps.avx512f || !caps.avx512bw || !caps.avx512vl) {
+		SUCCEED() << "avx512 not available, skipping";
+		return;
+	}
+
+	// The horizontal kernel keeps the intermediate results in float, whereas the
+	// reference rounds them to half, so the two differ by the amplified rounding.
+	test_all(zimg::CPUClass::CPU_X86_AVX512, 120.0, 30.0);
+}
+
+#endif // ZIMG_X86
@@ -3,6 +3,7 @@
 #include <limits>
 #include <vector>
 #include "Common/matrix.h"
+#include "Resize/filter.h"
 #include "bilinear.h"
 
 namespace zimg {;
@@ -17,36 +18,56 @@ T epsilon()
 }
 
 template <class T>
-struct TridiagonalLU {
+struct BandedLU {
 	std::vector<T> l;
-	std::vector<T> u;
 	std::vector<T> c;
+	std::vector<T> u;
 
-	TridiagonalLU(size_t n) : l(n), u(n), c(n)
+	BandedLU(size_t n, size_t p) : l(n), c(n * p), u(n * p)
 	{}
 };
 
+/**
+ * Crout decomposition of a banded matrix with p sub- and super-diagonals.
+ * The factors do not fill in outside the band, so the cost is O(n * p^2).
+ */
 template <class T>
-TridiagonalLU<T> tridiagonal_decompose(const RowMatrix<T> &m)
+BandedLU<T> banded_decompose(const RowMatrix<T> &m, size_t p)
 {
 	size_t n = m.rows();
-	TridiagonalLU<T> lu{ n };
-	T zero = static_cast<T>(0);
+	BandedLU<T> lu{ n, p };
 	T eps = epsilon<T>();
 
-	lu.c[0] = zero;
-	lu.l[0] = m[0][0];
-	lu.u[0] = m[0][1] / (m[0][0] + eps);
+	// L(i, j) for |i - j| <= p.
+	auto lower = [&](size_t i, size_t j) { return i == j ? lu.l[i] : lu.c[i * p + (i - j) - 1]; };
 
-	for (size_t i = 1; i < n - 1; ++i) {
-		lu.c[i] = m[i][i - 1];
-		lu.l[i] = m[i][i] - lu.c[i] * lu.u[i - 1];
-		lu.u[i] = m[i][i + 1] / (lu.l[i] + eps);
-	}
+	for (size_t i = 0; i < n; ++i) {
+		size_t band_left = i > p ? i - p : 0;
+		size_t band_right = std::min(i + p + 1, n);
+
+		for (size_t j = band_left; j <= i; ++j) {
+			T x = m[i][j];
 
-	lu.c[n - 1] = m[n - 1][n - 2];
-	lu.l[n - 1] = m[n - 1][n - 1] - lu.c[n - 1] * lu.u[n - 2];
-	lu.u[n - 1] = zero;
+			for (size_t k = std::max(band_left, j > p ? j - p : 0); k < j; ++k) {
+				x -= lower(i, k) * lu.u[k * p + (j - k) - 1];
+			}
+
+			if (j == i)
+				lu.l[i] = x;
+			else
+				lu.c[i * p + (i - j) - 1] = x;
+		}
+
+		for (size_t j = i + 1; j < band_right; ++j) {
+			T x = m[i][j];
+
+			for (size_t k = std::max(band_left, j > p ? j - p : 0); k < i; ++k) {
+				x -= lower(i, k) * lu.u[k * p + (j - k) - 1];
+			}
+
+			lu.u[i * p + (j - i) - 1] = x / (lu.l[i] + eps);
+		}
+	}
 
 	return lu;
 }
@@ -99,23 +120,33 @@ RowMatrix<double> bilinear_weights(int in, int out, double shift)
 	return m;
 }
 
-} // namespace
-
-
-BilinearContext create_bilinear_context(int in, int out, float shift)
+/**
+ * Factor the least-squares system for an upsampling matrix.
+ *
+ * @param m upsampling matrix, mapping the original vector to the upscaled vector
+ * @return an initialized context
+ */
+BilinearContext create_context(const RowMatrix<double> &m)
 {
 	BilinearContext ctx;
 
-	// Map output shift to input shift.
-	RowMatrix<double> m = bilinear_weights(in, out, -shift * (double)in / (double)out);
 	RowMatrix<double> transpose_m = transpose(m);
 	RowMatrix<double> pinv_m = transpose_m * m;
-	TridiagonalLU<double> lu = tridiagonal_decompose(pinv_m);
 
 	size_t rows = transpose_m.rows();
 	size_t cols = transpose_m.cols();
 
-	ctx.dst_width = in;
+	// Half-bandwidth of the normal equations, which follows the filter support.
+	size_t p = 1;
+	for (size_t i = 0; i < rows; ++i) {
+		if (pinv_m.row_right(i) > i + 1)
+			p = std::max(pinv_m.row_right(i) - i - 1, p);
+	}
+
+	BandedLU<double> lu = banded_decompose(pinv_m, p);
+
+	ctx.dst_width = (int)rows;
+	ctx.src_width = (int)cols;
 
 	size_t rowsize = 0;
 	for (size_t i = 0; i < rows; ++i) {
@@ -136,17 +167,46 @@ BilinearContext create_bilinear_context(int in, int out, float shift)
 		ctx.matrix_row_offsets[i] = (int)left;
 	}
 
-	ctx.lu_c.resize(rows);
+	ctx.lu_bandwidth = (int)p;
+	ctx.lu_c.resize(rows * p);
 	ctx.lu_l.resize(rows);
-	ctx.lu_u.resize(rows);
+	ctx.lu_u.resize(rows * p);
 	for (size_t i = 0; i < rows; ++i) {
-		ctx.lu_c[i] = (float)lu.c[i];
 		ctx.lu_l[i] = (float)(1.0 / (lu.l[i] + epsilon<float>())); // Pre-invert this value, as it is used in division.
+	}
+	for (size_t i = 0; i < rows * p; ++i) {
+		ctx.lu_c[i] = (float)lu.c[i];
 		ctx.lu_u[i] = (float)lu.u[i];
 	}
 
 	return ctx;
 }
 
+} // namespace
+
+
+BilinearContext create_bilinear_context(int in, int out, float shift)
+{
+	// Map output shift to input shift.
+	return create_context(bilinear_weights(in, out, -shift * (double)in / (double)out));
+}
+
+BilinearContext create_unresize_context(const resize::Filter &f, int in, int out, double shift)
+{
+	// The resampler shifts the output position, which is the negated input shift.
+	resize::FilterContext filter = resize::compute_filter(f, in, out, shift * (double)in / (double)out, in);
+	RowMatrix<double> m{ (size_t)out, (size_t)in };
+
+	for (unsigned i = 0; i < filter.filter_rows; ++i) {
+		const float *coeffs = &filter.data[filter.phase[i] * filter.stride];
+
+		for (unsigned k = 0; k < filter.filter_width; ++k) {
+			m[i][filter.left[i] + k] = coeffs[k];
+		}
+	}
+
+	return create_context(m);
+}
+
 } // namespace unresize
 } // namespace zimg
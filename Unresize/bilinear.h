@@ -6,6 +6,14 @@
 #include "Common/align.h"
 
 namespace zimg {;
+
+namespace resize {;
+
+class Filter;
+
+} // namespace resize
+
+
 namespace unresize {;
 
 /**
@@ -22,6 +30,11 @@ struct BilinearContext {
 	 */
 	int dst_width;
 
+	/**
+	 * Dimension of upsampled image (M).
+	 */
+	int src_width;
+
 	/**
 	 * Packed storage of (A') as row + offset.
 	 * The matrix is stored as a 2-D array of matrix_row_size rows
@@ -41,15 +54,22 @@ struct BilinearContext {
 	int matrix_row_stride;
 
 	/**
-	 * LU decomposition of (A' A) stored as three arrays of dimension (N).
+	 * Number of sub-diagonals (p) in the band of (A' A).
+	 * The band is tridiagonal (p = 1) for bilinear upsampling and widens with the filter support.
+	 */
+	int lu_bandwidth;
+
+	/**
+	 * Banded LU decomposition of (A' A) stored as arrays of dimension (N * p), (N), and (N * p).
 	 *
-	 * The relationship to L and U is given by the following.
+	 * The relationship to L and U is given by the following, for k = 1...p.
 	 *
-	 * lu_c(i) = L(i, i - 1)
+	 * lu_c(i, k) = L(i, i - k)
 	 * lu_l(i) = 1 / L(i, i)
-	 * lu_u(i) = U(i, i + 1)
+	 * lu_u(i, k) = U(i, i + k)
 	 *
-	 * lu_c(1) and lu_u(N) are set to 0 to simplify the execution loop.
+	 * lu_c(i, k) and lu_u(i, k) are stored at index (i * p + k - 1), and are set to 0
+	 * outside of the matrix to simplify the execution loop.
 	 * lu_l is stored inverted as it is used in forward substitution as a divisor.
 	 */
 	AlignedVector<float> lu_c;
@@ -67,6 +87,18 @@ struct BilinearContext {
  */
 BilinearContext create_bilinear_context(int in, int out, float shift);
 
+/**
+ * Initialize a context to invert upsampling with an arbitrary resampling filter.
+ *
+ * @param f resampling filter
+ * @param in dimension of original vector
+ * @param out dimension of upscaled vector
+ * @param shift center shift relative to upscaled vector
+ * @return an initialized context
+ * @throws ResamplingNotAvailable if the filter is too wide for the dimensions
+ */
+BilinearContext create_unresize_context(const resize::Filter &f, int in, int out, double shift);
+
 } // namespace unresize
 } // namespace zimg
 
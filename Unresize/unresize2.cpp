@@ -0,0 +1,61 @@
+#include <algorithm>
+#include <memory>
+#include "Common/copy_filter.h"
+#include "Common/except.h"
+#include "unresize2.h"
+#include "unresize_impl.h"
+
+namespace zimg {;
+namespace unresize {;
+
+namespace {;
+
+bool unresize_h_first(double xscale, double yscale)
+{
+	// Downscaling cost is proportional to input size, whereas upscaling cost is proportional to output size.
+	// Horizontal operation is roughly twice as costly as vertical operation for SIMD cores.
+	double h_first_cost = std::max(xscale, 1.0) * 2.0 + xscale * std::max(yscale, 1.0);
+	double v_first_cost = std::max(yscale, 1.0)       + yscale * std::max(xscale, 1.0) * 2.0;
+
+	return h_first_cost < v_first_cost;
+}
+
+} // namespace
+
+
+std::pair<IZimgFilter *, IZimgFilter *> create_unresize2(
+	const resize::Filter &f, PixelType type, int src_width, int src_height, int dst_width, int dst_height,
+	double shift_w, double shift_h, CPUClass cpu)
+{
+	bool skip_h = (src_width == dst_width && shift_w == 0);
+	bool skip_v = (src_height == dst_height && shift_h == 0);
+
+	if (dst_width > src_width || dst_height > src_height)
+		throw zimg::error::IllegalArgument{ "input dimension must be greater than output" };
+
+	if (skip_h && skip_v) {
+		return{ new CopyFilter{ (unsigned)src_width, (unsigned)src_height, type }, nullptr };
+	} else if (skip_h) {
+		return{ create_unresize_impl2(f, type, false, src_width, src_height, dst_width, dst_height, shift_h, cpu), nullptr };
+	} else if (skip_v) {
+		return{ create_unresize_impl2(f, type, true, src_width, src_height, dst_width, dst_height, shift_w, cpu), nullptr };
+	} else {
+		double xscale = (double)dst_width / (double)src_width;
+		double yscale = (double)dst_height / (double)src_height;
+		std::unique_ptr<IZimgFilter> stage1;
+		std::unique_ptr<IZimgFilter> stage2;
+
+		if (unresize_h_first(xscale, yscale)) {
+			stage1.reset(create_unresize_impl2(f, type, true, src_width, src_height, dst_width, src_height, shift_w, cpu));
+			stage2.reset(create_unresize_impl2(f, type, false, dst_width, src_height, dst_width, dst_height, shift_h, cpu));
+		} else {
+			stage1.reset(create_unresize_impl2(f, type, false, src_width, src_height, src_width, dst_height, shift_h, cpu));
+			stage2.reset(create_unresize_impl2(f, type, true, src_width, dst_height, dst_width, dst_height, shift_w, cpu));
+		}
+
+		return{ stage1.release(), stage2.release() };
+	}
+}
+
+} // namespace unresize
+} // namespace zimg
@@ -0,0 +1,46 @@
+#pragma once
+
+#ifndef ZIMG_UNRESIZE_UNRESIZE2_H_
+#define ZIMG_UNRESIZE_UNRESIZE2_H_
+
+#include <utility>
+#include "Common/zfilter.h"
+
+namespace zimg {;
+
+enum class CPUClass;
+enum class PixelType;
+
+class IZimgFilter;
+
+namespace resize {;
+
+class Filter;
+
+} // namespace resize
+
+
+namespace unresize {;
+
+/**
+ * Create filters to invert the upsampling of an image by a resampling filter.
+ *
+ * @param f resampling filter used to upsample the image
+ * @param type pixel type, must be HALF or FLOAT
+ * @param src_width upsampled image width
+ * @param src_height upsampled image height
+ * @param dst_width unresized image width, must not exceed src_width
+ * @param dst_height unresized image height, must not exceed src_height
+ * @param shift_w horizontal center shift relative to upsampled image
+ * @param shift_h vertical center shift relative to upsampled image
+ * @param cpu create filters optimized for given cpu
+ * @return pair of filters to be applied in order, the second of which may be null
+ */
+std::pair<IZimgFilter *, IZimgFilter *> create_unresize2(
+	const resize::Filter &f, PixelType type, int src_width, int src_height, int dst_width, int dst_height,
+	double shift_w, double shift_h, CPUClass cpu);
+
+} // namespace unresize
+} // namespace zimg
+
+#endif // ZIMG_UNRESIZE_UNRESIZE2_H_
@@ -1,6 +1,10 @@
+#include <algorithm>
 #include "Common/cpuinfo.h"
 #include "Common/except.h"
+#include "Common/linebuffer.h"
 #include "Common/osdep.h"
+#include "Common/pixel.h"
+#include "Common/zassert.h"
 #include "bilinear.h"
 #include "unresize_impl.h"
 #include "unresize_impl_x86.h"
@@ -28,8 +32,8 @@ public:
 	void process_f32_h(const ImagePlane<const float> &src, const ImagePlane<float> &dst, float *tmp) const override
 	{
 		for (int i = 0; i < src.height(); ++i) {
-			filter_scanline_h_forward(m_hcontext, src, tmp, i, 0, m_hcontext.dst_width, ScalarPolicy_F32{});
-			filter_scanline_h_back(m_hcontext, tmp, dst, i, m_hcontext.dst_width, 0, ScalarPolicy_F32{});
+			filter_scanline_h_forward(m_hcontext, src[i], tmp, 0, m_hcontext.dst_width, ScalarPolicy_F32{});
+			filter_scanline_h_back(m_hcontext, tmp, dst[i], m_hcontext.dst_width, 0, ScalarPolicy_F32{});
 		}
 	}
 
@@ -44,6 +48,50 @@ public:
 	}
 };
 
+template <class T, class Policy>
+class UnresizeImplH_C final : public UnresizeImplH {
+public:
+	UnresizeImplH_C(const BilinearContext &context, unsigned height, PixelType type) :
+		UnresizeImplH(context, image_attributes{ (unsigned)context.dst_width, height, type })
+	{}
+
+	size_t get_tmp_size(unsigned, unsigned) const override
+	{
+		return m_context.dst_width * sizeof(T);
+	}
+
+	void process(void *, const ZimgImageBufferConst &src, const ZimgImageBuffer &dst, void *tmp, unsigned i, unsigned, unsigned) const override
+	{
+		LineBuffer<const T> src_buf{ src };
+		LineBuffer<T> dst_buf{ dst };
+		T *tmp_p = static_cast<T *>(tmp);
+
+		filter_scanline_h_forward(m_context, src_buf[i], tmp_p, 0, m_context.dst_width, Policy{});
+		filter_scanline_h_back(m_context, tmp_p, dst_buf[i], m_context.dst_width, 0, Policy{});
+	}
+};
+
+template <class T, class Policy>
+class UnresizeImplV_C final : public UnresizeImplV {
+protected:
+	void process_plane(const ImagePlane<const void> &src, const ImagePlane<void> &dst) const override
+	{
+		ImagePlane<const T> src_plane = plane_cast<const T>(src);
+		ImagePlane<T> dst_plane = plane_cast<T>(dst);
+
+		for (int i = 0; i < m_context.dst_width; ++i) {
+			filter_scanline_v_forward(m_context, src_plane, dst_plane, i, 0, src_plane.width(), Policy{});
+		}
+		for (int i = m_context.dst_width; i > 0; --i) {
+			filter_scanline_v_back(m_context, dst_plane, i, 0, src_plane.width(), Policy{});
+		}
+	}
+public:
+	UnresizeImplV_C(const BilinearContext &context, unsigned width, PixelType type) :
+		UnresizeImplV(context, image_attributes{ width, (unsigned)context.dst_width, type })
+	{}
+};
+
 } // namespace
 
 
@@ -86,5 +134,131 @@ UnresizeImpl *create_unresize_impl(int src_width, int src_height, int dst_width,
 	return ret;
 }
 
+
+UnresizeImplH::UnresizeImplH(const BilinearContext &context, const image_attributes &attr) :
+	m_context(context),
+	m_attr(attr)
+{}
+
+ZimgFilterFlags UnresizeImplH::get_flags() const
+{
+	ZimgFilterFlags flags{};
+
+	flags.same_row = true;
+	flags.entire_row = true;
+
+	return flags;
+}
+
+IZimgFilter::image_attributes UnresizeImplH::get_image_attributes() const
+{
+	return m_attr;
+}
+
+IZimgFilter::pair_unsigned UnresizeImplH::get_required_row_range(unsigned i) const
+{
+	return{ i, std::min(i + get_simultaneous_lines(), m_attr.height) };
+}
+
+IZimgFilter::pair_unsigned UnresizeImplH::get_required_col_range(unsigned, unsigned) const
+{
+	return{ 0, (unsigned)m_context.src_width };
+}
+
+unsigned UnresizeImplH::get_max_buffering() const
+{
+	return get_simultaneous_lines();
+}
+
+
+UnresizeImplV::UnresizeImplV(const BilinearContext &context, const image_attributes &attr) :
+	m_context(context),
+	m_attr(attr)
+{}
+
+ZimgFilterFlags UnresizeImplV::get_flags() const
+{
+	ZimgFilterFlags flags{};
+
+	flags.entire_row = true;
+	flags.entire_plane = true;
+
+	return flags;
+}
+
+IZimgFilter::image_attributes UnresizeImplV::get_image_attributes() const
+{
+	return m_attr;
+}
+
+IZimgFilter::pair_unsigned UnresizeImplV::get_required_row_range(unsigned) const
+{
+	return{ 0, (unsigned)m_context.src_width };
+}
+
+IZimgFilter::pair_unsigned UnresizeImplV::get_required_col_range(unsigned, unsigned) const
+{
+	return{ 0, m_attr.width };
+}
+
+unsigned UnresizeImplV::get_simultaneous_lines() const
+{
+	return -1;
+}
+
+unsigned UnresizeImplV::get_max_buffering() const
+{
+	return -1;
+}
+
+void UnresizeImplV::process(void *, const ZimgImageBufferConst &src, const ZimgImageBuffer &dst, void *, unsigned, unsigned, unsigned) const
+{
+	_zassert_d(src.mask[0] == (unsigned)-1 && dst.mask[0] == (unsigned)-1, "entire plane must be buffered");
+
+	int pxsize = pixel_size(m_attr.type);
+	ImagePlane<const void> src_plane{ src.data[0], (int)m_attr.width, m_context.src_width, (int)(src.stride[0] / pxsize), m_attr.type };
+	ImagePlane<void> dst_plane{ dst.data[0], (int)m_attr.width, (int)m_attr.height, (int)(dst.stride[0] / pxsize), m_attr.type };
+
+	process_plane(src_plane, dst_plane);
+}
+
+
+IZimgFilter *create_unresize_impl2(const resize::Filter &f, PixelType type, bool horizontal, unsigned src_width, unsigned src_height, unsigned dst_width, unsigned dst_height,
+                                   double shift, CPUClass cpu)
+{
+	unsigned src_dim = horizontal ? src_width : src_height;
+	unsigned dst_dim = horizontal ? dst_width : dst_height;
+	IZimgFilter *ret = nullptr;
+
+	if (src_width != dst_width && src_height != dst_height)
+		throw zimg::error::InternalError{ "cannot unresize both width and height" };
+	if (dst_dim > src_dim)
+		throw zimg::error::IllegalArgument{ "input dimension must be greater than output" };
+	if (type != PixelType::HALF && type != PixelType::FLOAT)
+		throw zimg::error::UnsupportedOperation{ "pixel type not supported" };
+
+	BilinearContext context = create_unresize_context(f, dst_dim, src_dim, shift);
+
+#ifdef ZIMG_X86
+	if (horizontal)
+		ret = create_unresize_impl2_h_x86(context, dst_height, type, cpu);
+	else
+		ret = create_unresize_impl2_v_x86(context, dst_width, type, cpu);
+#endif
+	if (!ret && horizontal) {
+		if (type == PixelType::HALF)
+			ret = new UnresizeImplH_C<uint16_t, ScalarPolicy_F16>{ context, dst_height, type };
+		else
+			ret = new UnresizeImplH_C<float, ScalarPolicy_F32>{ context, dst_height, type };
+	} else if (!ret) {
+		if (type == PixelType::HALF)
+			ret = new UnresizeImplV_C<uint16_t, ScalarPolicy_F16>{ context, dst_width, type };
+		else
+			ret = new UnresizeImplV_C<float, ScalarPolicy_F32>{ context, dst_width, type };
+	}
+
+	return ret;
+}
+
 } // namespace unresize
 } // namespace zimg
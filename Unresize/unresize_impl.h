@@ -3,17 +3,28 @@
 #ifndef ZIMG_UNRESIZE_UNRESIZE_IMPL_H_
 #define ZIMG_UNRESIZE_UNRESIZE_IMPL_H_
 
+#include <algorithm>
 #include <cstddef>
+#include <cstdint>
 #include "Common/osdep.h"
 #include "Common/plane.h"
+#include "Common/zfilter.h"
+#include "Depth/quantize.h"
 #include "bilinear.h"
 
 namespace zimg {;
 
 enum class CPUClass;
+enum class PixelType;
 
 namespace unresize {;
 
+struct ScalarPolicy_F16 {
+	FORCE_INLINE float load(const uint16_t *src) { return depth::half_to_float(*src); }
+
+	FORCE_INLINE void store(uint16_t *dst, float x) { *dst = depth::float_to_half(x); }
+};
+
 struct ScalarPolicy_F32 {
 	FORCE_INLINE float load(const float *src) { return *src; }
 
@@ -21,13 +32,14 @@ struct ScalarPolicy_F32 {
 };
 
 template <class T, class Policy>
-inline FORCE_INLINE void filter_scanline_h_forward(const BilinearContext &ctx, const ImagePlane<const T> &src, T * RESTRICT tmp,
-                                                   ptrdiff_t i, ptrdiff_t j_begin, ptrdiff_t j_end, Policy policy)
+inline FORCE_INLINE void filter_scanline_h_forward(const BilinearContext &ctx, const T *src, T * RESTRICT tmp,
+                                                   ptrdiff_t j_begin, ptrdiff_t j_end, Policy policy)
 {
 	const float *c = ctx.lu_c.data();
 	const float *l = ctx.lu_l.data();
+	ptrdiff_t p = ctx.lu_bandwidth;
 
-	float z = j_begin ? policy.load(&src[i][j_begin - 1]) : 0;
+	float z = j_begin ? policy.load(&tmp[j_begin - 1]) : 0;
 
 	// Matrix-vector product, and forward substitution loop.
 	for (ptrdiff_t j = j_begin; j < j_end; ++j) {
@@ -37,26 +49,39 @@ inline FORCE_INLINE void filter_scanline_h_forward(const BilinearContext &ctx, c
 		float accum = 0;
 		for (ptrdiff_t k = 0; k < ctx.matrix_row_size; ++k) {
 			float coeff = row[k];
-			float x = policy.load(&src[i][left + k]);
+			float x = policy.load(&src[left + k]);
 			accum += coeff * x;
 		}
 
-		z = (accum - c[j] * z) * l[j];
+		// Outer diagonals of the band read the earlier results back from the buffer.
+		for (ptrdiff_t k = 2; k <= std::min(p, j); ++k) {
+			accum -= c[j * p + k - 1] * policy.load(&tmp[j - k]);
+		}
+
+		z = (accum - c[j * p] * z) * l[j];
 		policy.store(&tmp[j], z);
 	}
 }
 
 template <class T, class Policy>
-inline FORCE_INLINE void filter_scanline_h_back(const BilinearContext &ctx, const T * RESTRICT tmp, const ImagePlane<T> &dst,
-                                                ptrdiff_t i, ptrdiff_t j_begin, ptrdiff_t j_end, Policy policy)
+inline FORCE_INLINE void filter_scanline_h_back(const BilinearContext &ctx, const T * RESTRICT tmp, T *dst,
+                                                ptrdiff_t j_begin, ptrdiff_t j_end, Policy policy)
 {
 	const float *u = ctx.lu_u.data();
-	float w = j_begin < ctx.dst_width ? policy.load(&dst[i][j_begin]) : 0;
+	ptrdiff_t p = ctx.lu_bandwidth;
+
+	float w = j_begin < ctx.dst_width ? policy.load(&dst[j_begin]) : 0;
 
 	// Backward substitution.
 	for (ptrdiff_t j = j_begin; j > j_end; --j) {
-		w = policy.load(&tmp[j - 1]) - u[j - 1] * w;
-		policy.store(&dst[i][j - 1], w);
+		float z = policy.load(&tmp[j - 1]);
+
+		for (ptrdiff_t k = 2; k <= std::min(p, ctx.dst_width - j); ++k) {
+			z -= u[(j - 1) * p + k - 1] * policy.load(&dst[j - 1 + k]);
+		}
+
+		w = z - u[(j - 1) * p] * w;
+		policy.store(&dst[j - 1], w);
 	}
 }
 
@@ -66,6 +91,7 @@ inline FORCE_INLINE void filter_scanline_v_forward(const BilinearContext &ctx, c
 {
 	const float *c = ctx.lu_c.data();
 	const float *l = ctx.lu_l.data();
+	ptrdiff_t p = ctx.lu_bandwidth;
 
 	const float *row = ctx.matrix_coefficients.data() + i * ctx.matrix_row_stride;
 	ptrdiff_t top = ctx.matrix_row_offsets[i];
@@ -80,7 +106,11 @@ inline FORCE_INLINE void filter_scanline_v_forward(const BilinearContext &ctx, c
 			accum += coeff * x;
 		}
 
-		z = (accum - c[i] * z) * l[i];
+		for (ptrdiff_t k = 2; k <= std::min(p, i); ++k) {
+			accum -= c[i * p + k - 1] * policy.load(&dst[i - k][j]);
+		}
+
+		z = (accum - c[i * p] * z) * l[i];
 		policy.store(&dst[i][j], z);
 	}
 }
@@ -89,11 +119,17 @@ template <class T, class Policy>
 inline FORCE_INLINE void filter_scanline_v_back(const BilinearContext &ctx, const ImagePlane<T> &dst, ptrdiff_t i, ptrdiff_t j_begin, ptrdiff_t j_end, Policy policy)
 {
 	const float *u = ctx.lu_u.data();
+	ptrdiff_t p = ctx.lu_bandwidth;
 
 	for (ptrdiff_t j = j_begin; j < j_end; ++j) {
 		float w = i < ctx.dst_width ? policy.load(&dst[i][j]) : 0;
+		float z = policy.load(&dst[i - 1][j]);
 
-		w = policy.load(&dst[i - 1][j]) - u[i - 1] * w;
+		for (ptrdiff_t k = 2; k <= std::min(p, ctx.dst_width - i); ++k) {
+			z -= u[(i - 1) * p + k - 1] * policy.load(&dst[i - 1 + k][j]);
+		}
+
+		w = z - u[(i - 1) * p] * w;
 		policy.store(&dst[i - 1][j], w);
 	}
 }
@@ -143,6 +179,80 @@ public:
  */
 UnresizeImpl *create_unresize_impl(int src_width, int src_height, int dst_width, int dst_height, float shift_w, float shift_h, CPUClass cpu);
 
+
+/**
+ * Base class for horizontal unresize filters.
+ *
+ * Each output row depends on the entire input row.
+ */
+class UnresizeImplH : public ZimgFilter {
+protected:
+	BilinearContext m_context;
+	image_attributes m_attr;
+
+	UnresizeImplH(const BilinearContext &context, const image_attributes &attr);
+public:
+	ZimgFilterFlags get_flags() const override;
+
+	image_attributes get_image_attributes() const override;
+
+	pair_unsigned get_required_row_range(unsigned i) const override;
+
+	pair_unsigned get_required_col_range(unsigned left, unsigned right) const override;
+
+	unsigned get_max_buffering() const override;
+};
+
+/**
+ * Base class for vertical unresize filters.
+ *
+ * Each output column depends on the entire input column, so the whole plane
+ * is produced in a single call.
+ */
+class UnresizeImplV : public ZimgFilter {
+protected:
+	BilinearContext m_context;
+	image_attributes m_attr;
+
+	UnresizeImplV(const BilinearContext &context, const image_attributes &attr);
+
+	virtual void process_plane(const ImagePlane<const void> &src, const ImagePlane<void> &dst) const = 0;
+public:
+	ZimgFilterFlags get_flags() const override;
+
+	image_attributes get_image_attributes() const override;
+
+	pair_unsigned get_required_row_range(unsigned i) const override;
+
+	pair_unsigned get_required_col_range(unsigned left, unsigned right) const override;
+
+	unsigned get_simultaneous_lines() const override;
+
+	unsigned get_max_buffering() const override;
+
+	void process(void *ctx, const ZimgImageBufferConst &src, const ZimgImageBuffer &dst, void *tmp, unsigned i, unsigned left, unsigned right) const override;
+};
+
+/**
+ * Create a filter to unresize a single dimension.
+ *
+ * @param f resampling filter used to upsample the image
+ * @param type pixel type, must be HALF or FLOAT
+ * @param horizontal whether to unresize the width
+ * @param src_width upsampled image width
+ * @param src_height upsampled image height
+ * @param dst_width unresized image width
+ * @param dst_height unresized image height
+ * @param shift center shift relative to upsampled image
+ * @param cpu create filter optimized for given cpu
+ * @return concrete filter
+ * @throws IllegalArgument on invalid dimensions
+ * @throws ResamplingNotAvailable if the filter is too wide for the dimensions
+ * @throws UnsupportedOperation if pixel type not supported
+ */
+IZimgFilter *create_unresize_impl2(const resize::Filter &f, PixelType type, bool horizontal, unsigned src_width, unsigned src_height, unsigned dst_width, unsigned dst_height,
+                                   double shift, CPUClass cpu);
+
 } // namespace unresize
 } // namespace zimg
 
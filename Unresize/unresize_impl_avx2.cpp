@@ -1,6 +1,9 @@
 #ifdef ZIMG_X86
+#include <algorithm>
 #include <immintrin.h>
+#include "Common/linebuffer.h"
 #include "Common/osdep.h"
+#include "Common/pixel.h"
 #include "bilinear.h"
 #include "unresize_impl.h"
 #include "unresize_impl_x86.h"
@@ -61,197 +64,175 @@ inline FORCE_INLINE void transpose8_ps(__m256 &row0, __m256 &row1, __m256 &row2,
 	row7 = _mm256_permute2f128_ps(tt3, tt7, 0x31);
 }
 
+// Unresize eight rows at once. Each lane of the SIMD registers holds one row.
 template <bool DoLoop, class T, class Policy>
-void filter_plane_h_avx2(const BilinearContext &ctx, const ImagePlane<const T> &src, const ImagePlane<T> &dst, T *tmp, Policy policy)
+void filter_line8_h_avx2(const BilinearContext &ctx, const T * const *src_ptr, T * const *dst_ptr, int src_width, T *tmp, Policy policy)
 {
 	const float *matrix_data = ctx.matrix_coefficients.data();
 	const int *matrix_left = ctx.matrix_row_offsets.data();
 	ptrdiff_t matrix_stride = ctx.matrix_row_stride;
 
-	int src_width = src.width();
-	int src_height = src.height();
-
 	const float *pc = ctx.lu_c.data();
 	const float *pl = ctx.lu_l.data();
 	const float *pu = ctx.lu_u.data();
+	ptrdiff_t p = ctx.lu_bandwidth;
 
-	for (ptrdiff_t i = 0; i < mod(src_height, 8); i += 8) {
-		const T *src_ptr0 = src[i + 0];
-		const T *src_ptr1 = src[i + 1];
-		const T *src_ptr2 = src[i + 2];
-		const T *src_ptr3 = src[i + 3];
-		const T *src_ptr4 = src[i + 4];
-		const T *src_ptr5 = src[i + 5];
-		const T *src_ptr6 = src[i + 6];
-		const T *src_ptr7 = src[i + 7];
-
-		T *dst_ptr0 = dst[i + 0];
-		T *dst_ptr1 = dst[i + 1];
-		T *dst_ptr2 = dst[i + 2];
-		T *dst_ptr3 = dst[i + 3];
-		T *dst_ptr4 = dst[i + 4];
-		T *dst_ptr5 = dst[i + 5];
-		T *dst_ptr6 = dst[i + 6];
-		T *dst_ptr7 = dst[i + 7];
-
-		ptrdiff_t j;
-
-		// Input, matrix-vector product, and forward substitution loop.
-		__m256 z = _mm256_setzero_ps();
-		for (j = 0; j < ctx.dst_width; ++j) {
-			const float *matrix_row = &matrix_data[j * matrix_stride];
-			ptrdiff_t left = matrix_left[j];
-
-			if (left + matrix_stride > src_width)
-				break;
-
-			// Matrix-vector product.
-			__m256 accum0 = _mm256_setzero_ps();
-			__m256 accum1 = _mm256_setzero_ps();
-			__m256 accum2 = _mm256_setzero_ps();
-			__m256 accum3 = _mm256_setzero_ps();
-
-			for (ptrdiff_t k = 0; k < (DoLoop ? ctx.matrix_row_size : 8); k += 8) {
-				__m256 coeffs = _mm256_loadu_ps(&matrix_row[k]);
-				__m256 v0, v1, v2, v3, v4, v5, v6, v7;
-
-				v0 = policy.loadu_8(&src_ptr0[left + k]);
-				v0 = _mm256_mul_ps(coeffs, v0);
-
-				v1 = policy.loadu_8(&src_ptr1[left + k]);
-				v1 = _mm256_mul_ps(coeffs, v1);
-
-				v2 = policy.loadu_8(&src_ptr2[left + k]);
-				v2 = _mm256_mul_ps(coeffs, v2);
-
-				v3 = policy.loadu_8(&src_ptr3[left + k]);
-				v3 = _mm256_mul_ps(coeffs, v3);
-
-				v4 = policy.loadu_8(&src_ptr4[left + k]);
-				v4 = _mm256_mul_ps(coeffs, v4);
-
-				v5 = policy.loadu_8(&src_ptr5[left + k]);
-				v5 = _mm256_mul_ps(coeffs, v5);
-
-				v6 = policy.loadu_8(&src_ptr6[left + k]);
-				v6 = _mm256_mul_ps(coeffs, v6);
-
-				v7 = policy.loadu_8(&src_ptr7[left + k]);
-				v7 = _mm256_mul_ps(coeffs, v7);
-
-				transpose8_ps(v0, v1, v2, v3, v4, v5, v6, v7);
-
-				accum0 = _mm256_add_ps(accum0, v0);
-				accum1 = _mm256_add_ps(accum1, v1);
-				accum2 = _mm256_add_ps(accum2, v2);
-				accum3 = _mm256_add_ps(accum3, v3);
-				accum0 = _mm256_add_ps(accum0, v4);
-				accum1 = _mm256_add_ps(accum1, v5);
-				accum2 = _mm256_add_ps(accum2, v6);
-				accum3 = _mm256_add_ps(accum3, v7);
-			}
+	ptrdiff_t j;
 
-			// Forward substitution.
-			accum0 = _mm256_add_ps(accum0, accum2);
-			accum1 = _mm256_add_ps(accum1, accum3);
+	// Input, matrix-vector product, and forward substitution loop.
+	__m256 z = _mm256_setzero_ps();
+	for (j = 0; j < ctx.dst_width; ++j) {
+		const float *matrix_row = &matrix_data[j * matrix_stride];
+		ptrdiff_t left = matrix_left[j];
 
-			__m256 f = _mm256_add_ps(accum0, accum1);
-			__m256 c = _mm256_broadcast_ss(&pc[j]);
-			__m256 l = _mm256_broadcast_ss(&pl[j]);
+		if (left + matrix_stride > src_width)
+			break;
 
-			z = _mm256_fnmadd_ps(c, z, f);
-			z = _mm256_mul_ps(z, l);
+		// Matrix-vector product.
+		__m256 accum0 = _mm256_setzero_ps();
+		__m256 accum1 = _mm256_setzero_ps();
+		__m256 accum2 = _mm256_setzero_ps();
+		__m256 accum3 = _mm256_setzero_ps();
+
+		for (ptrdiff_t k = 0; k < (DoLoop ? ctx.matrix_row_size : 8); k += 8) {
+			__m256 coeffs = _mm256_loadu_ps(&matrix_row[k]);
+			__m256 v0, v1, v2, v3, v4, v5, v6, v7;
+
+			v0 = policy.loadu_8(&src_ptr[0][left + k]);
+			v0 = _mm256_mul_ps(coeffs, v0);
+
+			v1 = policy.loadu_8(&src_ptr[1][left + k]);
+			v1 = _mm256_mul_ps(coeffs, v1);
 
-			policy.store_8(&tmp[j * 8], z);
+			v2 = policy.loadu_8(&src_ptr[2][left + k]);
+			v2 = _mm256_mul_ps(coeffs, v2);
+
+			v3 = policy.loadu_8(&src_ptr[3][left + k]);
+			v3 = _mm256_mul_ps(coeffs, v3);
+
+			v4 = policy.loadu_8(&src_ptr[4][left + k]);
+			v4 = _mm256_mul_ps(coeffs, v4);
+
+			v5 = policy.loadu_8(&src_ptr[5][left + k]);
+			v5 = _mm256_mul_ps(coeffs, v5);
+
+			v6 = policy.loadu_8(&src_ptr[6][left + k]);
+			v6 = _mm256_mul_ps(coeffs, v6);
+
+			v7 = policy.loadu_8(&src_ptr[7][left + k]);
+			v7 = _mm256_mul_ps(coeffs, v7);
+
+			transpose8_ps(v0, v1, v2, v3, v4, v5, v6, v7);
+
+			accum0 = _mm256_add_ps(accum0, v0);
+			accum1 = _mm256_add_ps(accum1, v1);
+			accum2 = _mm256_add_ps(accum2, v2);
+			accum3 = _mm256_add_ps(accum3, v3);
+			accum0 = _mm256_add_ps(accum0, v4);
+			accum1 = _mm256_add_ps(accum1, v5);
+			accum2 = _mm256_add_ps(accum2, v6);
+			accum3 = _mm256_add_ps(accum3, v7);
 		}
-		// Handle remainder of line.
-		for (; j < ctx.dst_width; ++j) {
-			const float *matrix_row = &matrix_data[j * matrix_stride];
-			ptrdiff_t left = matrix_left[j];
 
-			for (ptrdiff_t ii = 0; ii < 8; ++ii) {
-				float accum = 0;
+		// Forward substitution.
+		accum0 = _mm256_add_ps(accum0, accum2);
+		accum1 = _mm256_add_ps(accum1, accum3);
 
-				for (ptrdiff_t k = 0; k < ctx.matrix_row_size; ++k) {
-					accum += matrix_row[k] * policy.load(&src[i + ii][left + k]);
-				}
-				policy.store(&tmp[j * 8 + ii], (accum - pc[j] * policy.load(&tmp[(j - 1) * 8 + ii])) * pl[j]);
+		__m256 f = _mm256_add_ps(accum0, accum1);
+		__m256 c = _mm256_broadcast_ss(&pc[j * p]);
+		__m256 l = _mm256_broadcast_ss(&pl[j]);
+
+		// Outer diagonals of the band read the earlier results back from the buffer.
+		for (ptrdiff_t k = 2; k <= std::min(p, j); ++k) {
+			f = _mm256_fnmadd_ps(_mm256_broadcast_ss(&pc[j * p + k - 1]), policy.load_8(&tmp[(j - k) * 8]), f);
+		}
+
+		z = _mm256_fnmadd_ps(c, z, f);
+		z = _mm256_mul_ps(z, l);
+
+		policy.store_8(&tmp[j * 8], z);
+	}
+	// Handle remainder of line.
+	for (; j < ctx.dst_width; ++j) {
+		const float *matrix_row = &matrix_data[j * matrix_stride];
+		ptrdiff_t left = matrix_left[j];
+
+		for (ptrdiff_t ii = 0; ii < 8; ++ii) {
+			float accum = 0;
+
+			for (ptrdiff_t k = 0; k < ctx.matrix_row_size; ++k) {
+				accum += matrix_row[k] * policy.load(&src_ptr[ii][left + k]);
+			}
+			for (ptrdiff_t k = 2; k <= std::min(p, j); ++k) {
+				accum -= pc[j * p + k - 1] * policy.load(&tmp[(j - k) * 8 + ii]);
 			}
+			policy.store(&tmp[j * 8 + ii], (accum - pc[j * p] * policy.load(&tmp[(j - 1) * 8 + ii])) * pl[j]);
 		}
+	}
 
-		// Backward substitution and output loop.
-		__m256 w = _mm256_setzero_ps();
-		for (ptrdiff_t j = ctx.dst_width; j > mod(ctx.dst_width, 8); --j) {
-			float w_buf[8];
+	// Backward substitution and output loop.
+	__m256 w = _mm256_setzero_ps();
+	for (ptrdiff_t j = ctx.dst_width; j > mod(ctx.dst_width, 8); --j) {
+		float w_buf[8];
 
-			_mm256_storeu_ps(w_buf, w);
-			for (ptrdiff_t ii = 0; ii < 8; ++ii) {
-				w_buf[ii] = policy.load(&tmp[(j - 1) * 8 + ii]) - pu[j - 1] * w_buf[ii];
-				policy.store(&dst[i + ii][j - 1], w_buf[ii]);
+		_mm256_storeu_ps(w_buf, w);
+		for (ptrdiff_t ii = 0; ii < 8; ++ii) {
+			float z = policy.load(&tmp[(j - 1) * 8 + ii]);
+
+			for (ptrdiff_t k = 2; k <= std::min(p, ctx.dst_width - j); ++k) {
+				z -= pu[(j - 1) * p + k - 1] * policy.load(&tmp[(j - 1 + k) * 8 + ii]);
 			}
-			w = _mm256_loadu_ps(w_buf);
+
+			// The result replaces the forward substitution, to be read by the outer diagonals.
+			w_buf[ii] = z - pu[(j - 1) * p] * w_buf[ii];
+			policy.store(&tmp[(j - 1) * 8 + ii], w_buf[ii]);
+			policy.store(&dst_ptr[ii][j - 1], w_buf[ii]);
 		}
-		for (ptrdiff_t j = mod(ctx.dst_width, 8); j > 0; j -= 8) {
-			__m256 u0, u1, u2, u3, u4, u5, u6, u7;
-			__m256 z0, z1, z2, z3, z4, z5, z6, z7;
-			__m256 w0, w1, w2, w3, w4, w5, w6, w7;
-
-			z7 = policy.load_8(&tmp[(j - 1) * 8]);
-			z6 = policy.load_8(&tmp[(j - 2) * 8]);
-			z5 = policy.load_8(&tmp[(j - 3) * 8]);
-			z4 = policy.load_8(&tmp[(j - 4) * 8]);
-			z3 = policy.load_8(&tmp[(j - 5) * 8]);
-			z2 = policy.load_8(&tmp[(j - 6) * 8]);
-			z1 = policy.load_8(&tmp[(j - 7) * 8]);
-			z0 = policy.load_8(&tmp[(j - 8) * 8]);
-
-			u7 = _mm256_broadcast_ss(&pu[j - 1]);
-			w = _mm256_fnmadd_ps(u7, w, z7);
-			w7 = w;
-
-			u6 = _mm256_broadcast_ss(&pu[j - 2]);
-			w = _mm256_fnmadd_ps(u6, w, z6);
-			w6 = w;
-
-			u5 = _mm256_broadcast_ss(&pu[j - 3]);
-			w = _mm256_fnmadd_ps(u5, w, z5);
-			w5 = w;
-
-			u4 = _mm256_broadcast_ss(&pu[j - 4]);
-			w = _mm256_fnmadd_ps(u4, w, z4);
-			w4 = w;
-
-			u3 = _mm256_broadcast_ss(&pu[j - 5]);
-			w = _mm256_fnmadd_ps(u3, w, z3);
-			w3 = w;
-
-			u2 = _mm256_broadcast_ss(&pu[j - 6]);
-			w = _mm256_fnmadd_ps(u2, w, z2);
-			w2 = w;
-
-			u1 = _mm256_broadcast_ss(&pu[j - 7]);
-			w = _mm256_fnmadd_ps(u1, w, z1);
-			w1 = w;
-
-			u0 = _mm256_broadcast_ss(&pu[j - 8]);
-			w = _mm256_fnmadd_ps(u0, w, z0);
-			w0 = w;
-
-			transpose8_ps(w0, w1, w2, w3, w4, w5, w6, w7);
-
-			policy.store_8(&dst_ptr0[j - 8], w0);
-			policy.store_8(&dst_ptr1[j - 8], w1);
-			policy.store_8(&dst_ptr2[j - 8], w2);
-			policy.store_8(&dst_ptr3[j - 8], w3);
-			policy.store_8(&dst_ptr4[j - 8], w4);
-			policy.store_8(&dst_ptr5[j - 8], w5);
-			policy.store_8(&dst_ptr6[j - 8], w6);
-			policy.store_8(&dst_ptr7[j - 8], w7);
+		w = _mm256_loadu_ps(w_buf);
+	}
+	for (ptrdiff_t j = mod(ctx.dst_width, 8); j > 0; j -= 8) {
+		__m256 x[8];
+
+		for (ptrdiff_t n = 7; n >= 0; --n) {
+			ptrdiff_t jj = j - 8 + n;
+			__m256 z = policy.load_8(&tmp[jj * 8]);
+
+			for (ptrdiff_t k = 2; k <= std::min(p, ctx.dst_width - jj - 1); ++k) {
+				z = _mm256_fnmadd_ps(_mm256_broadcast_ss(&pu[jj * p + k - 1]), policy.load_8(&tmp[(jj + k) * 8]), z);
+			}
+
+			__m256 u = _mm256_broadcast_ss(&pu[jj * p]);
+			w = _mm256_fnmadd_ps(u, w, z);
+
+			if (p > 1)
+				policy.store_8(&tmp[jj * 8], w);
+
+			x[n] = w;
+		}
+
+		transpose8_ps(x[0], x[1], x[2], x[3], x[4], x[5], x[6], x[7]);
+
+		for (ptrdiff_t ii = 0; ii < 8; ++ii) {
+			policy.store_8(&dst_ptr[ii][j - 8], x[ii]);
 		}
 	}
+}
+
+template <bool DoLoop, class T, class Policy>
+void filter_plane_h_avx2(const BilinearContext &ctx, const ImagePlane<const T> &src, const ImagePlane<T> &dst, T *tmp, Policy policy)
+{
+	int src_width = src.width();
+	int src_height = src.height();
+
+	for (ptrdiff_t i = 0; i < mod(src_height, 8); i += 8) {
+		const T *src_ptr[8] = { src[i + 0], src[i + 1], src[i + 2], src[i + 3], src[i + 4], src[i + 5], src[i + 6], src[i + 7] };
+		T *dst_ptr[8] = { dst[i + 0], dst[i + 1], dst[i + 2], dst[i + 3], dst[i + 4], dst[i + 5], dst[i + 6], dst[i + 7] };
+
+		filter_line8_h_avx2<DoLoop>(ctx, src_ptr, dst_ptr, src_width, tmp, policy);
+	}
 	for (ptrdiff_t i = mod(src_height, 8); i < src_height; ++i) {
-		filter_scanline_h_forward(ctx, src, tmp, i, 0, ctx.dst_width, policy);
-		filter_scanline_h_back(ctx, tmp, dst, i, ctx.dst_width, 0, policy);
+		filter_scanline_h_forward(ctx, src[i], tmp, 0, ctx.dst_width, policy);
+		filter_scanline_h_back(ctx, tmp, dst[i], ctx.dst_width, 0, policy);
 	}
 }
 
@@ -267,6 +248,7 @@ void filter_plane_v_avx2(const BilinearContext &ctx, const ImagePlane<const T> &
 	const float *pc = ctx.lu_c.data();
 	const float *pl = ctx.lu_l.data();
 	const float *pu = ctx.lu_u.data();
+	ptrdiff_t p = ctx.lu_bandwidth;
 
 	for (ptrdiff_t i = 0; i < ctx.dst_width; ++i) {
 		const float *matrix_row = &matrix_data[i * matrix_stride];
@@ -388,7 +370,7 @@ void filter_plane_v_avx2(const BilinearContext &ctx, const ImagePlane<const T> &
 		}
 
 		// Forward substitution.
-		__m256 c = _mm256_broadcast_ss(&pc[i]);
+		__m256 c = _mm256_broadcast_ss(&pc[i * p]);
 		__m256 l = _mm256_broadcast_ss(&pl[i]);
 
 		const T *dst_prev = i ? dst[i - 1] : nullptr;
@@ -397,6 +379,10 @@ void filter_plane_v_avx2(const BilinearContext &ctx, const ImagePlane<const T> &
 			__m256 z = i ? policy.load_8(&dst_prev[j]) : _mm256_setzero_ps();
 			__m256 f = policy.load_8(&dst_ptr[j]);
 
+			for (ptrdiff_t k = 2; k <= std::min(p, i); ++k) {
+				f = _mm256_fnmadd_ps(_mm256_broadcast_ss(&pc[i * p + k - 1]), policy.load_8(&dst[i - k][j]), f);
+			}
+
 			z = _mm256_fnmadd_ps(c, z, f);
 			z = _mm256_mul_ps(z, l);
 
@@ -408,7 +394,7 @@ void filter_plane_v_avx2(const BilinearContext &ctx, const ImagePlane<const T> &
 
 	// Back substitution.
 	for (ptrdiff_t i = ctx.dst_width; i > 0; --i) {
-		__m256 u = _mm256_broadcast_ss(pu + i - 1);
+		__m256 u = _mm256_broadcast_ss(&pu[(i - 1) * p]);
 
 		const T *dst_prev = i < ctx.dst_width ? dst[i] : nullptr;
 		T *dst_ptr = dst[i - 1];
@@ -417,6 +403,10 @@ void filter_plane_v_avx2(const BilinearContext &ctx, const ImagePlane<const T> &
 			__m256 w = i < ctx.dst_width ? policy.load_8(&dst_prev[j]) : _mm256_setzero_ps();
 			__m256 z = policy.load_8(&dst_ptr[j]);
 
+			for (ptrdiff_t k = 2; k <= std::min(p, ctx.dst_width - i); ++k) {
+				z = _mm256_fnmadd_ps(_mm256_broadcast_ss(&pu[(i - 1) * p + k - 1]), policy.load_8(&dst[i - 1 + k][j]), z);
+			}
+
 			w = _mm256_fnmadd_ps(u, w, z);
 			policy.store_8(&dst_ptr[j], w);
 		}
@@ -456,6 +446,64 @@ public:
 	}
 };
 
+template <bool DoLoop, class T, class Policy>
+class UnresizeImplH_AVX2 final : public UnresizeImplH {
+public:
+	UnresizeImplH_AVX2(const BilinearContext &context, unsigned height, PixelType type) :
+		UnresizeImplH(context, image_attributes{ (unsigned)context.dst_width, height, type })
+	{}
+
+	unsigned get_simultaneous_lines() const override
+	{
+		return 8;
+	}
+
+	size_t get_tmp_size(unsigned, unsigned) const override
+	{
+		return m_context.dst_width * 8 * sizeof(T);
+	}
+
+	void process(void *, const ZimgImageBufferConst &src, const ZimgImageBuffer &dst, void *tmp, unsigned i, unsigned, unsigned) const override
+	{
+		LineBuffer<const T> src_buf{ src };
+		LineBuffer<T> dst_buf{ dst };
+
+		// Rows past the bottom of the image repeat the last row.
+		unsigned last = m_attr.height - 1;
+		const T *src_ptr[8];
+		T *dst_ptr[8];
+
+		for (unsigned ii = 0; ii < 8; ++ii) {
+			src_ptr[ii] = src_buf[std::min(i + ii, last)];
+			dst_ptr[ii] = dst_buf[std::min(i + ii, last)];
+		}
+
+		filter_line8_h_avx2<DoLoop>(m_context, src_ptr, dst_ptr, m_context.src_width, static_cast<T *>(tmp), Policy{});
+	}
+};
+
+template <class T, class Policy>
+class UnresizeImplV_AVX2 final : public UnresizeImplV {
+protected:
+	void process_plane(const ImagePlane<const void> &src, const ImagePlane<void> &dst) const override
+	{
+		filter_plane_v_avx2(m_context, plane_cast<const T>(src), plane_cast<T>(dst), Policy{});
+	}
+public:
+	UnresizeImplV_AVX2(const BilinearContext &context, unsigned width, PixelType type) :
+		UnresizeImplV(context, image_attributes{ width, (unsigned)context.dst_width, type })
+	{}
+};
+
+template <class T, class Policy>
+IZimgFilter *create_unresize_impl2_h_avx2_typed(const BilinearContext &context, unsigned height, PixelType type)
+{
+	if (context.matrix_row_size > 8)
+		return new UnresizeImplH_AVX2<true, T, Policy>{ context, height, type };
+	else
+		return new UnresizeImplH_AVX2<false, T, Policy>{ context, height, type };
+}
+
 } // namespace
 
 
@@ -464,6 +512,26 @@ UnresizeImpl *create_unresize_impl_avx2(const BilinearContext &hcontext, const B
 	return new UnresizeImplAVX2{ hcontext, vcontext };
 }
 
+IZimgFilter *create_unresize_impl2_h_avx2(const BilinearContext &context, unsigned height, PixelType type)
+{
+	if (type == PixelType::HALF)
+		return create_unresize_impl2_h_avx2_typed<uint16_t, VectorPolicy_F16>(context, height, type);
+	else if (type == PixelType::FLOAT)
+		return create_unresize_impl2_h_avx2_typed<float, VectorPolicy_F32>(context, height, type);
+	else
+		return nullptr;
+}
+
+IZimgFilter *create_unresize_impl2_v_avx2(const BilinearContext &context, unsigned width, PixelType type)
+{
+	if (type == PixelType::HALF)
+		return new UnresizeImplV_AVX2<uint16_t, VectorPolicy_F16>{ context, width, type };
+	else if (type == PixelType::FLOAT)
+		return new UnresizeImplV_AVX2<float, VectorPolicy_F32>{ context, width, type };
+	else
+		return nullptr;
+}
+
 } // namespace unresize
 } // namespace zimg
 
@@ -0,0 +1,246 @@
+#ifdef ZIMG_X86
+
+#include <algorithm>
+#include <cstdint>
+#include <immintrin.h>
+#include "Common/align.h"
+#include "Common/linebuffer.h"
+#include "Common/osdep.h"
+#include "Common/pixel.h"
+#include "Common/zfilter.h"
+#include "bilinear.h"
+#include "unresize_impl.h"
+#include "unresize_impl_x86.h"
+
+namespace zimg {;
+namespace unresize {;
+
+namespace {;
+
+struct VectorPolicy_F16 {
+	FORCE_INLINE __m512 maskz_loadu_16(__mmask16 mask, const uint16_t *src) { return _mm512_maskz_cvtph_ps(mask, _mm256_maskz_loadu_epi16(mask, src)); }
+
+	FORCE_INLINE void storeu_16(uint16_t *dst, __m512 x) { _mm256_storeu_si256((__m256i *)dst, _mm512_maskz_cvtps_ph(0xFFFF, x, 0)); }
+
+	FORCE_INLINE void store(uint16_t *dst, float x) { *dst = _mm_extract_epi16(_mm_cvtps_ph(_mm_set_ps1(x), 0), 0); }
+};
+
+struct VectorPolicy_F32 : public ScalarPolicy_F32 {
+	FORCE_INLINE __m512 maskz_loadu_16(__mmask16 mask, const float *src) { return _mm512_maskz_loadu_ps(mask, src); }
+
+	FORCE_INLINE void storeu_16(float *dst, __m512 x) { _mm512_storeu_ps(dst, x); }
+};
+
+inline FORCE_INLINE __mmask16 tail_mask16(ptrdiff_t n)
+{
+	return n >= 16 ? 0xFFFFU : (__mmask16)((1U << n) - 1);
+}
+
+inline FORCE_INLINE void transpose16_ps(__m512 x[16])
+{
+	// The zero-masked forms with a full mask compile to the same instructions, but
+	// avoid the undefined pass-through operand that GCC reports as uninitialized.
+	const __mmask16 all = 0xFFFF;
+	__m512 t[16];
+	__m512 u[16];
+
+	for (unsigned k = 0; k < 16; k += 2) {
+		t[k + 0] = _mm512_maskz_unpacklo_ps(all, x[k], x[k + 1]);
+		t[k + 1] = _mm512_maskz_unpackhi_ps(all, x[k], x[k + 1]);
+	}
+
+	// Transpose the 4x4 blocks within each 128-bit lane.
+	for (unsigned k = 0; k < 16; k += 4) {
+		u[k + 0] = _mm512_shuffle_ps(t[k + 0], t[k + 2], _MM_SHUFFLE(1, 0, 1, 0));
+		u[k + 1] = _mm512_shuffle_ps(t[k + 0], t[k + 2], _MM_SHUFFLE(3, 2, 3, 2));
+		u[k + 2] = _mm512_shuffle_ps(t[k + 1], t[k + 3], _MM_SHUFFLE(1, 0, 1, 0));
+		u[k + 3] = _mm512_shuffle_ps(t[k + 1], t[k + 3], _MM_SHUFFLE(3, 2, 3, 2));
+	}
+
+	// Transpose the 128-bit lanes.
+	for (unsigned k = 0; k < 4; ++k) {
+		__m512 v0 = _mm512_maskz_shuffle_f32x4(all, u[k + 0], u[k + 4], _MM_SHUFFLE(1, 0, 1, 0));
+		__m512 v1 = _mm512_maskz_shuffle_f32x4(all, u[k + 0], u[k + 4], _MM_SHUFFLE(3, 2, 3, 2));
+		__m512 v2 = _mm512_maskz_shuffle_f32x4(all, u[k + 8], u[k + 12], _MM_SHUFFLE(1, 0, 1, 0));
+		__m512 v3 = _mm512_maskz_shuffle_f32x4(all, u[k + 8], u[k + 12], _MM_SHUFFLE(3, 2, 3, 2));
+
+		x[k + 0] = _mm512_maskz_shuffle_f32x4(all, v0, v2, _MM_SHUFFLE(2, 0, 2, 0));
+		x[k + 4] = _mm512_maskz_shuffle_f32x4(all, v0, v2, _MM_SHUFFLE(3, 1, 3, 1));
+		x[k + 8] = _mm512_maskz_shuffle_f32x4(all, v1, v3, _MM_SHUFFLE(2, 0, 2, 0));
+		x[k + 12] = _mm512_maskz_shuffle_f32x4(all, v1, v3, _MM_SHUFFLE(3, 1, 3, 1));
+	}
+}
+
+// Transpose 16 rows into column-interleaved order, so that each column is one vector.
+template <class T, class Policy>
+void transpose_line_in(const T * const *src_ptr, float *dst, int src_width, Policy policy)
+{
+	for (ptrdiff_t j = 0; j < src_width; j += 16) {
+		__mmask16 mask = tail_mask16(src_width - j);
+		__m512 x[16];
+
+		for (unsigned ii = 0; ii < 16; ++ii) {
+			x[ii] = policy.maskz_loadu_16(mask, &src_ptr[ii][j]);
+		}
+
+		transpose16_ps(x);
+
+		for (unsigned n = 0; n < 16; ++n) {
+			_mm512_storeu_ps(&dst[(j + n) * 16], x[n]);
+		}
+	}
+}
+
+// Unresize sixteen rows at once. Each lane of the SIMD registers holds one row.
+template <class T, class Policy>
+void filter_line16_h_avx512(const BilinearContext &ctx, const T * const *src_ptr, T * const *dst_ptr, int src_width, float *tmp, Policy policy)
+{
+	const float *matrix_data = ctx.matrix_coefficients.data();
+	const int *matrix_left = ctx.matrix_row_offsets.data();
+	ptrdiff_t matrix_stride = ctx.matrix_row_stride;
+
+	const float *pc = ctx.lu_c.data();
+	const float *pl = ctx.lu_l.data();
+	const float *pu = ctx.lu_u.data();
+	ptrdiff_t p = ctx.lu_bandwidth;
+
+	float *src_t = tmp;
+	float *tmp_z = tmp + align(src_width, 16) * 16;
+
+	transpose_line_in(src_ptr, src_t, src_width, policy);
+
+	// Matrix-vector product and forward substitution loop.
+	__m512 z = _mm512_setzero_ps();
+	for (ptrdiff_t j = 0; j < ctx.dst_width; ++j) {
+		const float *matrix_row = &matrix_data[j * matrix_stride];
+		ptrdiff_t left = matrix_left[j];
+		ptrdiff_t row_size = std::min((ptrdiff_t)ctx.matrix_row_size, src_width - left);
+
+		__m512 accum0 = _mm512_setzero_ps();
+		__m512 accum1 = _mm512_setzero_ps();
+		ptrdiff_t k;
+
+		for (k = 0; k < row_size - 1; k += 2) {
+			accum0 = _mm512_fmadd_ps(_mm512_set1_ps(matrix_row[k + 0]), _mm512_loadu_ps(&src_t[(left + k + 0) * 16]), accum0);
+			accum1 = _mm512_fmadd_ps(_mm512_set1_ps(matrix_row[k + 1]), _mm512_loadu_ps(&src_t[(left + k + 1) * 16]), accum1);
+		}
+		if (k < row_size)
+			accum0 = _mm512_fmadd_ps(_mm512_set1_ps(matrix_row[k]), _mm512_loadu_ps(&src_t[(left + k) * 16]), accum0);
+
+		__m512 f = _mm512_add_ps(accum0, accum1);
+		__m512 c = _mm512_set1_ps(pc[j * p]);
+		__m512 l = _mm512_set1_ps(pl[j]);
+
+		// Outer diagonals of the band read the earlier results back from the buffer.
+		for (ptrdiff_t k = 2; k <= std::min(p, j); ++k) {
+			f = _mm512_fnmadd_ps(_mm512_set1_ps(pc[j * p + k - 1]), _mm512_loadu_ps(&tmp_z[(j - k) * 16]), f);
+		}
+
+		z = _mm512_fnmadd_ps(c, z, f);
+		z = _mm512_mul_ps(z, l);
+
+		_mm512_storeu_ps(&tmp_z[j * 16], z);
+	}
+
+	// Backward substitution and output loop.
+	__m512 w = _mm512_setzero_ps();
+	for (ptrdiff_t j = ctx.dst_width; j > mod(ctx.dst_width, 16); --j) {
+		float w_buf[16];
+
+		_mm512_storeu_ps(w_buf, w);
+		for (ptrdiff_t ii = 0; ii < 16; ++ii) {
+			float z = tmp_z[(j - 1) * 16 + ii];
+
+			for (ptrdiff_t k = 2; k <= std::min(p, ctx.dst_width - j); ++k) {
+				z -= pu[(j - 1) * p + k - 1] * tmp_z[(j - 1 + k) * 16 + ii];
+			}
+
+			// The result replaces the forward substitution, to be read by the outer diagonals.
+			w_buf[ii] = z - pu[(j - 1) * p] * w_buf[ii];
+			tmp_z[(j - 1) * 16 + ii] = w_buf[ii];
+			policy.store(&dst_ptr[ii][j - 1], w_buf[ii]);
+		}
+		w = _mm512_loadu_ps(w_buf);
+	}
+	for (ptrdiff_t j = mod(ctx.dst_width, 16); j > 0; j -= 16) {
+		__m512 x[16];
+
+		for (ptrdiff_t n = 15; n >= 0; --n) {
+			ptrdiff_t jj = j - 16 + n;
+			__m512 z = _mm512_loadu_ps(&tmp_z[jj * 16]);
+
+			for (ptrdiff_t k = 2; k <= std::min(p, ctx.dst_width - jj - 1); ++k) {
+				z = _mm512_fnmadd_ps(_mm512_set1_ps(pu[jj * p + k - 1]), _mm512_loadu_ps(&tmp_z[(jj + k) * 16]), z);
+			}
+
+			__m512 u = _mm512_set1_ps(pu[jj * p]);
+			w = _mm512_fnmadd_ps(u, w, z);
+
+			if (p > 1)
+				_mm512_storeu_ps(&tmp_z[jj * 16], w);
+
+			x[n] = w;
+		}
+
+		transpose16_ps(x);
+
+		for (unsigned ii = 0; ii < 16; ++ii) {
+			policy.storeu_16(&dst_ptr[ii][j - 16], x[ii]);
+		}
+	}
+}
+
+template <class T, class Policy>
+class UnresizeImplH_AVX512 final : public UnresizeImplH {
+public:
+	UnresizeImplH_AVX512(const BilinearContext &context, unsigned height, PixelType type) :
+		UnresizeImplH(context, image_attributes{ (unsigned)context.dst_width, height, type })
+	{}
+
+	unsigned get_simultaneous_lines() const override
+	{
+		return 16;
+	}
+
+	size_t get_tmp_size(unsigned, unsigned) const override
+	{
+		// Transposed input rows, followed by the forward substitution result.
+		return (align(m_context.src_width, 16) + m_context.dst_width) * 16 * sizeof(float);
+	}
+
+	void process(void *, const ZimgImageBufferConst &src, const ZimgImageBuffer &dst, void *tmp, unsigned i, unsigned, unsigned) const override
+	{
+		LineBuffer<const T> src_buf{ src };
+		LineBuffer<T> dst_buf{ dst };
+
+		// Rows past the bottom of the image repeat the last row.
+		unsigned last = m_attr.height - 1;
+		const T *src_ptr[16];
+		T *dst_ptr[16];
+
+		for (unsigned ii = 0; ii < 16; ++ii) {
+			src_ptr[ii] = src_buf[std::min(i + ii, last)];
+			dst_ptr[ii] = dst_buf[std::min(i + ii, last)];
+		}
+
+		filter_line16_h_avx512(m_context, src_ptr, dst_ptr, m_context.src_width, static_cast<float *>(tmp), Policy{});
+	}
+};
+
+} // namespace
+
+
+IZimgFilter *create_unresize_impl2_h_avx512(const BilinearContext &context, unsigned height, PixelType type)
+{
+	if (type == PixelType::HALF)
+		return new UnresizeImplH_AVX512<uint16_t, VectorPolicy_F16>{ context, height, type };
+	else if (type == PixelType::FLOAT)
+		return new UnresizeImplH_AVX512<float, VectorPolicy_F32>{ context, height, type };
+	else
+		return nullptr;
+}
+
+} // namespace unresize
+} // namespace zimg
+
+#endif // ZIMG_X86
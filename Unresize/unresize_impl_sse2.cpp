@@ -1,8 +1,11 @@
 #ifdef ZIMG_X86
+#include <algorithm>
 #include <cstddef>
 #include <emmintrin.h>
 #include "Common/except.h"
+#include "Common/linebuffer.h"
 #include "Common/osdep.h"
+#include "Common/pixel.h"
 #include "bilinear.h"
 #include "unresize_impl.h"
 #include "unresize_impl_x86.h"
@@ -30,148 +33,156 @@ inline FORCE_INLINE void transpose4_ps(__m128 &x0, __m128 &x1, __m128 &x2, __m12
 	x3 = _mm_castpd_ps(o3);
 }
 
+// Unresize four rows at once. Each lane of the SIMD registers holds one row.
 template <bool DoLoop>
-void filter_plane_h_sse2(const BilinearContext &ctx, const ImagePlane<const float> &src, const ImagePlane<float> &dst, float *tmp)
+void filter_line4_h_sse2(const BilinearContext &ctx, const float * const *src_ptr, float * const *dst_ptr, int src_width, float *tmp)
 {
 	const float *matrix_data = ctx.matrix_coefficients.data();
 	const int *matrix_left = ctx.matrix_row_offsets.data();
 	ptrdiff_t matrix_stride = ctx.matrix_row_stride;
 
-	int src_width = src.width();
-	int src_height = src.height();
-
 	const float *pc = ctx.lu_c.data();
 	const float *pl = ctx.lu_l.data();
 	const float *pu = ctx.lu_u.data();
+	ptrdiff_t p = ctx.lu_bandwidth;
 
-	for (ptrdiff_t i = 0; i < mod(src_height, 4); i += 4) {
-		const float *src_ptr0 = src[i + 0];
-		const float *src_ptr1 = src[i + 1];
-		const float *src_ptr2 = src[i + 2];
-		const float *src_ptr3 = src[i + 3];
+	ptrdiff_t j;
 
-		float *dst_ptr0 = dst[i + 0];
-		float *dst_ptr1 = dst[i + 1];
-		float *dst_ptr2 = dst[i + 2];
-		float *dst_ptr3 = dst[i + 3];
+	// Input, matrix-vector product, and forward substitution loop.
+	__m128 z = _mm_setzero_ps();
+	for (j = 0; j < ctx.dst_width; ++j) {
+		const float *matrix_row = &matrix_data[j * matrix_stride];
+		ptrdiff_t left = matrix_left[j];
 
-		ptrdiff_t j;
+		if (left + matrix_stride > src_width)
+			break;
 
-		// Input, matrix-vector product, and forward substitution loop.
-		__m128 z = _mm_setzero_ps();
-		for (j = 0; j < ctx.dst_width; ++j) {
-			const float *matrix_row = &matrix_data[j * matrix_stride];
-			ptrdiff_t left = matrix_left[j];
+		// Matrix-vector product.
+		__m128 accum0 = _mm_setzero_ps();
+		__m128 accum1 = _mm_setzero_ps();
+		for (ptrdiff_t k = 0; k < (DoLoop ? ctx.matrix_row_size : 4); k += 4) {
+			__m128 coeffs = _mm_loadu_ps(&matrix_row[k]);
+			__m128 v0, v1, v2, v3;
 
-			if (left + matrix_stride > src_width)
-				break;
+			v0 = _mm_loadu_ps(&src_ptr[0][left + k]);
+			v0 = _mm_mul_ps(coeffs, v0);
 
-			// Matrix-vector product.
-			__m128 accum0 = _mm_setzero_ps();
-			__m128 accum1 = _mm_setzero_ps();
-			for (ptrdiff_t k = 0; k < (DoLoop ? ctx.matrix_row_size : 4); k += 4) {
-				__m128 coeffs = _mm_loadu_ps(&matrix_row[k]);
-				__m128 v0, v1, v2, v3;
+			v1 = _mm_loadu_ps(&src_ptr[1][left + k]);
+			v1 = _mm_mul_ps(coeffs, v1);
 
-				v0 = _mm_loadu_ps(&src_ptr0[left + k]);
-				v0 = _mm_mul_ps(coeffs, v0);
+			v2 = _mm_loadu_ps(&src_ptr[2][left + k]);
+			v2 = _mm_mul_ps(coeffs, v2);
 
-				v1 = _mm_loadu_ps(&src_ptr1[left + k]);
-				v1 = _mm_mul_ps(coeffs, v1);
+			v3 = _mm_loadu_ps(&src_ptr[3][left + k]);
+			v3 = _mm_mul_ps(coeffs, v3);
 
-				v2 = _mm_loadu_ps(&src_ptr2[left + k]);
-				v2 = _mm_mul_ps(coeffs, v2);
+			transpose4_ps(v0, v1, v2, v3);
 
-				v3 = _mm_loadu_ps(&src_ptr3[left + k]);
-				v3 = _mm_mul_ps(coeffs, v3);
+			accum0 = _mm_add_ps(accum0, v0);
+			accum1 = _mm_add_ps(accum1, v1);
+			accum0 = _mm_add_ps(accum0, v2);
+			accum1 = _mm_add_ps(accum1, v3);
+		}
 
-				transpose4_ps(v0, v1, v2, v3);
+		// Forward substitution.
+		__m128 f = _mm_add_ps(accum0, accum1);
+		__m128 c = _mm_set_ps1(pc[j * p]);
+		__m128 l = _mm_set_ps1(pl[j]);
 
-				accum0 = _mm_add_ps(accum0, v0);
-				accum1 = _mm_add_ps(accum1, v1);
-				accum0 = _mm_add_ps(accum0, v2);
-				accum1 = _mm_add_ps(accum1, v3);
-			}
+		// Outer diagonals of the band read the earlier results back from the buffer.
+		for (ptrdiff_t k = 2; k <= std::min(p, j); ++k) {
+			f = _mm_sub_ps(f, _mm_mul_ps(_mm_set_ps1(pc[j * p + k - 1]), _mm_load_ps(&tmp[(j - k) * 4])));
+		}
 
-			// Forward substitution.
-			__m128 f = _mm_add_ps(accum0, accum1);
-			__m128 c = _mm_set_ps1(pc[j]);
-			__m128 l = _mm_set_ps1(pl[j]);
+		z = _mm_mul_ps(c, z);
+		z = _mm_sub_ps(f, z);
+		z = _mm_mul_ps(z, l);
 
-			z = _mm_mul_ps(c, z);
-			z = _mm_sub_ps(f, z);
-			z = _mm_mul_ps(z, l);
+		_mm_store_ps(&tmp[j * 4], z);
+	}
+	// Handle remainder of line.
+	for (; j < ctx.dst_width; ++j) {
+		const float *matrix_row = &matrix_data[j * matrix_stride];
+		ptrdiff_t left = matrix_left[j];
+
+		for (ptrdiff_t ii = 0; ii < 4; ++ii) {
+			float accum = 0;
 
-			_mm_store_ps(&tmp[j * 4], z);
+			for (ptrdiff_t k = 0; k < ctx.matrix_row_size; ++k) {
+				accum += matrix_row[k] * src_ptr[ii][left + k];
+			}
+			for (ptrdiff_t k = 2; k <= std::min(p, j); ++k) {
+				accum -= pc[j * p + k - 1] * tmp[(j - k) * 4 + ii];
+			}
+			tmp[j * 4 + ii] = (accum - pc[j * p] * tmp[(j - 1) * 4 + ii]) * pl[j];
 		}
-		// Handle remainder of line.
-		for (; j < ctx.dst_width; ++j) {
-			const float *matrix_row = &matrix_data[j * matrix_stride];
-			ptrdiff_t left = matrix_left[j];
+	}
 
-			for (ptrdiff_t ii = 0; ii < 4; ++ii) {
-				float accum = 0;
+	// Backward substitution and output loop.
+	__m128 w = _mm_setzero_ps();
+	for (ptrdiff_t j = ctx.dst_width; j > mod(ctx.dst_width, 4); --j) {
+		float w_buf[4];
 
-				for (ptrdiff_t k = 0; k < ctx.matrix_row_size; ++k) {
-					accum += matrix_row[k] * src[i + ii][left + k];
-				}
-				tmp[j * 4 + ii] = (accum - pc[j] * tmp[(j - 1) * 4 + ii]) * pl[j];
+		_mm_storeu_ps(w_buf, w);
+		for (ptrdiff_t ii = 0; ii < 4; ++ii) {
+			float z = tmp[(j - 1) * 4 + ii];
+
+			for (ptrdiff_t k = 2; k <= std::min(p, ctx.dst_width - j); ++k) {
+				z -= pu[(j - 1) * p + k - 1] * tmp[(j - 1 + k) * 4 + ii];
 			}
+
+			// The result replaces the forward substitution, to be read by the outer diagonals.
+			w_buf[ii] = z - pu[(j - 1) * p] * w_buf[ii];
+			tmp[(j - 1) * 4 + ii] = w_buf[ii];
+			dst_ptr[ii][j - 1] = w_buf[ii];
 		}
+		w = _mm_loadu_ps(w_buf);
+	}
+	for (ptrdiff_t j = mod(ctx.dst_width, 4); j > 0; j -= 4) {
+		__m128 x[4];
 
-		// Backward substitution and output loop.
-		__m128 w = _mm_setzero_ps();
-		for (ptrdiff_t j = ctx.dst_width; j > mod(ctx.dst_width, 4); --j) {
-			float w_buf[4];
+		for (ptrdiff_t n = 3; n >= 0; --n) {
+			ptrdiff_t jj = j - 4 + n;
+			__m128 z = _mm_load_ps(&tmp[jj * 4]);
 
-			_mm_storeu_ps(w_buf, w);
-			for (ptrdiff_t ii = 0; ii < 4; ++ii) {
-				w_buf[ii] = tmp[(j - 1) * 4 + ii] - pu[j - 1] * w_buf[ii];
-				dst[i + ii][j - 1] = w_buf[ii];
+			for (ptrdiff_t k = 2; k <= std::min(p, ctx.dst_width - jj - 1); ++k) {
+				z = _mm_sub_ps(z, _mm_mul_ps(_mm_set_ps1(pu[jj * p + k - 1]), _mm_load_ps(&tmp[(jj + k) * 4])));
 			}
-			w = _mm_loadu_ps(w_buf);
-		}
-		for (ptrdiff_t j = mod(ctx.dst_width, 4); j > 0; j -= 4) {
-			__m128 u0, u1, u2, u3;
-			__m128 z0, z1, z2, z3;
-			__m128 w0, w1, w2, w3;
-
-			z3 = _mm_load_ps(&tmp[(j - 1) * 4]);
-			z2 = _mm_load_ps(&tmp[(j - 2) * 4]);
-			z1 = _mm_load_ps(&tmp[(j - 3) * 4]);
-			z0 = _mm_load_ps(&tmp[(j - 4) * 4]);
-
-			u3 = _mm_set_ps1(pu[j - 1]);
-			w = _mm_mul_ps(u3, w);
-			w = _mm_sub_ps(z3, w);
-			w3 = w;
-
-			u2 = _mm_set_ps1(pu[j - 2]);
-			w = _mm_mul_ps(u2, w);
-			w = _mm_sub_ps(z2, w);
-			w2 = w;
-
-			u1 = _mm_set_ps1(pu[j - 3]);
-			w = _mm_mul_ps(u1, w);
-			w = _mm_sub_ps(z1, w);
-			w1 = w;
-
-			u0 = _mm_set_ps1(pu[j - 4]);
-			w = _mm_mul_ps(u0, w);
-			w = _mm_sub_ps(z0, w);
-			w0 = w;
-
-			transpose4_ps(w0, w1, w2, w3);
-
-			_mm_store_ps(&dst_ptr0[j - 4], w0);
-			_mm_store_ps(&dst_ptr1[j - 4], w1);
-			_mm_store_ps(&dst_ptr2[j - 4], w2);
-			_mm_store_ps(&dst_ptr3[j - 4], w3);
+
+			__m128 u = _mm_set_ps1(pu[jj * p]);
+			w = _mm_mul_ps(u, w);
+			w = _mm_sub_ps(z, w);
+
+			if (p > 1)
+				_mm_store_ps(&tmp[jj * 4], w);
+
+			x[n] = w;
 		}
+
+		transpose4_ps(x[0], x[1], x[2], x[3]);
+
+		_mm_store_ps(&dst_ptr[0][j - 4], x[0]);
+		_mm_store_ps(&dst_ptr[1][j - 4], x[1]);
+		_mm_store_ps(&dst_ptr[2][j - 4], x[2]);
+		_mm_store_ps(&dst_ptr[3][j - 4], x[3]);
+	}
+}
+
+template <bool DoLoop>
+void filter_plane_h_sse2(const BilinearContext &ctx, const ImagePlane<const float> &src, const ImagePlane<float> &dst, float *tmp)
+{
+	int src_width = src.width();
+	int src_height = src.height();
+
+	for (ptrdiff_t i = 0; i < mod(src_height, 4); i += 4) {
+		const float *src_ptr[4] = { src[i + 0], src[i + 1], src[i + 2], src[i + 3] };
+		float *dst_ptr[4] = { dst[i + 0], dst[i + 1], dst[i + 2], dst[i + 3] };
+
+		filter_line4_h_sse2<DoLoop>(ctx, src_ptr, dst_ptr, src_width, tmp);
 	}
 	for (ptrdiff_t i = mod(src_height, 4); i < src_height; ++i) {
-		filter_scanline_h_forward(ctx, src, tmp, i, 0, ctx.dst_width, ScalarPolicy_F32{});
-		filter_scanline_h_back(ctx, tmp, dst, i, ctx.dst_width, 0, ScalarPolicy_F32{});
+		filter_scanline_h_forward(ctx, src[i], tmp, 0, ctx.dst_width, ScalarPolicy_F32{});
+		filter_scanline_h_back(ctx, tmp, dst[i], ctx.dst_width, 0, ScalarPolicy_F32{});
 	}
 }
 
@@ -186,6 +197,7 @@ void filter_plane_v_sse2(const BilinearContext &ctx, const ImagePlane<const floa
 	const float *pc = ctx.lu_c.data();
 	const float *pl = ctx.lu_l.data();
 	const float *pu = ctx.lu_u.data();
+	ptrdiff_t p = ctx.lu_bandwidth;
 
 	for (ptrdiff_t i = 0; i < ctx.dst_width; ++i) {
 		const float *matrix_row = &matrix_data[i * matrix_stride];
@@ -272,7 +284,7 @@ void filter_plane_v_sse2(const BilinearContext &ctx, const ImagePlane<const floa
 		}
 
 		// Forward substitution.
-		__m128 c = _mm_set_ps1(pc[i]);
+		__m128 c = _mm_set_ps1(pc[i * p]);
 		__m128 l = _mm_set_ps1(pl[i]);
 
 		const float *dst_prev = i ? dst[i - 1] : nullptr;
@@ -281,6 +293,10 @@ void filter_plane_v_sse2(const BilinearContext &ctx, const ImagePlane<const floa
 			__m128 z = i ? _mm_load_ps(&dst_prev[j]) : _mm_setzero_ps();
 			__m128 f = _mm_load_ps(&dst_ptr[j]);
 
+			for (ptrdiff_t k = 2; k <= std::min(p, i); ++k) {
+				f = _mm_sub_ps(f, _mm_mul_ps(_mm_set_ps1(pc[i * p + k - 1]), _mm_load_ps(&dst[i - k][j])));
+			}
+
 			z = _mm_mul_ps(c, z);
 			z = _mm_sub_ps(f, z);
 			z = _mm_mul_ps(z, l);
@@ -292,7 +308,7 @@ void filter_plane_v_sse2(const BilinearContext &ctx, const ImagePlane<const floa
 
 	// Back substitution.
 	for (ptrdiff_t i = ctx.dst_width; i > 0; --i) {
-		__m128 u = _mm_set_ps1(pu[i - 1]);
+		__m128 u = _mm_set_ps1(pu[(i - 1) * p]);
 
 		const float *dst_prev = i < ctx.dst_width ? dst[i] : nullptr;
 		float *dst_ptr = dst[i - 1];
@@ -301,6 +317,10 @@ void filter_plane_v_sse2(const BilinearContext &ctx, const ImagePlane<const floa
 			__m128 w = i < ctx.dst_width ? _mm_load_ps(&dst_prev[j]) : _mm_setzero_ps();
 			__m128 z = _mm_load_ps(&dst_ptr[j]);
 
+			for (ptrdiff_t k = 2; k <= std::min(p, ctx.dst_width - i); ++k) {
+				z = _mm_sub_ps(z, _mm_mul_ps(_mm_set_ps1(pu[(i - 1) * p + k - 1]), _mm_load_ps(&dst[i - 1 + k][j])));
+			}
+
 			w = _mm_mul_ps(u, w);
 			w = _mm_sub_ps(z, w);
 
@@ -339,6 +359,53 @@ public:
 	}
 };
 
+template <bool DoLoop>
+class UnresizeImplH_SSE2 final : public UnresizeImplH {
+public:
+	UnresizeImplH_SSE2(const BilinearContext &context, unsigned height) :
+		UnresizeImplH(context, image_attributes{ (unsigned)context.dst_width, height, PixelType::FLOAT })
+	{}
+
+	unsigned get_simultaneous_lines() const override
+	{
+		return 4;
+	}
+
+	size_t get_tmp_size(unsigned, unsigned) const override
+	{
+		return m_context.dst_width * 4 * sizeof(float);
+	}
+
+	void process(void *, const ZimgImageBufferConst &src, const ZimgImageBuffer &dst, void *tmp, unsigned i, unsigned, unsigned) const override
+	{
+		LineBuffer<const float> src_buf{ src };
+		LineBuffer<float> dst_buf{ dst };
+
+		// Rows past the bottom of the image repeat the last row.
+		unsigned last = m_attr.height - 1;
+		const float *src_ptr[4];
+		float *dst_ptr[4];
+
+		for (unsigned ii = 0; ii < 4; ++ii) {
+			src_ptr[ii] = src_buf[std::min(i + ii, last)];
+			dst_ptr[ii] = dst_buf[std::min(i + ii, last)];
+		}
+
+		filter_line4_h_sse2<DoLoop>(m_context, src_ptr, dst_ptr, m_context.src_width, static_cast<float *>(tmp));
+	}
+};
+
+class UnresizeImplV_SSE2 final : public UnresizeImplV {
+protected:
+	void process_plane(const ImagePlane<const void> &src, const ImagePlane<void> &dst) const override
+	{
+		filter_plane_v_sse2(m_context, plane_cast<const float>(src), plane_cast<float>(dst));
+	}
+public:
+	UnresizeImplV_SSE2(const BilinearContext &context, unsigned width) :
+		UnresizeImplV(context, image_attributes{ width, (unsigned)context.dst_width, PixelType::FLOAT })
+	{}
+};
 
 } // namespace
 
@@ -348,6 +415,25 @@ UnresizeImpl *create_unresize_impl_sse2(const BilinearContext &hcontext, const B
 	return new UnresizeImplSSE2{ hcontext, vcontext };
 }
 
+IZimgFilter *create_unresize_impl2_h_sse2(const BilinearContext &context, unsigned height, PixelType type)
+{
+	if (type != PixelType::FLOAT)
+		return nullptr;
+
+	if (context.matrix_row_size > 4)
+		return new UnresizeImplH_SSE2<true>{ context, height };
+	else
+		return new UnresizeImplH_SSE2<false>{ context, height };
+}
+
+IZimgFilter *create_unresize_impl2_v_sse2(const BilinearContext &context, unsigned width, PixelType type)
+{
+	if (type != PixelType::FLOAT)
+		return nullptr;
+
+	return new UnresizeImplV_SSE2{ context, width };
+}
+
 } // namespace unresize
 } // namespace zimg
 
@@ -29,6 +29,52 @@ UnresizeImpl *create_unresize_impl_x86(const BilinearContext &hcontext, const Bi
 	return ret;
 }
 
+IZimgFilter *create_unresize_impl2_h_x86(const BilinearContext &context, unsigned height, PixelType type, CPUClass cpu)
+{
+	X86Capabilities caps = query_x86_capabilities();
+	IZimgFilter *ret = nullptr;
+
+	// Fall back to lower tiers for pixel types that a tier does not implement.
+	if (cpu == CPUClass::CPU_AUTO) {
+		if (!ret && caps.avx512f && caps.avx512bw && caps.avx512vl)
+			ret = create_unresize_impl2_h_avx512(context, height, type);
+		if (!ret && caps.avx2)
+			ret = create_unresize_impl2_h_avx2(context, height, type);
+		if (!ret && caps.sse2)
+			ret = create_unresize_impl2_h_sse2(context, height, type);
+	} else {
+		if (!ret && cpu >= CPUClass::CPU_X86_AVX512)
+			ret = create_unresize_impl2_h_avx512(context, height, type);
+		if (!ret && cpu >= CPUClass::CPU_X86_AVX2)
+			ret = create_unresize_impl2_h_avx2(context, height, type);
+		if (!ret && cpu >= CPUClass::CPU_X86_SSE2)
+			ret = create_unresize_impl2_h_sse2(context, height, type);
+	}
+
+	return ret;
+}
+
+IZimgFilter *create_unresize_impl2_v_x86(const BilinearContext &context, unsigned width, PixelType type, CPUClass cpu)
+{
+	X86Capabilities caps = query_x86_capabilities();
+	IZimgFilter *ret = nullptr;
+
+	// Fall back to lower tiers for pixel types that a tier does not implement.
+	if (cpu == CPUClass::CPU_AUTO) {
+		if (!ret && caps.avx2)
+			ret = create_unresize_impl2_v_avx2(context, width, type);
+		if (!ret && caps.sse2)
+			ret = create_unresize_impl2_v_sse2(context, width, type);
+	} else {
+		if (!ret && cpu >= CPUClass::CPU_X86_AVX2)
+			ret = create_unresize_impl2_v_avx2(context, width, type);
+		if (!ret && cpu >= CPUClass::CPU_X86_SSE2)
+			ret = create_unresize_impl2_v_sse2(context, width, type);
+	}
+
+	return ret;
+}
+
 } // namespace unresize
 } // namespace zimg
 
@@ -7,7 +7,10 @@
 
 namespace zimg {;
 
+class IZimgFilter;
+
 enum class CPUClass;
+enum class PixelType;
 
 namespace unresize {;
 
@@ -24,6 +27,22 @@ UnresizeImpl *create_unresize_impl_avx2(const BilinearContext &hcontext, const B
 */
 UnresizeImpl *create_unresize_impl_x86(const BilinearContext &hcontext, const BilinearContext &vcontext, CPUClass cpu);
 
+IZimgFilter *create_unresize_impl2_h_sse2(const BilinearContext &context, unsigned height, PixelType type);
+IZimgFilter *create_unresize_impl2_v_sse2(const BilinearContext &context, unsigned width, PixelType type);
+
+IZimgFilter *create_unresize_impl2_h_avx2(const BilinearContext &context, unsigned height, PixelType type);
+IZimgFilter *create_unresize_impl2_v_avx2(const BilinearContext &context, unsigned width, PixelType type);
+
+IZimgFilter *create_unresize_impl2_h_avx512(const BilinearContext &context, unsigned height, PixelType type);
+
+/**
+ * Create an appropriate x86 optimized unresize filter for the given CPU.
+ *
+ * @see create_unresize_impl2
+ */
+IZimgFilter *create_unresize_impl2_h_x86(const BilinearContext &context, unsigned height, PixelType type, CPUClass cpu);
+IZimgFilter *create_unresize_impl2_v_x86(const BilinearContext &context, unsigned width, PixelType type, CPUClass cpu);
+
 } // namespace unresize
 } // namespace zimg
 